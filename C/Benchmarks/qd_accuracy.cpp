@@ -0,0 +1,606 @@
+/*
+ * qd_accuracy.cpp
+ *
+ * Measures the accuracy and speed of the arithmetic variants and the
+ * transcendental functions, so the cheapest configuration that meets an
+ * error budget can be chosen. See BuildBenchmarks.sh for how to build this,
+ * once for the sloppy library and once for the HP_ACCURATE library.
+ *
+ * The variants of the basic operations (sloppy_add vs ieee_add, sloppy_mul
+ * vs accurate_mul and sloppy_div vs accurate_div) are called directly, so
+ * both are measured by each build. The transcendental functions are called
+ * through the C API, so they use the variants selected by HP_ACCURATE.
+ *
+ * Every function is evaluated on several input sets: representative inputs
+ * (such as "small" and "wide") and adversarial inputs that are known to be
+ * hard for the algorithms (such as "cancel" for additions that cancel most
+ * digits, "pi" for trigonometric arguments close to multiples of pi/2, and
+ * "edge" for arguments close to the boundaries of the domain).
+ *
+ * The results are compared with a 640-bit MPFR reference (computed from the
+ * exact value of the input). Errors are expressed in ulps of the result,
+ * where an ulp is 2^-105 (double-double) or 2^-211 (quad-double) times the
+ * magnitude of the result, rounded down to a power of two.
+ *
+ * The output is CSV, with the columns:
+ *   mode,function,inputs,count,max_ulp,mean_ulp,ns_per_op
+ * mode is "sloppy" or "accurate". ns_per_op is the throughput on the input
+ * set. For the batch functions, this includes the conversion from and to
+ * arrays of dd_real or qd_real.
+ *
+ * Usage: qd_accuracy [-n count] [-t milliseconds] [-f filter]
+ *   -n: number of inputs per input set (default 1000).
+ *   -t: minimum duration of each speed measurement (default 10).
+ *   -f: only test functions whose name contains filter.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <chrono>
+#include <mpfr.h>
+#include "c_dd.h"
+#include "c_qd.h"
+
+#ifdef HP_ACCURATE
+static const char *acc_mode = "accurate";
+#else
+static const char *acc_mode = "sloppy";
+#endif
+
+static const mpfr_prec_t ref_prec = 640;
+static const int max_count = 100000;
+
+static int acc_count = 1000;
+static double acc_time = 0.01;
+static const char *acc_filter = 0;
+
+/**************************** Inputs ****************************/
+
+static unsigned long long rng_state = 0x9E3779B97F4A7C15ull;
+
+/* Returns a random number in [0, 1). */
+static double rng() {
+  rng_state ^= rng_state << 13;
+  rng_state ^= rng_state >> 7;
+  rng_state ^= rng_state << 17;
+  return (rng_state >> 11) * 0x1p-53;
+}
+
+/* Returns a number with a log-uniform magnitude in [lo, hi]. */
+static double rng_log(double lo, double hi, bool sign) {
+  double x = exp(log(lo) + rng() * (log(hi) - log(lo)));
+  return (sign && rng() < 0.5) ? -x : x;
+}
+
+/* Returns a random quad-double x0 + x1 + x2 + x3 with a given leading
+   component and random lower components. The first two components also
+   form a valid double-double. */
+static qd_real full(double x0) {
+  qd_real a;
+  a.x[0] = x0;
+  for (int k = 1; k < 4; k++)
+    a.x[k] = a.x[k - 1] * 0x1p-54 * (2.0 * rng() - 1.0);
+  return a;
+}
+
+static qd_real neg(const qd_real &a) {
+  qd_real b;
+  for (int k = 0; k < 4; k++)
+    b.x[k] = -a.x[k];
+  return b;
+}
+
+/* Rounds an MPFR number to a quad-double. */
+static qd_real from_mpfr(mpfr_srcptr m) {
+  mpfr_t t;
+  qd_real a;
+  mpfr_init2(t, ref_prec);
+  mpfr_set(t, m, MPFR_RNDN);
+  for (int k = 0; k < 4; k++) {
+    a.x[k] = mpfr_get_d(t, MPFR_RNDN);
+    mpfr_sub_d(t, t, a.x[k], MPFR_RNDN);
+  }
+  mpfr_clear(t);
+  return a;
+}
+
+/* Returns k * c (where c is an MPFR constant) plus a small offset. */
+static qd_real near_multiple(int (*c)(mpfr_ptr, mpfr_rnd_t), long k,
+    double offset) {
+  mpfr_t t;
+  mpfr_init2(t, ref_prec);
+  c(t, MPFR_RNDN);
+  mpfr_mul_si(t, t, k, MPFR_RNDN);
+  mpfr_add_d(t, t, offset, MPFR_RNDN);
+  qd_real a = from_mpfr(t);
+  mpfr_clear(t);
+  return a;
+}
+
+/* Returns 1 + d, rounded to a quad-double. */
+static qd_real one_plus(double d) {
+  mpfr_t t;
+  mpfr_init2(t, ref_prec);
+  mpfr_set_d(t, 1.0, MPFR_RNDN);
+  mpfr_add_d(t, t, d, MPFR_RNDN);
+  qd_real a = from_mpfr(t);
+  mpfr_clear(t);
+  return a;
+}
+
+static int const_half_pi(mpfr_ptr r, mpfr_rnd_t rnd) {
+  int i = mpfr_const_pi(r, rnd);
+  mpfr_mul_2si(r, r, -1, rnd);
+  return i;
+}
+
+/* An input set: fills a and b with input k. For double-double functions,
+   the first two components are used. p is the number of components (2 or
+   4), which some sets need to create adversarial inputs. */
+struct input_set {
+  const char *name;
+  void (*gen)(int p, qd_real &a, qd_real &b);
+};
+
+#define SET(name, body) { name, [](int p, qd_real &a, qd_real &b) { (void)p; body; } }
+#define END_SETS { 0, 0 }
+
+/* a and b in a range */
+#define RANGE(name, alo, ahi, asign, blo, bhi, bsign) \
+  SET(name, a = full(rng_log(alo, ahi, asign)); b = full(rng_log(blo, bhi, bsign)))
+
+static const input_set s_add[] = {
+  RANGE("small", 0.5, 2.0, true, 0.5, 2.0, true),
+  RANGE("wide", 1e-20, 1e20, true, 1e-20, 1e20, true),
+  /* b is -a, except for the last component: almost all digits cancel */
+  SET("cancel", a = full(rng_log(0.5, 2.0, true)); b = neg(a);
+      b.x[p - 1] += a.x[p - 1] * (2.0 * rng() - 1.0)),
+  /* a and b differ in the last bits of the first component */
+  SET("partial", a = full(rng_log(0.5, 2.0, true)); b = full(a.x[0]);
+      b.x[0] = -nextafter(a.x[0], 4.0 * a.x[0])),
+  END_SETS
+};
+
+static const input_set s_mul[] = {
+  RANGE("small", 0.5, 2.0, true, 0.5, 2.0, true),
+  RANGE("wide", 1e-100, 1e100, true, 1e-100, 1e100, true),
+  /* the lower components of the product are subnormal */
+  RANGE("tiny", 1e-160, 1e-150, true, 1e-160, 1e-150, true),
+  END_SETS
+};
+
+static const input_set s_div[] = {
+  RANGE("small", 0.5, 2.0, true, 0.5, 2.0, true),
+  RANGE("wide", 1e-100, 1e100, true, 1e-100, 1e100, true),
+  /* a and b are almost equal, so the quotient is close to 1 */
+  SET("near1", a = full(rng_log(0.5, 2.0, true)); b = a;
+      b.x[p - 1] *= 2.0 * rng()),
+  END_SETS
+};
+
+static const input_set s_sqrt[] = {
+  RANGE("small", 0.5, 2.0, false, 1, 1, false),
+  RANGE("wide", 1e-100, 1e100, false, 1, 1, false),
+  /* exact squares of doubles */
+  SET("square", double x = floor(rng_log(1.0, 67108864.0, false));
+      a = qd_real(x * x); b = qd_real(1.0)),
+  END_SETS
+};
+
+static const input_set s_exp[] = {
+  RANGE("small", 0.5, 2.0, true, 1, 1, false),
+  RANGE("wide", 1e-3, 300.0, true, 1, 1, false),
+  /* the lower components of the result are subnormal (for x < 0) */
+  RANGE("extreme", 300.0, 700.0, true, 1, 1, false),
+  RANGE("near0", 1e-30, 1e-10, true, 1, 1, false),
+  /* close to multiples of log(2), used for argument reduction */
+  SET("ln2", a = near_multiple(mpfr_const_log2,
+      static_cast<long>(rng() * 2000.0) - 1000, rng_log(1e-30, 1e-10, true));
+      b = qd_real(1.0)),
+  END_SETS
+};
+
+static const input_set s_hyp[] = {
+  RANGE("small", 0.5, 2.0, true, 1, 1, false),
+  RANGE("wide", 1e-3, 100.0, true, 1, 1, false),
+  RANGE("near0", 1e-30, 1e-10, true, 1, 1, false),
+  END_SETS
+};
+
+static const input_set s_log[] = {
+  RANGE("small", 0.5, 2.0, false, 1, 1, false),
+  RANGE("wide", 1e-100, 1e100, false, 1, 1, false),
+  /* close to 1, where the result is close to 0 */
+  SET("near1", a = one_plus(rng_log(1e-30, 1e-5, true)); b = qd_real(1.0)),
+  END_SETS
+};
+
+static const input_set s_trig[] = {
+  RANGE("small", 0.5, 2.0, true, 1, 1, false),
+  RANGE("wide", 1.0, 100.0, true, 1, 1, false),
+  RANGE("huge", 1e3, 1e10, true, 1, 1, false),
+  /* close to multiples of pi/2, where argument reduction cancels digits */
+  SET("pi", a = near_multiple(const_half_pi,
+      static_cast<long>(rng() * 2000.0) - 1000, rng_log(1e-30, 1e-5, true));
+      b = qd_real(1.0)),
+  END_SETS
+};
+
+static const input_set s_asin[] = {
+  RANGE("small", 1e-3, 0.5, true, 1, 1, false),
+  /* close to -1 or 1 */
+  SET("edge", a = qd_real(1.0 - ldexp(1.0, -static_cast<int>(5 + rng() * 45)));
+      if (rng() < 0.5) a = neg(a); b = qd_real(1.0)),
+  END_SETS
+};
+
+static const input_set s_atan[] = {
+  RANGE("small", 0.5, 2.0, true, 1, 1, false),
+  RANGE("wide", 1e-20, 1e20, true, 1, 1, false),
+  END_SETS
+};
+
+static const input_set s_atan2[] = {
+  RANGE("small", 0.5, 2.0, true, 0.5, 2.0, true),
+  RANGE("wide", 1e-20, 1e20, true, 1e-20, 1e20, true),
+  /* close to the negative x-axis */
+  SET("axis", a = full(rng_log(1e-30, 1e-10, true)); b = full(-rng_log(0.5, 2.0, false))),
+  END_SETS
+};
+
+static const input_set s_asinh[] = {
+  RANGE("small", 0.5, 2.0, true, 1, 1, false),
+  RANGE("wide", 1e-20, 1e20, true, 1, 1, false),
+  RANGE("near0", 1e-30, 1e-10, true, 1, 1, false),
+  END_SETS
+};
+
+static const input_set s_acosh[] = {
+  RANGE("wide", 1.001, 1e20, false, 1, 1, false),
+  /* close to 1, where the result is close to 0 */
+  SET("edge", a = one_plus(rng_log(1e-30, 1e-5, false)); b = qd_real(1.0)),
+  END_SETS
+};
+
+static const input_set s_pow[] = {
+  RANGE("small", 0.5, 2.0, false, 0.5, 10.0, true),
+  /* close to 1 with a large exponent */
+  SET("near1", a = one_plus(rng_log(1e-30, 1e-10, true));
+      b = qd_real(floor(rng_log(1e3, 1e6, true)))),
+  END_SETS
+};
+
+static const input_set s_batch_exp[] = {
+  RANGE("small", 0.5, 2.0, true, 1, 1, false),
+  RANGE("wide", 1e-3, 300.0, true, 1, 1, false),
+  END_SETS
+};
+
+static const input_set s_batch_log[] = {
+  RANGE("small", 0.5, 2.0, false, 1, 1, false),
+  RANGE("wide", 1e-100, 1e100, false, 1, 1, false),
+  END_SETS
+};
+
+static const input_set s_batch_trig[] = {
+  RANGE("small", 0.5, 2.0, true, 1, 1, false),
+  RANGE("wide", 1.0, 100.0, true, 1, 1, false),
+  END_SETS
+};
+
+/************************** Evaluation **************************/
+
+/* The double-double in the first two components of a quad-double */
+static inline dd_real &dd(qd_real &a) {
+  return *reinterpret_cast<dd_real *>(a.x);
+}
+
+static inline const dd_real &dd(const qd_real &a) {
+  return *reinterpret_cast<const dd_real *>(a.x);
+}
+
+/* Evaluates a function for n inputs. */
+typedef void (*eval_func)(const qd_real *a, const qd_real *b, qd_real *r, int n);
+
+template <dd_real (*F)(const dd_real &, const dd_real &)>
+static void dd_op(const qd_real *a, const qd_real *b, qd_real *r, int n) {
+  for (int k = 0; k < n; k++)
+    dd(r[k]) = F(dd(a[k]), dd(b[k]));
+}
+
+static dd_real dd_mul_op(const dd_real &a, const dd_real &b) {
+  return a * b;
+}
+
+template <void (*F)(const dd_real *, dd_real *)>
+static void dd_unary(const qd_real *a, const qd_real *, qd_real *r, int n) {
+  for (int k = 0; k < n; k++)
+    F(&dd(a[k]), &dd(r[k]));
+}
+
+template <void (*F)(const dd_real *, const dd_real *, dd_real *)>
+static void dd_binary(const qd_real *a, const qd_real *b, qd_real *r, int n) {
+  for (int k = 0; k < n; k++)
+    F(&dd(a[k]), &dd(b[k]), &dd(r[k]));
+}
+
+static void dd_nroot3(const qd_real *a, const qd_real *, qd_real *r, int n) {
+  for (int k = 0; k < n; k++)
+    c_dd_nroot(&dd(a[k]), 3, &dd(r[k]));
+}
+
+static void dd_sin(const dd_real *a, dd_real *b) {
+  dd_real c;
+  c_dd_sincos(a, b, &c);
+}
+
+template <qd_real (*F)(const qd_real &, const qd_real &)>
+static void qd_op(const qd_real *a, const qd_real *b, qd_real *r, int n) {
+  for (int k = 0; k < n; k++)
+    r[k] = F(a[k], b[k]);
+}
+
+template <void (*F)(const qd_real *, qd_real *)>
+static void qd_unary(const qd_real *a, const qd_real *, qd_real *r, int n) {
+  for (int k = 0; k < n; k++)
+    F(&a[k], &r[k]);
+}
+
+template <void (*F)(const qd_real *, const qd_real *, qd_real *)>
+static void qd_binary(const qd_real *a, const qd_real *b, qd_real *r, int n) {
+  for (int k = 0; k < n; k++)
+    F(&a[k], &b[k], &r[k]);
+}
+
+static void qd_nroot3(const qd_real *a, const qd_real *, qd_real *r, int n) {
+  for (int k = 0; k < n; k++)
+    c_qd_nroot(&a[k], 3, &r[k]);
+}
+
+static void qd_sin(const qd_real *a, qd_real *b) {
+  qd_real c;
+  c_qd_sincos(a, b, &c);
+}
+
+/* Buffers for the batch functions */
+static double planes[3][4][max_count];
+static dd_real dd_aos[max_count];
+static qd_real qd_aos[max_count];
+
+static void init_planes(dd_real_array &d, qd_real_array &q, int j, int n) {
+  d.count = q.count = n;
+  for (int c = 0; c < 4; c++) {
+    if (c < 2)
+      d.x[c] = planes[j][c];
+    q.x[c] = planes[j][c];
+  }
+}
+
+template <void (*F)(const dd_real_array *, dd_real_array *)>
+static void dd_batch(const qd_real *a, const qd_real *, qd_real *r, int n) {
+  dd_real_array x, y;
+  qd_real_array unused;
+  init_planes(x, unused, 0, n);
+  init_planes(y, unused, 1, n);
+  for (int k = 0; k < n; k++)
+    dd_aos[k] = dd(a[k]);
+  c_dd_to_soa(dd_aos, &x);
+  F(&x, &y);
+  c_dd_to_aos(&y, dd_aos);
+  for (int k = 0; k < n; k++)
+    dd(r[k]) = dd_aos[k];
+}
+
+static void dd_sin_n(const dd_real_array *a, dd_real_array *b) {
+  dd_real_array c;
+  qd_real_array unused;
+  init_planes(c, unused, 2, b->count);
+  c_dd_sincos_n(a, b, &c);
+}
+
+template <void (*F)(const qd_real_array *, qd_real_array *)>
+static void qd_batch(const qd_real *a, const qd_real *, qd_real *r, int n) {
+  dd_real_array unused;
+  qd_real_array x, y;
+  init_planes(unused, x, 0, n);
+  init_planes(unused, y, 1, n);
+  c_qd_to_soa(a, &x);
+  F(&x, &y);
+  c_qd_to_aos(&y, r);
+}
+
+static void qd_sin_n(const qd_real_array *a, qd_real_array *b) {
+  dd_real_array unused;
+  qd_real_array c;
+  init_planes(unused, c, 2, b->count);
+  c_qd_sincos_n(a, b, &c);
+}
+
+/* The MPFR reference of a function */
+typedef void (*ref_func)(mpfr_ptr r, mpfr_srcptr a, mpfr_srcptr b);
+
+#define REF1(f) [](mpfr_ptr r, mpfr_srcptr a, mpfr_srcptr) { f(r, a, MPFR_RNDN); }
+#define REF2(f) [](mpfr_ptr r, mpfr_srcptr a, mpfr_srcptr b) { f(r, a, b, MPFR_RNDN); }
+
+/* A function to test */
+struct test {
+  const char *name;
+  int p;                  /* 2 for double-double, 4 for quad-double */
+  eval_func eval;
+  ref_func ref;
+  const input_set *sets;
+};
+
+/*************************** Measuring ***************************/
+
+static qd_real in_a[max_count], in_b[max_count], out[max_count];
+
+static void to_mpfr(mpfr_ptr m, const qd_real &a, int p) {
+  mpfr_set_d(m, a.x[0], MPFR_RNDN);
+  for (int k = 1; k < p; k++)
+    mpfr_add_d(m, m, a.x[k], MPFR_RNDN);
+}
+
+/* Returns the error of r in ulps of ref. */
+static double ulp_error(const qd_real &r, int p, mpfr_srcptr ref, mpfr_ptr t) {
+  to_mpfr(t, r, p);
+  mpfr_sub(t, t, ref, MPFR_RNDN);
+  mpfr_abs(t, t, MPFR_RNDN);
+  if (mpfr_zero_p(t))
+    return 0.0;
+  if (!mpfr_number_p(t))
+    return INFINITY;
+  /* ref is in [2^(e-1), 2^e), so an ulp is 2^(e - 1 - bits + 1) */
+  int bits = (p == 2) ? 106 : 212;
+  mpfr_mul_2si(t, t, bits - mpfr_get_exp(ref), MPFR_RNDN);
+  return mpfr_get_d(t, MPFR_RNDN);
+}
+
+static void run(const test &t) {
+  if (acc_filter != 0 && strstr(t.name, acc_filter) == 0)
+    return;
+
+  mpfr_t a, b, ref, tmp;
+  mpfr_init2(a, ref_prec);
+  mpfr_init2(b, ref_prec);
+  mpfr_init2(ref, ref_prec);
+  mpfr_init2(tmp, ref_prec);
+
+  for (const input_set *s = t.sets; s->name; s++) {
+    int n = 0;
+    while (n < acc_count) {
+      s->gen(t.p, in_a[n], in_b[n]);
+      if (t.p == 2) {
+        in_a[n].x[2] = in_a[n].x[3] = 0.0;
+        in_b[n].x[2] = in_b[n].x[3] = 0.0;
+      }
+      n++;
+    }
+
+    t.eval(in_a, in_b, out, n);
+
+    double max_err = 0.0, sum_err = 0.0;
+    int used = 0;
+    for (int k = 0; k < n; k++) {
+      to_mpfr(a, in_a[k], t.p);
+      to_mpfr(b, in_b[k], t.p);
+      t.ref(ref, a, b);
+      /* skip results that overflow or are exactly 0 */
+      if (!mpfr_number_p(ref) || mpfr_zero_p(ref) ||
+          fabs(mpfr_get_d(ref, MPFR_RNDN)) > 1e300)
+        continue;
+      double err = ulp_error(out[k], t.p, ref, tmp);
+      if (err > max_err || err != err)
+        max_err = err;
+      sum_err += err;
+      used++;
+    }
+
+    typedef std::chrono::steady_clock clock;
+    long reps = 0;
+    clock::time_point start = clock::now();
+    double elapsed;
+    do {
+      t.eval(in_a, in_b, out, n);
+      reps++;
+      elapsed = std::chrono::duration<double>(clock::now() - start).count();
+    } while (elapsed < acc_time);
+
+    printf("%s,%s,%s,%d,%.3g,%.3g,%.3f\n", acc_mode, t.name, s->name, used,
+      max_err, used ? sum_err / used : 0.0, elapsed * 1e9 / (reps * n));
+    fflush(stdout);
+  }
+
+  mpfr_clear(a);
+  mpfr_clear(b);
+  mpfr_clear(ref);
+  mpfr_clear(tmp);
+}
+
+static const test tests[] = {
+  /* double-double arithmetic variants */
+  { "dd_real::sloppy_add", 2, dd_op<dd_real::sloppy_add>, REF2(mpfr_add), s_add },
+  { "dd_real::ieee_add", 2, dd_op<dd_real::ieee_add>, REF2(mpfr_add), s_add },
+  { "dd_real::operator*", 2, dd_op<dd_mul_op>, REF2(mpfr_mul), s_mul },
+  { "dd_real::sloppy_div", 2, dd_op<dd_real::sloppy_div>, REF2(mpfr_div), s_div },
+  { "dd_real::accurate_div", 2, dd_op<dd_real::accurate_div>, REF2(mpfr_div), s_div },
+
+  /* double-double functions */
+  { "c_dd_sqrt", 2, dd_unary<c_dd_sqrt>, REF1(mpfr_sqrt), s_sqrt },
+  { "c_dd_nroot(3)", 2, dd_nroot3, REF1(mpfr_cbrt), s_sqrt },
+  { "c_dd_exp", 2, dd_unary<c_dd_exp>, REF1(mpfr_exp), s_exp },
+  { "c_dd_log", 2, dd_unary<c_dd_log>, REF1(mpfr_log), s_log },
+  { "c_dd_log10", 2, dd_unary<c_dd_log10>, REF1(mpfr_log10), s_log },
+  { "c_dd_sin", 2, dd_unary<c_dd_sin>, REF1(mpfr_sin), s_trig },
+  { "c_dd_cos", 2, dd_unary<c_dd_cos>, REF1(mpfr_cos), s_trig },
+  { "c_dd_tan", 2, dd_unary<c_dd_tan>, REF1(mpfr_tan), s_trig },
+  { "c_dd_sincos", 2, dd_unary<dd_sin>, REF1(mpfr_sin), s_trig },
+  { "c_dd_asin", 2, dd_unary<c_dd_asin>, REF1(mpfr_asin), s_asin },
+  { "c_dd_acos", 2, dd_unary<c_dd_acos>, REF1(mpfr_acos), s_asin },
+  { "c_dd_atan", 2, dd_unary<c_dd_atan>, REF1(mpfr_atan), s_atan },
+  { "c_dd_atan2", 2, dd_binary<c_dd_atan2>, REF2(mpfr_atan2), s_atan2 },
+  { "c_dd_sinh", 2, dd_unary<c_dd_sinh>, REF1(mpfr_sinh), s_hyp },
+  { "c_dd_cosh", 2, dd_unary<c_dd_cosh>, REF1(mpfr_cosh), s_hyp },
+  { "c_dd_tanh", 2, dd_unary<c_dd_tanh>, REF1(mpfr_tanh), s_hyp },
+  { "c_dd_asinh", 2, dd_unary<c_dd_asinh>, REF1(mpfr_asinh), s_asinh },
+  { "c_dd_acosh", 2, dd_unary<c_dd_acosh>, REF1(mpfr_acosh), s_acosh },
+  { "c_dd_atanh", 2, dd_unary<c_dd_atanh>, REF1(mpfr_atanh), s_asin },
+  { "c_dd_pow", 2, dd_binary<c_dd_pow>, REF2(mpfr_pow), s_pow },
+  { "c_dd_exp_n", 2, dd_batch<c_dd_exp_n>, REF1(mpfr_exp), s_batch_exp },
+  { "c_dd_log_n", 2, dd_batch<c_dd_log_n>, REF1(mpfr_log), s_batch_log },
+  { "c_dd_sincos_n", 2, dd_batch<dd_sin_n>, REF1(mpfr_sin), s_batch_trig },
+
+  /* quad-double arithmetic variants */
+  { "qd_real::sloppy_add", 4, qd_op<qd_real::sloppy_add>, REF2(mpfr_add), s_add },
+  { "qd_real::ieee_add", 4, qd_op<qd_real::ieee_add>, REF2(mpfr_add), s_add },
+  { "qd_real::sloppy_mul", 4, qd_op<qd_real::sloppy_mul>, REF2(mpfr_mul), s_mul },
+  { "qd_real::accurate_mul", 4, qd_op<qd_real::accurate_mul>, REF2(mpfr_mul), s_mul },
+  { "qd_real::sloppy_div", 4, qd_op<qd_real::sloppy_div>, REF2(mpfr_div), s_div },
+  { "qd_real::accurate_div", 4, qd_op<qd_real::accurate_div>, REF2(mpfr_div), s_div },
+
+  /* quad-double functions */
+  { "c_qd_sqrt", 4, qd_unary<c_qd_sqrt>, REF1(mpfr_sqrt), s_sqrt },
+  { "c_qd_nroot(3)", 4, qd_nroot3, REF1(mpfr_cbrt), s_sqrt },
+  { "c_qd_exp", 4, qd_unary<c_qd_exp>, REF1(mpfr_exp), s_exp },
+  { "c_qd_log", 4, qd_unary<c_qd_log>, REF1(mpfr_log), s_log },
+  { "c_qd_log10", 4, qd_unary<c_qd_log10>, REF1(mpfr_log10), s_log },
+  { "c_qd_sin", 4, qd_unary<c_qd_sin>, REF1(mpfr_sin), s_trig },
+  { "c_qd_cos", 4, qd_unary<c_qd_cos>, REF1(mpfr_cos), s_trig },
+  { "c_qd_tan", 4, qd_unary<c_qd_tan>, REF1(mpfr_tan), s_trig },
+  { "c_qd_sincos", 4, qd_unary<qd_sin>, REF1(mpfr_sin), s_trig },
+  { "c_qd_asin", 4, qd_unary<c_qd_asin>, REF1(mpfr_asin), s_asin },
+  { "c_qd_acos", 4, qd_unary<c_qd_acos>, REF1(mpfr_acos), s_asin },
+  { "c_qd_atan", 4, qd_unary<c_qd_atan>, REF1(mpfr_atan), s_atan },
+  { "c_qd_atan2", 4, qd_binary<c_qd_atan2>, REF2(mpfr_atan2), s_atan2 },
+  { "c_qd_sinh", 4, qd_unary<c_qd_sinh>, REF1(mpfr_sinh), s_hyp },
+  { "c_qd_cosh", 4, qd_unary<c_qd_cosh>, REF1(mpfr_cosh), s_hyp },
+  { "c_qd_tanh", 4, qd_unary<c_qd_tanh>, REF1(mpfr_tanh), s_hyp },
+  { "c_qd_asinh", 4, qd_unary<c_qd_asinh>, REF1(mpfr_asinh), s_asinh },
+  { "c_qd_acosh", 4, qd_unary<c_qd_acosh>, REF1(mpfr_acosh), s_acosh },
+  { "c_qd_atanh", 4, qd_unary<c_qd_atanh>, REF1(mpfr_atanh), s_asin },
+  { "c_qd_pow", 4, qd_binary<c_qd_pow>, REF2(mpfr_pow), s_pow },
+  { "c_qd_exp_n", 4, qd_batch<c_qd_exp_n>, REF1(mpfr_exp), s_batch_exp },
+  { "c_qd_log_n", 4, qd_batch<c_qd_log_n>, REF1(mpfr_log), s_batch_log },
+  { "c_qd_sincos_n", 4, qd_batch<qd_sin_n>, REF1(mpfr_sin), s_batch_trig },
+};
+
+int main(int argc, char *argv[]) {
+  for (int i = 1; i < argc - 1; i++) {
+    if (strcmp(argv[i], "-n") == 0)
+      acc_count = atoi(argv[++i]);
+    else if (strcmp(argv[i], "-t") == 0)
+      acc_time = atof(argv[++i]) / 1000.0;
+    else if (strcmp(argv[i], "-f") == 0)
+      acc_filter = argv[++i];
+  }
+  if (acc_count < 1)
+    acc_count = 1;
+  if (acc_count > max_count)
+    acc_count = max_count;
+
+  printf("mode,function,inputs,count,max_ulp,mean_ulp,ns_per_op\n");
+  for (const test &t : tests)
+    run(t);
+  return 0;
+}
@@ -0,0 +1,730 @@
+/*
+ * qd_bench.cpp
+ *
+ * Microbenchmarks for every function in c_dd.h and c_qd.h. See
+ * BuildBenchmarks.sh for how to build this, once for the sloppy library and
+ * once for the HP_ACCURATE library.
+ *
+ * Every function is measured in two ways:
+ * - latency: each call depends on the result of the previous call, so
+ *   calls cannot overlap. The dependency is created by adding 0 times the
+ *   (first component of the) previous result to the next input, which adds
+ *   a multiply and an add (a few cycles) to the chain.
+ * - throughput: the calls work on 256 independent inputs, so the CPU can
+ *   overlap consecutive calls.
+ * The batch functions (*_n) and the conversions (to_soa/to_aos) are measured
+ * on arrays of 1024 elements, and report the time per element.
+ *
+ * Each function is measured for one or more input ranges (such as "small",
+ * "wide" and "huge"), since the cost of many functions depends on the
+ * magnitude of the input.
+ *
+ * The overhead of calling the pointer-based C wrappers is measured by
+ * comparing c_dd_add, c_dd_neg, c_qd_add and c_qd_neg with the inline C++
+ * operators (kind "inline"). Rows with kind "ffi" contain the difference.
+ *
+ * The output is CSV, with the columns:
+ *   mode,function,range,kind,ns_per_op,cycles_per_op
+ * mode is "sloppy" or "accurate". cycles_per_op uses the time stamp counter,
+ * which runs at the nominal (not the actual) clock frequency of the CPU. It
+ * is empty on CPUs without a time stamp counter.
+ *
+ * Usage: qd_bench [-t milliseconds] [-f filter]
+ *   -t: minimum duration of each measurement (default 20).
+ *   -f: only benchmark functions whose name contains filter.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <chrono>
+#include "c_dd.h"
+#include "c_qd.h"
+#include "c_repro.h"
+#include "c_blas.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define QD_BENCH_TSC 1
+#endif
+
+#ifdef HP_ACCURATE
+static const char *bench_mode = "accurate";
+#else
+static const char *bench_mode = "sloppy";
+#endif
+
+static double bench_time = 0.02;
+static const char *bench_filter = 0;
+
+/**************************** Inputs ****************************/
+
+/* Inputs of an argument. Log-uniform magnitudes in [lo, hi] (with a random
+   sign if sign is set), integers in [lo, hi], or powers of two in
+   [lo, hi]. */
+enum domain_kind { dom_log, dom_int, dom_pow2 };
+
+struct domain {
+  domain_kind kind;
+  double lo, hi;
+  bool sign;
+};
+
+/* An input range of a function, with the domains of both arguments. */
+struct range {
+  const char *name;
+  domain a, b;
+};
+
+static const domain d_unit   = { dom_log, 0.5, 2.0, false };
+static const domain d_sunit  = { dom_log, 0.5, 2.0, true };
+static const domain d_wide   = { dom_log, 1e-3, 1e3, true };
+static const domain d_pwide  = { dom_log, 1e-3, 1e3, false };
+static const domain d_huge   = { dom_log, 1e10, 1e100, true };
+static const domain d_phuge  = { dom_log, 1e10, 1e100, false };
+static const domain d_exp    = { dom_log, 1e-3, 100.0, true };
+static const domain d_trig   = { dom_log, 1.0, 100.0, true };
+static const domain d_btrig  = { dom_log, 1e3, 1e10, true };
+static const domain d_small  = { dom_log, 1e-3, 0.5, true };
+static const domain d_edge   = { dom_log, 0.9, 0.999, true };
+static const domain d_acosh  = { dom_log, 1.001, 1e3, false };
+static const domain d_expo   = { dom_log, 0.5, 10.0, true };
+static const domain d_mod    = { dom_log, 1.0, 1e6, true };
+static const domain d_npwr   = { dom_int, -10, 10, false };
+static const domain d_nroot  = { dom_int, 2, 5, false };
+static const domain d_ldexp  = { dom_int, -100, 100, false };
+static const domain d_pow2   = { dom_pow2, -10, 10, true };
+
+/* Ends a list of ranges (the name is null) */
+static const range range_end = { 0, d_unit, d_unit };
+
+#define RANGES(...) { __VA_ARGS__, range_end }
+
+static const range r_arith[] = RANGES(
+  { "small", d_sunit, d_sunit }, { "wide", d_wide, d_wide },
+  { "huge", d_huge, d_huge });
+static const range r_pos[] = RANGES(
+  { "small", d_unit, d_unit }, { "wide", d_pwide, d_unit },
+  { "huge", d_phuge, d_unit });
+static const range r_exp[] = RANGES(
+  { "small", d_sunit, d_unit }, { "wide", d_exp, d_unit });
+static const range r_trig[] = RANGES(
+  { "small", d_sunit, d_unit }, { "wide", d_trig, d_unit },
+  { "huge", d_btrig, d_unit });
+static const range r_unit[] = RANGES(
+  { "small", d_small, d_unit }, { "edge", d_edge, d_unit });
+static const range r_acosh[] = RANGES({ "wide", d_acosh, d_unit });
+static const range r_pow[] = RANGES({ "small", d_unit, d_expo });
+static const range r_mod[] = RANGES(
+  { "small", d_sunit, d_unit }, { "wide", d_mod, d_unit });
+static const range r_npwr[] = RANGES({ "small", d_unit, d_npwr });
+static const range r_nroot[] = RANGES({ "small", d_pwide, d_nroot });
+static const range r_ldexp[] = RANGES({ "small", d_wide, d_ldexp });
+static const range r_pot[] = RANGES({ "small", d_wide, d_pow2 });
+static const range r_none[] = RANGES({ "-", d_unit, d_unit });
+
+static unsigned long long rng_state = 0x9E3779B97F4A7C15ull;
+
+/* Returns a random number in [0, 1). */
+static double rng() {
+  rng_state ^= rng_state << 13;
+  rng_state ^= rng_state >> 7;
+  rng_state ^= rng_state << 17;
+  return (rng_state >> 11) * 0x1p-53;
+}
+
+static double random_double(const domain &d) {
+  double x;
+  switch (d.kind) {
+  case dom_int:
+    return floor(d.lo + rng() * (d.hi - d.lo + 1.0));
+  case dom_pow2:
+    x = ldexp(1.0, static_cast<int>(floor(d.lo + rng() * (d.hi - d.lo + 1.0))));
+    break;
+  default:
+    x = exp(log(d.lo) + rng() * (log(d.hi) - log(d.lo)));
+  }
+  return (d.sign && rng() < 0.5) ? -x : x;
+}
+
+/* Random numbers with lower components that fill the full precision. */
+static void random_value(const domain &d, double &a) {
+  a = random_double(d);
+}
+
+static void random_value(const domain &d, int &a) {
+  a = static_cast<int>(random_double(d));
+}
+
+static void random_value(const domain &d, dd_real &a) {
+  a.x[0] = random_double(d);
+  a.x[1] = (d.kind == dom_log) ? a.x[0] * 0x1p-54 * (2.0 * rng() - 1.0) : 0.0;
+}
+
+static void random_value(const domain &d, qd_real &a) {
+  a.x[0] = random_double(d);
+  for (int k = 1; k < 4; k++)
+    a.x[k] = (d.kind == dom_log) ? a.x[k - 1] * 0x1p-54 * (2.0 * rng() - 1.0) : 0.0;
+}
+
+/* The first component of a value, used to create dependency chains. */
+static inline double &first(double &a) { return a; }
+static inline double &first(dd_real &a) { return a.x[0]; }
+static inline double &first(qd_real &a) { return a.x[0]; }
+static inline double &first(dd_real_pair &a) { return a.v1.x[0]; }
+static inline double &first(qd_real_pair &a) { return a.v1.x[0]; }
+static inline double first(int &a) { return a; }
+
+/**************************** Timing ****************************/
+
+struct timing {
+  double ns;
+  double cycles;
+};
+
+static inline unsigned long long ticks() {
+#ifdef QD_BENCH_TSC
+  return __rdtsc();
+#else
+  return 0;
+#endif
+}
+
+/* Repeatedly calls pass() (which performs ops operations) until at least
+   bench_time seconds have passed, and returns the time per operation. */
+template <class P>
+static timing measure(P pass, long ops) {
+  typedef std::chrono::steady_clock clock;
+  long n = 0, reps = 1;
+
+  pass(); /* warm up */
+  clock::time_point start = clock::now();
+  unsigned long long t0 = ticks();
+  double elapsed;
+  for (;;) {
+    for (long k = 0; k < reps; k++)
+      pass();
+    n += reps;
+    elapsed = std::chrono::duration<double>(clock::now() - start).count();
+    if (elapsed >= bench_time)
+      break;
+    reps *= 2;
+  }
+  unsigned long long t1 = ticks();
+
+  timing t;
+  t.ns = elapsed * 1e9 / (static_cast<double>(n) * ops);
+  t.cycles = static_cast<double>(t1 - t0) / (static_cast<double>(n) * ops);
+  return t;
+}
+
+static void report(const char *name, const char *range, const char *kind,
+    timing t) {
+#ifdef QD_BENCH_TSC
+  printf("%s,%s,%s,%s,%.3f,%.2f\n", bench_mode, name, range, kind, t.ns, t.cycles);
+#else
+  printf("%s,%s,%s,%s,%.3f,\n", bench_mode, name, range, kind, t.ns);
+#endif
+  fflush(stdout);
+}
+
+static bool selected(const char *name) {
+  return bench_filter == 0 || strstr(name, bench_filter) != 0;
+}
+
+/************************** Benchmarks **************************/
+
+static const int N = 256;
+
+/* Benchmarks r = f(a, b) (or r = f(a) if B is void) for each range. */
+template <class A, class B, class R, class F>
+static void bench(const char *name, const range *ranges, F f) {
+  static A a[N];
+  static B b[N];
+  static R r[N];
+  if (!selected(name))
+    return;
+
+  for (const range *rg = ranges; rg->name; rg++) {
+    for (int k = 0; k < N; k++) {
+      random_value(rg->a, a[k]);
+      random_value(rg->b, b[k]);
+    }
+
+    report(name, rg->name, "latency", measure([&]() {
+      R y = r[0];
+      for (int k = 0; k < N; k++) {
+        A x = a[k];
+        first(x) += first(y) * 0.0;
+        f(&x, &b[k], &y);
+      }
+      r[0] = y;
+    }, N));
+
+    report(name, rg->name, "throughput", measure([&]() {
+      for (int k = 0; k < N; k++)
+        f(&a[k], &b[k], &r[k]);
+    }, N));
+  }
+}
+
+#define UNARY(A, R, f, ranges) \
+  bench<A, double, R>(#f, ranges, [](const A *a, const double *, R *r) { f(a, r); })
+#define BINARY(A, B, R, f, ranges) \
+  bench<A, B, R>(#f, ranges, [](const A *a, const B *b, R *r) { f(a, b, r); })
+#define BINARY_INT(A, R, f, ranges) \
+  bench<A, int, R>(#f, ranges, [](const A *a, const int *b, R *r) { f(a, *b, r); })
+#define COMPARE(A, B, f) \
+  bench<A, B, int>(#f, r_arith, [](const A *a, const B *b, int *r) { *r = f(a, b); })
+#define SINCOS(T, P, f, ranges) \
+  bench<T, double, P>(#f, ranges, [](const T *a, const double *, P *r) { f(a, &r->v1, &r->v2); })
+#define TO_STRING(T, f, format, precision) \
+  bench<T, double, int>(#f "/" #format, r_arith, [](const T *a, const double *, int *r) { \
+    char buf[128]; qd_string s = { buf, static_cast<int>(sizeof(buf)), format, precision }; *r = f(a, &s); })
+
+/* Benchmarks parsing the shortest strings of random values. */
+template <class T>
+static void bench_parse(const char *name, int (*to_string)(const T *, const qd_string *),
+    int (*parse)(const char *, int, T *)) {
+  static char s[N][128];
+  static int len[N];
+  static T r[N];
+  if (!selected(name))
+    return;
+
+  for (const range *rg = r_arith; rg->name; rg++) {
+    for (int k = 0; k < N; k++) {
+      T a;
+      random_value(rg->a, a);
+      qd_string str = { s[k], static_cast<int>(sizeof(s[k])), qd_shortest, 0 };
+      len[k] = to_string(&a, &str);
+    }
+
+    report(name, rg->name, "throughput", measure([&]() {
+      for (int k = 0; k < N; k++)
+        parse(s[k], len[k], &r[k]);
+    }, N));
+  }
+}
+
+/* Polynomial evaluation: the Taylor polynomial of exp of degree poly_n */
+static const int poly_n = 16;
+static dd_real poly_dd[poly_n + 1];
+static qd_real poly_qd[poly_n + 1];
+
+static void init_poly() {
+  poly_dd[0] = 1.0;
+  poly_qd[0] = 1.0;
+  for (int k = 1; k <= poly_n; k++) {
+    poly_dd[k] = poly_dd[k - 1] / static_cast<double>(k);
+    poly_qd[k] = poly_qd[k - 1] / static_cast<double>(k);
+  }
+}
+
+#define POLYEVAL(T, f, c) \
+  bench<T, double, T>(#f, r_unit, [](const T *a, const double *, T *r) { f(c, poly_n, a, r); })
+
+/* In-place functions (b = b op a). The result starts as a copy of b, so the
+   values do not grow or shrink over time. */
+#define SELF(A, f, ranges) \
+  bench<A, qd_real, qd_real>(#f, ranges, [](const A *a, const qd_real *b, qd_real *r) { *r = *b; f(a, r); })
+
+/* Benchmarks a batch function on arrays of M elements. */
+static const int M = 1024;
+
+struct batch_data {
+  double in[3][4][M];
+  double out[2][4][M];
+  dd_real_array dd[5];
+  qd_real_array qd[5];
+  dd_real dd_aos[M];
+  qd_real qd_aos[M];
+};
+
+static batch_data *batch;
+
+static void init_batch(const domain &da, const domain &db) {
+  for (int k = 0; k < M; k++) {
+    dd_real x;
+    qd_real y;
+    for (int j = 0; j < 3; j++) {
+      random_value(j == 1 ? db : da, y);
+      for (int c = 0; c < 4; c++)
+        batch->in[j][c][k] = y.x[c];
+    }
+    random_value(da, x);
+    batch->dd_aos[k] = x;
+    random_value(da, y);
+    batch->qd_aos[k] = y;
+  }
+  for (int j = 0; j < 5; j++) {
+    double (*p)[4][M] = (j < 3) ? &batch->in[j] : &batch->out[j - 3];
+    batch->dd[j].count = M;
+    batch->qd[j].count = M;
+    for (int c = 0; c < 4; c++) {
+      if (c < 2)
+        batch->dd[j].x[c] = (*p)[c];
+      batch->qd[j].x[c] = (*p)[c];
+    }
+  }
+}
+
+template <class F>
+static void bench_batch(const char *name, const domain &da, const domain &db,
+    F f) {
+  if (!selected(name))
+    return;
+  init_batch(da, db);
+  report(name, "-", "throughput", measure([&]() { f(); }, M));
+}
+
+#define BATCH(f, da, db, ...) \
+  bench_batch(#f, da, db, [&]() { f(__VA_ARGS__); })
+
+/* The matrix-vector products use the batch arrays as a matrix of
+   gemv_n x gemv_n elements (so the time per element is the time per
+   multiply-add), and the first gemv_n elements as the vectors. */
+static const int gemv_n = 32;
+
+/* Benchmarks writing (both passes) and reading (both passes) a table of M
+   rows and one column in text form, on a single thread, with the values of
+   the batch benchmarks. */
+static void bench_text(const char *write_name, const char *read_name,
+    void (*measure_text)(qd_text *), void (*format_text)(qd_text *),
+    void (*parse_text)(qd_text *)) {
+  static char text[M * 128];
+  static qd_text t;
+  double *in[4], *out[4];
+  if (!selected(write_name) && !selected(read_name))
+    return;
+  init_batch(d_wide, d_unit);
+  for (int c = 0; c < 4; c++) {
+    in[c] = batch->in[0][c];
+    out[c] = batch->out[0][c];
+  }
+
+  t.rows = M;
+  t.columns = 1;
+  t.separator = ',';
+  t.format = qd_shortest;
+  t.x = in;
+  timing w = measure([&]() {
+    t.next_chunk = t.done_chunks = 0;
+    measure_text(&t);
+    t.text = text;
+    t.next_chunk = 0;
+    format_text(&t);
+  }, M);
+  if (selected(write_name))
+    report(write_name, "wide", "throughput", w);
+
+  t.x = out;
+  timing r = measure([&]() {
+    t.next_chunk = t.done_chunks = 0;
+    c_qd_count_text(&t);
+    t.next_chunk = 0;
+    parse_text(&t);
+  }, M);
+  if (selected(read_name))
+    report(read_name, "wide", "throughput", r);
+}
+
+/* Compares a C wrapper with the inline C++ operator. */
+template <class T, class C, class I>
+static void bench_ffi(const char *name, C call, I inl) {
+  static T a[N], b[N], r[N];
+  if (!selected(name))
+    return;
+  for (int k = 0; k < N; k++) {
+    random_value(d_sunit, a[k]);
+    random_value(d_sunit, b[k]);
+  }
+  timing c = measure([&]() {
+    for (int k = 0; k < N; k++)
+      call(&a[k], &b[k], &r[k]);
+  }, N);
+  timing i = measure([&]() {
+    for (int k = 0; k < N; k++) {
+      r[k] = inl(a[k], b[k]);
+      __asm__ __volatile__("" : : "g"(&r[k]) : "memory");
+    }
+  }, N);
+  report(name, "small", "inline", i);
+  c.ns -= i.ns;
+  c.cycles -= i.cycles;
+  report(name, "small", "ffi", c);
+}
+
+int main(int argc, char *argv[]) {
+  for (int i = 1; i < argc - 1; i++) {
+    if (strcmp(argv[i], "-t") == 0)
+      bench_time = atof(argv[++i]) / 1000.0;
+    else if (strcmp(argv[i], "-f") == 0)
+      bench_filter = argv[++i];
+  }
+
+  batch = new batch_data;
+  init_poly();
+
+  printf("mode,function,range,kind,ns_per_op,cycles_per_op\n");
+
+  /* double-double */
+  BINARY(dd_real, dd_real, dd_real, c_dd_add, r_arith);
+  BINARY(double, double, dd_real, c_dd_add_d_d, r_arith);
+  BINARY(double, dd_real, dd_real, c_dd_add_d_dd, r_arith);
+  BINARY(dd_real, double, dd_real, c_dd_add_dd_d, r_arith);
+  BINARY(dd_real, dd_real, dd_real, c_dd_sub, r_arith);
+  BINARY(double, double, dd_real, c_dd_sub_d_d, r_arith);
+  BINARY(double, dd_real, dd_real, c_dd_sub_d_dd, r_arith);
+  BINARY(dd_real, double, dd_real, c_dd_sub_dd_d, r_arith);
+  BINARY(dd_real, dd_real, dd_real, c_dd_mul, r_arith);
+  BINARY(double, double, dd_real, c_dd_mul_d_d, r_arith);
+  BINARY(double, dd_real, dd_real, c_dd_mul_d_dd, r_arith);
+  BINARY(dd_real, double, dd_real, c_dd_mul_dd_d, r_arith);
+  BINARY(dd_real, double, dd_real, c_dd_mul_pot, r_pot);
+  BINARY(dd_real, dd_real, dd_real, c_dd_div, r_arith);
+  BINARY(double, double, dd_real, c_dd_div_d_d, r_arith);
+  BINARY(double, dd_real, dd_real, c_dd_div_d_dd, r_arith);
+  BINARY(dd_real, double, dd_real, c_dd_div_dd_d, r_arith);
+  BINARY(dd_real, dd_real, dd_real, c_dd_add_sloppy, r_arith);
+  BINARY(dd_real, dd_real, dd_real, c_dd_add_accurate, r_arith);
+  BINARY(dd_real, dd_real, dd_real, c_dd_sub_sloppy, r_arith);
+  BINARY(dd_real, dd_real, dd_real, c_dd_sub_accurate, r_arith);
+  BINARY(dd_real, dd_real, dd_real, c_dd_div_sloppy, r_arith);
+  BINARY(dd_real, dd_real, dd_real, c_dd_div_accurate, r_arith);
+  BINARY(dd_real, dd_real, dd_real, c_dd_rem, r_mod);
+  BINARY(dd_real, dd_real, dd_real_pair, c_dd_divrem, r_mod);
+  BINARY(dd_real, dd_real, dd_real, c_dd_fmod, r_mod);
+  UNARY(dd_real, dd_real, c_dd_sqrt, r_pos);
+  UNARY(double, dd_real, c_dd_sqrt_d, r_pos);
+  UNARY(dd_real, dd_real, c_dd_sqr, r_arith);
+  UNARY(double, dd_real, c_dd_sqr_d, r_arith);
+  UNARY(dd_real, dd_real, c_dd_abs, r_arith);
+  BINARY_INT(dd_real, dd_real, c_dd_npwr, r_npwr);
+  BINARY(dd_real, dd_real, dd_real, c_dd_pow, r_pow);
+  BINARY_INT(dd_real, dd_real, c_dd_nroot, r_nroot);
+  BINARY_INT(dd_real, dd_real, c_dd_ldexp, r_ldexp);
+  UNARY(dd_real, dd_real, c_dd_nint, r_arith);
+  UNARY(dd_real, dd_real, c_dd_aint, r_arith);
+  UNARY(dd_real, dd_real, c_dd_floor, r_arith);
+  UNARY(dd_real, dd_real, c_dd_ceil, r_arith);
+  UNARY(dd_real, dd_real, c_dd_exp, r_exp);
+  UNARY(dd_real, dd_real, c_dd_log, r_pos);
+  UNARY(dd_real, dd_real, c_dd_log10, r_pos);
+  UNARY(dd_real, dd_real, c_dd_sin, r_trig);
+  UNARY(dd_real, dd_real, c_dd_cos, r_trig);
+  UNARY(dd_real, dd_real, c_dd_tan, r_trig);
+  UNARY(dd_real, dd_real, c_dd_asin, r_unit);
+  UNARY(dd_real, dd_real, c_dd_acos, r_unit);
+  UNARY(dd_real, dd_real, c_dd_atan, r_arith);
+  BINARY(dd_real, dd_real, dd_real, c_dd_atan2, r_arith);
+  UNARY(dd_real, dd_real, c_dd_sinh, r_exp);
+  UNARY(dd_real, dd_real, c_dd_cosh, r_exp);
+  UNARY(dd_real, dd_real, c_dd_tanh, r_exp);
+  UNARY(dd_real, dd_real, c_dd_asinh, r_arith);
+  UNARY(dd_real, dd_real, c_dd_acosh, r_acosh);
+  UNARY(dd_real, dd_real, c_dd_atanh, r_unit);
+  SINCOS(dd_real, dd_real_pair, c_dd_sincos, r_trig);
+  SINCOS(dd_real, dd_real_pair, c_dd_sincosh, r_exp);
+  UNARY(dd_real, dd_real, c_dd_neg, r_arith);
+  UNARY(dd_real, dd_real, c_dd_inv, r_arith);
+  COMPARE(dd_real, dd_real, c_dd_comp);
+  COMPARE(dd_real, double, c_dd_comp_dd_d);
+  COMPARE(double, dd_real, c_dd_comp_d_dd);
+  TO_STRING(dd_real, c_dd_to_string, qd_shortest, 0);
+  TO_STRING(dd_real, c_dd_to_string, qd_scientific, 31);
+  bench_parse<dd_real>("c_dd_parse", c_dd_to_string, c_dd_parse);
+  POLYEVAL(dd_real, c_dd_polyeval, poly_dd);
+
+  dd_real_array *da = batch->dd;
+  BATCH(c_dd_add_n, d_sunit, d_sunit, &da[0], &da[1], &da[3]);
+  BATCH(c_dd_sub_n, d_sunit, d_sunit, &da[0], &da[1], &da[3]);
+  BATCH(c_dd_mul_n, d_sunit, d_sunit, &da[0], &da[1], &da[3]);
+  BATCH(c_dd_div_n, d_sunit, d_sunit, &da[0], &da[1], &da[3]);
+  BATCH(c_dd_sqr_n, d_sunit, d_sunit, &da[0], &da[3]);
+  BATCH(c_dd_fma_n, d_sunit, d_sunit, &da[0], &da[1], &da[2]);
+  BATCH(c_dd_axpy, d_sunit, d_sunit, &poly_dd[2], &da[0], &da[3]);
+  BATCH(c_dd_exp_n, d_exp, d_unit, &da[0], &da[3]);
+  BATCH(c_dd_log_n, d_pwide, d_unit, &da[0], &da[3]);
+  BATCH(c_dd_sincos_n, d_trig, d_unit, &da[0], &da[3], &da[4]);
+  BATCH(c_dd_atan2_n, d_sunit, d_sunit, &da[0], &da[1], &da[3]);
+  BATCH(c_dd_polyeval_n, d_small, d_unit, poly_dd, poly_n, &da[0], &da[3]);
+  {
+    /* The coefficients of the polynomials cycle through 3 arrays */
+    dd_real_array c[poly_n + 1];
+    for (int k = 0; k <= poly_n; k++)
+      c[k] = da[k % 3];
+    BATCH(c_dd_polyeval_set_n, d_sunit, d_unit, c, poly_n, &poly_dd[2], &da[3]);
+  }
+  {
+    dd_real s;
+    BATCH(c_dd_sum_d, d_wide, d_unit, batch->in[0][0], M, &s);
+    BATCH(c_dd_dot_d, d_wide, d_unit, batch->in[0][0], batch->in[1][0], M, &s);
+    BATCH(c_dd_dot_dd, d_sunit, d_sunit, &da[0], &da[1], &s);
+  }
+  {
+    double (*in)[4][M] = batch->in, (*out)[4][M] = batch->out;
+    dd_gemv g = {
+      { { in[0][0], in[0][1] }, gemv_n, gemv_n, gemv_n, 1 },
+      { { in[1][0], in[1][1] }, gemv_n, 1, 1, 1 },
+      { { out[0][0], out[0][1] }, gemv_n, 1, 1, 1 },
+      { 1.0, 0.0 }, { 0.0, 0.0 }, 0 };
+    bench_batch("c_dd_gemv", d_sunit, d_sunit, [&]() {
+      g.next_tile = 0;
+      c_dd_gemv(&g);
+    });
+  }
+  BATCH(c_dd_to_soa, d_sunit, d_unit, batch->dd_aos, &da[3]);
+  BATCH(c_dd_to_aos, d_sunit, d_unit, &da[0], batch->dd_aos);
+  bench_text("c_dd_format_text", "c_dd_parse_text", c_dd_measure_text,
+    c_dd_format_text, c_dd_parse_text);
+
+  /* quad-double */
+  BINARY(qd_real, qd_real, qd_real, c_qd_add, r_arith);
+  BINARY(dd_real, qd_real, qd_real, c_qd_add_dd_qd, r_arith);
+  BINARY(qd_real, dd_real, qd_real, c_qd_add_qd_dd, r_arith);
+  BINARY(double, qd_real, qd_real, c_qd_add_d_qd, r_arith);
+  BINARY(qd_real, double, qd_real, c_qd_add_qd_d, r_arith);
+  SELF(qd_real, c_qd_selfadd, r_arith);
+  SELF(dd_real, c_qd_selfadd_dd, r_arith);
+  SELF(double, c_qd_selfadd_d, r_arith);
+  BINARY(qd_real, qd_real, qd_real, c_qd_sub, r_arith);
+  BINARY(dd_real, qd_real, qd_real, c_qd_sub_dd_qd, r_arith);
+  BINARY(qd_real, dd_real, qd_real, c_qd_sub_qd_dd, r_arith);
+  BINARY(double, qd_real, qd_real, c_qd_sub_d_qd, r_arith);
+  BINARY(qd_real, double, qd_real, c_qd_sub_qd_d, r_arith);
+  SELF(qd_real, c_qd_selfsub, r_arith);
+  SELF(dd_real, c_qd_selfsub_dd, r_arith);
+  SELF(double, c_qd_selfsub_d, r_arith);
+  BINARY(qd_real, qd_real, qd_real, c_qd_mul, r_arith);
+  BINARY(dd_real, qd_real, qd_real, c_qd_mul_dd_qd, r_arith);
+  BINARY(qd_real, dd_real, qd_real, c_qd_mul_qd_dd, r_arith);
+  BINARY(double, qd_real, qd_real, c_qd_mul_d_qd, r_arith);
+  BINARY(qd_real, double, qd_real, c_qd_mul_qd_d, r_arith);
+  SELF(qd_real, c_qd_selfmul, r_arith);
+  SELF(dd_real, c_qd_selfmul_dd, r_arith);
+  SELF(double, c_qd_selfmul_d, r_arith);
+  BINARY(qd_real, double, qd_real, c_qd_mul_pot, r_pot);
+  BINARY(qd_real, qd_real, qd_real, c_qd_div, r_arith);
+  BINARY(dd_real, qd_real, qd_real, c_qd_div_dd_qd, r_arith);
+  BINARY(qd_real, dd_real, qd_real, c_qd_div_qd_dd, r_arith);
+  BINARY(double, qd_real, qd_real, c_qd_div_d_qd, r_arith);
+  BINARY(qd_real, double, qd_real, c_qd_div_qd_d, r_arith);
+  SELF(qd_real, c_qd_selfdiv, r_arith);
+  SELF(dd_real, c_qd_selfdiv_dd, r_arith);
+  SELF(double, c_qd_selfdiv_d, r_arith);
+  BINARY(qd_real, qd_real, qd_real, c_qd_add_sloppy, r_arith);
+  BINARY(qd_real, qd_real, qd_real, c_qd_add_accurate, r_arith);
+  BINARY(qd_real, qd_real, qd_real, c_qd_sub_sloppy, r_arith);
+  BINARY(qd_real, qd_real, qd_real, c_qd_sub_accurate, r_arith);
+  BINARY(qd_real, qd_real, qd_real, c_qd_mul_sloppy, r_arith);
+  BINARY(qd_real, qd_real, qd_real, c_qd_mul_accurate, r_arith);
+  BINARY(qd_real, qd_real, qd_real, c_qd_div_sloppy, r_arith);
+  BINARY(qd_real, qd_real, qd_real, c_qd_div_accurate, r_arith);
+  BINARY(qd_real, qd_real, qd_real, c_qd_rem, r_mod);
+  BINARY(qd_real, qd_real, qd_real_pair, c_qd_divrem, r_mod);
+  BINARY(qd_real, qd_real, qd_real, c_qd_fmod, r_mod);
+  UNARY(qd_real, qd_real, c_qd_copy, r_arith);
+  UNARY(dd_real, qd_real, c_qd_copy_dd, r_arith);
+  UNARY(double, qd_real, c_qd_copy_d, r_arith);
+  UNARY(qd_real, qd_real, c_qd_sqrt, r_pos);
+  UNARY(qd_real, qd_real, c_qd_sqr, r_arith);
+  UNARY(qd_real, qd_real, c_qd_abs, r_arith);
+  BINARY_INT(qd_real, qd_real, c_qd_npwr, r_npwr);
+  BINARY(qd_real, qd_real, qd_real, c_qd_pow, r_pow);
+  BINARY_INT(qd_real, qd_real, c_qd_nroot, r_nroot);
+  BINARY_INT(qd_real, qd_real, c_qd_ldexp, r_ldexp);
+  UNARY(qd_real, qd_real, c_qd_nint, r_arith);
+  UNARY(qd_real, qd_real, c_qd_aint, r_arith);
+  UNARY(qd_real, qd_real, c_qd_floor, r_arith);
+  UNARY(qd_real, qd_real, c_qd_ceil, r_arith);
+  UNARY(qd_real, qd_real, c_qd_exp, r_exp);
+  UNARY(qd_real, qd_real, c_qd_log, r_pos);
+  UNARY(qd_real, qd_real, c_qd_log10, r_pos);
+  UNARY(qd_real, qd_real, c_qd_sin, r_trig);
+  UNARY(qd_real, qd_real, c_qd_cos, r_trig);
+  UNARY(qd_real, qd_real, c_qd_tan, r_trig);
+  UNARY(qd_real, qd_real, c_qd_asin, r_unit);
+  UNARY(qd_real, qd_real, c_qd_acos, r_unit);
+  UNARY(qd_real, qd_real, c_qd_atan, r_arith);
+  BINARY(qd_real, qd_real, qd_real, c_qd_atan2, r_arith);
+  UNARY(qd_real, qd_real, c_qd_sinh, r_exp);
+  UNARY(qd_real, qd_real, c_qd_cosh, r_exp);
+  UNARY(qd_real, qd_real, c_qd_tanh, r_exp);
+  UNARY(qd_real, qd_real, c_qd_asinh, r_arith);
+  UNARY(qd_real, qd_real, c_qd_acosh, r_acosh);
+  UNARY(qd_real, qd_real, c_qd_atanh, r_unit);
+  SINCOS(qd_real, qd_real_pair, c_qd_sincos, r_trig);
+  SINCOS(qd_real, qd_real_pair, c_qd_sincosh, r_exp);
+  UNARY(qd_real, qd_real, c_qd_neg, r_arith);
+  UNARY(qd_real, qd_real, c_qd_inv, r_arith);
+  COMPARE(qd_real, qd_real, c_qd_comp);
+  COMPARE(qd_real, double, c_qd_comp_qd_d);
+  COMPARE(double, qd_real, c_qd_comp_d_qd);
+  TO_STRING(qd_real, c_qd_to_string, qd_shortest, 0);
+  TO_STRING(qd_real, c_qd_to_string, qd_scientific, 62);
+  bench_parse<qd_real>("c_qd_parse", c_qd_to_string, c_qd_parse);
+  POLYEVAL(qd_real, c_qd_polyeval, poly_qd);
+
+  qd_real_array *qa = batch->qd;
+  BATCH(c_qd_add_n, d_sunit, d_sunit, &qa[0], &qa[1], &qa[3]);
+  BATCH(c_qd_sub_n, d_sunit, d_sunit, &qa[0], &qa[1], &qa[3]);
+  BATCH(c_qd_mul_n, d_sunit, d_sunit, &qa[0], &qa[1], &qa[3]);
+  BATCH(c_qd_sqr_n, d_sunit, d_sunit, &qa[0], &qa[3]);
+  BATCH(c_qd_fma_n, d_sunit, d_sunit, &qa[0], &qa[1], &qa[2]);
+  BATCH(c_qd_axpy, d_sunit, d_sunit, &poly_qd[2], &qa[0], &qa[3]);
+  BATCH(c_qd_exp_n, d_exp, d_unit, &qa[0], &qa[3]);
+  BATCH(c_qd_log_n, d_pwide, d_unit, &qa[0], &qa[3]);
+  BATCH(c_qd_sincos_n, d_trig, d_unit, &qa[0], &qa[3], &qa[4]);
+  BATCH(c_qd_atan2_n, d_sunit, d_sunit, &qa[0], &qa[1], &qa[3]);
+  BATCH(c_qd_polyeval_n, d_small, d_unit, poly_qd, poly_n, &qa[0], &qa[3]);
+  {
+    qd_real_array c[poly_n + 1];
+    for (int k = 0; k <= poly_n; k++)
+      c[k] = qa[k % 3];
+    BATCH(c_qd_polyeval_set_n, d_sunit, d_unit, c, poly_n, &poly_qd[2], &qa[3]);
+  }
+  {
+    qd_real s;
+    qd_repro r;
+    c_qd_repro_init(&r);
+    BATCH(c_qd_sum_d, d_wide, d_unit, batch->in[0][0], M, &s);
+    BATCH(c_qd_dot_qd, d_sunit, d_sunit, &qa[0], &qa[1], &s);
+    BATCH(c_qd_repro_sum_d, d_wide, d_unit, &r, batch->in[0][0], M);
+    BATCH(c_qd_repro_dot_d, d_wide, d_unit, &r, batch->in[0][0], batch->in[1][0], M);
+    BATCH(c_qd_repro_sqr_d, d_wide, d_unit, &r, batch->in[0][0], M);
+  }
+  {
+    double (*in)[4][M] = batch->in, (*out)[4][M] = batch->out;
+    qd_gemv g = {
+      { { in[0][0], in[0][1], in[0][2], in[0][3] }, gemv_n, gemv_n, gemv_n, 1 },
+      { { in[1][0], in[1][1], in[1][2], in[1][3] }, gemv_n, 1, 1, 1 },
+      { { out[0][0], out[0][1], out[0][2], out[0][3] }, gemv_n, 1, 1, 1 },
+      { 1.0, 0.0, 0.0, 0.0 }, { 0.0, 0.0, 0.0, 0.0 }, 0 };
+    bench_batch("c_qd_gemv", d_sunit, d_sunit, [&]() {
+      g.next_tile = 0;
+      c_qd_gemv(&g);
+    });
+  }
+  BATCH(c_qd_to_soa, d_sunit, d_unit, batch->qd_aos, &qa[3]);
+  BATCH(c_qd_to_aos, d_sunit, d_unit, &qa[0], batch->qd_aos);
+  bench_text("c_qd_format_text", "c_qd_parse_text", c_qd_measure_text,
+    c_qd_format_text, c_qd_parse_text);
+
+  /* call overhead of the C wrappers */
+  bench_ffi<dd_real>("c_dd_add",
+    [](const dd_real *a, const dd_real *b, dd_real *c) { c_dd_add(a, b, c); },
+    [](const dd_real &a, const dd_real &b) { return a + b; });
+  bench_ffi<dd_real>("c_dd_neg",
+    [](const dd_real *a, const dd_real *, dd_real *c) { c_dd_neg(a, c); },
+    [](const dd_real &a, const dd_real &) { return -a; });
+  bench_ffi<qd_real>("c_qd_add",
+    [](const qd_real *a, const qd_real *b, qd_real *c) { c_qd_add(a, b, c); },
+    [](const qd_real &a, const qd_real &b) { return a + b; });
+  bench_ffi<qd_real>("c_qd_neg",
+    [](const qd_real *a, const qd_real *, qd_real *c) { c_qd_neg(a, c); },
+    [](const qd_real &a, const qd_real &) { return -a; });
+
+  delete batch;
+  return 0;
+}
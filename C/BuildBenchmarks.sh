@@ -0,0 +1,23 @@
+# Builds the benchmarks in the Benchmarks directory, for both the sloppy and
+# the HP_ACCURATE version of the library:
+# * qd_bench, qd_bench-accurate: speed of every function (see qd_bench.cpp).
+# * qd_accuracy, qd_accuracy-accurate: accuracy and speed of the arithmetic
+#   variants and transcendental functions (see qd_accuracy.cpp). This
+#   requires MPFR (for example, the libmpfr-dev package).
+#
+# The benchmarks link with the same object files as the Linux libraries (see
+# BuildLinux.sh), so they measure the actual cost of calling the library.
+
+CFLAGS="-m64 -msse2 -ffp-contract=off -O3 -I . -Wno-attributes"
+
+rm -f *.o
+gcc $CFLAGS -c c_dd.cpp c_qd.cpp qd_libm.cpp
+g++ $CFLAGS -o Benchmarks/qd_bench Benchmarks/qd_bench.cpp c_dd.o c_qd.o qd_libm.o -lm
+g++ $CFLAGS -o Benchmarks/qd_accuracy Benchmarks/qd_accuracy.cpp c_dd.o c_qd.o qd_libm.o -lmpfr -lgmp -lm
+
+rm -f *.o
+gcc $CFLAGS -DHP_ACCURATE -c c_dd.cpp c_qd.cpp qd_libm.cpp
+g++ $CFLAGS -DHP_ACCURATE -o Benchmarks/qd_bench-accurate Benchmarks/qd_bench.cpp c_dd.o c_qd.o qd_libm.o -lm
+g++ $CFLAGS -DHP_ACCURATE -o Benchmarks/qd_accuracy-accurate Benchmarks/qd_accuracy.cpp c_dd.o c_qd.o qd_libm.o -lmpfr -lgmp -lm
+
+rm -f *.o
@@ -0,0 +1,30 @@
+# Builds the Linux x86-64 libraries. Each library contains SSE2, AVX2+FMA and
+# AVX-512 versions of the kernels. The fastest versions for the CPU are
+# selected at runtime, so there is no need to build with -mavx2
+# or -march=native.
+#
+# Output (in the parent directory):
+# * libmp_linux64.a, libmp-accurate_linux64.a: static libraries for Delphi.
+#   The helper functions qd_log, qd_exp etc. are provided by
+#   Neslib.MultiPrecision.pas.
+# * libqd_linux64.a, libqd-accurate_linux64.a, libqd_linux64.so,
+#   libqd-accurate_linux64.so: static and shared libraries for C/C++. These
+#   include the helper functions in qd_libm.cpp.
+
+CFLAGS="-m64 -fPIC -fvisibility=hidden -msse2 -ffp-contract=off -O3 -I . -Wno-attributes"
+
+rm -f *.o
+gcc $CFLAGS -c c_dd.cpp c_qd.cpp
+ar rcs ../libmp_linux64.a c_dd.o c_qd.o
+gcc $CFLAGS -c qd_libm.cpp
+ar rcs ../libqd_linux64.a c_dd.o c_qd.o qd_libm.o
+gcc -shared -Wl,-z,defs -o ../libqd_linux64.so c_dd.o c_qd.o qd_libm.o -lm
+
+rm -f *.o
+gcc $CFLAGS -DHP_ACCURATE -c c_dd.cpp c_qd.cpp
+ar rcs ../libmp-accurate_linux64.a c_dd.o c_qd.o
+gcc $CFLAGS -DHP_ACCURATE -c qd_libm.cpp
+ar rcs ../libqd-accurate_linux64.a c_dd.o c_qd.o qd_libm.o
+gcc -shared -Wl,-z,defs -o ../libqd-accurate_linux64.so c_dd.o c_qd.o qd_libm.o -lm
+
+rm -f *.o
@@ -13,12 +13,12 @@ if [ ! -d $SDK_ROOT ]; then
 fi
 
 rm *.o
-clang -c -fPIC -O3 -Wno-absolute-value -isysroot $SDK_ROOT -I . -Xassembler -L c_dd.cpp c_qd.cpp
+clang -c -fPIC -ffp-contract=off -O3 -Wno-absolute-value -isysroot $SDK_ROOT -I . -Xassembler -L c_dd.cpp c_qd.cpp
 ar rcs ../mp_mac64.a *.o
 ranlib ../mp_mac64.a
 
 rm *.o
-clang -c -fPIC -DHP_ACCURATE -O3 -Wno-absolute-value -isysroot $SDK_ROOT -I . -Xassembler -L c_dd.cpp c_qd.cpp
+clang -c -fPIC -ffp-contract=off -DHP_ACCURATE -O3 -Wno-absolute-value -isysroot $SDK_ROOT -I . -Xassembler -L c_dd.cpp c_qd.cpp
 ar rcs ../mp-accurate_mac64.a *.o
 ranlib ../mp-accurate_mac64.a
 
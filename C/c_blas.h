@@ -0,0 +1,137 @@
+/*
+ * c_blas.h
+ *
+ * Matrix products in double-double and quad-double precision, like the
+ * gemm and gemv routines of the (extended precision) BLAS:
+ *   c_dd_gemm, c_qd_gemm: c = alpha * a * b + beta * c
+ *   c_dd_gemv, c_qd_gemv: y = alpha * a * x + beta * y
+ * The vector routines are batch functions: c_dd_axpy and c_dd_dot_dd in
+ * c_dd.h, and c_qd_axpy and c_qd_dot_qd in c_qd.h.
+ *
+ * A matrix is stored like a dd_real_array or qd_real_array, with a
+ * separate array of doubles for each component, and with any distance
+ * between rows and columns. So a row-major matrix has col_stride 1, a
+ * column-major matrix has row_stride 1, and a matrix is transposed by
+ * swapping its rows and cols, and its row_stride and col_stride. The
+ * vectors of gemv are matrices with a single column, so the distance
+ * between their elements is row_stride.
+ *
+ * c_dd_gemm splits c into square tiles. For each tile, blocks of columns of
+ * a and rows of b are copied ("packed") into a work buffer, in the order
+ * in which the SIMD kernels read them, and the kernels update a few rows
+ * and one vector of columns of the tile at a time, keeping them in
+ * registers. The products are accumulated like c_dd_dot_dd: the leading
+ * parts are added with two_sum, and the rounding errors and low-order
+ * products are added up separately, so the sums are only renormalized
+ * every 16 products. c_qd_gemm uses the same blocking, but accumulates in
+ * quad-double arithmetic.
+ *
+ * c_dd_gemv splits y into tiles of rows. If the rows of a and x are
+ * contiguous (col_stride 1 and row_stride 1), every element of y is a dot
+ * product like c_dd_dot_dd. Otherwise, the kernels walk the columns of a,
+ * accumulating 8 rows at a time.
+ *
+ * Like c_mp_render_tile, multiple threads can compute the same product at
+ * the same time: each call claims the next tile (using next_tile) until
+ * all tiles are done. Every element is accumulated in the same order,
+ * whatever tile it is in, so the results are the same for any number of
+ * threads, and on all CPUs.
+ *
+ * If beta is zero, c (or y) is not read, so it does not have to be
+ * initialized. The output must not overlap the inputs.
+ */
+#ifndef _QD_C_BLAS_H
+#define _QD_C_BLAS_H
+
+#include "qd_config.h"
+
+/* Number of doubles of the work buffer of c_dd_gemm and c_qd_gemm. Each
+   thread needs its own buffer. */
+#define QD_GEMM_WORK 40960
+
+/* Rows and columns of the tiles of c_dd_gemm and c_qd_gemm, and rows of
+   the tiles of c_dd_gemv and c_qd_gemv. There are (rows + tile - 1) / tile
+   * (cols + tile - 1) / tile tiles. */
+#define QD_DD_GEMM_TILE 64
+#define QD_QD_GEMM_TILE 32
+#define QD_GEMV_TILE 64
+
+/* Element (i, j) consists of x[0][i * row_stride + j * col_stride] and
+   x[1][i * row_stride + j * col_stride] */
+struct dd_matrix {
+  double *x[2];
+  int rows;
+  int cols;
+  int row_stride;
+  int col_stride;
+};
+
+/* Element (i, j) consists of x[0][i * row_stride + j * col_stride] ..
+   x[3][i * row_stride + j * col_stride] */
+struct qd_matrix {
+  double *x[4];
+  int rows;
+  int cols;
+  int row_stride;
+  int col_stride;
+};
+
+/* c = alpha * a * b + beta * c, with a: m x k, b: k x n, c: m x n. */
+struct dd_gemm {
+  dd_matrix a;
+  dd_matrix b;
+  dd_matrix c;
+  double alpha[2];
+  double beta[2];
+  int next_tile;         /* next tile to compute. Must be set to 0 before
+                            the first call to c_dd_gemm. */
+};
+
+struct qd_gemm {
+  qd_matrix a;
+  qd_matrix b;
+  qd_matrix c;
+  double alpha[4];
+  double beta[4];
+  int next_tile;
+};
+
+/* y = alpha * a * x + beta * y, with a: m x n, x: n x 1, y: m x 1. */
+struct dd_gemv {
+  dd_matrix a;
+  dd_matrix x;
+  dd_matrix y;
+  double alpha[2];
+  double beta[2];
+  int next_tile;         /* must be set to 0 before the first call */
+};
+
+struct qd_gemv {
+  qd_matrix a;
+  qd_matrix x;
+  qd_matrix y;
+  double alpha[4];
+  double beta[4];
+  int next_tile;
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Computes the tiles of the product that have not been claimed yet by
+   another call. work must point to QD_GEMM_WORK doubles, which are not
+   used by other threads. Does nothing if the sizes of the matrices don't
+   match. */
+QD_API void c_dd_gemm(dd_gemm *g, double *work);
+QD_API void c_qd_gemm(qd_gemm *g, double *work);
+
+/* Same as c_dd_gemm, for a matrix-vector product. */
+QD_API void c_dd_gemv(dd_gemv *g);
+QD_API void c_qd_gemv(qd_gemv *g);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _QD_C_BLAS_H */
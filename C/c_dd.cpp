@@ -13,41 +13,45 @@
 #include "qd_config.h"
 #include "dd_real.h"
 #include "c_dd.h"
-#include "dd_real.cpp"
+#include "c_blas.h"
+#include "c_solve.h"
+#include "qd_cpu.h"
 #include "dd_const.cpp"
+#include "dd_real.cpp"
+#include "dd_batch.cpp"
+#include "dd_blas.cpp"
+#include "dd_solve.cpp"
+#include "qd_text.h"
+
+/* The features of this CPU, detected on first use (see qd_cpu.h). */
+static int dd_cpu = 0;
+
+#ifdef QD_FMA_DISPATCH
+/* Whether to use the FMA versions of the multiplication kernels. */
+static inline bool dd_fma() {
+	return (qd::cached_cpu_features(&dd_cpu) & qd::cpu_fma) != 0;
+}
+#endif
+
+/* Batch kernels for this CPU. */
+static inline const dd_batch_kernels *dd_batch() {
+	return dd_batch_select(qd::cached_cpu_features(&dd_cpu));
+}
+
+/* Matrix product kernels for this CPU. */
+static inline const dd_blas_kernels *dd_blas() {
+	return dd_blas_select(qd::cached_cpu_features(&dd_cpu));
+}
+
+/* LU update kernel for this CPU. */
+static inline const qd_lu_kernels *dd_lu() {
+	return qd_lu_select(qd::cached_cpu_features(&dd_cpu));
+}
 
 extern "C" {
 
 void c_dd_init() {
-	qd::_d_nan = qd_nan();
-	qd::_d_inf = qd_inf();
-
-	dd_real::_2pi = dd_real(6.283185307179586232e+00,
-		2.449293598294706414e-16);
-	dd_real::_pi = dd_real(3.141592653589793116e+00,
-		1.224646799147353207e-16);
-	dd_real::_pi2 = dd_real(1.570796326794896558e+00,
-		6.123233995736766036e-17);
-	dd_real::_pi4 = dd_real(7.853981633974482790e-01,
-		3.061616997868383018e-17);
-	dd_real::_3pi4 = dd_real(2.356194490192344837e+00,
-		9.1848509936051484375e-17);
-	dd_real::_e = dd_real(2.718281828459045091e+00,
-		1.445646891729250158e-16);
-	dd_real::_log2 = dd_real(6.931471805599452862e-01,
-		2.319046813846299558e-17);
-	dd_real::_log10 = dd_real(2.302585092994045901e+00,
-		-2.170756223382249351e-16);
-	dd_real::_nan = dd_real(qd::_d_nan, qd::_d_nan);
-	dd_real::_inf = dd_real(qd::_d_inf, qd::_d_inf);
-
-	dd_real::_max =
-		dd_real(1.79769313486231570815e+308, 9.97920154767359795037e+291);
-	dd_real::_safe_max =
-		dd_real(1.7976931080746007281e+308, 9.97920154767359795037e+291);
-	
-	dd_real::_pi16 = dd_real(1.963495408493620697e-01,
-		7.654042494670957545e-18);
+	qd::cached_cpu_features(&dd_cpu);
 }
 
 /* add */
@@ -82,15 +86,39 @@ void c_dd_sub_d_dd(const double *a, const dd_real *b, dd_real *c) {
 
 /* mul */
 void c_dd_mul(const dd_real *a, const dd_real *b, dd_real *c) {
+#ifdef QD_FMA_DISPATCH
+	if (dd_fma()) {
+		*c = mul_fma(*a, *b);
+		return;
+	}
+#endif
 	*c = *a * *b;
 }
 void c_dd_mul_d_d(const double *a, const double *b, dd_real *c) {
+#ifdef QD_FMA_DISPATCH
+	if (dd_fma()) {
+		*c = dd_real::mul_fma(*a, *b);
+		return;
+	}
+#endif
 	*c = dd_real::mul(*a, *b);	
 }
 void c_dd_mul_dd_d(const dd_real *a, const double *b, dd_real *c) {
+#ifdef QD_FMA_DISPATCH
+	if (dd_fma()) {
+		*c = mul_fma(*a, *b);
+		return;
+	}
+#endif
 	*c = *a * *b;
 }
 void c_dd_mul_d_dd(const double *a, const dd_real *b, dd_real *c) {
+#ifdef QD_FMA_DISPATCH
+	if (dd_fma()) {
+		*c = mul_fma(*b, *a);
+		return;
+	}
+#endif
 	*c = *a * *b;
 }
 void c_dd_mul_pot(const dd_real *a, const double *b, dd_real *c) {
@@ -99,18 +127,74 @@ void c_dd_mul_pot(const dd_real *a, const double *b, dd_real *c) {
 
 /* div */
 void c_dd_div(const dd_real *a, const dd_real *b, dd_real *c) {
+#ifdef QD_FMA_DISPATCH
+	if (dd_fma()) {
+		*c = div_fma(*a, *b);
+		return;
+	}
+#endif
 	*c = *a / *b;
 }
 void c_dd_div_d_d(const double *a, const double *b, dd_real *c) {
+#ifdef QD_FMA_DISPATCH
+	if (dd_fma()) {
+		*c = dd_real::div_fma(*a, *b);
+		return;
+	}
+#endif
 	*c = dd_real::div(*a, *b);
 }
 void c_dd_div_dd_d(const dd_real *a, const double *b, dd_real *c) {
+#ifdef QD_FMA_DISPATCH
+	if (dd_fma()) {
+		*c = div_fma(*a, *b);
+		return;
+	}
+#endif
 	*c = *a / *b;
 }
 void c_dd_div_d_dd(const double *a, const dd_real *b, dd_real *c) {
+#ifdef QD_FMA_DISPATCH
+	if (dd_fma()) {
+		*c = div_fma(dd_real(*a), *b);
+		return;
+	}
+#endif
 	*c = *a / *b;
 }
 
+/* sloppy and accurate versions */
+void c_dd_add_sloppy(const dd_real *a, const dd_real *b, dd_real *c) {
+	*c = dd_real::sloppy_add(*a, *b);
+}
+void c_dd_add_accurate(const dd_real *a, const dd_real *b, dd_real *c) {
+	*c = dd_real::ieee_add(*a, *b);
+}
+void c_dd_sub_sloppy(const dd_real *a, const dd_real *b, dd_real *c) {
+	*c = dd_real::sloppy_add(*a, -*b);
+}
+void c_dd_sub_accurate(const dd_real *a, const dd_real *b, dd_real *c) {
+	*c = dd_real::ieee_add(*a, -*b);
+}
+void c_dd_div_sloppy(const dd_real *a, const dd_real *b, dd_real *c) {
+#ifdef QD_FMA_DISPATCH
+	if (dd_fma()) {
+		*c = dd_real::sloppy_div_fma(*a, *b);
+		return;
+	}
+#endif
+	*c = dd_real::sloppy_div(*a, *b);
+}
+void c_dd_div_accurate(const dd_real *a, const dd_real *b, dd_real *c) {
+#ifdef QD_FMA_DISPATCH
+	if (dd_fma()) {
+		*c = dd_real::accurate_div_fma(*a, *b);
+		return;
+	}
+#endif
+	*c = dd_real::accurate_div(*a, *b);
+}
+
 void c_dd_rem(const dd_real *a, const dd_real *b, dd_real *c) {
 	*c = drem(*a, *b);
 }
@@ -129,9 +213,21 @@ void c_dd_sqrt_d(const double *a, dd_real *b) {
 	*b = sqrt(*a);
 }
 void c_dd_sqr(const dd_real *a, dd_real *b) {
+#ifdef QD_FMA_DISPATCH
+	if (dd_fma()) {
+		*b = sqr_fma(*a);
+		return;
+	}
+#endif
 	*b = sqr(*a);
 }
 void c_dd_sqr_d(const double *a, dd_real *b) {
+#ifdef QD_FMA_DISPATCH
+	if (dd_fma()) {
+		*b = dd_real::sqr_fma(*a);
+		return;
+	}
+#endif
 	*b = sqr(*a);
 }
 
@@ -229,12 +325,25 @@ void c_dd_sincosh(const dd_real *a, dd_real *s, dd_real *c) {
 	sincosh(*a, *s, *c);
 }
 
+void c_dd_polyeval(const dd_real *c, int n, const dd_real *a, dd_real *b) {
+	*b = polyeval(c, n, *a);
+}
+void c_dd_polyroot(const dd_real *c, int n, dd_real *a, int max_iter) {
+	*a = polyroot(c, n, *a, max_iter);
+}
+
 void c_dd_neg(const dd_real *a, dd_real *b) {
 	b->x[0] = -a->x[0];
 	b->x[1] = -a->x[1];
 }
 
 void c_dd_inv(const dd_real *a, dd_real *b) {
+#ifdef QD_FMA_DISPATCH
+	if (dd_fma()) {
+		*b = div_fma(dd_real(1.0), *a);
+		return;
+	}
+#endif
 	*b = inv(*a);
 }
 
@@ -270,4 +379,108 @@ int c_dd_comp_d_dd(const double *a, const dd_real *b) {
   return 0;
 }
 
-}
\ No newline at end of file
+int c_dd_to_string(const dd_real *a, const qd_string *b) {
+  return a->to_string(b->buf, b->size, b->format, b->precision);
+}
+
+int c_dd_parse(const char *s, int len, dd_real *a) {
+  return dd_real::parse(s, len, *a);
+}
+
+void c_qd_count_text(qd_text *t) {
+  qd::text::count(t);
+}
+void c_dd_parse_text(qd_text *t) {
+  qd::text::parse<2>(t);
+}
+void c_dd_measure_text(qd_text *t) {
+  qd::text::measure<2>(t);
+}
+void c_dd_format_text(qd_text *t) {
+  qd::text::format<2>(t);
+}
+
+/* batch */
+void c_dd_add_n(const dd_real_array *a, const dd_real_array *b, dd_real_array *c) {
+	dd_batch()->add_n(a, b, c, 0);
+}
+void c_dd_sub_n(const dd_real_array *a, const dd_real_array *b, dd_real_array *c) {
+	dd_batch()->sub_n(a, b, c, 0);
+}
+void c_dd_mul_n(const dd_real_array *a, const dd_real_array *b, dd_real_array *c) {
+	dd_batch()->mul_n(a, b, c, 0);
+}
+void c_dd_div_n(const dd_real_array *a, const dd_real_array *b, dd_real_array *c) {
+	dd_batch()->div_n(a, b, c, 0);
+}
+void c_dd_fma_n(const dd_real_array *a, const dd_real_array *b, dd_real_array *c) {
+	dd_batch()->fma_n(a, b, c, 0);
+}
+void c_dd_axpy(const dd_real *alpha, const dd_real_array *x, dd_real_array *y) {
+	dd_batch()->axpy_n(*alpha, x, y, 0);
+}
+void c_dd_sqr_n(const dd_real_array *a, dd_real_array *b) {
+	dd_batch()->sqr_n(a, b, 0);
+}
+void c_dd_exp_n(const dd_real_array *a, dd_real_array *b) {
+	dd_batch()->exp_n(a, b, 0);
+}
+void c_dd_log_n(const dd_real_array *a, dd_real_array *b) {
+	dd_batch()->log_n(a, b, 0);
+}
+void c_dd_sincos_n(const dd_real_array *a, dd_real_array *s, dd_real_array *c) {
+	dd_batch()->sincos_n(a, s, c, 0);
+}
+void c_dd_atan2_n(const dd_real_array *a, const dd_real_array *b, dd_real_array *c) {
+	dd_batch()->atan2_n(a, b, c, 0);
+}
+void c_dd_polyeval_n(const dd_real *c, int n, const dd_real_array *a, dd_real_array *b) {
+	dd_batch()->polyeval_n(c, n, a, b, 0);
+}
+void c_dd_polyeval_set_n(const dd_real_array *c, int n, const dd_real *a, dd_real_array *b) {
+	dd_batch()->polyeval_set_n(c, n, *a, b, 0);
+}
+void c_dd_sum_d(const double *a, int n, dd_real *s) {
+	dd_acc acc = { };
+	dd_batch()->sum_d(a, n, &acc, 0);
+	*s = qd::generic::dd_acc_sum(&acc);
+}
+void c_dd_dot_d(const double *a, const double *b, int n, dd_real *s) {
+	dd_acc acc = { };
+	dd_batch()->dot_d(a, b, n, &acc, 0);
+	*s = qd::generic::dd_acc_sum(&acc);
+}
+void c_dd_dot_dd(const dd_real_array *a, const dd_real_array *b, dd_real *s) {
+	dd_acc acc = { };
+	dd_batch()->dot_dd(a, b, &acc, 0);
+	*s = qd::generic::dd_acc_sum(&acc);
+}
+void c_dd_to_soa(const dd_real *a, dd_real_array *b) {
+	dd_batch()->to_soa_n(a, b, 0);
+}
+void c_dd_to_aos(const dd_real_array *a, dd_real *b) {
+	dd_batch()->to_aos_n(a, b, 0);
+}
+
+/* Matrix products */
+void c_dd_gemm(dd_gemm *g, double *work) {
+	dd_gemm_tiles(dd_blas(), g, work);
+}
+void c_dd_gemv(dd_gemv *g) {
+	dd_gemv_tiles(dd_blas(), g);
+}
+
+/* Linear solver */
+int c_dd_gesv_step(dd_gesv *g) {
+	return dd_gesv_step(g);
+}
+void c_dd_gesv_pass(dd_gesv *g, double *work) {
+	dd_gesv_pass(dd_lu(), dd_blas(), g, work);
+}
+void c_dd_gesv(dd_gesv *g, double *work) {
+	g->stage = 0;
+	while (dd_gesv_step(g))
+		dd_gesv_pass(dd_lu(), dd_blas(), g, work);
+}
+
+}
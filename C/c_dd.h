@@ -21,10 +21,59 @@ struct dd_real_pair {
 	dd_real v2;
 };
 
+/* Structure-of-arrays view of count double-double numbers, as used by the
+   batch functions below. Element i consists of x[0][i] and x[1][i]. */
+struct dd_real_array {
+	double *x[2];
+	int count;
+};
+
+/* Output buffer and format for c_dd_to_string and c_qd_to_string */
+struct qd_string {
+	char *buf;
+	int size;        /* size of buf, including the null terminator */
+	int format;      /* qd_format value (see dd_real.h) */
+	int precision;   /* digits after the decimal point (not for qd_shortest) */
+};
+
+/* Number of parts into which the text functions split their work */
+#define QD_TEXT_CHUNKS 256
+
+/* A table of values in text form (such as a CSV file), for the text
+   functions below and in c_qd.h. Each row is a line of text, with the
+   columns separated by separator. Empty lines are skipped. Component k of
+   the value in column c and row r is stored in x[c * n + k][r], with
+   n = 2 for dd_real and n = 4 for qd_real.
+
+   Reading and writing both take two passes, since the position of a row in
+   the output is only known once everything before it has been counted.
+   Multiple threads can work on the same pass at the same time by calling
+   the same function with the same table. Each call repeatedly claims the
+   next part of the work (using next_chunk) until all parts are done, like
+   c_mp_render_tile. next_chunk and done_chunks must be set to 0 before
+   each pass. */
+struct qd_text {
+	long long size;    /* length of text in chars */
+	char *text;
+	double **x;        /* component arrays (see above) */
+	int columns;
+	int rows;
+	int separator;     /* char between columns, such as ',' or '\t' */
+	int format;        /* qd_format value, for writing */
+	int precision;     /* digits after the decimal point (not for qd_shortest) */
+	int errors;        /* number of fields that were not a number */
+	int next_chunk;    /* next part of the work to claim */
+	int done_chunks;   /* number of parts that are done */
+	long long chunk[QD_TEXT_CHUNKS + 1];  /* used internally */
+};
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/* Detects the CPU features in advance (see qd_cpu.h). Nothing else needs
+   to be initialized, so this is optional. The Delphi unit calls it so that
+   it also works with object files built before that was the case. */
 QD_API void c_dd_init();
 
 /* add */
@@ -52,6 +101,18 @@ QD_API void c_dd_div_d_d(const double *a, const double *b, dd_real *c);
 QD_API void c_dd_div_d_dd(const double *a, const dd_real *b, dd_real *c);
 QD_API void c_dd_div_dd_d(const dd_real *a, const double *b, dd_real *c);
 
+/* Sloppy and accurate versions of add, sub and div. These always use the
+   given algorithm, regardless of whether the library is compiled with
+   HP_ACCURATE, so one application can use both. The accurate add and sub
+   satisfy IEEE-style error bounds; the sloppy ones do not, but are about
+   twice as fast. Multiplication has only one version for double-doubles. */
+QD_API void c_dd_add_sloppy(const dd_real *a, const dd_real *b, dd_real *c);
+QD_API void c_dd_add_accurate(const dd_real *a, const dd_real *b, dd_real *c);
+QD_API void c_dd_sub_sloppy(const dd_real *a, const dd_real *b, dd_real *c);
+QD_API void c_dd_sub_accurate(const dd_real *a, const dd_real *b, dd_real *c);
+QD_API void c_dd_div_sloppy(const dd_real *a, const dd_real *b, dd_real *c);
+QD_API void c_dd_div_accurate(const dd_real *a, const dd_real *b, dd_real *c);
+
 QD_API void c_dd_rem(const dd_real *a, const dd_real *b, dd_real *c);
 QD_API void c_dd_divrem(const dd_real *a, const dd_real *b, dd_real_pair *c);
 QD_API void c_dd_fmod(const dd_real *a, const dd_real *b, dd_real *c);
@@ -97,12 +158,110 @@ QD_API void c_dd_atanh(const dd_real *a, dd_real *b);
 QD_API void c_dd_sincos(const dd_real *a, dd_real *s, dd_real *c);
 QD_API void c_dd_sincosh(const dd_real *a, dd_real *s, dd_real *c);
 
+/* Evaluates the polynomial c[0] + c[1] x + ... + c[n] x^n at x = a. */
+QD_API void c_dd_polyeval(const dd_real *c, int n, const dd_real *a, dd_real *b);
+
+/* Finds a root of the polynomial c with Newton's method, starting at *a,
+   and stores it in *a. Stops when the value of the polynomial is less than
+   the machine epsilon times the largest coefficient. *a is NaN if this
+   does not happen within max_iter iterations. */
+QD_API void c_dd_polyroot(const dd_real *c, int n, dd_real *a, int max_iter);
+
 QD_API void c_dd_neg(const dd_real *a, dd_real *b);
 QD_API void c_dd_inv(const dd_real *a, dd_real *b);
 QD_API int c_dd_comp(const dd_real *a, const dd_real *b);
 QD_API int c_dd_comp_dd_d(const dd_real *a, const double *b);
 QD_API int c_dd_comp_d_dd(const double *a, const dd_real *b);
 
+/* Converts a to a decimal string, using the exact value of a:
+   - qd_shortest: the shortest string that converts back to a. Uses fixed
+     notation for exponents from -5 to 20, and scientific notation
+     otherwise.
+   - qd_scientific: d.ddde+XX, with b->precision digits after the point.
+   - qd_fixed: ddd.ddd, with b->precision digits after the point.
+   Digits are rounded to nearest (ties to even). Special values are "nan",
+   "inf" and "-inf". Returns the length of the string. Like snprintf, the
+   string is truncated if this is not less than b->size. Does not allocate
+   memory. */
+QD_API int c_dd_to_string(const dd_real *a, const qd_string *b);
+
+/* Parses a decimal number at the start of the len chars at s, or of the
+   null-terminated string s if len is negative. Accepts leading white
+   space, an optional sign, digits with an optional decimal point, and an
+   optional exponent (e or E). Also accepts "inf", "infinity" and "nan" in
+   any case. Each component is the nearest double (ties to even) to the
+   rest of the exact value, so strings from c_dd_to_string convert back to
+   the same value. Returns the number of chars used, or 0 if s does not
+   start with a number (then a is set to NaN). Does not allocate memory. */
+QD_API int c_dd_parse(const char *s, int len, dd_real *a);
+
+/* Reading a table from text, in two passes (see qd_text):
+   1. c_qd_count_text: counts the rows and sets t->rows. If t->columns is
+      0, it is set to the number of fields in the first row.
+   2. c_dd_parse_text: parses the rows into t->x, which must have room for
+      t->rows values per component. Fields are parsed like c_dd_parse.
+      Fields that are missing, empty or not a number (or have other text
+      after the number) are set to NaN and counted in t->errors.
+   t->text does not need to be null-terminated. */
+QD_API void c_qd_count_text(qd_text *t);
+QD_API void c_dd_parse_text(qd_text *t);
+
+/* Writing a table to text, in two passes (see qd_text):
+   1. c_dd_measure_text: sets t->size to the length of the text for the
+      t->rows rows in t->x.
+   2. c_dd_format_text: formats the rows like c_dd_to_string (with
+      t->format and t->precision) into t->text, which must have room for
+      t->size chars. Every row ends with '\n'. The text is not
+      null-terminated.
+   The values must not change between the two passes. */
+QD_API void c_dd_measure_text(qd_text *t);
+QD_API void c_dd_format_text(qd_text *t);
+
+/* batch functions. These process c->count (or b->count) elements. The
+   input arrays must contain at least that many elements and may be the
+   same as the output array. */
+QD_API void c_dd_add_n(const dd_real_array *a, const dd_real_array *b, dd_real_array *c);
+QD_API void c_dd_sub_n(const dd_real_array *a, const dd_real_array *b, dd_real_array *c);
+QD_API void c_dd_mul_n(const dd_real_array *a, const dd_real_array *b, dd_real_array *c);
+QD_API void c_dd_div_n(const dd_real_array *a, const dd_real_array *b, dd_real_array *c);
+QD_API void c_dd_sqr_n(const dd_real_array *a, dd_real_array *b);
+
+/* c = c + a * b */
+QD_API void c_dd_fma_n(const dd_real_array *a, const dd_real_array *b, dd_real_array *c);
+
+/* y = y + alpha * x (y->count elements). For matrix products, see c_blas.h. */
+QD_API void c_dd_axpy(const dd_real *alpha, const dd_real_array *x, dd_real_array *y);
+
+/* batch transcendental functions. sincos processes s->count elements.
+   atan2_n computes c = atan2(a, b), with the same results as c_dd_atan2. */
+QD_API void c_dd_exp_n(const dd_real_array *a, dd_real_array *b);
+QD_API void c_dd_log_n(const dd_real_array *a, dd_real_array *b);
+QD_API void c_dd_sincos_n(const dd_real_array *a, dd_real_array *s, dd_real_array *c);
+QD_API void c_dd_atan2_n(const dd_real_array *a, const dd_real_array *b, dd_real_array *c);
+
+/* batch polynomial evaluation, with the same results as c_dd_polyeval:
+   - polyeval_n: evaluates the polynomial c at the b->count points in a.
+   - polyeval_set_n: evaluates b->count polynomials at the point a.
+     Coefficient k (0 <= k <= n) of polynomial j is element j of c[k]. */
+QD_API void c_dd_polyeval_n(const dd_real *c, int n, const dd_real_array *a, dd_real_array *b);
+QD_API void c_dd_polyeval_set_n(const dd_real_array *c, int n, const dd_real *a, dd_real_array *b);
+
+/* compensated sums and dot products: s = a[0] + ... + a[n - 1], and
+   s = a[0] * b[0] + ... + a[n - 1] * b[n - 1] (dot_dd: a->count elements).
+   The rounding errors are accumulated separately and added at the end, so
+   the results are nearly as accurate as if they were computed in twice the
+   precision of the inputs, and are the same on all CPUs. To use several
+   threads, split the arrays into parts and add the sums of the parts in a
+   fixed order. */
+QD_API void c_dd_sum_d(const double *a, int n, dd_real *s);
+QD_API void c_dd_dot_d(const double *a, const double *b, int n, dd_real *s);
+QD_API void c_dd_dot_dd(const dd_real_array *a, const dd_real_array *b, dd_real *s);
+
+/* conversion between an array of dd_real (array-of-structures) and a
+   dd_real_array. to_aos processes a->count elements. */
+QD_API void c_dd_to_soa(const dd_real *a, dd_real_array *b);
+QD_API void c_dd_to_aos(const dd_real_array *a, dd_real *b);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,95 @@
+/*
+ * c_file.h
+ *
+ * A binary file format for arrays of double-double or quad-double values,
+ * used to save and restore the state of long computations.
+ *
+ * A file starts with a 64-byte qd_file_header, followed by the values:
+ * - qd_file_soa (structure of arrays): one plane of count doubles for each
+ *   component. Plane k starts at offset header_size + k * stride, where
+ *   stride is 8 * count rounded up to a multiple of 64, so every plane is
+ *   aligned to 64 bytes. This is the layout of dd_real_array and
+ *   qd_real_array, and of the vectors in dd_vector.h and qd_vector.h.
+ * - qd_file_aos (array of structures): count dd_real or qd_real values at
+ *   offset header_size.
+ * The padding between planes (and after the last plane) is zero.
+ *
+ * When the file is mapped into memory (with mmap or MapViewOfFile, which
+ * align the mapping to a page), the planes can be used directly with the
+ * batch functions, without copying. A file can also be written as a
+ * stream: the header, then each plane followed by its padding.
+ *
+ * The values are stored in the byte order of the writer. All CPUs this
+ * library supports are little-endian, so c_qd_file_check only accepts
+ * files in the byte order of the reader. The header also records whether
+ * the writer was compiled with HP_ACCURATE. This does not change how the
+ * values are stored, so files can be exchanged between both versions.
+ */
+#ifndef _QD_C_FILE_H
+#define _QD_C_FILE_H
+
+#include "qd_config.h"
+
+/* Version of the file format written by c_qd_file_init. Readers accept
+   files with this version or lower. */
+#define QD_FILE_VERSION 1
+
+/* Written in the byte order of the writer, to detect the byte order */
+#define QD_FILE_BYTE_ORDER 0x01020304
+
+/* Layout of the values in a file */
+enum qd_file_layout {
+  qd_file_soa = 0,
+  qd_file_aos = 1
+};
+
+/* Result of c_qd_file_check */
+enum qd_file_status {
+  qd_file_ok = 0,
+  qd_file_invalid = 1,      /* not a valid file, or truncated */
+  qd_file_version = 2,      /* written by a newer version of the format */
+  qd_file_byte_order = 3    /* written on a CPU with another byte order */
+};
+
+struct qd_file_header {
+  char magic[8];            /* "QDARRAY" followed by a null char */
+  int version;              /* QD_FILE_VERSION */
+  int byte_order;           /* QD_FILE_BYTE_ORDER */
+  int components;           /* 2 for dd_real, 4 for qd_real */
+  int layout;               /* qd_file_layout value */
+  int accurate;             /* 1 if the writer used HP_ACCURATE, 0 if not */
+  int header_size;          /* offset of the values: 64 */
+  long long count;          /* number of values */
+  long long stride;         /* bytes between planes (qd_file_soa only) */
+  char reserved[16];        /* zero */
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Initializes the header of a file with count values of the given number
+   of components (2 or 4) and layout. */
+QD_API void c_qd_file_init(qd_file_header *h, int components, int layout,
+    long long count);
+
+/* Checks whether the first *size bytes of a file (or all of them, if size
+   is NULL) start with a valid header, and whether they contain all the
+   values it describes. Returns a qd_file_status value. The size is passed
+   by pointer because 32-bit Delphi passes 64-bit integers on the stack,
+   where regparm(3) would use registers. */
+QD_API int c_qd_file_check(const qd_file_header *h, const long long *size);
+
+/* Returns the offset of plane k (qd_file_soa), or of the values
+   (qd_file_aos, for k = 0), from the start of the file. */
+QD_API long long c_qd_file_offset(const qd_file_header *h, int k);
+
+/* Returns the size of the file, including the padding after the last
+   plane. */
+QD_API long long c_qd_file_size(const qd_file_header *h);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _QD_C_FILE_H */
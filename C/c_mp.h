@@ -0,0 +1,85 @@
+/*
+ * c_mp.h
+ *
+ * Escape-time rendering of the Mandelbrot set in double, double-double or
+ * quad-double precision. A whole tile is rendered by a single call, using
+ * SIMD kernels that iterate several pixels at once, instead of making
+ * separate calls for every multiplication and addition.
+ *
+ * Multiple threads can render the same tile at the same time by calling
+ * c_mp_render_tile with the same mp_tile. Each call repeatedly claims the
+ * next unrendered row by atomically incrementing tile->next_row, until all
+ * rows are done. So threads that finish their rows early render more of
+ * them. The threads are up to the caller; the Delphi unit uses
+ * CPUCount - 1 tasks plus the calling thread.
+ *
+ * For deep zooms, mp_perturbation computes a single reference orbit at
+ * the center of the tile in quad-double precision (c_mp_reference_orbit),
+ * and iterates the difference of every pixel to that orbit in double
+ * precision. This is about as fast as rendering in double precision, at
+ * any magnification the quad-double center can express.
+ */
+#ifndef _QD_C_MP_H
+#define _QD_C_MP_H
+
+#include "qd_config.h"
+
+/* The precision used for the iterations */
+enum mp_precision {
+  mp_double = 0,
+  mp_dd = 1,
+  mp_qd = 2,
+  mp_perturbation = 3
+};
+
+/* A tile of width x height pixels. Pixel (col, row) corresponds to the
+   point c = x + y*i, with
+     x = center_re - step * width / 2 + col * step
+     y = center_im - step * height / 2 + row * step
+   The center is given as a quad-double (4 components), and is rounded to
+   the precision used for the iterations. */
+struct mp_tile {
+  double center_re[4];
+  double center_im[4];
+  double step;           /* distance between two pixels */
+  const double *orbit;   /* reference orbit for mp_perturbation */
+  int precision;         /* one of the mp_precision values */
+  int width;
+  int height;
+  int max_iter;
+  int next_row;          /* next row to render. Must be set to 0 before
+                            the first call to c_mp_render_tile. */
+  int orbit_len;         /* number of points in orbit */
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Renders the rows of the tile that have not been claimed yet by another
+   call. The iteration count of pixel (col, row) is stored in
+   out[row * width + col], or -1 if the pixel did not escape within
+   max_iter iterations. The iterations are z = z^2 + c, starting with
+   z = c, until |z|^2 > 4.
+
+   Returns early if *cancel becomes nonzero. The flag is checked after
+   every few pixels and every 1024 iterations. cancel may be NULL.
+
+   The iterations always use the sloppy additions, also if the library is
+   compiled with HP_ACCURATE. */
+QD_API void c_mp_render_tile(mp_tile *tile, int *out, const volatile int *cancel);
+
+/* Computes the reference orbit for mp_perturbation: the iterations
+   z = z^2 + c, starting with z = 0, for c = the center of the tile, in
+   quad-double precision. Point n is stored in orbit[2n] (real part) and
+   orbit[2n + 1] (imaginary part), until the orbit escapes or
+   max_iter + 2 points have been stored. orbit must have room for
+   2 * (max_iter + 2) doubles. Sets tile->orbit and tile->orbit_len.
+   This must be called once, before rendering the tile. */
+QD_API void c_mp_reference_orbit(mp_tile *tile, double *orbit);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _QD_C_MP_H */
@@ -15,65 +15,57 @@
 #include "qd_config.h"
 #include "qd_real.h"
 #include "c_qd.h"
-#include "qd_real.cpp" 
+#include "c_mp.h"
+#include "c_file.h"
+#include "c_repro.h"
+#include "c_blas.h"
+#include "c_solve.h"
+#include "qd_cpu.h"
 #include "qd_const.cpp" 
+#include "qd_real.cpp" 
+#include "qd_batch.cpp"
+#include "qd_blas.cpp"
+#include "qd_solve.cpp"
+#include "qd_text.h"
+#include "mp_render.cpp"
+#include "qd_file.cpp"
+#include "qd_repro.cpp"
 
-extern "C" {
+/* The features of this CPU, detected on first use (see qd_cpu.h). */
+static int qd_cpu = 0;
 
-void c_qd_init() {
-	qd::_d_nan = qd_nan();
-	qd::_d_inf = qd_inf();
-
-	qd_real::_2pi = qd_real(6.283185307179586232e+00,
-		2.449293598294706414e-16,
-		-5.989539619436679332e-33,
-		2.224908441726730563e-49);
-	qd_real::_pi = qd_real(3.141592653589793116e+00,
-		1.224646799147353207e-16,
-		-2.994769809718339666e-33,
-		1.112454220863365282e-49);
-	qd_real::_pi2 = qd_real(1.570796326794896558e+00,
-		6.123233995736766036e-17,
-		-1.497384904859169833e-33,
-		5.562271104316826408e-50);
-	qd_real::_pi4 = qd_real(7.853981633974482790e-01,
-		3.061616997868383018e-17,
-		-7.486924524295849165e-34,
-		2.781135552158413204e-50);
-	qd_real::_3pi4 = qd_real(2.356194490192344837e+00,
-		9.1848509936051484375e-17,
-		3.9168984647504003225e-33,
-		-2.5867981632704860386e-49);
-	qd_real::_e = qd_real(2.718281828459045091e+00,
-		1.445646891729250158e-16,
-		-2.127717108038176765e-33,
-		1.515630159841218954e-49);
-	qd_real::_log2 = qd_real(6.931471805599452862e-01,
-		2.319046813846299558e-17,
-		5.707708438416212066e-34,
-		-3.582432210601811423e-50);
-	qd_real::_log10 = qd_real(2.302585092994045901e+00,
-		-2.170756223382249351e-16,
-		-9.984262454465776570e-33,
-		-4.023357454450206379e-49);
-	qd_real::_nan = qd_real(qd::_d_nan, qd::_d_nan,
-		qd::_d_nan, qd::_d_nan);
-	qd_real::_inf = qd_real(qd::_d_inf, qd::_d_inf,
-		qd::_d_inf, qd::_d_inf);
-
-	qd_real::_max = qd_real(
-		1.79769313486231570815e+308, 9.97920154767359795037e+291,
-		5.53956966280111259858e+275, 3.07507889307840487279e+259);
-	qd_real::_safe_max = qd_real(
-		1.7976931080746007281e+308, 9.97920154767359795037e+291,
-		5.53956966280111259858e+275, 3.07507889307840487279e+259);
-
-	qd_real::_pi1024 = qd_real(
-		3.067961575771282340e-03, 1.195944139792337116e-19,
-		-2.924579892303066080e-36, 1.086381075061880158e-52);
+#ifdef QD_FMA_DISPATCH
+/* Whether to use the FMA versions of the multiplication kernels. */
+static inline bool qd_fma() {
+	return (qd::cached_cpu_features(&qd_cpu) & qd::cpu_fma) != 0;
+}
+#endif
+
+/* Batch kernels for this CPU. */
+static inline const qd_batch_kernels *qd_batch() {
+	return qd_batch_select(qd::cached_cpu_features(&qd_cpu));
+}
+
+/* Matrix product kernels for this CPU. */
+static inline const qd_blas_kernels *qd_blas() {
+	return qd_blas_select(qd::cached_cpu_features(&qd_cpu));
+}
+
+/* LU update kernel for this CPU. */
+static inline const qd_lu_kernels *qd_lu() {
+	return qd_lu_select(qd::cached_cpu_features(&qd_cpu));
+}
 
+/* Mandelbrot row kernels for this CPU. */
+static inline const mp_render_kernels *mp_render() {
+	return mp_render_select(qd::cached_cpu_features(&qd_cpu));
 }
 
+extern "C" {
+
+void c_qd_init() {
+	qd::cached_cpu_features(&qd_cpu);
+}
 
 /* add */
 void c_qd_add(const qd_real *a, const qd_real *b, qd_real *c) {
@@ -115,6 +107,12 @@ void c_qd_sub_d_qd(const double *a, const qd_real *b, qd_real *c) {
 
 /* mul */
 void c_qd_mul(const qd_real *a, const qd_real *b, qd_real *c) {
+#ifdef QD_FMA_DISPATCH
+	if (qd_fma()) {
+		*c = mul_fma(*a, *b);
+		return;
+	}
+#endif
 	*c = *a * *b;
 }
 void c_qd_mul_qd_dd(const qd_real *a, const dd_real *b, qd_real *c) {
@@ -193,6 +191,12 @@ void c_qd_selfsub_d(const double *a, qd_real *b) {
 
 /* selfmul */
 void c_qd_selfmul(const qd_real *a, qd_real *b) {
+#ifdef QD_FMA_DISPATCH
+	if (qd_fma()) {
+		*b = mul_fma(*b, *a);
+		return;
+	}
+#endif
 	*b *= *a;
 }
 void c_qd_selfmul_dd(const dd_real *a, qd_real *b) {
@@ -217,6 +221,46 @@ void c_qd_selfdiv_d(const double *a, qd_real *b) {
 
 
 
+/* sloppy and accurate versions */
+void c_qd_add_sloppy(const qd_real *a, const qd_real *b, qd_real *c) {
+	*c = qd_real::sloppy_add(*a, *b);
+}
+void c_qd_add_accurate(const qd_real *a, const qd_real *b, qd_real *c) {
+	*c = qd_real::ieee_add(*a, *b);
+}
+void c_qd_sub_sloppy(const qd_real *a, const qd_real *b, qd_real *c) {
+	*c = qd_real::sloppy_add(*a, -*b);
+}
+void c_qd_sub_accurate(const qd_real *a, const qd_real *b, qd_real *c) {
+	*c = qd_real::ieee_add(*a, -*b);
+}
+void c_qd_mul_sloppy(const qd_real *a, const qd_real *b, qd_real *c) {
+#ifdef QD_FMA_DISPATCH
+	if (qd_fma()) {
+		*c = qd_real::sloppy_mul_fma(*a, *b);
+		return;
+	}
+#endif
+	*c = qd_real::sloppy_mul(*a, *b);
+}
+void c_qd_mul_accurate(const qd_real *a, const qd_real *b, qd_real *c) {
+#ifdef QD_FMA_DISPATCH
+	if (qd_fma()) {
+		*c = qd_real::accurate_mul_fma(*a, *b);
+		return;
+	}
+#endif
+	*c = qd_real::accurate_mul(*a, *b);
+}
+void c_qd_div_sloppy(const qd_real *a, const qd_real *b, qd_real *c) {
+	*c = qd_real::sloppy_div(*a, *b);
+}
+void c_qd_div_accurate(const qd_real *a, const qd_real *b, qd_real *c) {
+	*c = qd_real::accurate_div(*a, *b);
+}
+
+
+
 /* copy */
 void c_qd_copy(const qd_real *a, qd_real *b) {
   b->x[0] = a->x[0];
@@ -242,6 +286,12 @@ void c_qd_sqrt(const qd_real *a, qd_real *b) {
   *b = sqrt(*a);
 }
 void c_qd_sqr(const qd_real *a, qd_real *b) {
+#ifdef QD_FMA_DISPATCH
+  if (qd_fma()) {
+    *b = sqr_fma(*a);
+    return;
+  }
+#endif
   *b = sqr(*a);
 }
 
@@ -340,6 +390,13 @@ void c_qd_sincosh(const qd_real *a, qd_real *s, qd_real *c) {
   sincosh(*a, *s, *c);
 }
 
+void c_qd_polyeval(const qd_real *c, int n, const qd_real *a, qd_real *b) {
+	*b = polyeval(c, n, *a);
+}
+void c_qd_polyroot(const qd_real *c, int n, qd_real *a, int max_iter) {
+	*a = polyroot(c, n, *a, max_iter);
+}
+
 void c_qd_neg(const qd_real *a, qd_real *b) {
 	b->x[0] = -a->x[0];
 	b->x[1] = -a->x[1];
@@ -383,4 +440,142 @@ int c_qd_comp_d_qd(const double *a, const qd_real *b) {
   return 0;
 }
 
-}
\ No newline at end of file
+int c_qd_to_string(const qd_real *a, const qd_string *b) {
+	return a->to_string(b->buf, b->size, b->format, b->precision);
+}
+
+int c_qd_parse(const char *s, int len, qd_real *a) {
+	return qd_real::parse(s, len, *a);
+}
+
+void c_qd_parse_text(qd_text *t) {
+	qd::text::parse<4>(t);
+}
+void c_qd_measure_text(qd_text *t) {
+	qd::text::measure<4>(t);
+}
+void c_qd_format_text(qd_text *t) {
+	qd::text::format<4>(t);
+}
+
+/* batch */
+void c_qd_add_n(const qd_real_array *a, const qd_real_array *b, qd_real_array *c) {
+	qd_batch()->add_n(a, b, c, 0);
+}
+void c_qd_sub_n(const qd_real_array *a, const qd_real_array *b, qd_real_array *c) {
+	qd_batch()->sub_n(a, b, c, 0);
+}
+void c_qd_mul_n(const qd_real_array *a, const qd_real_array *b, qd_real_array *c) {
+	qd_batch()->mul_n(a, b, c, 0);
+}
+void c_qd_fma_n(const qd_real_array *a, const qd_real_array *b, qd_real_array *c) {
+	qd_batch()->fma_n(a, b, c, 0);
+}
+void c_qd_axpy(const qd_real *alpha, const qd_real_array *x, qd_real_array *y) {
+	qd_batch()->axpy_n(*alpha, x, y, 0);
+}
+void c_qd_sqr_n(const qd_real_array *a, qd_real_array *b) {
+	qd_batch()->sqr_n(a, b, 0);
+}
+void c_qd_exp_n(const qd_real_array *a, qd_real_array *b) {
+	qd_batch()->exp_n(a, b, 0);
+}
+void c_qd_log_n(const qd_real_array *a, qd_real_array *b) {
+	qd_batch()->log_n(a, b, 0);
+}
+void c_qd_sincos_n(const qd_real_array *a, qd_real_array *s, qd_real_array *c) {
+	qd_batch()->sincos_n(a, s, c, 0);
+}
+void c_qd_atan2_n(const qd_real_array *a, const qd_real_array *b, qd_real_array *c) {
+	qd_batch()->atan2_n(a, b, c, 0);
+}
+void c_qd_polyeval_n(const qd_real *c, int n, const qd_real_array *a, qd_real_array *b) {
+	qd_batch()->polyeval_n(c, n, a, b, 0);
+}
+void c_qd_polyeval_set_n(const qd_real_array *c, int n, const qd_real *a, qd_real_array *b) {
+	qd_batch()->polyeval_set_n(c, n, *a, b, 0);
+}
+void c_qd_sum_d(const double *a, int n, qd_real *s) {
+	qd_acc acc = { };
+	qd_batch()->sum_d(a, n, &acc, 0);
+	*s = qd::generic::qd_acc_sum(&acc);
+}
+void c_qd_dot_qd(const qd_real_array *a, const qd_real_array *b, qd_real *s) {
+	qd_acc acc = { };
+	qd_batch()->dot_qd(a, b, &acc, 0);
+	*s = qd::generic::qd_acc_sum(&acc);
+}
+void c_qd_to_soa(const qd_real *a, qd_real_array *b) {
+	qd_batch()->to_soa_n(a, b, 0);
+}
+void c_qd_to_aos(const qd_real_array *a, qd_real *b) {
+	qd_batch()->to_aos_n(a, b, 0);
+}
+
+/* Matrix products */
+void c_qd_gemm(qd_gemm *g, double *work) {
+	qd_gemm_tiles(qd_blas(), g, work);
+}
+void c_qd_gemv(qd_gemv *g) {
+	qd_gemv_tiles(qd_blas(), g);
+}
+
+/* Linear solver */
+int c_qd_gesv_step(qd_gesv *g) {
+	return qd_gesv_step(g);
+}
+void c_qd_gesv_pass(qd_gesv *g, double *work) {
+	qd_gesv_pass(qd_lu(), qd_blas(), g, work);
+}
+void c_qd_gesv(qd_gesv *g, double *work) {
+	g->stage = 0;
+	while (qd_gesv_step(g))
+		qd_gesv_pass(qd_lu(), qd_blas(), g, work);
+}
+
+/* Mandelbrot rendering */
+void c_mp_render_tile(mp_tile *tile, int *out, const volatile int *cancel) {
+	mp_render_tile(mp_render(), tile, out, cancel);
+}
+void c_mp_reference_orbit(mp_tile *tile, double *orbit) {
+	mp_reference_orbit(tile, orbit);
+}
+
+/* Binary files */
+void c_qd_file_init(qd_file_header *h, int components, int layout, long long count) {
+	qd_file_init(h, components, layout, count);
+}
+int c_qd_file_check(const qd_file_header *h, const long long *size) {
+	return qd_file_check(h, size ? *size : -1);
+}
+long long c_qd_file_offset(const qd_file_header *h, int k) {
+	return qd_file_offset(h, k);
+}
+long long c_qd_file_size(const qd_file_header *h) {
+	return qd_file_size(h);
+}
+
+/* Reproducible sums */
+void c_qd_repro_init(qd_repro *r) {
+	repro_clear(r);
+}
+void c_qd_repro_sum_d(qd_repro *r, const double *a, int n) {
+	repro_sum(r, a, n);
+}
+void c_qd_repro_dot_d(qd_repro *r, const double *a, const double *b, int n) {
+	repro_dot(r, a, b, n);
+}
+void c_qd_repro_sqr_d(qd_repro *r, const double *a, int n) {
+	repro_sqr(r, a, n);
+}
+void c_qd_repro_merge(qd_repro *r, const qd_repro *b) {
+	repro_merge(r, b);
+}
+void c_dd_repro_result(const qd_repro *r, dd_real *s) {
+	repro_result<2>(r, s->x);
+}
+void c_qd_repro_result(const qd_repro *r, qd_real *s) {
+	repro_result<4>(r, s->x);
+}
+
+}
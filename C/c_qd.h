@@ -23,10 +23,20 @@ struct qd_real_pair {
 	qd_real v2;
 };
 
+/* Structure-of-arrays view of count quad-double numbers, as used by the
+   batch functions below. Element i consists of x[0][i] .. x[3][i]. */
+struct qd_real_array {
+	double *x[4];
+	int count;
+};
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/* Detects the CPU features in advance (see qd_cpu.h). Nothing else needs
+   to be initialized, so this is optional. The Delphi unit calls it so that
+   it also works with object files built before that was the case. */
 QD_API void c_qd_init();
 
 /* add */
@@ -70,6 +80,20 @@ QD_API void c_qd_selfdiv(const qd_real *a, qd_real *b);
 QD_API void c_qd_selfdiv_dd(const dd_real *a, qd_real *b);
 QD_API void c_qd_selfdiv_d(const double *a, qd_real *b);
 
+/* Sloppy and accurate versions of add, sub, mul and div. These always use
+   the given algorithm for the operation itself, regardless of whether the
+   library is compiled with HP_ACCURATE, so one application can use both.
+   The accurate add and sub satisfy IEEE-style error bounds; the sloppy ones
+   do not, but are considerably faster. */
+QD_API void c_qd_add_sloppy(const qd_real *a, const qd_real *b, qd_real *c);
+QD_API void c_qd_add_accurate(const qd_real *a, const qd_real *b, qd_real *c);
+QD_API void c_qd_sub_sloppy(const qd_real *a, const qd_real *b, qd_real *c);
+QD_API void c_qd_sub_accurate(const qd_real *a, const qd_real *b, qd_real *c);
+QD_API void c_qd_mul_sloppy(const qd_real *a, const qd_real *b, qd_real *c);
+QD_API void c_qd_mul_accurate(const qd_real *a, const qd_real *b, qd_real *c);
+QD_API void c_qd_div_sloppy(const qd_real *a, const qd_real *b, qd_real *c);
+QD_API void c_qd_div_accurate(const qd_real *a, const qd_real *b, qd_real *c);
+
 QD_API void c_qd_rem(const qd_real *a, const qd_real *b, qd_real *c);
 QD_API void c_qd_divrem(const qd_real *a, const qd_real *b, qd_real_pair *c);
 QD_API void c_qd_fmod(const qd_real *a, const qd_real *b, qd_real *c);
@@ -118,11 +142,77 @@ QD_API void c_qd_atanh(const qd_real *a, qd_real *b);
 QD_API void c_qd_sincos(const qd_real *a, qd_real *s, qd_real *c);
 QD_API void c_qd_sincosh(const qd_real *a, qd_real *s, qd_real *c);
 
+/* Evaluates the polynomial c[0] + c[1] x + ... + c[n] x^n at x = a. */
+QD_API void c_qd_polyeval(const qd_real *c, int n, const qd_real *a, qd_real *b);
+
+/* Finds a root of the polynomial c with Newton's method, starting at *a,
+   and stores it in *a. Stops when the value of the polynomial is less than
+   the machine epsilon times the largest coefficient. *a is NaN if this
+   does not happen within max_iter iterations. */
+QD_API void c_qd_polyroot(const qd_real *c, int n, qd_real *a, int max_iter);
+
 QD_API void c_qd_neg(const qd_real *a, qd_real *b);
 QD_API void c_qd_inv(const qd_real *a, qd_real *b);
 QD_API int c_qd_comp(const qd_real *a, const qd_real *b);
 QD_API int c_qd_comp_qd_d(const qd_real *a, const double *b);
 QD_API int c_qd_comp_d_qd(const double *a, const qd_real *b);
+
+/* Converts a to a decimal string (see c_dd_to_string) */
+QD_API int c_qd_to_string(const qd_real *a, const qd_string *b);
+
+/* Parses a decimal number (see c_dd_parse) */
+QD_API int c_qd_parse(const char *s, int len, qd_real *a);
+
+/* Reading and writing tables in text form. Same as c_dd_parse_text,
+   c_dd_measure_text and c_dd_format_text (see c_dd.h). */
+QD_API void c_qd_parse_text(qd_text *t);
+QD_API void c_qd_measure_text(qd_text *t);
+QD_API void c_qd_format_text(qd_text *t);
+
+/* batch functions. These process c->count (or b->count) elements. The
+   input arrays must contain at least that many elements and may be the
+   same as the output array. */
+QD_API void c_qd_add_n(const qd_real_array *a, const qd_real_array *b, qd_real_array *c);
+QD_API void c_qd_sub_n(const qd_real_array *a, const qd_real_array *b, qd_real_array *c);
+QD_API void c_qd_mul_n(const qd_real_array *a, const qd_real_array *b, qd_real_array *c);
+QD_API void c_qd_sqr_n(const qd_real_array *a, qd_real_array *b);
+
+/* c = c + a * b */
+QD_API void c_qd_fma_n(const qd_real_array *a, const qd_real_array *b, qd_real_array *c);
+
+/* y = y + alpha * x (y->count elements). For matrix products, see c_blas.h. */
+QD_API void c_qd_axpy(const qd_real *alpha, const qd_real_array *x, qd_real_array *y);
+
+/* batch transcendental functions. sincos processes s->count elements.
+   atan2_n computes c = atan2(a, b), with the same results as c_qd_atan2. */
+QD_API void c_qd_exp_n(const qd_real_array *a, qd_real_array *b);
+QD_API void c_qd_log_n(const qd_real_array *a, qd_real_array *b);
+QD_API void c_qd_sincos_n(const qd_real_array *a, qd_real_array *s, qd_real_array *c);
+QD_API void c_qd_atan2_n(const qd_real_array *a, const qd_real_array *b, qd_real_array *c);
+
+/* batch polynomial evaluation, with the same results as c_qd_polyeval:
+   - polyeval_n: evaluates the polynomial c at the b->count points in a.
+   - polyeval_set_n: evaluates b->count polynomials at the point a.
+     Coefficient k (0 <= k <= n) of polynomial j is element j of c[k]. */
+QD_API void c_qd_polyeval_n(const qd_real *c, int n, const qd_real_array *a, qd_real_array *b);
+QD_API void c_qd_polyeval_set_n(const qd_real_array *c, int n, const qd_real *a, qd_real_array *b);
+
+/* compensated sum s = a[0] + ... + a[n - 1]. Like c_dd_sum_d, but the
+   rounding errors are accumulated in 3 more levels, so the result is
+   nearly as accurate as if it was computed in quad-double precision. */
+QD_API void c_qd_sum_d(const double *a, int n, qd_real *s);
+
+/* dot product s = a[0] * b[0] + ... + a[n - 1] * b[n - 1] (a->count
+   elements), in quad-double arithmetic. Like the other sums, the products
+   are added in a fixed number of independent accumulators, so the result
+   is the same on all CPUs. */
+QD_API void c_qd_dot_qd(const qd_real_array *a, const qd_real_array *b, qd_real *s);
+
+/* conversion between an array of qd_real (array-of-structures) and a
+   qd_real_array. to_aos processes a->count elements. */
+QD_API void c_qd_to_soa(const qd_real *a, qd_real_array *b);
+QD_API void c_qd_to_aos(const qd_real_array *a, qd_real *b);
+
 #ifdef __cplusplus
 }
 #endif
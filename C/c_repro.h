@@ -0,0 +1,81 @@
+/*
+ * c_repro.h
+ *
+ * Reproducible sums, dot products and norms of arrays of doubles, with
+ * results that do not depend on the order of the elements, on how the
+ * arrays are split into parts, or on the number of threads that add them.
+ *
+ * A qd_repro accumulates the exact sum of the values added to it: every
+ * double is split into 32-bit digits on a fixed grid (multiples of
+ * 2^-1074, the smallest subnormal double) and added to integer limbs,
+ * without any rounding. Products and squares are first split into two
+ * doubles with the error-free transformations two_prod and two_sqr (see
+ * inline.h), which are exact unless the products underflow. Since integer
+ * addition is associative, accumulators for different parts of an array
+ * can be filled by different threads and merged in any order. The exact
+ * sum is only rounded once, by c_dd_repro_result or c_qd_repro_result:
+ * each component is the nearest double (ties to even) to the rest of the
+ * exact sum, like the components that c_dd_parse returns.
+ *
+ * A norm is the square root of the result of c_qd_repro_sqr_d, which is
+ * also reproducible.
+ *
+ * These functions do not allocate memory, so a qd_repro can be placed on
+ * the stack.
+ */
+#ifndef _QD_C_REPRO_H
+#define _QD_C_REPRO_H
+
+#include "qd_config.h"
+#include "dd_real.h"
+#include "qd_real.h"
+
+/* Number of limbs of a qd_repro: enough for the range of the doubles
+   (2098 bits), and for sums of up to 2^70 of the largest doubles. */
+#define QD_REPRO_LIMBS 68
+
+/* Flags for the special values that were added to a qd_repro */
+enum qd_repro_special {
+  qd_repro_pos_inf = 1,
+  qd_repro_neg_inf = 2,
+  qd_repro_nan = 4
+};
+
+struct qd_repro {
+  long long limb[QD_REPRO_LIMBS];  /* the sum in units of 2^-1074, in
+                                      32-bit digits (least significant
+                                      first) */
+  int special;                     /* qd_repro_special flags */
+  int reserved;                    /* zero */
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Sets the sum of r to zero. */
+QD_API void c_qd_repro_init(qd_repro *r);
+
+/* Adds a[0] + ... + a[n - 1] to r. */
+QD_API void c_qd_repro_sum_d(qd_repro *r, const double *a, int n);
+
+/* Adds a[0] * b[0] + ... + a[n - 1] * b[n - 1] to r. */
+QD_API void c_qd_repro_dot_d(qd_repro *r, const double *a, const double *b, int n);
+
+/* Adds a[0]^2 + ... + a[n - 1]^2 to r. */
+QD_API void c_qd_repro_sqr_d(qd_repro *r, const double *a, int n);
+
+/* Adds the sum of b to r. */
+QD_API void c_qd_repro_merge(qd_repro *r, const qd_repro *b);
+
+/* Rounds the sum of r to a double-double or quad-double. The result is NaN
+   if a NaN (or both infinities) was added, and infinite if an infinity was
+   added or the sum is too large. */
+QD_API void c_dd_repro_result(const qd_repro *r, dd_real *s);
+QD_API void c_qd_repro_result(const qd_repro *r, qd_real *s);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _QD_C_REPRO_H */
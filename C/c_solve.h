@@ -0,0 +1,136 @@
+/*
+ * c_solve.h
+ *
+ * Solving systems of linear equations a * x = b in double-double and
+ * quad-double precision, like the gesv routine of LAPACK, using
+ * mixed-precision iterative refinement:
+ * - The leading parts of a are factored in double precision (LU
+ *   factorization with partial pivoting), which takes most of the time of
+ *   solving the system, but is done at double-precision speed.
+ * - x is refined: the residual r = b - a * x is computed in double-double
+ *   (quad-double) precision like c_dd_gemm (c_dd_gemv for a single
+ *   right-hand side), the correction d is solved from a * d = r with the
+ *   double-precision factors, and added to x. This stops when the residual
+ *   is as small as that of a solution computed in double-double
+ *   (quad-double) precision, which usually takes a few steps.
+ * - If the corrections don't get smaller, because a is too ill-conditioned
+ *   for double precision, or if a is singular in double precision, a is
+ *   factored in double-double (quad-double) precision instead.
+ *
+ * Both factorizations are blocked: each step factors a panel of
+ * QD_GESV_BLOCK columns, and then subtracts a matrix product from the rest
+ * of the matrix. The solver runs in stages: c_dd_gesv_step performs the
+ * serial part of the next stage (such as factoring a panel or checking a
+ * residual), and c_dd_gesv_pass the parallel part, which is split into
+ * tiles. Like c_dd_gemm, multiple threads can call c_dd_gesv_pass at the
+ * same time: each call claims the next tile until all tiles are done. So a
+ * solver looks like this:
+ *
+ *   g.stage = 0;
+ *   while (c_dd_gesv_step(&g))
+ *     call c_dd_gesv_pass(&g, work) on up to g.tiles threads, each with
+ *     its own work buffer of QD_GEMM_WORK doubles;
+ *
+ * c_dd_gesv does all of this on the calling thread. The results are the
+ * same for any number of threads, and on all CPUs.
+ *
+ * The factors buffer is only used by the double-double (quad-double)
+ * factorization. If it is NULL when the refinement stalls, c_dd_gesv_step
+ * returns 0 with status qd_gesv_stalled. The caller can then allocate the
+ * buffer and continue calling c_dd_gesv_step, or use the refined x.
+ */
+#ifndef _QD_C_SOLVE_H
+#define _QD_C_SOLVE_H
+
+#include "qd_config.h"
+#include "c_blas.h"
+
+/* Columns of the panels of the factorizations */
+#define QD_GESV_BLOCK 32
+
+/* Number of doubles of the work and factors buffers, for an n x n matrix a
+   and nrhs right-hand sides. */
+#define QD_DD_GESV_WORK(n, nrhs) ((n) * (n) + 3 * (n) * (nrhs))
+#define QD_QD_GESV_WORK(n, nrhs) ((n) * (n) + 5 * (n) * (nrhs))
+#define QD_DD_GESV_FACTORS(n) (2 * (n) * (n))
+#define QD_QD_GESV_FACTORS(n) (4 * (n) * (n))
+
+/* Result of a solver */
+enum qd_gesv_status {
+  qd_gesv_refined = 0,   /* x was refined using the double-precision factors */
+  qd_gesv_factored = 1,  /* x was solved using the double-double (quad-double)
+                            factors */
+  qd_gesv_singular = 2,  /* a is singular. x is undefined. */
+  qd_gesv_stalled = 3,   /* the refinement stalled, and factors is NULL */
+  qd_gesv_invalid = 4    /* the sizes of the matrices don't match */
+};
+
+/* Solves a * x = b, with a: n x n, b and x: n x nrhs. */
+struct dd_gesv {
+  dd_matrix a;
+  dd_matrix b;
+  dd_matrix x;           /* receives the solution. Must not overlap a or b. */
+  double *work;          /* QD_DD_GESV_WORK(n, nrhs) doubles */
+  double *factors;       /* NULL, or QD_DD_GESV_FACTORS(n) doubles */
+  int *pivots;           /* n ints */
+  int max_iterations;    /* maximum number of refinement steps */
+  int iterations;        /* number of refinement steps done */
+  int status;            /* a qd_gesv_status, when c_dd_gesv_step returns 0 */
+  int tiles;             /* number of tiles of the next pass */
+  int stage;             /* must be set to 0 before the first call */
+
+  /* Internal state */
+  int block;
+  int next_tile;
+  double anorm;
+  double dnorm;
+  dd_gemm gemm;
+  dd_gemv gemv;
+};
+
+struct qd_gesv {
+  qd_matrix a;
+  qd_matrix b;
+  qd_matrix x;
+  double *work;          /* QD_QD_GESV_WORK(n, nrhs) doubles */
+  double *factors;       /* NULL, or QD_QD_GESV_FACTORS(n) doubles */
+  int *pivots;
+  int max_iterations;
+  int iterations;
+  int status;
+  int tiles;
+  int stage;
+
+  int block;
+  int next_tile;
+  double anorm;
+  double dnorm;
+  qd_gemm gemm;
+  qd_gemv gemv;
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Performs the serial part of the next stage. Returns 1 if c_dd_gesv_pass
+   must be called next, or 0 if the solver is done (see status). */
+QD_API int c_dd_gesv_step(dd_gesv *g);
+QD_API int c_qd_gesv_step(qd_gesv *g);
+
+/* Computes the tiles of the current pass that have not been claimed yet by
+   another call. work must point to QD_GEMM_WORK doubles, which are not used
+   by other threads. */
+QD_API void c_dd_gesv_pass(dd_gesv *g, double *work);
+QD_API void c_qd_gesv_pass(qd_gesv *g, double *work);
+
+/* Runs the whole solver on the calling thread (from stage 0). work must
+   point to QD_GEMM_WORK doubles. */
+QD_API void c_dd_gesv(dd_gesv *g, double *work);
+QD_API void c_qd_gesv(qd_gesv *g, double *work);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _QD_C_SOLVE_H */
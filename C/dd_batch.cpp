@@ -0,0 +1,264 @@
+/*
+ * dd_batch.cpp
+ *
+ * Batch (array) versions of the double-double arithmetic operators, used
+ * by the c_dd_*_n functions in c_dd.cpp. The numbers are stored in
+ * structure-of-arrays layout (see dd_real_array in c_dd.h).
+ *
+ * On Intel, the kernels are compiled for SSE2, AVX2 and AVX-512 and
+ * the widest version supported by the CPU is selected on first use. On
+ * other CPUs, only the scalar versions in qd::generic are used.
+ *
+ * The transcendental and polynomial kernels use the tables and templates
+ * in dd_real.cpp, so this file must be included after it (see c_dd.cpp).
+ */
+#include "qd_config.h"
+#include "dd_real.h"
+#include "c_dd.h"
+#include "qd_cpu.h"
+#include "simd.h"
+
+/* Accumulators of the compensated sums and dot products (c_dd_sum_d and
+   friends). Element j is added to accumulator j % dd_acc_count with
+   two_sum: s[k] holds the sum and c[k] the sum of the rounding errors (the
+   Sum2 and Dot2 algorithms of Ogita, Rump and Oishi), so the sum is only
+   renormalized at the end. dd_acc_count is a multiple of every vector
+   width, so all instruction sets add the elements in the same order and
+   give bitwise identical results. */
+enum { dd_acc_count = 8 };
+
+struct dd_acc {
+  double s[dd_acc_count];
+  double c[dd_acc_count];
+};
+
+namespace qd {
+namespace generic {
+
+inline dd_real load(const dd_real_array *a, int i) {
+  return dd_real(a->x[0][i], a->x[1][i]);
+}
+
+inline void store(dd_real_array *a, int i, const dd_real &b) {
+  a->x[0][i] = b.x[0];
+  a->x[1][i] = b.x[1];
+}
+
+void dd_add_n(const dd_real_array *a, const dd_real_array *b,
+    dd_real_array *c, int i) {
+  for (; i < c->count; i++)
+    store(c, i, load(a, i) + load(b, i));
+}
+
+void dd_sub_n(const dd_real_array *a, const dd_real_array *b,
+    dd_real_array *c, int i) {
+  for (; i < c->count; i++)
+    store(c, i, load(a, i) - load(b, i));
+}
+
+void dd_mul_n(const dd_real_array *a, const dd_real_array *b,
+    dd_real_array *c, int i) {
+  for (; i < c->count; i++)
+    store(c, i, load(a, i) * load(b, i));
+}
+
+void dd_div_n(const dd_real_array *a, const dd_real_array *b,
+    dd_real_array *c, int i) {
+  for (; i < c->count; i++)
+    store(c, i, load(a, i) / load(b, i));
+}
+
+void dd_fma_n(const dd_real_array *a, const dd_real_array *b,
+    dd_real_array *c, int i) {
+  for (; i < c->count; i++)
+    store(c, i, load(c, i) + load(a, i) * load(b, i));
+}
+
+void dd_axpy_n(const dd_real &alpha, const dd_real_array *x,
+    dd_real_array *y, int i) {
+  for (; i < y->count; i++)
+    store(y, i, load(y, i) + alpha * load(x, i));
+}
+
+void dd_sqr_n(const dd_real_array *a, dd_real_array *b, int i) {
+  for (; i < b->count; i++)
+    store(b, i, sqr(load(a, i)));
+}
+
+void dd_exp_n(const dd_real_array *a, dd_real_array *b, int i) {
+  for (; i < b->count; i++)
+    store(b, i, exp(load(a, i)));
+}
+
+void dd_log_n(const dd_real_array *a, dd_real_array *b, int i) {
+  for (; i < b->count; i++)
+    store(b, i, log(load(a, i)));
+}
+
+void dd_sincos_n(const dd_real_array *a, dd_real_array *s,
+    dd_real_array *c, int i) {
+  dd_real sin_a, cos_a;
+  for (; i < s->count; i++) {
+    sincos(load(a, i), sin_a, cos_a);
+    store(s, i, sin_a);
+    store(c, i, cos_a);
+  }
+}
+
+void dd_atan2_n(const dd_real_array *a, const dd_real_array *b,
+    dd_real_array *c, int i) {
+  for (; i < c->count; i++)
+    store(c, i, atan2(load(a, i), load(b, i)));
+}
+
+/* Element i of c[k] and up */
+struct dd_coef_array {
+  const dd_real_array *c;
+  int i;
+  dd_real operator()(int k) const { return load(c + k, i); }
+};
+
+void dd_polyeval_n(const dd_real *c, int n, const dd_real_array *x,
+    dd_real_array *y, int i) {
+  for (; i < y->count; i++)
+    store(y, i, polyeval(c, n, load(x, i)));
+}
+
+void dd_polyeval_set_n(const dd_real_array *c, int n, const dd_real &x,
+    dd_real_array *y, int i) {
+  for (; i < y->count; i++) {
+    dd_coef_array coef = { c, i };
+    store(y, i, dd_polyeval(coef, n, x));
+  }
+}
+
+void dd_sum_d(const double *a, int n, dd_acc *acc, int i) {
+  for (; i < n; i++) {
+    int k = i % dd_acc_count;
+    double e;
+    acc->s[k] = two_sum(acc->s[k], a[i], e);
+    acc->c[k] += e;
+  }
+}
+
+void dd_dot_d(const double *a, const double *b, int n, dd_acc *acc,
+    int i) {
+  for (; i < n; i++) {
+    int k = i % dd_acc_count;
+    double p, e, f;
+    p = two_prod(a[i], b[i], e);
+    acc->s[k] = two_sum(acc->s[k], p, f);
+    acc->c[k] += e + f;
+  }
+}
+
+/* The error of the product of a and b is e plus the cross terms, which is
+   accumulated without renormalizing the product first. */
+void dd_dot_dd(const dd_real_array *a, const dd_real_array *b, dd_acc *acc,
+    int i) {
+  for (; i < a->count; i++) {
+    int k = i % dd_acc_count;
+    double p, e, f;
+    p = two_prod(a->x[0][i], b->x[0][i], e);
+    e += a->x[0][i] * b->x[1][i] + a->x[1][i] * b->x[0][i];
+    acc->s[k] = two_sum(acc->s[k], p, f);
+    acc->c[k] += e + f;
+  }
+}
+
+/* Adds up the accumulators, in a fixed order */
+dd_real dd_acc_sum(const dd_acc *acc) {
+  dd_real s = 0.0;
+  double c = 0.0;
+  for (int k = 0; k < dd_acc_count; k++) {
+    s += acc->s[k];
+    c += acc->c[k];
+  }
+  return s + c;
+}
+
+void dd_to_soa_n(const dd_real *a, dd_real_array *b, int i) {
+  for (; i < b->count; i++)
+    store(b, i, a[i]);
+}
+
+void dd_to_aos_n(const dd_real_array *a, dd_real *b, int i) {
+  for (; i < a->count; i++)
+    b[i] = load(a, i);
+}
+
+}
+}
+
+#ifdef QD_FMA_DISPATCH
+
+namespace qd {
+namespace sse2 {
+#define QD_SIMD_TARGET QD_TARGET_SSE2
+#include "dd_batch.h"
+#undef QD_SIMD_TARGET
+}
+
+namespace avx2 {
+#define QD_SIMD_TARGET QD_TARGET_AVX2
+#include "dd_batch.h"
+#undef QD_SIMD_TARGET
+}
+
+namespace avx512 {
+#define QD_SIMD_TARGET QD_TARGET_AVX512
+#include "dd_batch.h"
+#undef QD_SIMD_TARGET
+}
+}
+
+#endif /* QD_FMA_DISPATCH */
+
+/* Batch kernels for a specific instruction set. */
+struct dd_batch_kernels {
+  void (*add_n)(const dd_real_array *, const dd_real_array *, dd_real_array *, int);
+  void (*sub_n)(const dd_real_array *, const dd_real_array *, dd_real_array *, int);
+  void (*mul_n)(const dd_real_array *, const dd_real_array *, dd_real_array *, int);
+  void (*div_n)(const dd_real_array *, const dd_real_array *, dd_real_array *, int);
+  void (*fma_n)(const dd_real_array *, const dd_real_array *, dd_real_array *, int);
+  void (*axpy_n)(const dd_real &, const dd_real_array *, dd_real_array *, int);
+  void (*sqr_n)(const dd_real_array *, dd_real_array *, int);
+  void (*exp_n)(const dd_real_array *, dd_real_array *, int);
+  void (*log_n)(const dd_real_array *, dd_real_array *, int);
+  void (*sincos_n)(const dd_real_array *, dd_real_array *, dd_real_array *, int);
+  void (*atan2_n)(const dd_real_array *, const dd_real_array *, dd_real_array *, int);
+  void (*polyeval_n)(const dd_real *, int, const dd_real_array *, dd_real_array *, int);
+  void (*polyeval_set_n)(const dd_real_array *, int, const dd_real &, dd_real_array *, int);
+  void (*sum_d)(const double *, int, dd_acc *, int);
+  void (*dot_d)(const double *, const double *, int, dd_acc *, int);
+  void (*dot_dd)(const dd_real_array *, const dd_real_array *, dd_acc *, int);
+  void (*to_soa_n)(const dd_real *, dd_real_array *, int);
+  void (*to_aos_n)(const dd_real_array *, dd_real *, int);
+};
+
+#define QD_DD_BATCH_KERNELS(ns) { ns::dd_add_n, ns::dd_sub_n, ns::dd_mul_n, \
+  ns::dd_div_n, ns::dd_fma_n, ns::dd_axpy_n, ns::dd_sqr_n, ns::dd_exp_n, \
+  ns::dd_log_n, ns::dd_sincos_n, ns::dd_atan2_n, ns::dd_polyeval_n, \
+  ns::dd_polyeval_set_n, ns::dd_sum_d, ns::dd_dot_d, ns::dd_dot_dd, ns::dd_to_soa_n, \
+  ns::dd_to_aos_n }
+
+#ifdef QD_FMA_DISPATCH
+static const dd_batch_kernels dd_batch_sse2 = QD_DD_BATCH_KERNELS(qd::sse2);
+static const dd_batch_kernels dd_batch_avx2 = QD_DD_BATCH_KERNELS(qd::avx2);
+static const dd_batch_kernels dd_batch_avx512 = QD_DD_BATCH_KERNELS(qd::avx512);
+#else
+static const dd_batch_kernels dd_batch_generic = QD_DD_BATCH_KERNELS(qd::generic);
+#endif
+
+/* Returns the fastest batch kernels for this CPU. */
+static const dd_batch_kernels *dd_batch_select(int cpu_features) {
+#ifdef QD_FMA_DISPATCH
+  if (cpu_features & qd::cpu_avx512)
+    return &dd_batch_avx512;
+  if (cpu_features & qd::cpu_avx2)
+    return &dd_batch_avx2;
+  return &dd_batch_sse2;
+#else
+  return &dd_batch_generic;
+#endif
+}
@@ -0,0 +1,817 @@
+/*
+ * dd_batch.h
+ *
+ * Double-double batch kernels, operating on "width" numbers at a time.
+ * This file is included once for each of the SIMD namespaces in simd.h
+ * (see dd_batch.cpp), and relies on the "vec" type and functions declared
+ * there. The algorithms are identical to the ones in dd_inline.h, so the
+ * results are bitwise identical to the scalar versions.
+ *
+ * Every array kernel processes elements [i, c->count) and hands the
+ * remaining elements that don't fill a whole vector to the scalar version
+ * in qd::generic.
+ *
+ * The transcendental functions (exp, log, sincos and atan2) follow
+ * dd_real.cpp. exp, log and atan2 give the same results as the scalar
+ * versions. sincos always uses all the Taylor terms the scalar version may
+ * use, so that all lanes take the same path. Its results may differ from
+ * the scalar version in the last bit. So that the results don't depend on
+ * the position of an element in the array, the remaining elements of exp,
+ * log and sincos are processed by padding them to a whole vector instead.
+ *
+ * The sums and dot products (dd_sum_d and friends) add the elements in
+ * dd_acc_count independent accumulators, which every width divides. So the
+ * order of the additions, and the result, is the same for all widths.
+ */
+
+/* width double-double numbers */
+struct dd_vec {
+  vec x[2];
+};
+
+QD_SIMD_TARGET inline dd_vec load(const dd_real_array *a, int i) {
+  dd_vec r;
+  r.x[0] = load(a->x[0] + i);
+  r.x[1] = load(a->x[1] + i);
+  return r;
+}
+
+QD_SIMD_TARGET inline void store(dd_real_array *a, int i, const dd_vec &b) {
+  store(a->x[0] + i, b.x[0]);
+  store(a->x[1] + i, b.x[1]);
+}
+
+/* Same as load and store, for the last n < width elements. The unused
+   lanes are set to zero. */
+QD_SIMD_TARGET inline dd_vec load_partial(const dd_real_array *a, int i,
+    int n) {
+  dd_vec r;
+  r.x[0] = load_partial(a->x[0] + i, n);
+  r.x[1] = load_partial(a->x[1] + i, n);
+  return r;
+}
+
+QD_SIMD_TARGET inline void store_partial(dd_real_array *a, int i, int n,
+    const dd_vec &b) {
+  store_partial(a->x[0] + i, b.x[0], n);
+  store_partial(a->x[1] + i, b.x[1], n);
+}
+
+/* Broadcasts a double-double constant to all lanes */
+QD_SIMD_TARGET inline dd_vec set1(const dd_real &a) {
+  dd_vec r;
+  r.x[0] = set1(a.x[0]);
+  r.x[1] = set1(a.x[1]);
+  return r;
+}
+
+QD_SIMD_TARGET inline dd_vec select(mask m, const dd_vec &a,
+    const dd_vec &b) {
+  dd_vec r;
+  r.x[0] = select(m, a.x[0], b.x[0]);
+  r.x[1] = select(m, a.x[1], b.x[1]);
+  return r;
+}
+
+QD_SIMD_TARGET inline dd_vec neg(const dd_vec &a) {
+  dd_vec r;
+  r.x[0] = -a.x[0];
+  r.x[1] = -a.x[1];
+  return r;
+}
+
+/*********** Additions ************/
+/* double-double + double */
+QD_SIMD_TARGET inline dd_vec add(const dd_vec &a, vec b) {
+  dd_vec r;
+  vec s1, s2;
+  s1 = two_sum(a.x[0], b, s2);
+  s2 += a.x[1];
+  r.x[0] = quick_two_sum(s1, s2, r.x[1]);
+  return r;
+}
+
+/* double-double + double-double */
+QD_SIMD_TARGET inline dd_vec add(const dd_vec &a, const dd_vec &b) {
+  dd_vec r;
+#ifndef QD_IEEE_ADD
+  vec s, e;
+  s = two_sum(a.x[0], b.x[0], e);
+  e += (a.x[1] + b.x[1]);
+  r.x[0] = quick_two_sum(s, e, r.x[1]);
+#else
+  vec s1, s2, t1, t2;
+  s1 = two_sum(a.x[0], b.x[0], s2);
+  t1 = two_sum(a.x[1], b.x[1], t2);
+  s2 += t1;
+  s1 = quick_two_sum(s1, s2, s2);
+  s2 += t2;
+  r.x[0] = quick_two_sum(s1, s2, r.x[1]);
+#endif
+  return r;
+}
+
+/*********** Subtractions ************/
+/* double-double - double */
+QD_SIMD_TARGET inline dd_vec sub(const dd_vec &a, vec b) {
+  dd_vec r;
+  vec s1, s2;
+  s1 = two_diff(a.x[0], b, s2);
+  s2 += a.x[1];
+  r.x[0] = quick_two_sum(s1, s2, r.x[1]);
+  return r;
+}
+
+/* double - double-double */
+QD_SIMD_TARGET inline dd_vec sub(vec a, const dd_vec &b) {
+  dd_vec r;
+  vec s1, s2;
+  s1 = two_diff(a, b.x[0], s2);
+  s2 -= b.x[1];
+  r.x[0] = quick_two_sum(s1, s2, r.x[1]);
+  return r;
+}
+
+/* double-double - double-double */
+QD_SIMD_TARGET inline dd_vec sub(const dd_vec &a, const dd_vec &b) {
+  dd_vec r;
+#ifndef QD_IEEE_ADD
+  vec s, e;
+  s = two_diff(a.x[0], b.x[0], e);
+  e += a.x[1];
+  e -= b.x[1];
+  r.x[0] = quick_two_sum(s, e, r.x[1]);
+#else
+  vec s1, s2, t1, t2;
+  s1 = two_diff(a.x[0], b.x[0], s2);
+  t1 = two_diff(a.x[1], b.x[1], t2);
+  s2 += t1;
+  s1 = quick_two_sum(s1, s2, s2);
+  s2 += t2;
+  r.x[0] = quick_two_sum(s1, s2, r.x[1]);
+#endif
+  return r;
+}
+
+/*********** Multiplications ************/
+/* double-double * double,  where double is a power of 2. */
+QD_SIMD_TARGET inline dd_vec mul_pwr2(const dd_vec &a, double b) {
+  dd_vec r;
+  r.x[0] = a.x[0] * set1(b);
+  r.x[1] = a.x[1] * set1(b);
+  return r;
+}
+
+/* double-double * double */
+QD_SIMD_TARGET inline dd_vec mul(const dd_vec &a, vec b) {
+  dd_vec r;
+  vec p1, p2;
+  p1 = two_prod(a.x[0], b, p2);
+  p2 += (a.x[1] * b);
+  r.x[0] = quick_two_sum(p1, p2, r.x[1]);
+  return r;
+}
+
+/* double-double * double-double */
+QD_SIMD_TARGET inline dd_vec mul(const dd_vec &a, const dd_vec &b) {
+  dd_vec r;
+  vec p1, p2;
+  p1 = two_prod(a.x[0], b.x[0], p2);
+  p2 += (a.x[0] * b.x[1] + a.x[1] * b.x[0]);
+  r.x[0] = quick_two_sum(p1, p2, r.x[1]);
+  return r;
+}
+
+/*********** Divisions ************/
+/* double-double / double-double */
+QD_SIMD_TARGET inline dd_vec div(const dd_vec &a, const dd_vec &b) {
+#ifdef QD_SLOPPY_DIV
+  vec s1, s2;
+  vec q1, q2;
+  dd_vec r;
+
+  q1 = a.x[0] / b.x[0];  /* approximate quotient */
+
+  /* compute  this - q1 * dd */
+  r = mul(b, q1);
+  s1 = two_diff(a.x[0], r.x[0], s2);
+  s2 -= r.x[1];
+  s2 += a.x[1];
+
+  /* get next approximation */
+  q2 = (s1 + s2) / b.x[0];
+
+  /* renormalize */
+  r.x[0] = quick_two_sum(q1, q2, r.x[1]);
+  return r;
+#else
+  vec q1, q2, q3;
+  dd_vec r;
+
+  q1 = a.x[0] / b.x[0];  /* approximate quotient */
+
+  r = sub(a, mul(b, q1));
+
+  q2 = r.x[0] / b.x[0];
+  r = sub(r, mul(b, q2));
+
+  q3 = r.x[0] / b.x[0];
+
+  r.x[0] = quick_two_sum(q1, q2, r.x[1]);
+  return add(r, q3);
+#endif
+}
+
+/*********** Squaring **********/
+QD_SIMD_TARGET inline dd_vec sqr(const dd_vec &a) {
+  dd_vec r;
+  vec p1, p2;
+  p1 = two_sqr(a.x[0], p2);
+  p2 += set1(2.0) * a.x[0] * a.x[1];
+  p2 += a.x[1] * a.x[1];
+  r.x[0] = quick_two_sum(p1, p2, r.x[1]);
+  return r;
+}
+
+/*********** Miscellaneous ************/
+/* Round to Nearest integer */
+QD_SIMD_TARGET inline dd_vec nint(const dd_vec &a) {
+  dd_vec r;
+  vec hi, lo, hi_int, lo_int;
+  mask tie;
+
+  /* High word is an integer already.  Round the low word. */
+  hi = nint(a.x[0]);
+  lo_int = nint(a.x[1]);
+  hi_int = quick_two_sum(hi, lo_int, lo_int);
+
+  /* High word is not an integer. Consult the low word to break a tie. */
+  tie = mask_and(is_eq(abs(hi - a.x[0]), set1(0.5)),
+                 is_lt(a.x[1], set1(0.0)));
+  lo = hi - select(tie, set1(1.0), set1(0.0));
+
+  r.x[0] = select(is_eq(hi, a.x[0]), hi_int, lo);
+  r.x[1] = select(is_eq(hi, a.x[0]), lo_int, set1(0.0));
+  return r;
+}
+
+/* Computes a * 2^m for integral m in [-2044, 2046] */
+QD_SIMD_TARGET inline dd_vec ldexp(const dd_vec &a, vec m) {
+  dd_vec r;
+  r.x[0] = ldexp(a.x[0], m);
+  r.x[1] = ldexp(a.x[1], m);
+  return r;
+}
+
+/* Square root, using Karp's trick like sqrt in dd_real.cpp */
+QD_SIMD_TARGET inline dd_vec sqrt(const dd_vec &a) {
+  dd_vec r;
+  vec x, ax, p1, p2;
+
+  x = set1(1.0) / sqrt(a.x[0]);
+  ax = a.x[0] * x;
+  r.x[0] = two_sqr(ax, r.x[1]);
+  r = sub(a, r);
+  p1 = two_sum(ax, r.x[0] * (x * set1(0.5)), p2);
+
+  r.x[0] = select(is_zero(a.x[0]), set1(0.0), p1);
+  r.x[1] = select(is_zero(a.x[0]), set1(0.0), p2);
+  return r;
+}
+
+/*********** Exponential and Logarithm ************/
+/* Looks up the entries j of a table of double-double numbers */
+QD_SIMD_TARGET inline dd_vec gather(const double (*table)[2], vec j) {
+  dd_vec r;
+  j = j * set1(2.0);
+  r.x[0] = gather(table[0], j);
+  r.x[1] = gather(table[0] + 1, j);
+  return r;
+}
+
+/* Same as exp in dd_real.cpp */
+QD_SIMD_TARGET inline dd_vec exp(const dd_vec &a) {
+  mask under, over, in, one;
+  dd_vec x, r, s, p;
+  vec k, m, j1, j2, c, r0;
+
+  under = is_le(a.x[0], set1(-709.0));
+  over = is_le(set1(709.0), a.x[0]);
+  in = is_lt(abs(a.x[0]), set1(709.0));
+  one = mask_and(is_eq(a.x[0], set1(1.0)), is_zero(a.x[1]));
+
+  /* Lanes that are out of range or NaN compute exp(0) instead */
+  x.x[0] = select(in, a.x[0], set1(0.0));
+  x.x[1] = select(in, a.x[1], set1(0.0));
+
+  k = floor(x.x[0] * set1(exp_inv_ln2) + set1(0.5));
+  m = floor(k * set1(1.0 / 4096.0));
+  j2 = k - m * set1(4096.0);
+  j1 = floor(j2 * set1(1.0 / 64.0));
+  j2 = j2 - j1 * set1(64.0);
+
+  r = sub(sub(x, k * set1(exp_ln2_hi)),
+          mul(set1(dd_real(exp_ln2_lo[0], exp_ln2_lo[1])), k));
+  r0 = r.x[0];
+
+  c = set1(inv_fact[1][0]) + r0 * (set1(inv_fact[2][0]) + r0 *
+      (set1(inv_fact[3][0]) + r0 * set1(inv_fact[4][0])));
+  p = add(set1(dd_real(inv_fact[0][0], inv_fact[0][1])), r0 * c);
+  p = add(mul(r, p), set1(0.5));
+  p = add(r, mul(sqr(r), p));
+
+  s = mul(gather(exp2_table1, j1), gather(exp2_table2, j2));
+  s = add(s, mul(s, p));
+  s = ldexp(s, m);
+
+  s = select(one, set1(dd_real::_e), s);
+  s = select(in, s, set1(dd_real::_nan));
+  s = select(under, set1(dd_real(0.0)), s);
+  s = select(over, set1(dd_real::_inf), s);
+  return s;
+}
+
+/* Same as log in dd_real.cpp */
+QD_SIMD_TARGET inline dd_vec log(const dd_vec &a) {
+  mask valid, tiny;
+  dd_vec m, u, w, p, s;
+  vec e, k, i, j, y, c, w0;
+
+  /* Lanes that are not positive and finite compute log(1) instead */
+  valid = mask_and(is_lt(set1(0.0), a.x[0]),
+                   is_lt(a.x[0], set1(dd_real::_inf.x[0])));
+  m.x[0] = select(valid, a.x[0], set1(1.0));
+  m.x[1] = select(valid, a.x[1], set1(0.0));
+
+  tiny = is_lt(m.x[0], set1(2.2250738585072014e-308));
+  m = select(tiny, mul_pwr2(m, 18014398509481984.0), m);
+  e = select(tiny, set1(-54.0), set1(0.0));
+
+  k = exponent(m.x[0] * set1(4.0 / 3.0));
+  m = ldexp(m, -k);
+  e = e + k;
+
+  i = floor(m.x[0] * set1(64.0) + set1(0.5));
+  j = floor((m.x[0] * set1(64.0) / i - set1(1.0)) * set1(4096.0) + set1(0.5));
+  y = i * (set1(4096.0) + j) * set1(1.0 / 262144.0);
+
+  u = div(sub(m, y), add(m, y));
+  w = sqr(u);
+  w0 = w.x[0];
+
+  c = set1(inv_odd[1][0]) + w0 * set1(inv_odd[2][0]);
+  p = add(set1(dd_real(inv_odd[0][0], inv_odd[0][1])), w0 * c);
+  p = mul(w, p);
+
+  s = add(add(mul(set1(dd_real::_log2), e), gather(log_table1, i - set1(48.0))),
+          gather(log_table2, j + set1(43.0)));
+  s = add(s, mul_pwr2(add(u, mul(u, p)), 2.0));
+
+  s = select(valid, s, set1(dd_real::_nan));
+  s = select(is_eq(a.x[0], set1(dd_real::_inf.x[0])), set1(dd_real::_inf), s);
+  return s;
+}
+
+/*********** Trigonometric Functions ************/
+/* Same as sin_taylor in dd_real.cpp, but always uses all 8 Taylor terms.
+   Assumes |a| <= pi/32. */
+QD_SIMD_TARGET inline dd_vec sin_taylor(const dd_vec &a) {
+  dd_vec r, s, x;
+
+  x = neg(sqr(a));
+  s = a;
+  r = a;
+  for (int i = 0; i < n_inv_fact; i += 2) {
+    r = mul(r, x);
+    s = add(s, mul(r, set1(dd_real(inv_fact[i][0], inv_fact[i][1]))));
+  }
+  return s;
+}
+
+/* Same as sincos in dd_real.cpp. The table entries and the final quadrant
+   are chosen per lane using masks. Lanes with |a| >= 1e6 are reduced by
+   the scalar rem_pio2. */
+QD_SIMD_TARGET inline void sincos(const dd_vec &a, dd_vec &sin_a,
+    dd_vec &cos_a) {
+  dd_vec t, u, v, sin_t, cos_t, s, c;
+  vec q, j, k, abs_k;
+  mask bad, neg_k;
+
+  /* reduce modulo pi/2 (Cody-Waite) */
+  q = floor(a.x[0] * set1(inv_pio2) + set1(0.5));
+  t = a;
+  for (int i = 0; i < n_pio2_cw; i++)
+    t = sub(t, q * set1(pio2_cw[i]));
+  j = q - set1(4.0) * floor(q * set1(0.25));
+  j = select(is_eq(j, set1(3.0)), set1(-1.0), j);
+
+  if (any(is_le(set1(1.0e6), abs(a.x[0])))) {
+    double a0[width], a1[width], t0[width], t1[width], jl[width];
+    store(a0, a.x[0]);
+    store(a1, a.x[1]);
+    store(t0, t.x[0]);
+    store(t1, t.x[1]);
+    store(jl, j);
+    for (int l = 0; l < width; l++)
+      if (qd_fabs(a0[l]) >= 1.0e6) {
+        dd_real tl;
+        int jj;
+        if (!::rem_pio2(dd_real(a0[l], a1[l]), tl, jj))
+          jj = 4;
+        t0[l] = tl.x[0];
+        t1[l] = tl.x[1];
+        jl[l] = jj;
+      }
+    t.x[0] = load(t0);
+    t.x[1] = load(t1);
+    j = load(jl);
+  }
+
+  /* reduce modulo pi/16 */
+  k = floor(t.x[0] / set1(dd_real::_pi16.x[0]) + set1(0.5));
+  t = sub(t, mul(set1(dd_real::_pi16), k));
+  abs_k = abs(k);
+
+  /* Cannot reduce modulo pi/2 (a is not finite) or pi/16 */
+  bad = mask_or(is_lt(set1(2.0), abs(j)), is_lt(set1(4.0), abs_k));
+
+  sin_t = sin_taylor(t);
+  cos_t = sqrt(sub(set1(1.0), sqr(sin_t)));
+
+  /* (u, v) = (cos(k * pi/16), sin(|k| * pi/16)); (1, 0) if k = 0 */
+  u = set1(dd_real(1.0));
+  v = set1(dd_real(0.0));
+  for (int i = 1; i <= 4; i++) {
+    mask m = is_eq(abs_k, set1(i));
+    u = select(m, set1(dd_real(cos_table[i - 1][0], cos_table[i - 1][1])), u);
+    v = select(m, set1(dd_real(sin_table[i - 1][0], sin_table[i - 1][1])), v);
+  }
+  neg_k = is_lt(k, set1(0.0));
+  v = select(neg_k, neg(v), v);
+
+  s = add(mul(u, sin_t), mul(v, cos_t));
+  c = sub(mul(u, cos_t), mul(v, sin_t));
+
+  /* j = 1: (c, -s); j = -1: (-c, s); |j| = 2: (-s, -c) */
+  {
+    mask j1 = is_eq(abs(j), set1(1.0));
+    mask j2 = is_eq(abs(j), set1(2.0));
+    mask jn = is_lt(j, set1(0.0));
+    sin_a = select(j1, select(jn, neg(c), c), select(j2, neg(s), s));
+    cos_a = select(j1, select(jn, s, neg(s)), select(j2, neg(c), c));
+  }
+
+  sin_a = select(bad, set1(dd_real::_nan), sin_a);
+  cos_a = select(bad, set1(dd_real::_nan), cos_a);
+}
+
+/* Same as atan2 in dd_real.cpp. The table entries are gathered, and the
+   symmetries are applied per lane using masks. Lanes where x or y is zero
+   or not finite, or where |x| = |y|, are computed by the scalar atan2. */
+QD_SIMD_TARGET inline dd_vec atan2(const dd_vec &y, const dd_vec &x) {
+  dd_vec ax, ay, t, num, den, v, w, p, z;
+  vec inf, f, k1, c1, k2, c2, c, w0;
+  mask regular, swap;
+
+  inf = set1(__builtin_inf());
+  regular = mask_and(
+      mask_and(is_nonzero(x.x[0]), is_lt(abs(x.x[0]), inf)),
+      mask_and(is_nonzero(y.x[0]), is_lt(abs(y.x[0]), inf)));
+  regular = mask_andnot(regular, is_eq(abs(x.x[0]), abs(y.x[0])));
+
+  /* The other lanes compute atan2(1/2, 1) */
+  ax = select(is_lt(x.x[0], set1(0.0)), neg(x), x);
+  ay = select(is_lt(y.x[0], set1(0.0)), neg(y), y);
+  ax = select(regular, ax, set1(dd_real(1.0)));
+  ay = select(regular, ay, set1(dd_real(0.5)));
+
+  swap = mask_or(is_lt(ax.x[0], ay.x[0]),
+      mask_and(is_eq(ay.x[0], ax.x[0]), is_lt(ax.x[1], ay.x[1])));
+  t = ax;
+  ax = select(swap, ay, ax);
+  ay = select(swap, t, ay);
+
+  /* Scale the arguments to avoid overflow and underflow */
+  f = select(is_lt(set1(1e290), ax.x[0]), set1(2.40991986510288411e-181),
+      select(is_lt(ax.x[0], set1(1e-200)), set1(4.14951556888099290e+180),
+      set1(1.0)));
+  for (int n = 0; n < 2; n++) {
+    ax.x[n] = ax.x[n] * f;
+    ay.x[n] = ay.x[n] * f;
+  }
+
+  k1 = floor(ay.x[0] / ax.x[0] * set1(64.0) + set1(0.5));
+  c1 = k1 * set1(1.0 / 64.0);
+  num = sub(ay, mul(ax, c1));
+  den = add(ax, mul(ay, c1));
+
+  k2 = floor(num.x[0] / den.x[0] * set1(4096.0) + set1(0.5));
+  c2 = k2 * set1(1.0 / 4096.0);
+  v = div(sub(num, mul(den, c2)), add(den, mul(num, c2)));
+
+  w = sqr(v);
+  w0 = w.x[0];
+
+  /* atan(v) = v - v w (1/3 - w (1/5 - w (1/7 - w/9))), with w = v^2 */
+  c = set1(inv_odd[1][0]) - w0 * (set1(inv_odd[2][0]) - w0 * set1(inv_odd[3][0]));
+  p = sub(set1(dd_real(inv_odd[0][0], inv_odd[0][1])), w0 * c);
+  p = mul(w, p);
+
+  z = add(add(gather(atan_table1, k1), gather(atan_table2, k2 + set1(32.0))),
+      sub(v, mul(v, p)));
+
+  z = select(swap, sub(set1(dd_real::_pi2), z), z);
+  z = select(is_lt(x.x[0], set1(0.0)), sub(set1(dd_real::_pi), z), z);
+  z = select(is_lt(y.x[0], set1(0.0)), neg(z), z);
+
+  if (!all(regular)) {
+    double y0[width], y1[width], x0[width], x1[width], z0[width], z1[width];
+    double r[width];
+    store(y0, y.x[0]);
+    store(y1, y.x[1]);
+    store(x0, x.x[0]);
+    store(x1, x.x[1]);
+    store(z0, z.x[0]);
+    store(z1, z.x[1]);
+    store(r, select(regular, set1(1.0), set1(0.0)));
+    for (int l = 0; l < width; l++)
+      if (r[l] == 0.0) {
+        dd_real zl = ::atan2(dd_real(y0[l], y1[l]), dd_real(x0[l], x1[l]));
+        z0[l] = zl.x[0];
+        z1[l] = zl.x[1];
+      }
+    z.x[0] = load(z0);
+    z.x[1] = load(z1);
+  }
+  return z;
+}
+
+/*********** Polynomials ************/
+/* The same coefficients for all lanes */
+struct dd_coef_bcast {
+  const dd_real *c;
+  QD_SIMD_TARGET dd_vec operator()(int k) const { return set1(c[k]); }
+};
+
+/* Different coefficients for every lane: element i of c[k] and up */
+struct dd_coef_load {
+  const dd_real_array *c;
+  int i;
+  QD_SIMD_TARGET dd_vec operator()(int k) const { return load(c + k, i); }
+};
+
+/* Same as dd_estrin8 in dd_real.cpp */
+template <class Coef>
+QD_SIMD_TARGET inline dd_vec estrin8(const Coef &coef, int k,
+    const dd_vec &x, const dd_vec &x2, const dd_vec &x4) {
+  dd_vec p0 = add(coef(k), mul(coef(k + 1), x));
+  dd_vec p1 = add(coef(k + 2), mul(coef(k + 3), x));
+  dd_vec p2 = add(coef(k + 4), mul(coef(k + 5), x));
+  dd_vec p3 = add(coef(k + 6), mul(coef(k + 7), x));
+  return add(add(p0, mul(p1, x2)), mul(add(p2, mul(p3, x2)), x4));
+}
+
+/* Same as dd_polyeval in dd_real.cpp. Assumes n >= 0. */
+template <class Coef>
+QD_SIMD_TARGET inline dd_vec polyeval(const Coef &coef, int n,
+    const dd_vec &x) {
+  int k = (n + 1) & ~7;
+  dd_vec r;
+  if (k <= n) {
+    r = coef(n);
+    for (int i = n - 1; i >= k; i--)
+      r = add(mul(r, x), coef(i));
+    if (k == 0)
+      return r;
+  }
+
+  dd_vec x2 = sqr(x);
+  dd_vec x4 = sqr(x2);
+  dd_vec x8 = sqr(x4);
+  if (k > n) {
+    k -= 8;
+    r = estrin8(coef, k, x, x2, x4);
+  }
+  while (k > 0) {
+    k -= 8;
+    r = add(mul(r, x8), estrin8(coef, k, x, x2, x4));
+  }
+  return r;
+}
+
+/*********** Array Kernels ************/
+QD_SIMD_TARGET void dd_add_n(const dd_real_array *a, const dd_real_array *b,
+    dd_real_array *c, int i) {
+  for (; i <= c->count - width; i += width)
+    store(c, i, add(load(a, i), load(b, i)));
+  zero_upper();
+  generic::dd_add_n(a, b, c, i);
+}
+
+QD_SIMD_TARGET void dd_sub_n(const dd_real_array *a, const dd_real_array *b,
+    dd_real_array *c, int i) {
+  for (; i <= c->count - width; i += width)
+    store(c, i, sub(load(a, i), load(b, i)));
+  zero_upper();
+  generic::dd_sub_n(a, b, c, i);
+}
+
+QD_SIMD_TARGET void dd_mul_n(const dd_real_array *a, const dd_real_array *b,
+    dd_real_array *c, int i) {
+  for (; i <= c->count - width; i += width)
+    store(c, i, mul(load(a, i), load(b, i)));
+  zero_upper();
+  generic::dd_mul_n(a, b, c, i);
+}
+
+QD_SIMD_TARGET void dd_div_n(const dd_real_array *a, const dd_real_array *b,
+    dd_real_array *c, int i) {
+  for (; i <= c->count - width; i += width)
+    store(c, i, div(load(a, i), load(b, i)));
+  zero_upper();
+  generic::dd_div_n(a, b, c, i);
+}
+
+QD_SIMD_TARGET void dd_fma_n(const dd_real_array *a, const dd_real_array *b,
+    dd_real_array *c, int i) {
+  for (; i <= c->count - width; i += width)
+    store(c, i, add(load(c, i), mul(load(a, i), load(b, i))));
+  zero_upper();
+  generic::dd_fma_n(a, b, c, i);
+}
+
+QD_SIMD_TARGET void dd_axpy_n(const dd_real &alpha, const dd_real_array *x,
+    dd_real_array *y, int i) {
+  dd_vec a = set1(alpha);
+  for (; i <= y->count - width; i += width)
+    store(y, i, add(load(y, i), mul(a, load(x, i))));
+  zero_upper();
+  generic::dd_axpy_n(alpha, x, y, i);
+}
+
+QD_SIMD_TARGET void dd_sqr_n(const dd_real_array *a, dd_real_array *b,
+    int i) {
+  for (; i <= b->count - width; i += width)
+    store(b, i, sqr(load(a, i)));
+  zero_upper();
+  generic::dd_sqr_n(a, b, i);
+}
+
+QD_SIMD_TARGET void dd_exp_n(const dd_real_array *a, dd_real_array *b,
+    int i) {
+  for (; i <= b->count - width; i += width)
+    store(b, i, exp(load(a, i)));
+  if (i < b->count)
+    store_partial(b, i, b->count - i, exp(load_partial(a, i, b->count - i)));
+  zero_upper();
+}
+
+QD_SIMD_TARGET void dd_log_n(const dd_real_array *a, dd_real_array *b,
+    int i) {
+  for (; i <= b->count - width; i += width)
+    store(b, i, log(load(a, i)));
+  if (i < b->count)
+    store_partial(b, i, b->count - i, log(load_partial(a, i, b->count - i)));
+  zero_upper();
+}
+
+QD_SIMD_TARGET void dd_sincos_n(const dd_real_array *a, dd_real_array *s,
+    dd_real_array *c, int i) {
+  dd_vec sin_a, cos_a;
+  for (; i <= s->count - width; i += width) {
+    sincos(load(a, i), sin_a, cos_a);
+    store(s, i, sin_a);
+    store(c, i, cos_a);
+  }
+  if (i < s->count) {
+    sincos(load_partial(a, i, s->count - i), sin_a, cos_a);
+    store_partial(s, i, s->count - i, sin_a);
+    store_partial(c, i, s->count - i, cos_a);
+  }
+  zero_upper();
+}
+
+QD_SIMD_TARGET void dd_atan2_n(const dd_real_array *a, const dd_real_array *b,
+    dd_real_array *c, int i) {
+  for (; i <= c->count - width; i += width)
+    store(c, i, atan2(load(a, i), load(b, i)));
+  zero_upper();
+  generic::dd_atan2_n(a, b, c, i);
+}
+
+/* One polynomial at many points, and many polynomials at one point */
+QD_SIMD_TARGET void dd_polyeval_n(const dd_real *c, int n,
+    const dd_real_array *x, dd_real_array *y, int i) {
+  if (n >= 0) {
+    dd_coef_bcast coef = { c };
+    for (; i <= y->count - width; i += width)
+      store(y, i, polyeval(coef, n, load(x, i)));
+  }
+  zero_upper();
+  generic::dd_polyeval_n(c, n, x, y, i);
+}
+
+QD_SIMD_TARGET void dd_polyeval_set_n(const dd_real_array *c, int n,
+    const dd_real &x, dd_real_array *y, int i) {
+  if (n >= 0) {
+    dd_vec xv = set1(x);
+    for (; i <= y->count - width; i += width) {
+      dd_coef_load coef = { c, i };
+      store(y, i, polyeval(coef, n, xv));
+    }
+  }
+  zero_upper();
+  generic::dd_polyeval_set_n(c, n, x, y, i);
+}
+
+/* Compensated sums and dot products. The accumulators (see dd_acc in
+   dd_batch.cpp) are kept in dd_acc_count / width vectors, so that element
+   j is added to the same accumulator as in the scalar versions. */
+const int acc_vecs = dd_acc_count / width;
+
+QD_SIMD_TARGET inline void load_acc(const double *acc, vec *x) {
+  for (int k = 0; k < acc_vecs; k++)
+    x[k] = load(acc + k * width);
+}
+
+QD_SIMD_TARGET inline void store_acc(double *acc, const vec *x) {
+  for (int k = 0; k < acc_vecs; k++)
+    store(acc + k * width, x[k]);
+}
+
+QD_SIMD_TARGET void dd_sum_d(const double *a, int n, dd_acc *acc, int i) {
+  vec s[acc_vecs], c[acc_vecs];
+  load_acc(acc->s, s);
+  load_acc(acc->c, c);
+  for (; i <= n - dd_acc_count; i += dd_acc_count) {
+    for (int k = 0; k < acc_vecs; k++) {
+      vec e;
+      s[k] = two_sum(s[k], load(a + i + k * width), e);
+      c[k] += e;
+    }
+  }
+  store_acc(acc->s, s);
+  store_acc(acc->c, c);
+  zero_upper();
+  generic::dd_sum_d(a, n, acc, i);
+}
+
+QD_SIMD_TARGET void dd_dot_d(const double *a, const double *b, int n,
+    dd_acc *acc, int i) {
+  vec s[acc_vecs], c[acc_vecs];
+  load_acc(acc->s, s);
+  load_acc(acc->c, c);
+  for (; i <= n - dd_acc_count; i += dd_acc_count) {
+    for (int k = 0; k < acc_vecs; k++) {
+      int j = i + k * width;
+      vec p, e, f;
+      p = two_prod(load(a + j), load(b + j), e);
+      s[k] = two_sum(s[k], p, f);
+      c[k] += e + f;
+    }
+  }
+  store_acc(acc->s, s);
+  store_acc(acc->c, c);
+  zero_upper();
+  generic::dd_dot_d(a, b, n, acc, i);
+}
+
+QD_SIMD_TARGET void dd_dot_dd(const dd_real_array *a, const dd_real_array *b,
+    dd_acc *acc, int i) {
+  vec s[acc_vecs], c[acc_vecs];
+  load_acc(acc->s, s);
+  load_acc(acc->c, c);
+  for (; i <= a->count - dd_acc_count; i += dd_acc_count) {
+    for (int k = 0; k < acc_vecs; k++) {
+      dd_vec x = load(a, i + k * width), y = load(b, i + k * width);
+      vec p, e, f;
+      p = two_prod(x.x[0], y.x[0], e);
+      e += x.x[0] * y.x[1] + x.x[1] * y.x[0];
+      s[k] = two_sum(s[k], p, f);
+      c[k] += e + f;
+    }
+  }
+  store_acc(acc->s, s);
+  store_acc(acc->c, c);
+  zero_upper();
+  generic::dd_dot_dd(a, b, acc, i);
+}
+
+/* Array-of-structures to structure-of-arrays and back */
+QD_SIMD_TARGET void dd_to_soa_n(const dd_real *a, dd_real_array *b, int i) {
+  for (; i <= b->count - width; i += width) {
+    vec x0, x1;
+    deinterleave2(a[i].x, x0, x1);
+    store(b->x[0] + i, x0);
+    store(b->x[1] + i, x1);
+  }
+  zero_upper();
+  generic::dd_to_soa_n(a, b, i);
+}
+
+QD_SIMD_TARGET void dd_to_aos_n(const dd_real_array *a, dd_real *b, int i) {
+  for (; i <= a->count - width; i += width)
+    interleave2(b[i].x, load(a->x[0] + i), load(a->x[1] + i));
+  zero_upper();
+  generic::dd_to_aos_n(a, b, i);
+}
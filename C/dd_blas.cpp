@@ -0,0 +1,279 @@
+/*
+ * dd_blas.cpp
+ *
+ * Double-double matrix products (see c_blas.h).
+ *
+ * Like the batch kernels, the kernels are compiled for SSE2, AVX2 and
+ * AVX-512 on Intel, and the widest version supported by the CPU is
+ * selected on first use. On other CPUs, the scalar versions in qd::generic
+ * are used. The kernels for the rows of c_dd_gemv are the dot product
+ * kernels in dd_batch.h, so this file must be included after dd_batch.cpp
+ * (see c_dd.cpp).
+ *
+ * The work buffer of c_dd_gemm holds the packed block of a (dd_gemm_tile
+ * rows and dd_gemm_depth columns), the packed block of b (dd_gemm_depth
+ * rows and dd_gemm_tile columns), and the accumulators of the tile (s for
+ * the sums of the leading parts, e for the errors). The blocks are packed
+ * in panels of dd_gemm_mr rows of a and dd_gemm_nr columns of b, with the
+ * leading parts and the trailing parts of each column (row) of a panel in
+ * consecutive doubles. Rows and columns past the end of the matrices are
+ * packed as zeros.
+ *
+ * The errors e grow with the number of products, and so do their own
+ * rounding errors. So every dd_blas_renorm products, the kernels move
+ * them into the sums with two_sum (s + e = s' + e' exactly). This is
+ * about as accurate as adding the products to double-doubles one by one,
+ * and much cheaper than renormalizing after every product.
+ */
+#include "qd_config.h"
+#include "dd_real.h"
+#include "c_dd.h"
+#include "c_blas.h"
+#include "qd_cpu.h"
+#include "simd.h"
+
+enum {
+  dd_gemm_mr = 4,                    /* rows of a block of the kernels */
+  dd_gemm_tile = QD_DD_GEMM_TILE,
+  dd_gemm_depth = 128,               /* columns of a packed at once */
+  dd_gemv_rows = 8,                  /* rows of a gemv_cols kernel */
+  dd_blas_renorm = 16                /* products between renormalizations */
+};
+
+namespace qd {
+namespace generic {
+
+const int dd_gemm_nr = 1;
+
+/* Adds the products of kc columns of a packed panel of a and kc rows of a
+   packed panel of b to the accumulators of a block of dd_gemm_mr x
+   dd_gemm_nr elements. Row r of the block is at s[r * ld] (e[r * ld]).
+   If first is true, the accumulators start at zero. kc is a multiple of
+   dd_blas_renorm, except in the last block of a row. */
+void dd_gemm_block(const double *a, const double *b, int kc, double *s,
+    double *e, int ld, bool first) {
+  for (int r = 0; r < dd_gemm_mr; r++) {
+    double sr = first ? 0.0 : s[r * ld], er = first ? 0.0 : e[r * ld];
+    for (int k = 0; k < kc; k++) {
+      double a0 = a[k * 2 * dd_gemm_mr + r];
+      double a1 = a[k * 2 * dd_gemm_mr + dd_gemm_mr + r];
+      double b0 = b[k * 2], b1 = b[k * 2 + 1];
+      double p, q, f;
+      p = two_prod(a0, b0, q);
+      q += a0 * b1 + a1 * b0;
+      sr = two_sum(sr, p, f);
+      er += q + f;
+      if ((k & (dd_blas_renorm - 1)) == dd_blas_renorm - 1)
+        sr = two_sum(sr, er, er);
+    }
+    s[r * ld] = sr;
+    e[r * ld] = er;
+  }
+}
+
+/* Accumulates a(i, j) * x[j] over all columns j, for rows row .. row + n - 1
+   (n <= dd_gemv_rows) of a */
+void dd_gemv_cols(const dd_matrix *a, const dd_matrix *x, int row, int n,
+    double *s, double *e) {
+  for (int r = 0; r < n; r++) {
+    const double *a0 = a->x[0] + (row + r) * a->row_stride;
+    const double *a1 = a->x[1] + (row + r) * a->row_stride;
+    double sr = 0.0, er = 0.0;
+    for (int j = 0; j < a->cols; j++) {
+      double x0 = x->x[0][j * x->row_stride], x1 = x->x[1][j * x->row_stride];
+      double p, q, f;
+      p = two_prod(a0[j * a->col_stride], x0, q);
+      q += a0[j * a->col_stride] * x1 + a1[j * a->col_stride] * x0;
+      sr = two_sum(sr, p, f);
+      er += q + f;
+      if ((j & (dd_blas_renorm - 1)) == dd_blas_renorm - 1)
+        sr = two_sum(sr, er, er);
+    }
+    s[r] = sr;
+    e[r] = er;
+  }
+}
+
+}
+}
+
+#ifdef QD_FMA_DISPATCH
+
+namespace qd {
+namespace sse2 {
+#define QD_SIMD_TARGET QD_TARGET_SSE2
+#include "dd_blas.h"
+#undef QD_SIMD_TARGET
+}
+
+namespace avx2 {
+#define QD_SIMD_TARGET QD_TARGET_AVX2
+#include "dd_blas.h"
+#undef QD_SIMD_TARGET
+}
+
+namespace avx512 {
+#define QD_SIMD_TARGET QD_TARGET_AVX512
+#include "dd_blas.h"
+#undef QD_SIMD_TARGET
+}
+}
+
+#endif /* QD_FMA_DISPATCH */
+
+/* Matrix product kernels for a specific instruction set. */
+struct dd_blas_kernels {
+  int nr;                /* columns of a block of gemm_block */
+  void (*gemm_block)(const double *, const double *, int, double *, double *, int, bool);
+  void (*gemv_cols)(const dd_matrix *, const dd_matrix *, int, int, double *, double *);
+  void (*dot_dd)(const dd_real_array *, const dd_real_array *, dd_acc *, int);
+};
+
+#define QD_DD_BLAS_KERNELS(ns) { ns::dd_gemm_nr, ns::dd_gemm_block, \
+  ns::dd_gemv_cols, ns::dd_dot_dd }
+
+#ifdef QD_FMA_DISPATCH
+static const dd_blas_kernels dd_blas_sse2 = QD_DD_BLAS_KERNELS(qd::sse2);
+static const dd_blas_kernels dd_blas_avx2 = QD_DD_BLAS_KERNELS(qd::avx2);
+static const dd_blas_kernels dd_blas_avx512 = QD_DD_BLAS_KERNELS(qd::avx512);
+#else
+static const dd_blas_kernels dd_blas_generic = QD_DD_BLAS_KERNELS(qd::generic);
+#endif
+
+/* Returns the fastest matrix product kernels for this CPU. */
+static const dd_blas_kernels *dd_blas_select(int cpu_features) {
+#ifdef QD_FMA_DISPATCH
+  if (cpu_features & qd::cpu_avx512)
+    return &dd_blas_avx512;
+  if (cpu_features & qd::cpu_avx2)
+    return &dd_blas_avx2;
+  return &dd_blas_sse2;
+#else
+  return &dd_blas_generic;
+#endif
+}
+
+/* Packs rows i0 .. i0 + m - 1 and columns k0 .. k0 + kc - 1 of a */
+static void dd_gemm_pack_a(const dd_matrix *a, int i0, int m, int k0, int kc,
+    double *p) {
+  for (int i = 0; i < m; i += dd_gemm_mr)
+    for (int k = 0; k < kc; k++, p += 2 * dd_gemm_mr)
+      for (int r = 0; r < dd_gemm_mr; r++) {
+        int index = (i0 + i + r) * a->row_stride + (k0 + k) * a->col_stride;
+        bool inside = i + r < m;
+        p[r] = inside ? a->x[0][index] : 0.0;
+        p[dd_gemm_mr + r] = inside ? a->x[1][index] : 0.0;
+      }
+}
+
+/* Packs rows k0 .. k0 + kc - 1 and columns j0 .. j0 + n - 1 of b, in panels
+   of nr columns */
+static void dd_gemm_pack_b(const dd_matrix *b, int k0, int kc, int j0, int n,
+    int nr, double *p) {
+  for (int j = 0; j < n; j += nr)
+    for (int k = 0; k < kc; k++, p += 2 * nr)
+      for (int c = 0; c < nr; c++) {
+        int index = (k0 + k) * b->row_stride + (j0 + j + c) * b->col_stride;
+        bool inside = j + c < n;
+        p[c] = inside ? b->x[0][index] : 0.0;
+        p[nr + c] = inside ? b->x[1][index] : 0.0;
+      }
+}
+
+/* x[index] = alpha * sum + beta * x[index] */
+static inline void dd_blas_update(double *const *x, int index,
+    const dd_real &alpha, const dd_real &beta, const dd_real &sum) {
+  dd_real r = alpha * sum;
+  if (!beta.is_zero())
+    r += beta * dd_real(x[0][index], x[1][index]);
+  x[0][index] = r.x[0];
+  x[1][index] = r.x[1];
+}
+
+/* Computes tiles of the product until all tiles have been claimed. Tiles
+   are claimed with an atomic increment of next_tile, like the rows in
+   mp_render_tile. */
+static void dd_gemm_tiles(const dd_blas_kernels *kernels, dd_gemm *g,
+    double *work) {
+  const dd_matrix *a = &g->a, *b = &g->b, *c = &g->c;
+  if (a->rows != c->rows || b->cols != c->cols || a->cols != b->rows)
+    return;
+
+  int m = c->rows, n = c->cols, depth = a->cols, nr = kernels->nr;
+  int tiles_n = (n + dd_gemm_tile - 1) / dd_gemm_tile;
+  int tiles = ((m + dd_gemm_tile - 1) / dd_gemm_tile) * tiles_n;
+  dd_real alpha(g->alpha[0], g->alpha[1]), beta(g->beta[0], g->beta[1]);
+  double *pa = work;
+  double *pb = pa + 2 * dd_gemm_tile * dd_gemm_depth;
+  double *s = pb + 2 * dd_gemm_depth * dd_gemm_tile;
+  double *e = s + dd_gemm_tile * dd_gemm_tile;
+
+  for (;;) {
+    int tile = __atomic_fetch_add(&g->next_tile, 1, __ATOMIC_RELAXED);
+    if (tile >= tiles)
+      return;
+    int i0 = (tile / tiles_n) * dd_gemm_tile, j0 = (tile % tiles_n) * dd_gemm_tile;
+    int mc = m - i0 < dd_gemm_tile ? m - i0 : dd_gemm_tile;
+    int nc = n - j0 < dd_gemm_tile ? n - j0 : dd_gemm_tile;
+
+    for (int k0 = 0; k0 < depth; k0 += dd_gemm_depth) {
+      int kc = depth - k0 < dd_gemm_depth ? depth - k0 : dd_gemm_depth;
+      dd_gemm_pack_a(a, i0, mc, k0, kc, pa);
+      dd_gemm_pack_b(b, k0, kc, j0, nc, nr, pb);
+      for (int i = 0; i < mc; i += dd_gemm_mr)
+        for (int j = 0; j < nc; j += nr)
+          kernels->gemm_block(pa + i * 2 * kc, pb + j * 2 * kc, kc,
+              s + i * dd_gemm_tile + j, e + i * dd_gemm_tile + j,
+              dd_gemm_tile, k0 == 0);
+    }
+
+    for (int i = 0; i < mc; i++)
+      for (int j = 0; j < nc; j++) {
+        int k = i * dd_gemm_tile + j;
+        dd_real sum = depth > 0 ? dd_real(s[k]) + e[k] : dd_real(0.0);
+        dd_blas_update(c->x, (i0 + i) * c->row_stride + (j0 + j) * c->col_stride,
+            alpha, beta, sum);
+      }
+  }
+}
+
+/* Computes tiles of rows of the product until all tiles have been claimed */
+static void dd_gemv_tiles(const dd_blas_kernels *kernels, dd_gemv *g) {
+  const dd_matrix *a = &g->a, *x = &g->x, *y = &g->y;
+  if (x->rows != a->cols || y->rows != a->rows || x->cols != 1 || y->cols != 1)
+    return;
+
+  int m = a->rows;
+  int tiles = (m + QD_GEMV_TILE - 1) / QD_GEMV_TILE;
+  dd_real alpha(g->alpha[0], g->alpha[1]), beta(g->beta[0], g->beta[1]);
+
+  for (;;) {
+    int tile = __atomic_fetch_add(&g->next_tile, 1, __ATOMIC_RELAXED);
+    if (tile >= tiles)
+      return;
+    int i0 = tile * QD_GEMV_TILE;
+    int mc = m - i0 < QD_GEMV_TILE ? m - i0 : QD_GEMV_TILE;
+
+    if (a->col_stride == 1 && x->row_stride == 1) {
+      dd_real_array row, column = { { x->x[0], x->x[1] }, a->cols };
+      row.count = a->cols;
+      for (int i = i0; i < i0 + mc; i++) {
+        row.x[0] = a->x[0] + i * a->row_stride;
+        row.x[1] = a->x[1] + i * a->row_stride;
+        dd_acc acc = { };
+        kernels->dot_dd(&row, &column, &acc, 0);
+        dd_blas_update(y->x, i * y->row_stride, alpha, beta,
+            qd::generic::dd_acc_sum(&acc));
+      }
+    } else {
+      for (int i = i0; i < i0 + mc; i += dd_gemv_rows) {
+        int n = i0 + mc - i < dd_gemv_rows ? i0 + mc - i : dd_gemv_rows;
+        double s[dd_gemv_rows], e[dd_gemv_rows];
+        kernels->gemv_cols(a, x, i, n, s, e);
+        for (int r = 0; r < n; r++)
+          dd_blas_update(y->x, (i + r) * y->row_stride, alpha, beta,
+              dd_real(s[r]) + e[r]);
+      }
+    }
+  }
+}
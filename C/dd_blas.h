@@ -0,0 +1,77 @@
+/*
+ * dd_blas.h
+ *
+ * Double-double matrix product kernels, operating on blocks that are
+ * "width" columns wide. This file is included once for each of the SIMD
+ * namespaces in simd.h (see dd_blas.cpp), after dd_batch.h. The kernels
+ * perform the same operations in the same order as the scalar versions in
+ * qd::generic, so the results are bitwise identical.
+ */
+
+const int dd_gemm_nr = width;
+
+QD_SIMD_TARGET void dd_gemm_block(const double *a, const double *b, int kc,
+    double *s, double *e, int ld, bool first) {
+  vec sv[dd_gemm_mr], ev[dd_gemm_mr];
+  for (int r = 0; r < dd_gemm_mr; r++) {
+    sv[r] = first ? set1(0.0) : load(s + r * ld);
+    ev[r] = first ? set1(0.0) : load(e + r * ld);
+  }
+
+  for (int k = 0; k < kc; k++, a += 2 * dd_gemm_mr, b += 2 * width) {
+    vec b0 = load(b), b1 = load(b + width);
+    for (int r = 0; r < dd_gemm_mr; r++) {
+      vec a0 = set1(a[r]), a1 = set1(a[dd_gemm_mr + r]);
+      vec p, q, f;
+      p = two_prod(a0, b0, q);
+      q += a0 * b1 + a1 * b0;
+      sv[r] = two_sum(sv[r], p, f);
+      ev[r] += q + f;
+    }
+    if ((k & (dd_blas_renorm - 1)) == dd_blas_renorm - 1)
+      for (int r = 0; r < dd_gemm_mr; r++)
+        sv[r] = two_sum(sv[r], ev[r], ev[r]);
+  }
+
+  for (int r = 0; r < dd_gemm_mr; r++) {
+    store(s + r * ld, sv[r]);
+    store(e + r * ld, ev[r]);
+  }
+  zero_upper();
+}
+
+/* Accumulates dd_gemv_rows rows at once, if they are contiguous */
+QD_SIMD_TARGET void dd_gemv_cols(const dd_matrix *a, const dd_matrix *x,
+    int row, int n, double *s, double *e) {
+  if (n < dd_gemv_rows || a->row_stride != 1) {
+    generic::dd_gemv_cols(a, x, row, n, s, e);
+    return;
+  }
+
+  const int vecs = dd_gemv_rows / width;
+  const double *a0 = a->x[0] + row, *a1 = a->x[1] + row;
+  vec sv[vecs], ev[vecs];
+  for (int k = 0; k < vecs; k++)
+    sv[k] = ev[k] = set1(0.0);
+
+  for (int j = 0; j < a->cols; j++, a0 += a->col_stride, a1 += a->col_stride) {
+    vec x0 = set1(x->x[0][j * x->row_stride]), x1 = set1(x->x[1][j * x->row_stride]);
+    for (int k = 0; k < vecs; k++) {
+      vec y0 = load(a0 + k * width), y1 = load(a1 + k * width);
+      vec p, q, f;
+      p = two_prod(y0, x0, q);
+      q += y0 * x1 + y1 * x0;
+      sv[k] = two_sum(sv[k], p, f);
+      ev[k] += q + f;
+    }
+    if ((j & (dd_blas_renorm - 1)) == dd_blas_renorm - 1)
+      for (int k = 0; k < vecs; k++)
+        sv[k] = two_sum(sv[k], ev[k], ev[k]);
+  }
+
+  for (int k = 0; k < vecs; k++) {
+    store(s + k * width, sv[k]);
+    store(e + k * width, ev[k]);
+  }
+  zero_upper();
+}
@@ -327,10 +327,12 @@ inline dd_real dd_real::accurate_div(const dd_real &a, const dd_real &b) {
 
   q1 = a.x[0] / b.x[0];  /* approximate quotient */
 
-  r = a - q1 * b;
+  /* The residuals always use the IEEE addition, so the result does not
+     depend on QD_IEEE_ADD. */
+  r = ieee_add(a, -(q1 * b));
   
   q2 = r.x[0] / b.x[0];
-  r -= (q2 * b);
+  r = ieee_add(r, -(q2 * b));
 
   q3 = r.x[0] / b.x[0];
 
@@ -399,6 +401,122 @@ inline dd_real dd_real::sqr(double a) {
   return dd_real(p1, p2);
 }
 
+#ifdef QD_FMA_DISPATCH
+/*********** FMA Variants ************/
+/* These are identical to the functions above, except that they use
+   two_prod_fma and two_sqr_fma.  */
+QD_FMA_TARGET inline dd_real dd_real::mul_fma(double a, double b) {
+  double p, e;
+  p = qd::two_prod_fma(a, b, e);
+  return dd_real(p, e);
+}
+
+QD_FMA_TARGET inline dd_real mul_fma(const dd_real &a, double b) {
+  double p1, p2;
+
+  p1 = qd::two_prod_fma(a.x[0], b, p2);
+  p2 += (a.x[1] * b);
+  p1 = qd::quick_two_sum(p1, p2, p2);
+  return dd_real(p1, p2);
+}
+
+QD_FMA_TARGET inline dd_real mul_fma(const dd_real &a, const dd_real &b) {
+  double p1, p2;
+
+  p1 = qd::two_prod_fma(a.x[0], b.x[0], p2);
+  p2 += (a.x[0] * b.x[1] + a.x[1] * b.x[0]);
+  p1 = qd::quick_two_sum(p1, p2, p2);
+  return dd_real(p1, p2);
+}
+
+QD_FMA_TARGET inline dd_real dd_real::div_fma(double a, double b) {
+  double q1, q2;
+  double p1, p2;
+  double s, e;
+
+  q1 = a / b;
+  p1 = qd::two_prod_fma(q1, b, p2);
+  s = qd::two_diff(a, p1, e);
+  e -= p2;
+  q2 = (s + e) / b;
+  s = qd::quick_two_sum(q1, q2, e);
+
+  return dd_real(s, e);
+}
+
+QD_FMA_TARGET inline dd_real div_fma(const dd_real &a, double b) {
+  double q1, q2;
+  double p1, p2;
+  double s, e;
+  dd_real r;
+
+  q1 = a.x[0] / b;
+  p1 = qd::two_prod_fma(q1, b, p2);
+  s = qd::two_diff(a.x[0], p1, e);
+  e += a.x[1];
+  e -= p2;
+  q2 = (s + e) / b;
+  r.x[0] = qd::quick_two_sum(q1, q2, r.x[1]);
+
+  return r;
+}
+
+QD_FMA_TARGET inline dd_real dd_real::sloppy_div_fma(const dd_real &a,
+                                                     const dd_real &b) {
+  double s1, s2;
+  double q1, q2;
+  dd_real r;
+
+  q1 = a.x[0] / b.x[0];
+  r = ::mul_fma(b, q1);
+  s1 = qd::two_diff(a.x[0], r.x[0], s2);
+  s2 -= r.x[1];
+  s2 += a.x[1];
+  q2 = (s1 + s2) / b.x[0];
+  r.x[0] = qd::quick_two_sum(q1, q2, r.x[1]);
+  return r;
+}
+
+QD_FMA_TARGET inline dd_real dd_real::accurate_div_fma(const dd_real &a,
+                                                       const dd_real &b) {
+  double q1, q2, q3;
+  dd_real r;
+
+  q1 = a.x[0] / b.x[0];
+  r = ieee_add(a, -::mul_fma(b, q1));
+  q2 = r.x[0] / b.x[0];
+  r = ieee_add(r, -::mul_fma(b, q2));
+  q3 = r.x[0] / b.x[0];
+  q1 = qd::quick_two_sum(q1, q2, q2);
+  r = dd_real(q1, q2) + q3;
+  return r;
+}
+
+QD_FMA_TARGET inline dd_real div_fma(const dd_real &a, const dd_real &b) {
+#ifdef QD_SLOPPY_DIV
+  return dd_real::sloppy_div_fma(a, b);
+#else
+  return dd_real::accurate_div_fma(a, b);
+#endif
+}
+
+QD_FMA_TARGET inline dd_real sqr_fma(const dd_real &a) {
+  double p1, p2;
+  double s1, s2;
+  p1 = qd::two_sqr_fma(a.x[0], p2);
+  p2 += 2.0 * a.x[0] * a.x[1];
+  p2 += a.x[1] * a.x[1];
+  s1 = qd::quick_two_sum(p1, p2, s2);
+  return dd_real(s1, s2);
+}
+
+QD_FMA_TARGET inline dd_real dd_real::sqr_fma(double a) {
+  double p1, p2;
+  p1 = qd::two_sqr_fma(a, p2);
+  return dd_real(p1, p2);
+}
+#endif
+
 
 /********** Exponentiation **********/
 inline dd_real dd_real::operator^(int n) {
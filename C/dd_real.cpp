@@ -13,6 +13,8 @@
 
 #include "qd_config.h"
 #include "dd_real.h"
+#include "qd_decimal.h"
+#include "qd_rem_pio2.cpp"
 
 #ifndef QD_INLINE
 #include "dd_inline.h"
@@ -146,6 +148,111 @@ dd_real pow(const dd_real &a, const dd_real &b) {
   return exp(b * log(a));
 }
 
+namespace qd {
+
+/* Coefficients of a polynomial in an array of dd_real */
+struct dd_coef_ptr {
+  const dd_real *c;
+  dd_real operator()(int k) const { return c[k]; }
+};
+
+/* Evaluates coef(k) + coef(k + 1) x + ... + coef(k + 7) x^7 with Estrin's
+   scheme. x2 and x4 are x^2 and x^4. */
+template <class Coef>
+inline dd_real dd_estrin8(const Coef &coef, int k, const dd_real &x,
+    const dd_real &x2, const dd_real &x4) {
+  dd_real p0 = coef(k) + coef(k + 1) * x;
+  dd_real p1 = coef(k + 2) + coef(k + 3) * x;
+  dd_real p2 = coef(k + 4) + coef(k + 5) * x;
+  dd_real p3 = coef(k + 6) + coef(k + 7) * x;
+  return (p0 + p1 * x2) + (p2 + p3 * x2) * x4;
+}
+
+/* Evaluates coef(0) + coef(1) x + ... + coef(n) x^n. The coefficients are
+   split into blocks of 8, which are evaluated with Estrin's scheme and
+   combined with Horner's method in powers of x^8. Unlike the terms of
+   Horner's method, the blocks do not depend on each other, so their
+   operations can overlap. The leading (n + 1) % 8 coefficients use
+   Horner's method. polyeval in dd_batch.h uses the same operations, so
+   the batch functions give bitwise identical results. */
+template <class Coef>
+inline dd_real dd_polyeval(const Coef &coef, int n, const dd_real &x) {
+  if (n < 0)
+    return 0.0;
+
+  int k = (n + 1) & ~7;  /* coefficients in whole blocks */
+  dd_real r;
+  if (k <= n) {
+    r = coef(n);
+    for (int i = n - 1; i >= k; i--)
+      r = r * x + coef(i);
+    if (k == 0)
+      return r;
+  }
+
+  dd_real x2 = sqr(x);
+  dd_real x4 = sqr(x2);
+  dd_real x8 = sqr(x4);
+  if (k > n) {
+    k -= 8;
+    r = dd_estrin8(coef, k, x, x2, x4);
+  }
+  while (k > 0) {
+    k -= 8;
+    r = r * x8 + dd_estrin8(coef, k, x, x2, x4);
+  }
+  return r;
+}
+
+}
+
+/* Evaluates the polynomial c[0] + c[1] x + ... + c[n] x^n. */
+dd_real polyeval(const dd_real *c, int n, const dd_real &x) {
+  qd::dd_coef_ptr coef = { c };
+  return qd::dd_polyeval(coef, n, x);
+}
+
+/* Finds a root of the polynomial c[0] + c[1] x + ... + c[n] x^n with
+   Newton's method, starting at x0. The iteration stops when the value of
+   the polynomial is less than thresh (or the machine epsilon if thresh is
+   zero) times the largest coefficient. The derivative is evaluated along
+   with the polynomial with Horner's method, so no memory is allocated.
+   Returns NaN if there is no convergence after max_iter iterations. */
+dd_real polyroot(const dd_real *c, int n, 
+    const dd_real &x0, int max_iter, double thresh) {
+  if (n < 0) {
+    dd_real::error("(dd_real::polyroot): Negative degree.");
+    return dd_real::_nan;
+  }
+
+  dd_real x = x0;
+  double max_c = qd_fabs(to_double(c[0]));
+
+  if (thresh == 0.0)
+    thresh = dd_real::_eps;
+  for (int i = 1; i <= n; i++) {
+    double v = qd_fabs(to_double(c[i]));
+    if (v > max_c)
+      max_c = v;
+  }
+  thresh *= max_c;
+
+  for (int i = 0; i < max_iter; i++) {
+    dd_real f = c[n];
+    dd_real d = 0.0;
+    for (int k = n - 1; k >= 0; k--) {
+      d = d * x + f;
+      f = f * x + c[k];
+    }
+    if (abs(f) < thresh)
+      return x;
+    x -= f / d;
+  }
+
+  dd_real::error("(dd_real::polyroot): Failed to converge.");
+  return dd_real::_nan;
+}
+
 static const int n_inv_fact = 15;
 static const double inv_fact[n_inv_fact][2] = {
   { 1.66666666666666657e-01,  9.25185853854297066e-18},
@@ -165,19 +272,161 @@ static const double inv_fact[n_inv_fact][2] = {
   { 2.81145725434552060e-15,  1.65088427308614326e-31}
 };
 
+/* exp2_table1[j] = 2^(j/64) */
+static const double exp2_table1[64][2] = {
+  { 1.00000000000000000e+00,  0.00000000000000000e+00},
+  { 1.01088928605170048e+00, -1.52347786033685772e-17},
+  { 1.02189714865411663e+00,  5.10922502897344389e-17},
+  { 1.03302487902122841e+00,  7.60083887402708849e-18},
+  { 1.04427378242741375e+00,  8.55188970553796489e-17},
+  { 1.05564517836055716e+00,  1.75932573877209198e-18},
+  { 1.06714040067682370e+00, -7.89985396684158212e-17},
+  { 1.07876079775711986e+00, -6.65666043605659260e-17},
+  { 1.09050773266525769e+00, -3.04678207981247115e-17},
+  { 1.10238258330784089e+00,  5.26603687157069439e-17},
+  { 1.11438674259589243e+00,  1.04102784568455710e-16},
+  { 1.12652161860824185e+00,  5.16585675879545674e-17},
+  { 1.13878863475669156e+00,  8.91281267602540778e-17},
+  { 1.15118922995298267e+00,  3.25071021886382721e-17},
+  { 1.16372485877757748e+00,  3.82920483692409350e-17},
+  { 1.17639699165028122e+00,  5.55420325421807896e-17},
+  { 1.18920711500272103e+00,  3.98201523146564611e-17},
+  { 1.20215673145270308e+00,  6.64498149925230124e-17},
+  { 1.21524735998046896e+00, -7.71263069268148813e-17},
+  { 1.22848053610687002e+00, -1.89878163130252995e-17},
+  { 1.24185781207348400e+00,  4.65802759183693679e-17},
+  { 1.25538075702469110e+00, -6.71138982129687842e-18},
+  { 1.26905095719173322e+00,  2.66793213134218610e-18},
+  { 1.28287001607877826e+00,  1.71359491824356097e-17},
+  { 1.29683955465100964e+00,  2.53825027948883150e-17},
+  { 1.31096121152476441e+00, -7.18153613551945386e-17},
+  { 1.32523664315974132e+00, -2.85873121003886137e-17},
+  { 1.33966752405330292e+00,  8.92728259483173198e-17},
+  { 1.35425554693689265e+00,  7.70094837980298946e-17},
+  { 1.36900242297459052e+00,  9.59379791911884877e-17},
+  { 1.38390988196383202e+00, -6.77051165879478629e-17},
+  { 1.39897967253831124e+00, -9.61421320905132307e-17},
+  { 1.41421356237309515e+00, -9.66729331345291345e-17},
+  { 1.42961333839197002e+00, -1.20316424890536552e-17},
+  { 1.44518080697704665e+00, -3.02375813499398732e-17},
+  { 1.46091779418064704e+00, -5.60037718607521580e-17},
+  { 1.47682614593949935e+00, -3.48399455689279580e-17},
+  { 1.49290772829126484e+00,  1.41929201542840358e-17},
+  { 1.50916442759342284e+00, -1.01645532775429504e-16},
+  { 1.52559815074453842e+00, -1.10249417123425609e-16},
+  { 1.54221082540794074e+00,  7.94983480969762086e-17},
+  { 1.55900440023783693e+00,  3.78120705335752750e-17},
+  { 1.57598084510788650e+00, -1.01369164712783040e-17},
+  { 1.59314215134226700e+00, -1.00944065423119637e-16},
+  { 1.61049033194925428e+00,  2.47071925697978879e-17},
+  { 1.62802742185734783e+00, -6.71295508470708409e-17},
+  { 1.64575547815396495e+00, -1.01256799136747726e-16},
+  { 1.66367658032673638e+00,  5.89099269671309967e-17},
+  { 1.68179283050742900e+00,  8.19901002058149652e-17},
+  { 1.70010635371852348e+00, -8.02371937039770025e-18},
+  { 1.71861929812247793e+00, -1.85138041826311099e-17},
+  { 1.73733383527370622e+00,  3.16438929929295695e-17},
+  { 1.75625216037329945e+00,  2.96014069544887331e-17},
+  { 1.77537649252652119e+00,  6.42973179655657203e-17},
+  { 1.79470907500310717e+00,  1.82274584279120868e-17},
+  { 1.81425217550039886e+00, -9.96953153892034882e-17},
+  { 1.83400808640934243e+00,  3.28310722424562720e-17},
+  { 1.85397912508338547e+00,  9.76188749072759354e-17},
+  { 1.87416763411029996e+00, -6.12276341300414256e-17},
+  { 1.89457598158696561e+00,  3.40340353521652967e-17},
+  { 1.91520656139714740e+00, -1.06199460561959626e-16},
+  { 1.93606179349229435e+00,  1.03323859606763257e-16},
+  { 1.95714412417540018e+00,  8.96076779103666777e-17},
+  { 1.97845602638795093e+00,  4.03887531092781666e-17}
+};
+
+/* exp2_table2[j] = 2^(j/4096) */
+static const double exp2_table2[64][2] = {
+  { 1.00000000000000000e+00,  0.00000000000000000e+00},
+  { 1.00016923970530214e+00,  9.33618533547846199e-17},
+  { 1.00033850805268232e+00, -5.14133393131895707e-18},
+  { 1.00050780504698755e+00,  6.96242402202057255e-17},
+  { 1.00067713069306641e+00, -5.11512329768566764e-17},
+  { 1.00084648499576745e+00,  8.42299002458648658e-17},
+  { 1.00101586795994102e+00, -2.82452207477616781e-17},
+  { 1.00118527959043746e+00, -7.18042456559213167e-17},
+  { 1.00135471989210822e+00, -1.89737284167929934e-17},
+  { 1.00152418886980565e+00,  9.06044106726912173e-17},
+  { 1.00169368652838320e+00, -7.17327634990031998e-17},
+  { 1.00186321287269431e+00, -1.33071962467226607e-17},
+  { 1.00203276790759399e+00,  2.57269259432211180e-17},
+  { 1.00220235163793792e+00, -3.92993778548451721e-17},
+  { 1.00237196406858220e+00,  8.46137724799471750e-17},
+  { 1.00254160520438451e+00, -4.19488324163994025e-17},
+  { 1.00271127505020252e+00, -3.63661592869226394e-17},
+  { 1.00288097361089523e+00, -2.61094406324393831e-17},
+  { 1.00305070089132231e+00,  1.75307847798233211e-17},
+  { 1.00322045689634431e+00,  5.75392352562826744e-17},
+  { 1.00339024163082269e+00, -8.68492200511795617e-18},
+  { 1.00356005509961932e+00,  9.49003543098177759e-17},
+  { 1.00372989730759765e+00, -8.71038060581842237e-17},
+  { 1.00389976825962091e+00,  3.49589169585715450e-17},
+  { 1.00406966796055408e+00,  9.75378754984024100e-17},
+  { 1.00423959641526284e+00, -1.05762211962928569e-16},
+  { 1.00440955362861284e+00,  4.20918873812712593e-17},
+  { 1.00457953960547175e+00, -1.67001668575547876e-17},
+  { 1.00474955435070723e+00, -1.62314635541245144e-17},
+  { 1.00491959786918805e+00,  2.30285392780281171e-17},
+  { 1.00508967016578388e+00,  1.64180469767730324e-17},
+  { 1.00525977124536503e+00,  3.72669843182841367e-17},
+  { 1.00542990111280273e+00,  9.49918653545503176e-17},
+  { 1.00560005977296929e+00, -8.68093131444458157e-17},
+  { 1.00577024723073705e+00,  4.00054749103011688e-17},
+  { 1.00594046349098010e+00,  7.19049911150997400e-17},
+  { 1.00611070855857299e+00, -1.39080686710657830e-17},
+  { 1.00628098243839093e+00, -8.14020864257304965e-17},
+  { 1.00645128513531001e+00, -5.76215104374953425e-17},
+  { 1.00662161665420724e+00,  6.74527847731045680e-17},
+  { 1.00679197699996070e+00,  1.89985572403462958e-17},
+  { 1.00696236617744894e+00, -9.63743003231640716e-17},
+  { 1.00713278419155117e+00, -1.25286544624539789e-17},
+  { 1.00730323104714792e+00,  3.02057888784369419e-17},
+  { 1.00747370674912040e+00, -4.86939425860856491e-17},
+  { 1.00764421130235027e+00,  5.22402993768745317e-17},
+  { 1.00781474471172072e+00, -9.36154355147845591e-17},
+  { 1.00798530698211497e+00, -8.65251323306194957e-17},
+  { 1.00815589811841755e+00, -3.25205875608430806e-17},
+  { 1.00832651812551388e+00, -9.91723226806091428e-17},
+  { 1.00849716700828984e+00, -7.13604740416252277e-17},
+  { 1.00866784477163240e+00, -1.72686837122432199e-17},
+  { 1.00883855142042944e+00, -6.61995469367394011e-17},
+  { 1.00900928695956926e+00,  3.56545690151302038e-17},
+  { 1.00918005139394151e+00,  3.71731001370881786e-17},
+  { 1.00935084472843628e+00,  7.06257240682552768e-17},
+  { 1.00952166696794476e+00, -1.43214123034288193e-17},
+  { 1.00969251811735861e+00,  1.56681880131341096e-17},
+  { 1.00986339818157078e+00, -1.10436957803936884e-16},
+  { 1.01003430716547449e+00, -5.76731742716039802e-17},
+  { 1.01020524507396425e+00,  4.83548497844038274e-18},
+  { 1.01037621191193527e+00,  7.01512128971544210e-17},
+  { 1.01054720768428363e+00,  7.16180287361957384e-17},
+  { 1.01071823239590608e+00,  1.05046591340840500e-16}
+};
+
+/* 4096/log(2), and exp_ln2_hi + exp_ln2_lo = log(2)/4096, where exp_ln2_hi
+   has 30 significant bits */
+static const double exp_inv_ln2 = 5.90927888748119403e+03;
+static const double exp_ln2_hi = 1.69225385661775363e-04;
+static const double exp_ln2_lo[2] = {
+  2.17117535129069265e-13, -9.78675807011760187e-30
+};
+
 /* Exponential.  Computes exp(x) in double-double precision. */
 dd_real exp(const dd_real &a) {
-  /* Strategy:  We first reduce the size of x by noting that
-     
-          exp(kr + m * log(2)) = 2^m * exp(r)^k
+  /* Strategy:  We write a = (4096 m + 64 j1 + j2) * log(2)/4096 + r, where
+     m, j1 and j2 are integers with 0 <= j1, j2 < 64, so that
 
-     where m and k are integers.  By choosing m appropriately
-     we can make |kr| <= log(2) / 2 = 0.347.  Then exp(r) is 
-     evaluated using the familiar Taylor series.  Reducing the 
-     argument substantially speeds up the convergence.       */  
+          exp(a) = 2^m * 2^(j1/64) * 2^(j2/4096) * exp(r)
 
-  const double k = 512.0;
-  const double inv_k = 1.0 / k;
+     with |r| <= log(2)/8192 = 8.5e-5.  The powers of two are looked up in
+     exp2_table1 and exp2_table2, and exp(r) - 1 is evaluated with the
+     Taylor series up to r^7.  Since r is so small, only the first few terms
+     need double-double arithmetic.                                         */
 
   if (a.x[0] <= -709.0)
     return 0.0;
@@ -191,56 +440,211 @@ dd_real exp(const dd_real &a) {
   if (a.is_one())
     return dd_real::_e;
 
-  double m = qd_floor(a.x[0] / dd_real::_log2.x[0] + 0.5);
-  dd_real r = mul_pwr2(a - dd_real::_log2 * m, inv_k);
-  dd_real s, t, p;
+  if (a.isnan())
+    return dd_real::_nan;
 
-  p = sqr(r);
-  s = r + mul_pwr2(p, 0.5);
-  p *= r;
-  t = p * dd_real(inv_fact[0][0], inv_fact[0][1]);
-  int i = 0;
-  do {
-    s += t;
-    p *= r;
-    ++i;
-    t = p * dd_real(inv_fact[i][0], inv_fact[i][1]);
-  } while (qd_fabs(to_double(t)) > inv_k * dd_real::_eps && i < 5);
-
-  s += t;
-
-  s = mul_pwr2(s, 2.0) + sqr(s);
-  s = mul_pwr2(s, 2.0) + sqr(s);
-  s = mul_pwr2(s, 2.0) + sqr(s);
-  s = mul_pwr2(s, 2.0) + sqr(s);
-  s = mul_pwr2(s, 2.0) + sqr(s);
-  s = mul_pwr2(s, 2.0) + sqr(s);
-  s = mul_pwr2(s, 2.0) + sqr(s);
-  s = mul_pwr2(s, 2.0) + sqr(s);
-  s = mul_pwr2(s, 2.0) + sqr(s);
-  s += 1.0;
+  double k = qd_floor(a.x[0] * exp_inv_ln2 + 0.5);
+  double m = qd_floor(k * (1.0 / 4096.0));
+  int j = static_cast<int>(k - m * 4096.0);
+
+  /* k * exp_ln2_hi is exact, since |k| < 2^22 */
+  dd_real r = (a - k * exp_ln2_hi) - dd_real(exp_ln2_lo[0], exp_ln2_lo[1]) * k;
+  double c, r0 = r.x[0];
+  dd_real p, s;
+
+  /* exp(r) - 1 = r + r^2 (1/2 + r (1/6 + r c)) */
+  c = inv_fact[1][0] + r0 * (inv_fact[2][0] + r0 * (inv_fact[3][0] +
+      r0 * inv_fact[4][0]));
+  p = dd_real(inv_fact[0][0], inv_fact[0][1]) + r0 * c;
+  p = r * p + 0.5;
+  p = r + sqr(r) * p;
+
+  s = dd_real(exp2_table1[j >> 6][0], exp2_table1[j >> 6][1]) *
+      dd_real(exp2_table2[j & 63][0], exp2_table2[j & 63][1]);
+  s = s + s * p;
 
   return ldexp(s, static_cast<int>(m));
 }
 
+/* inv_odd[i] = 1/(2i + 3) */
+static const int n_inv_odd = 15;
+static const double inv_odd[n_inv_odd][2] = {
+  { 3.33333333333333315e-01,  1.85037170770859413e-17},
+  { 2.00000000000000011e-01, -1.11022302462515660e-17},
+  { 1.42857142857142849e-01,  7.93016446160826056e-18},
+  { 1.11111111111111105e-01,  6.16790569236198044e-18},
+  { 9.09090909090909116e-02, -2.52323414687535584e-18},
+  { 7.69230769230769273e-02, -4.27008855625060232e-18},
+  { 6.66666666666666657e-02,  9.25185853854297104e-19},
+  { 5.88235294117647051e-02,  8.16340459283203327e-19},
+  { 5.26315789473684181e-02,  2.92163953848725389e-18},
+  { 4.76190476190476164e-02,  2.64338815386942019e-18},
+  { 4.34782608695652162e-02,  1.20676415720125708e-18},
+  { 4.00000000000000008e-02, -8.32667268468867375e-19},
+  { 3.70370370370370350e-02,  2.05596856412066015e-18},
+  { 3.44827586206896547e-02,  4.78544407166015744e-19},
+  { 3.22580645161290314e-02,  8.95341148891255250e-19}
+};
+
+/* log_table1[i] = log((i + 48)/64) */
+static const double log_table1[49][2] = {
+  {-2.87682072451780901e-01, -2.60716061644256398e-17},
+  {-2.67062785249045254e-01,  7.32891532732016949e-18},
+  {-2.46860077931525784e-01, -1.36174337174836802e-17},
+  {-2.27057450635346075e-01, -9.55141576273848843e-18},
+  {-2.07639364778244490e-01, -1.20532432166861289e-17},
+  {-1.88591169807550030e-01,  7.43216421919692505e-18},
+  {-1.69899036795397473e-01,  4.86800876443907079e-19},
+  {-1.51549898127200933e-01, -5.16695936846155944e-18},
+  {-1.33531392624522627e-01,  3.66445766366008474e-18},
+  {-1.15831815525121701e-01, -4.33848436980809596e-18},
+  {-9.84400728132525243e-02,  4.43900963367513588e-18},
+  {-8.13456394539524008e-02, -5.07707635593116993e-18},
+  {-6.45385211375711781e-02,  6.47048666169293300e-18},
+  {-4.80092191863606063e-02, -1.43909033472922047e-18},
+  {-3.17486983145802981e-02, -3.03822630846808579e-18},
+  {-1.57483569681391676e-02, -1.00215786305289737e-18},
+  { 0.00000000000000000e+00,  0.00000000000000000e+00},
+  { 1.55041865359652545e-02, -3.27832102289242913e-19},
+  { 3.07716586667536873e-02,  1.04317320290059678e-18},
+  { 4.58095360312942013e-02,  1.90295986647425706e-18},
+  { 6.06246218164348399e-02,  2.64240259387269342e-18},
+  { 7.52234212375875316e-02, -5.93060419629324072e-18},
+  { 8.96121586896871380e-02, -5.42681293366471353e-18},
+  { 1.03796793681643559e-01,  5.47772415726659013e-18},
+  { 1.17783035656383456e-01, -1.19716857475936773e-18},
+  { 1.31576357788719261e-01,  1.11230008797295880e-17},
+  { 1.45182009844497889e-01,  8.24241878302247539e-18},
+  { 1.58605030176638573e-01,  1.12570038721825922e-17},
+  { 1.71850256926659228e-01, -6.02245382101137048e-18},
+  { 1.84922338494011990e-01,  3.02366141535740643e-18},
+  { 1.97825743329919868e-01,  1.28211943729801419e-17},
+  { 2.10564769107349642e-01, -4.24940531472989533e-18},
+  { 2.23143551314209765e-01, -9.09127059732479905e-18},
+  { 2.35566071312766911e-01, -2.39433714951873546e-18},
+  { 2.47836163904581269e-01, -1.24322095787025232e-17},
+  { 2.59957524436926046e-01,  2.06980693897893503e-17},
+  { 2.71933715483641758e-01,  7.83319637697442012e-19},
+  { 2.83768173130644619e-01, -2.03266558112665612e-17},
+  { 2.95464212893835898e-01, -2.16461086040598997e-17},
+  { 3.07025035294911874e-01, -1.23199162001019643e-17},
+  { 3.18453731118534589e-01,  2.71147793673262360e-17},
+  { 3.29753286372467980e-01,  2.12202061619694602e-18},
+  { 3.40926586970593193e-01,  1.74671364435447471e-17},
+  { 3.51976423157178198e-01, -1.29538930301919629e-17},
+  { 3.62905493689368475e-01, -2.14923614553109720e-17},
+  { 3.73716409793584059e-01,  2.18362112811981843e-17},
+  { 3.84411698910332056e-01, -1.61214970076467292e-17},
+  { 3.94993808240868993e-01, -1.51137244183361680e-17},
+  { 4.05465108108164385e-01, -2.88113802596264264e-18}
+};
+
+/* log_table2[j] = log(1 + (j - 43)/4096) */
+static const double log_table2[87][2] = {
+  {-1.05535400910351639e-02, -7.25941568955685737e-19},
+  {-1.03068397073983672e-02, -4.15318605037396561e-19},
+  {-1.00602001698304171e-02, -6.99930610388006035e-20},
+  {-9.81362144832462202e-03,  7.67951156294011725e-19},
+  {-9.56710351289647917e-03, -1.59233596916934183e-19},
+  {-9.32064633358366083e-03,  1.74334655630909496e-19},
+  {-9.07424988044598299e-03,  7.03273931262190493e-19},
+  {-8.82791412356538803e-03,  7.46920175987228859e-19},
+  {-8.58163903304592218e-03, -7.45733849720802199e-19},
+  {-8.33542457901371818e-03, -7.73762132676292010e-19},
+  {-8.08927073161696576e-03, -3.18865459328876563e-20},
+  {-7.84317746102589260e-03, -2.76470815412490379e-19},
+  {-7.59714473743274693e-03,  1.64947995953690743e-20},
+  {-7.35117253105177070e-03,  4.25754943905035243e-19},
+  {-7.10526081211917959e-03,  2.71409101480605997e-19},
+  {-6.85940955089314307e-03,  2.74935414239585585e-19},
+  {-6.61361871765376013e-03, -1.44151082837087378e-19},
+  {-6.36788828270304016e-03, -3.93987537392698576e-19},
+  {-6.12221821636488046e-03,  2.68022041624835466e-19},
+  {-5.87660848898504187e-03, -4.75710012466222170e-20},
+  {-5.63105907093113325e-03,  2.17894955518924119e-21},
+  {-5.38556993259258539e-03,  4.22348051636940245e-19},
+  {-5.14014104438062936e-03, -3.79635005375019904e-19},
+  {-4.89477237672828087e-03,  1.91480938067756941e-19},
+  {-4.64946390009030996e-03, -6.71556280062807567e-20},
+  {-4.40421558494322792e-03,  1.78603825731136695e-19},
+  {-4.15902740178526048e-03,  2.31054411158582917e-19},
+  {-3.91389932113632866e-03, -4.28089862306812556e-19},
+  {-3.66883131353802974e-03,  4.74847786934895450e-20},
+  {-3.42382334955360990e-03, -2.12116865935615057e-19},
+  {-3.17887539976794992e-03,  1.10603559691361961e-19},
+  {-2.93398743478753832e-03, -1.78581282679738599e-19},
+  {-2.68915942524045482e-03, -1.02341239659220654e-19},
+  {-2.44439134177634569e-03, -9.43423178917747073e-20},
+  {-2.19968315506640462e-03,  3.01886627508348795e-20},
+  {-1.95503483580335060e-03,  4.23089975868117194e-20},
+  {-1.71044635470140758e-03, -2.38579359016768071e-20},
+  {-1.46591768249628319e-03, -8.74510533618092990e-20},
+  {-1.22144878994514768e-03, -4.60703402474547451e-20},
+  {-9.77039647826612742e-04, -4.34891950935811583e-20},
+  {-7.32690226940710941e-04, -4.06074485988407647e-21},
+  {-4.88400498108874513e-04,  4.83364011033017519e-20},
+  {-2.44170432173914482e-04,  2.52627502647402595e-20},
+  { 0.00000000000000000e+00,  0.00000000000000000e+00},
+  { 2.44110827527362707e-04,  1.77171796530404887e-21},
+  { 4.88162079501351187e-04,  1.35619766115681169e-21},
+  { 7.32153784993847521e-04, -4.73965273886891506e-20},
+  { 9.76085973055458925e-04, -2.87911565340967140e-20},
+  { 1.21995867271553881e-03,  2.73637967322885053e-20},
+  { 1.46377191298220741e-03,  4.67881719509121933e-20},
+  { 1.70752572284237243e-03, -4.06053447156312446e-20},
+  { 1.95122013126174934e-03,  1.02198352357159588e-19},
+  { 2.19485516718488302e-03,  1.87574730904519332e-19},
+  { 2.43843085953516754e-03,  1.97929480221573571e-19},
+  { 2.68194723721486717e-03, -4.57894805082501185e-20},
+  { 2.92540432910513588e-03,  1.77224490363642349e-19},
+  { 3.16880216406604034e-03,  5.44643647432984855e-20},
+  { 3.41214077093657774e-03, -1.38978902986614071e-20},
+  { 3.65542017853469781e-03, -3.07962086256581250e-20},
+  { 3.89864041565732289e-03,  1.25416590383049728e-19},
+  { 4.14180151108036864e-03,  3.36398021396031531e-19},
+  { 4.38490349355876493e-03, -1.45614591485570386e-19},
+  { 4.62794639182647315e-03,  3.57388820338121514e-19},
+  { 4.87093023459651223e-03,  3.05979323121979191e-19},
+  { 5.11385505056097429e-03, -3.16333083527133018e-19},
+  { 5.35672086839104455e-03,  3.75754673069286935e-19},
+  { 5.59952771673702821e-03, -4.15380125578459267e-19},
+  { 5.84227562422836091e-03, -2.99774986840257440e-19},
+  { 6.08496461947363732e-03, -6.85749739498745228e-20},
+  { 6.32759473106062759e-03,  5.57674101250218903e-20},
+  { 6.57016598755629823e-03, -1.92052037888950597e-19},
+  { 6.81267841750683115e-03, -2.15099916705227399e-20},
+  { 7.05513204943764623e-03,  1.85123378022074868e-20},
+  { 7.29752691185341952e-03, -4.31229393509403542e-20},
+  { 7.53986303323810406e-03, -3.09140992297371426e-19},
+  { 7.78214044205494896e-03, -1.28191791233438450e-20},
+  { 8.02435916674652111e-03,  8.56640443816977447e-19},
+  { 8.26651923573472683e-03, -9.55484337350411144e-20},
+  { 8.50862067742082402e-03,  1.97311419580425625e-19},
+  { 8.75066352018545254e-03, -1.08344472404459438e-19},
+  { 8.99264779238864720e-03, -8.15034169533909709e-19},
+  { 9.23457352236985857e-03, -5.63323119544618154e-19},
+  { 9.47644073844797555e-03,  5.30247316740690789e-19},
+  { 9.71824946892134618e-03, -5.41214469458391938e-20},
+  { 9.95999974206778979e-03,  4.82809504725551005e-19},
+  { 1.02016915861446265e-02,  6.10370079051234250e-19},
+  { 1.04433250293886910e-02,  4.07574277155848148e-19}
+};
+
 /* Logarithm.  Computes log(x) in double-double precision.
    This is a natural logarithm (i.e., base e).            */
 dd_real log(const dd_real &a) {
-  /* Strategy.  The Taylor series for log converges much more
-     slowly than that of exp, due to the lack of the factorial
-     term in the denominator.  Hence this routine instead tries
-     to determine the root of the function
+  /* Strategy:  We write a = 2^e * m with 0.75 <= m < 1.5, and approximate
+     m by y = i/64 * (1 + j/4096), where i and j are integers, so that
 
-         f(x) = exp(x) - a
+          log(a) = e log(2) + log(i/64) + log(1 + j/4096) + log(m/y).
 
-     using Newton iteration.  The iteration is given by
+     The two logarithms are looked up in log_table1 and log_table2.  Since
+     |m/y - 1| < 1.3e-4, the series
 
-         x' = x - f(x)/f'(x) 
-            = x - (1 - a * exp(-x))
-            = x + a * exp(-x) - 1.
-           
-     Only one iteration is needed, since Newton's iteration
-     approximately doubles the number of digits per iteration. */
+          log(m/y) = 2 atanh(u) = 2 (u + u^3/3 + u^5/5 + ...),
+
+     where u = (m - y)/(m + y), converges quickly.  Only the first few
+     terms need double-double arithmetic.                                */
 
   if (a.is_one()) {
     return 0.0;
@@ -251,10 +655,43 @@ dd_real log(const dd_real &a) {
     return dd_real::_nan;
   }
 
-  dd_real x = qd_log(a.x[0]);   /* Initial approximation */
+  if (a.isnan())
+    return dd_real::_nan;
+
+  if (a.isinf())
+    return dd_real::_inf;
+
+  dd_real m = a;
+  double e = 0.0;
+
+  /* Subnormal numbers are scaled by 2^54 first */
+  if (m.x[0] < 2.2250738585072014e-308) {
+    m = mul_pwr2(m, 18014398509481984.0);
+    e = -54.0;
+  }
+
+  int k = qd::exponent(m.x[0] * (4.0 / 3.0));
+  m = ldexp(m, -k);
+  e += k;
+
+  double i = qd_floor(m.x[0] * 64.0 + 0.5);
+  double j = qd_floor((m.x[0] * 64.0 / i - 1.0) * 4096.0 + 0.5);
+  double y = i * (4096.0 + j) * (1.0 / 262144.0);   /* exact */
+  int ti = static_cast<int>(i) - 48, tj = static_cast<int>(j) + 43;
+
+  dd_real u = (m - y) / (m + y);
+  dd_real w = sqr(u);
+  double c, w0 = w.x[0];
+  dd_real p, s;
 
-  x = x + a * exp(-x) - 1.0;
-  return x;
+  /* atanh(u) = u + u w (1/3 + w (1/5 + w/7)), with w = u^2 */
+  c = inv_odd[1][0] + w0 * inv_odd[2][0];
+  p = dd_real(inv_odd[0][0], inv_odd[0][1]) + w0 * c;
+  p = w * p;
+
+  s = dd_real::_log2 * e + dd_real(log_table1[ti][0], log_table1[ti][1]) +
+      dd_real(log_table2[tj][0], log_table2[tj][1]);
+  return s + mul_pwr2(u + u * p, 2.0);
 }
 
 dd_real log10(const dd_real &a) {
@@ -335,6 +772,46 @@ static void sincos_taylor(const dd_real &a,
 }
 
 
+/* 2/pi, and pi/2 split into pieces of 33 bits for the Cody-Waite
+   reduction in rem_pio2 */
+static const double inv_pio2 = 6.36619772367581382e-01;
+static const int n_pio2_cw = 5;
+static const double pio2_cw[n_pio2_cw] = {
+  1.57079632673412561e+00,  6.07710050630396598e-11,
+  2.02226624871116646e-21,  8.47842763968524269e-32,
+  2.06836569553604390e-40
+};
+
+/* Reduces a modulo pi/2: computes t and j with a = t + j * pi/2 (modulo
+   2 pi), |t| <= pi/4 (approximately) and -1 <= j <= 2.  Returns false if
+   a is not finite. */
+static bool rem_pio2(const dd_real &a, dd_real &t, int &j) {
+  if (qd_fabs(a.x[0]) < 1.0e6) {
+    /* Cody-Waite.  Since |q| < 2^20, the products q * pio2_cw[i] are
+       exact, and the leading bits of a cancel exactly. */
+    double q = qd_floor(a.x[0] * inv_pio2 + 0.5);
+    t = a;
+    for (int i = 0; i < n_pio2_cw; i++)
+      t = t - q * pio2_cw[i];
+    j = static_cast<int>(q - 4.0 * qd_floor(q * 0.25));
+    if (j == 3)
+      j = -1;
+    return true;
+  }
+
+  if (a.isnan() || a.isinf())
+    return false;
+
+  /* Payne-Hanek */
+  double y[qd::pio2::frac_words];
+  j = qd::pio2::rem_pio2(a.x, 2, y);
+  dd_real f = y[0];
+  for (int i = 1; i < qd::pio2::frac_words; i++)
+    f += y[i];
+  t = f * dd_real::_pi2;
+  return true;
+}
+
 dd_real sin(const dd_real &a) {  
 
   /* Strategy.  To compute sin(x), we choose integers a, b so that
@@ -352,25 +829,19 @@ dd_real sin(const dd_real &a) {
     return 0.0;
   }
 
-  // approximately reduce modulo 2*pi
-  dd_real z = nint(a / dd_real::_2pi);
-  dd_real r = a - dd_real::_2pi * z;
+  // reduce modulo pi/2 and then modulo pi/16.
+  dd_real r, t;
+  int j;
+  if (!rem_pio2(a, t, j)) {
+    dd_real::error("(dd_real::sin): Cannot reduce modulo pi/2.");
+    return dd_real::_nan;
+  }
 
-  // approximately reduce modulo pi/2 and then modulo pi/16.
-  dd_real t;
-  double q = qd_floor(r.x[0] / dd_real::_pi2.x[0] + 0.5);
-  t = r - dd_real::_pi2 * q;
-  int j = static_cast<int>(q);
-  q = qd_floor(t.x[0] / dd_real::_pi16.x[0] + 0.5);
+  double q = qd_floor(t.x[0] / dd_real::_pi16.x[0] + 0.5);
   t -= dd_real::_pi16 * q;
   int k = static_cast<int>(q);
   int abs_k = qd_abs(k);
 
-  if (j < -2 || j > 2) {
-    dd_real::error("(dd_real::sin): Cannot reduce modulo pi/2.");
-    return dd_real::_nan;
-  }
-
   if (abs_k > 4) {
     dd_real::error("(dd_real::sin): Cannot reduce modulo pi/16.");
     return dd_real::_nan;
@@ -428,25 +899,19 @@ dd_real cos(const dd_real &a) {
     return 1.0;
   }
 
-  // approximately reduce modulo 2*pi
-  dd_real z = nint(a / dd_real::_2pi);
-  dd_real r = a - z * dd_real::_2pi;
+  // reduce modulo pi/2 and then modulo pi/16
+  dd_real r, t;
+  int j;
+  if (!rem_pio2(a, t, j)) {
+    dd_real::error("(dd_real::cos): Cannot reduce modulo pi/2.");
+    return dd_real::_nan;
+  }
 
-  // approximately reduce modulo pi/2 and then modulo pi/16
-  dd_real t;
-  double q = qd_floor(r.x[0] / dd_real::_pi2.x[0] + 0.5);
-  t = r - dd_real::_pi2 * q;
-  int j = static_cast<int>(q);
-  q = qd_floor(t.x[0] / dd_real::_pi16.x[0] + 0.5);
+  double q = qd_floor(t.x[0] / dd_real::_pi16.x[0] + 0.5);
   t -= dd_real::_pi16 * q;
   int k = static_cast<int>(q);
   int abs_k = qd_abs(k);
 
-  if (j < -2 || j > 2) {
-    dd_real::error("(dd_real::cos): Cannot reduce modulo pi/2.");
-    return dd_real::_nan;
-  }
-
   if (abs_k > 4) {
     dd_real::error("(dd_real::cos): Cannot reduce modulo pi/16.");
     return dd_real::_nan;
@@ -507,27 +972,21 @@ void sincos(const dd_real &a, dd_real &sin_a, dd_real &cos_a) {
     return;
   }
 
-  // approximately reduce modulo 2*pi
-  dd_real z = nint(a / dd_real::_2pi);
-  dd_real r = a - dd_real::_2pi * z;
-
-  // approximately reduce module pi/2 and pi/16
+  // reduce modulo pi/2 and pi/16
   dd_real t;
-  double q = qd_floor(r.x[0] / dd_real::_pi2.x[0] + 0.5);
-  t = r - dd_real::_pi2 * q;
-  int j = static_cast<int>(q);
-  int abs_j = qd_abs(j);
-  q = qd_floor(t.x[0] / dd_real::_pi16.x[0] + 0.5);
-  t -= dd_real::_pi16 * q;
-  int k = static_cast<int>(q);
-  int abs_k = qd_abs(k);
-
-  if (abs_j > 2) {
+  int j;
+  if (!rem_pio2(a, t, j)) {
     dd_real::error("(dd_real::sincos): Cannot reduce modulo pi/2.");
     cos_a = sin_a = dd_real::_nan;
     return;
   }
 
+  int abs_j = qd_abs(j);
+  double q = qd_floor(t.x[0] / dd_real::_pi16.x[0] + 0.5);
+  t -= dd_real::_pi16 * q;
+  int k = static_cast<int>(q);
+  int abs_k = qd_abs(k);
+
   if (abs_k > 4) {
     dd_real::error("(dd_real::sincos): Cannot reduce modulo pi/16.");
     cos_a = sin_a = dd_real::_nan;
@@ -575,23 +1034,168 @@ dd_real atan(const dd_real &a) {
   return atan2(a, dd_real(1.0));
 }
 
+/* atan_table1[k] = atan(k/64) */
+static const double atan_table1[65][2] = {
+  { 0.00000000000000000e+00,  0.00000000000000000e+00},
+  { 1.56237286204768313e-02, -4.91360013656630395e-19},
+  { 3.12398334302682774e-02, -1.18844271158774798e-18},
+  { 4.68407129159696539e-02, -1.65567744225495210e-19},
+  { 6.24188099959573500e-02, -1.54907563082950458e-18},
+  { 7.79666338315423008e-02,  5.80455187314335664e-18},
+  { 9.34767811585894698e-02, -6.28447259954209545e-18},
+  { 1.08941956989865793e-01,  6.82671220724095851e-18},
+  { 1.24354994546761438e-01, -3.12532414245393831e-18},
+  { 1.39708874289163648e-01, -2.95798642473158131e-18},
+  { 1.54996741923940973e-01,  9.58541559411432383e-18},
+  { 1.70211925285474408e-01, -3.54116407980212514e-18},
+  { 1.85347949995694761e-01,  4.18069226884307898e-18},
+  { 2.00398553825878512e-01,  3.13995428718444929e-18},
+  { 2.15357699697738048e-01,  4.73816013007873289e-19},
+  { 2.30219587276843718e-01,  1.23134045291427032e-17},
+  { 2.44978663126864143e-01,  1.06987556187344514e-17},
+  { 2.59629629408257512e-01,  1.92387549246153041e-17},
+  { 2.74167451119658789e-01,  8.26135357516377348e-18},
+  { 2.88587361894077410e-01, -1.42836995737725708e-17},
+  { 3.02884868374971417e-01, -1.10108279030013690e-17},
+  { 3.17055753209147029e-01, -1.89392892429264215e-17},
+  { 3.31096076704132103e-01, -7.95261037579379870e-18},
+  { 3.45002177207105132e-01, -2.29388047555783039e-17},
+  { 3.58770670270572245e-01, -2.46238155826386349e-17},
+  { 3.72398446676754202e-01,  1.96123115048456534e-17},
+  { 3.85882669398073752e-01,  2.37882273249194087e-17},
+  { 3.99220769575252543e-01,  2.24659810561704206e-17},
+  { 4.12410441597387323e-01, -1.58765222777068909e-17},
+  { 4.25449637370042266e-01,  2.33155307418928847e-17},
+  { 4.38336559857957830e-01, -2.49427703062654091e-17},
+  { 4.51069655988523499e-01, -2.27037952294204745e-17},
+  { 4.63647609000806094e-01,  2.26987774529616871e-17},
+  { 4.76069330322761219e-01,  1.46544873322567134e-17},
+  { 4.88333951056405535e-01, -1.13732361893295846e-17},
+  { 5.00440813147294161e-01, -4.71816750855187565e-17},
+  { 5.12389460310737732e-01, -2.54627814728558035e-17},
+  { 5.24179628782913243e-01,  5.52009411964166575e-18},
+  { 5.35811237960463704e-01, -4.06379568348255750e-18},
+  { 5.47284380987436925e-01,  4.92370967139625499e-17},
+  { 5.58599315343562441e-01, -5.45563054859162639e-18},
+  { 5.69756453482978431e-01,  1.22550620850541836e-17},
+  { 5.80756353567670414e-01, -1.44146437819306691e-17},
+  { 5.91599710335111384e-01,  4.92049545368677175e-17},
+  { 6.02287346134964152e-01,  2.95043073722840231e-17},
+  { 6.12820202165241357e-01, -3.15520618485862261e-17},
+  { 6.23199329934065904e-01,  2.67240388514009508e-17},
+  { 6.33425882969144594e-01, -2.72907674360152756e-17},
+  { 6.43501108793284371e-01,  1.58347850514442862e-17},
+  { 6.53426341180761927e-01,  3.58006348573400954e-17},
+  { 6.63202992706093286e-01, -3.07605486442964900e-17},
+  { 6.72832547593763208e-01, -1.89931500971470508e-17},
+  { 6.82316554874748071e-01,  6.94322367156000774e-18},
+  { 6.91656621853199871e-01, -8.11715119228579578e-18},
+  { 7.00854407884450192e-01, -1.98762623433581612e-17},
+  { 7.09911618463524907e-01, -4.59716645058488703e-17},
+  { 7.18829999621624527e-01, -2.14783884444569830e-17},
+  { 7.27611332626510676e-01,  2.56932569739183885e-18},
+  { 7.36257428981428097e-01,  3.47393764829945672e-17},
+  { 7.44770125716075149e-01,  3.70831584913554675e-17},
+  { 7.53151280962194414e-01, -2.42569346591820681e-17},
+  { 7.61402769805578417e-01,  9.85003033275282190e-18},
+  { 7.69526480405658297e-01, -3.70499190560272129e-17},
+  { 7.77524310373347793e-01, -2.66764909519445022e-17},
+  { 7.85398163397448279e-01,  3.06161699786838302e-17}
+};
+
+/* atan_table2[k] = atan((k - 32)/4096) */
+static const double atan_table2[65][2] = {
+  {-7.81234106010111114e-03, -1.52476084924874749e-19},
+  {-7.56821487459730709e-03,  3.39493952125539228e-19},
+  {-7.32408778697816142e-03,  1.85763499216561921e-19},
+  {-7.07995982633782134e-03, -2.23118687865995943e-19},
+  {-6.83583102177105859e-03, -3.28938913705392696e-19},
+  {-6.59170140237324773e-03, -2.89380818143564605e-19},
+  {-6.34757099724034615e-03, -1.25785210318369155e-19},
+  {-6.10343983546887334e-03,  2.62770151535843054e-19},
+  {-5.85930794615588911e-03,  2.19033658397414091e-19},
+  {-5.61517535839897459e-03,  5.01955993505814458e-20},
+  {-5.37104210129621049e-03,  1.49348950424495029e-19},
+  {-5.12690820394615544e-03,  1.17843231531078430e-19},
+  {-4.88277369544782604e-03, -3.76782281313993522e-19},
+  {-4.63863860490067777e-03,  1.25315081875569793e-19},
+  {-4.39450296140457899e-03, -3.35717387707248761e-19},
+  {-4.15036679405979703e-03, -2.07617922301773216e-19},
+  {-3.90623013196697176e-03, -7.02385262363964414e-20},
+  {-3.66209300422709735e-03, -3.91668187145044581e-20},
+  {-3.41795543994150106e-03, -2.04481268647664399e-19},
+  {-3.17381746821182283e-03, -2.01549206768739688e-19},
+  {-2.92967911813999358e-03, -8.23091681638925965e-20},
+  {-2.68554041882821488e-03,  1.15010438710480094e-19},
+  {-2.44140139937893763e-03, -7.07052202155181108e-20},
+  {-2.19726208889484305e-03,  2.08797029479202007e-19},
+  {-1.95312251647881876e-03,  7.33126723756371621e-20},
+  {-1.70898271123394105e-03, -5.17418189395423146e-20},
+  {-1.46484270226345252e-03,  4.54355623056954604e-20},
+  {-1.22070251867074085e-03, -7.17031500961301642e-20},
+  {-9.76562189559319459e-04,  2.90330625499426262e-20},
+  {-7.32421744032805120e-04,  2.17001956215392108e-20},
+  {-4.88281211194898290e-04,  1.44569743155695780e-20},
+  {-2.44140620149361771e-04,  7.22802186877753722e-21},
+  { 0.00000000000000000e+00,  0.00000000000000000e+00},
+  { 2.44140620149361771e-04, -7.22802186877753722e-21},
+  { 4.88281211194898290e-04, -1.44569743155695780e-20},
+  { 7.32421744032805120e-04, -2.17001956215392108e-20},
+  { 9.76562189559319459e-04, -2.90330625499426262e-20},
+  { 1.22070251867074085e-03,  7.17031500961301642e-20},
+  { 1.46484270226345252e-03, -4.54355623056954604e-20},
+  { 1.70898271123394105e-03,  5.17418189395423146e-20},
+  { 1.95312251647881876e-03, -7.33126723756371621e-20},
+  { 2.19726208889484305e-03, -2.08797029479202007e-19},
+  { 2.44140139937893763e-03,  7.07052202155181108e-20},
+  { 2.68554041882821488e-03, -1.15010438710480094e-19},
+  { 2.92967911813999358e-03,  8.23091681638925965e-20},
+  { 3.17381746821182283e-03,  2.01549206768739688e-19},
+  { 3.41795543994150106e-03,  2.04481268647664399e-19},
+  { 3.66209300422709735e-03,  3.91668187145044581e-20},
+  { 3.90623013196697176e-03,  7.02385262363964414e-20},
+  { 4.15036679405979703e-03,  2.07617922301773216e-19},
+  { 4.39450296140457899e-03,  3.35717387707248761e-19},
+  { 4.63863860490067777e-03, -1.25315081875569793e-19},
+  { 4.88277369544782604e-03,  3.76782281313993522e-19},
+  { 5.12690820394615544e-03, -1.17843231531078430e-19},
+  { 5.37104210129621049e-03, -1.49348950424495029e-19},
+  { 5.61517535839897459e-03, -5.01955993505814458e-20},
+  { 5.85930794615588911e-03, -2.19033658397414091e-19},
+  { 6.10343983546887334e-03, -2.62770151535843054e-19},
+  { 6.34757099724034615e-03,  1.25785210318369155e-19},
+  { 6.59170140237324773e-03,  2.89380818143564605e-19},
+  { 6.83583102177105859e-03,  3.28938913705392696e-19},
+  { 7.07995982633782134e-03,  2.23118687865995943e-19},
+  { 7.32408778697816142e-03, -1.85763499216561921e-19},
+  { 7.56821487459730709e-03, -3.39493952125539228e-19},
+  { 7.81234106010111114e-03,  1.52476084924874749e-19}
+};
+
 dd_real atan2(const dd_real &y, const dd_real &x) {
-  /* Strategy: Instead of using Taylor series to compute 
-     arctan, we instead use Newton's iteration to solve
-     the equation
+  /* Strategy:  By symmetry, we can assume that 0 <= y <= x, and adjust
+     the result afterwards.  We write
 
-        sin(z) = y/r    or    cos(z) = x/r
+          atan(y/x) = atan(c1) + atan(c2) + atan(v),
 
-     where r = sqrt(x^2 + y^2).
-     The iteration is given by
+     where c1 = k1/64 is the nearest multiple of 1/64 to y/x, and
+     c2 = k2/4096 is the nearest multiple of 1/4096 to the quotient
+     (y - c1 x)/(x + c1 y), using the identity
 
-        z' = z + (y - sin(z)) / cos(z)          (for equation 1)
-        z' = z - (x - cos(z)) / sin(z)          (for equation 2)
+          atan(y/x) - atan(c) = atan((y - c x)/(x + c y)).
 
-     Here, x and y are normalized so that x^2 + y^2 = 1.
-     If |x| > |y|, then first iteration is used since the 
-     denominator is larger.  Otherwise, the second is used.
-  */
+     The arctangents of c1 and c2 are looked up in atan_table1 and
+     atan_table2.  Both reductions are applied to the numerator and the
+     denominator separately, so that only one division is needed.  Since
+     |v| <= 1/8192, the series
+
+          atan(v) = v - v^3/3 + v^5/5 - ...
+
+     converges quickly.  Only the first few terms need double-double
+     arithmetic.                                                         */
+
+  if (x.isnan() || y.isnan())
+    return dd_real::_nan;
 
   if (x.is_zero()) {
     
@@ -614,25 +1218,58 @@ dd_real atan2(const dd_real &y, const dd_real &x) {
     return (y.is_positive()) ? dd_real::_3pi4 : -dd_real::_pi4;
   }
 
-  dd_real r = sqrt(sqr(x) + sqr(y));
-  dd_real xx = x / r;
-  dd_real yy = y / r;
+  if (y.isinf()) {
+    return (y.is_positive()) ? dd_real::_pi2 : -dd_real::_pi2;
+  } else if (x.isinf()) {
+    if (x.is_positive())
+      return 0.0;
+    return (y.is_positive()) ? dd_real::_pi : -dd_real::_pi;
+  }
 
-  /* Compute double precision approximation to atan. */
-  dd_real z = qd_atan2(to_double(y), to_double(x));
-  dd_real sin_z, cos_z;
+  dd_real ax = abs(x), ay = abs(y);
+  bool swap = (ay > ax);
+  if (swap) {
+    dd_real t = ax;
+    ax = ay;
+    ay = t;
+  }
 
-  if (qd_fabs(xx.x[0]) > qd_fabs(yy.x[0])) {
-    /* Use Newton iteration 1.  z' = z + (y - sin(z)) / cos(z)  */
-    sincos(z, sin_z, cos_z);
-    z += (yy - sin_z) / cos_z;
-  } else {
-    /* Use Newton iteration 2.  z' = z - (x - cos(z)) / sin(z)  */
-    sincos(z, sin_z, cos_z);
-    z -= (xx - cos_z) / sin_z;
+  /* Scale the arguments to avoid overflow and underflow */
+  if (ax.x[0] > 1e290) {
+    ax = mul_pwr2(ax, 2.40991986510288411e-181);   /* 2^-600 */
+    ay = mul_pwr2(ay, 2.40991986510288411e-181);
+  } else if (ax.x[0] < 1e-200) {
+    ax = mul_pwr2(ax, 4.14951556888099290e+180);   /* 2^600 */
+    ay = mul_pwr2(ay, 4.14951556888099290e+180);
   }
 
-  return z;
+  double k1 = qd_floor(ay.x[0] / ax.x[0] * 64.0 + 0.5);
+  double c1 = k1 * (1.0 / 64.0);
+  dd_real num = ay - ax * c1;
+  dd_real den = ax + ay * c1;
+
+  double k2 = qd_floor(num.x[0] / den.x[0] * 4096.0 + 0.5);
+  double c2 = k2 * (1.0 / 4096.0);
+  dd_real v = (num - den * c2) / (den + num * c2);
+
+  dd_real w = sqr(v);
+  double c, w0 = w.x[0];
+  dd_real p, z;
+  int t1 = static_cast<int>(k1), t2 = static_cast<int>(k2) + 32;
+
+  /* atan(v) = v - v w (1/3 - w (1/5 - w (1/7 - w/9))), with w = v^2 */
+  c = inv_odd[1][0] - w0 * (inv_odd[2][0] - w0 * inv_odd[3][0]);
+  p = dd_real(inv_odd[0][0], inv_odd[0][1]) - w0 * c;
+  p = w * p;
+
+  z = dd_real(atan_table1[t1][0], atan_table1[t1][1]) +
+      dd_real(atan_table2[t2][0], atan_table2[t2][1]) + (v - v * p);
+
+  if (swap)
+    z = dd_real::_pi2 - z;
+  if (x.is_negative())
+    z = dd_real::_pi - z;
+  return (y.is_negative()) ? -z : z;
 }
 
 dd_real tan(const dd_real &a) {
@@ -764,4 +1401,36 @@ dd_real atanh(const dd_real &a) {
 QD_API dd_real fmod(const dd_real &a, const dd_real &b) {
   dd_real n = aint(a / b);
   return (a - b * n);
-}
\ No newline at end of file
+}
+
+/* Sets s to the first precision digits of a, correctly rounded, followed
+   by a null terminator. s must have room for precision + 1 chars. expn is
+   set to the exponent of the first digit. */
+void dd_real::to_digits(char *s, int &expn, int precision) const {
+  qd::decimal::to_digits(x, 2, s, expn, precision);
+}
+
+/* Writes a to s in the given format (a qd_format value). Returns the
+   length of the string, which does not fit if it is not less than size. */
+int dd_real::to_string(char *s, int size, int format, int precision) const {
+  return qd::decimal::to_string(x, 2, s, size, format, precision);
+}
+
+/* Parses a decimal number at the start of s (see c_dd_parse). Returns the
+   number of chars used, or 0 (and sets a to NaN) if s does not start with
+   a number. */
+int dd_real::parse(const char *s, int len, dd_real &a) {
+  return qd::decimal::parse(s, len, a.x, 2);
+}
+
+/* The result is NaN if s is not a number, or has other chars after it. */
+dd_real::dd_real(const char *s) {
+  int n = parse(s, -1, *this);
+  if (n == 0 || s[n] != 0)
+    *this = _nan;
+}
+
+dd_real &dd_real::operator=(const char *s) {
+  *this = dd_real(s);
+  return *this;
+}
@@ -54,10 +54,17 @@
 #undef min
 #endif
 
+/* Formats for to_string (see c_dd_to_string) */
+enum qd_format {
+  qd_fixed = 0,        /* ddd.ddd */
+  qd_scientific = 1,   /* d.ddde+XX */
+  qd_shortest = 2      /* shortest digits that identify the value */
+};
+
 struct dd_real {
   double x[2];
 
-  dd_real(double hi, double lo) { x[0] = hi; x[1] = lo; }
+  constexpr dd_real(double hi, double lo) : x{hi, lo} {}
   dd_real() {x[0] = 0.0; x[1] = 0.0; }
   dd_real(double h) { x[0] = h; x[1] = 0.0; }
   dd_real(int h) {
@@ -75,24 +82,24 @@ struct dd_real {
   double _hi() const { return x[0]; }
   double _lo() const { return x[1]; }
 
-  static dd_real _2pi;
-  static dd_real _pi;
-  static dd_real _3pi4;
-  static dd_real _pi2;
-  static dd_real _pi4;
-  static dd_real _e;
-  static dd_real _log2;
-  static dd_real _log10;
-  static dd_real _nan;
-  static dd_real _inf;
+  static const dd_real _2pi;
+  static const dd_real _pi;
+  static const dd_real _3pi4;
+  static const dd_real _pi2;
+  static const dd_real _pi4;
+  static const dd_real _e;
+  static const dd_real _log2;
+  static const dd_real _log10;
+  static const dd_real _nan;
+  static const dd_real _inf;
 
   static const double _eps;
   static const double _min_normalized;
-  static dd_real _max;
-  static dd_real _safe_max;
+  static const dd_real _max;
+  static const dd_real _safe_max;
   static const int _ndigits;
 
-  static dd_real _pi16;
+  static const dd_real _pi16;
 
   bool isnan() const { return QD_ISNAN(x[0]) || QD_ISNAN(x[1]); }
   bool isfinite() const { return QD_ISFINITE(x[0]); }
@@ -131,12 +138,24 @@ struct dd_real {
   static dd_real sqr(double d);
 
   static dd_real sqrt(double a);
+
+#ifdef QD_FMA_DISPATCH
+  QD_FMA_TARGET static dd_real mul_fma(double a, double b);
+  QD_FMA_TARGET static dd_real div_fma(double a, double b);
+  QD_FMA_TARGET static dd_real sqr_fma(double a);
+  QD_FMA_TARGET static dd_real sloppy_div_fma(const dd_real &a, const dd_real &b);
+  QD_FMA_TARGET static dd_real accurate_div_fma(const dd_real &a, const dd_real &b);
+#endif
   
   bool is_zero() const;
   bool is_one() const;
   bool is_positive() const;
   bool is_negative() const;
 
+  void to_digits(char *s, int &expn, int precision = _ndigits) const;
+  int to_string(char *s, int size, int format = qd_shortest, int precision = _ndigits) const;
+  static int parse(const char *s, int len, dd_real &a);
+
   static dd_real rand(void);
 };
 
@@ -172,6 +191,16 @@ QD_API dd_real operator/(const dd_real &a, const dd_real &b);
 
 QD_API dd_real inv(const dd_real &a);
 
+#ifdef QD_FMA_DISPATCH
+/* Same as the operators above, but using a fused multiply-subtract for the
+   product error terms. Only call these if the CPU supports FMA3. */
+QD_API QD_FMA_TARGET dd_real mul_fma(const dd_real &a, double b);
+QD_API QD_FMA_TARGET dd_real mul_fma(const dd_real &a, const dd_real &b);
+QD_API QD_FMA_TARGET dd_real div_fma(const dd_real &a, double b);
+QD_API QD_FMA_TARGET dd_real div_fma(const dd_real &a, const dd_real &b);
+QD_API QD_FMA_TARGET dd_real sqr_fma(const dd_real &a);
+#endif
+
 QD_API dd_real rem(const dd_real &a, const dd_real &b);
 QD_API dd_real drem(const dd_real &a, const dd_real &b);
 QD_API dd_real divrem(const dd_real &a, const dd_real &b, dd_real &r);
@@ -0,0 +1,381 @@
+/*
+ * dd_solve.cpp
+ *
+ * Double-double linear solver with mixed-precision iterative refinement
+ * (see c_solve.h).
+ *
+ * The work buffer holds the double-precision factors (n x n doubles, row
+ * by row), the residual r (2 planes of n x nrhs doubles, column by column),
+ * and the correction d (n x nrhs doubles). The residual is computed by
+ * c_dd_gemm or c_dd_gemv with alpha = -1 and beta = 1, after copying b to r.
+ *
+ * The refinement stops when the largest element of r is at most
+ * anorm * xnorm * n * eps, where anorm is the largest row sum of |a|,
+ * xnorm the largest element of |x|, and eps the precision of double-double,
+ * which is about the backward error of a double-double factorization. It
+ * stalls if a correction is not less than half of the previous one, or
+ * after max_iterations corrections.
+ *
+ * The double-double factorization (in the factors buffer, as 2 planes of
+ * n x n doubles) works like the double-precision one in qd_lu.cpp. The
+ * rows of U right of a panel are computed in tiles of columns, and the
+ * rest of the matrix is updated with c_dd_gemm.
+ */
+#include "qd_config.h"
+#include "dd_real.h"
+#include "c_solve.h"
+#include "qd_lu.cpp"
+
+/* Finishes the solver with the given status */
+static int dd_gesv_finish(dd_gesv *g, int status) {
+  g->status = status;
+  g->stage = qd::lu::stage_done;
+  return 0;
+}
+
+/* Solves the first approximation of x from the leading parts of b */
+static void dd_gesv_start(dd_gesv *g) {
+  int n = g->a.rows, nrhs = g->b.cols;
+  double *d = g->work + n * n + 2 * n * nrhs;
+  for (int j = 0; j < nrhs; j++) {
+    for (int i = 0; i < n; i++)
+      d[j * n + i] = g->b.x[0][i * g->b.row_stride + j * g->b.col_stride];
+    qd::lu::solve(g->work, n, g->pivots, d + j * n);
+    for (int i = 0; i < n; i++) {
+      int index = i * g->x.row_stride + j * g->x.col_stride;
+      g->x.x[0][index] = d[j * n + i];
+      g->x.x[1][index] = 0.0;
+    }
+  }
+}
+
+/* Sets up the pass that computes the residual r = b - a * x */
+static int dd_gesv_residual(dd_gesv *g) {
+  int n = g->a.rows, nrhs = g->b.cols;
+  double *r0 = g->work + n * n, *r1 = r0 + n * nrhs;
+  for (int j = 0; j < nrhs; j++)
+    for (int i = 0; i < n; i++) {
+      int index = i * g->b.row_stride + j * g->b.col_stride;
+      r0[j * n + i] = g->b.x[0][index];
+      r1[j * n + i] = g->b.x[1][index];
+    }
+
+  dd_matrix r = { { r0, r1 }, n, nrhs, 1, n };
+  if (nrhs == 1) {
+    g->gemv.a = g->a;
+    g->gemv.x = g->x;
+    g->gemv.y = r;
+    g->gemv.alpha[0] = -1.0;
+    g->gemv.alpha[1] = 0.0;
+    g->gemv.beta[0] = 1.0;
+    g->gemv.beta[1] = 0.0;
+    g->gemv.next_tile = 0;
+    g->tiles = (n + QD_GEMV_TILE - 1) / QD_GEMV_TILE;
+  } else {
+    g->gemm.a = g->a;
+    g->gemm.b = g->x;
+    g->gemm.c = r;
+    g->gemm.alpha[0] = -1.0;
+    g->gemm.alpha[1] = 0.0;
+    g->gemm.beta[0] = 1.0;
+    g->gemm.beta[1] = 0.0;
+    g->gemm.next_tile = 0;
+    g->tiles = ((n + QD_DD_GEMM_TILE - 1) / QD_DD_GEMM_TILE)
+        * ((nrhs + QD_DD_GEMM_TILE - 1) / QD_DD_GEMM_TILE);
+  }
+  g->stage = qd::lu::stage_residual;
+  return 1;
+}
+
+/* Checks the residual, and adds the next correction to x. Returns false if
+   x is accurate enough, or if the refinement stalled. */
+static bool dd_gesv_refine(dd_gesv *g) {
+  int n = g->a.rows, nrhs = g->b.cols;
+  double *r0 = g->work + n * n, *d = r0 + 2 * n * nrhs;
+  double rnorm = 0.0, xnorm = 0.0, dnorm = 0.0;
+  for (int j = 0; j < nrhs; j++)
+    for (int i = 0; i < n; i++) {
+      double r = qd::lu::abs(r0[j * n + i]);
+      double x = qd::lu::abs(g->x.x[0][i * g->x.row_stride + j * g->x.col_stride]);
+      if (!(r <= rnorm))
+        rnorm = r;
+      if (x > xnorm)
+        xnorm = x;
+    }
+  if (rnorm <= g->anorm * xnorm * 4.0 * dd_real::_eps) {
+    dd_gesv_finish(g, qd_gesv_refined);
+    return false;
+  }
+  if (g->iterations >= g->max_iterations) {
+    g->stage = qd::lu::stage_stalled;
+    return false;
+  }
+
+  for (int j = 0; j < nrhs; j++) {
+    for (int i = 0; i < n; i++)
+      d[j * n + i] = r0[j * n + i];
+    qd::lu::solve(g->work, n, g->pivots, d + j * n);
+  }
+  for (int k = 0; k < n * nrhs; k++)
+    if (!(qd::lu::abs(d[k]) <= dnorm))
+      dnorm = qd::lu::abs(d[k]);
+  if (!(dnorm <= (g->dnorm < 0.0 ? qd::lu::max_double : 0.5 * g->dnorm))) {
+    g->stage = qd::lu::stage_stalled;
+    return false;
+  }
+
+  for (int j = 0; j < nrhs; j++)
+    for (int i = 0; i < n; i++) {
+      int index = i * g->x.row_stride + j * g->x.col_stride;
+      dd_real x = dd_real(g->x.x[0][index], g->x.x[1][index]) + d[j * n + i];
+      g->x.x[0][index] = x.x[0];
+      g->x.x[1][index] = x.x[1];
+    }
+  g->iterations++;
+  g->dnorm = dnorm;
+  return true;
+}
+
+/* Factors columns j0 .. j0 + kb - 1 of the double-double factors, like
+   qd::lu::panel. Returns false if a pivot is zero. */
+static bool dd_gesv_panel(dd_gesv *g, int j0, int kb) {
+  int n = g->a.rows;
+  double *f0 = g->factors, *f1 = f0 + n * n;
+  for (int j = j0; j < j0 + kb; j++) {
+    int p = j;
+    double max = qd::lu::abs(f0[j * n + j]);
+    for (int i = j + 1; i < n; i++)
+      if (qd::lu::abs(f0[i * n + j]) > max) {
+        max = qd::lu::abs(f0[i * n + j]);
+        p = i;
+      }
+    if (!(max > 0.0))
+      return false;
+    g->pivots[j] = p;
+    if (p != j)
+      for (int c = 0; c < n; c++) {
+        double t0 = f0[j * n + c], t1 = f1[j * n + c];
+        f0[j * n + c] = f0[p * n + c];
+        f1[j * n + c] = f1[p * n + c];
+        f0[p * n + c] = t0;
+        f1[p * n + c] = t1;
+      }
+
+    dd_real pivot(f0[j * n + j], f1[j * n + j]);
+    for (int i = j + 1; i < n; i++) {
+      dd_real l = dd_real(f0[i * n + j], f1[i * n + j]) / pivot;
+      f0[i * n + j] = l.x[0];
+      f1[i * n + j] = l.x[1];
+      for (int c = j + 1; c < j0 + kb; c++) {
+        dd_real v = dd_real(f0[i * n + c], f1[i * n + c])
+            - l * dd_real(f0[j * n + c], f1[j * n + c]);
+        f0[i * n + c] = v.x[0];
+        f1[i * n + c] = v.x[1];
+      }
+    }
+  }
+  return true;
+}
+
+/* Computes tiles of columns of the rows of U right of the panel, until all
+   tiles have been claimed */
+static void dd_gesv_trsm(dd_gesv *g) {
+  int n = g->a.rows, j0 = g->block, s = j0 + qd::lu::block;
+  double *f0 = g->factors, *f1 = f0 + n * n;
+  for (;;) {
+    int t = __atomic_fetch_add(&g->next_tile, 1, __ATOMIC_RELAXED);
+    int c0 = s + t * qd::lu::tile;
+    if (c0 >= n)
+      return;
+    int c1 = n - c0 < qd::lu::tile ? n : c0 + qd::lu::tile;
+    for (int j = j0; j < s; j++)
+      for (int i = j + 1; i < s; i++) {
+        dd_real l(f0[i * n + j], f1[i * n + j]);
+        for (int c = c0; c < c1; c++) {
+          dd_real v = dd_real(f0[i * n + c], f1[i * n + c])
+              - l * dd_real(f0[j * n + c], f1[j * n + c]);
+          f0[i * n + c] = v.x[0];
+          f1[i * n + c] = v.x[1];
+        }
+      }
+  }
+}
+
+/* Sets up the update of the rest of the double-double factors:
+   a22 = -l21 * u12 + a22 */
+static void dd_gesv_product(dd_gesv *g) {
+  int n = g->a.rows, j0 = g->block, s = j0 + qd::lu::block, m = n - s;
+  double *f0 = g->factors, *f1 = f0 + n * n;
+  dd_matrix l = { { f0 + s * n + j0, f1 + s * n + j0 }, m, qd::lu::block, n, 1 };
+  dd_matrix u = { { f0 + j0 * n + s, f1 + j0 * n + s }, qd::lu::block, m, n, 1 };
+  dd_matrix a = { { f0 + s * n + s, f1 + s * n + s }, m, m, n, 1 };
+  g->gemm.a = l;
+  g->gemm.b = u;
+  g->gemm.c = a;
+  g->gemm.alpha[0] = -1.0;
+  g->gemm.alpha[1] = 0.0;
+  g->gemm.beta[0] = 1.0;
+  g->gemm.beta[1] = 0.0;
+  g->gemm.next_tile = 0;
+  g->tiles = ((m + QD_DD_GEMM_TILE - 1) / QD_DD_GEMM_TILE)
+      * ((m + QD_DD_GEMM_TILE - 1) / QD_DD_GEMM_TILE);
+}
+
+/* Solves x with the double-double factors */
+static void dd_gesv_solve(dd_gesv *g) {
+  int n = g->a.rows, nrhs = g->b.cols;
+  const double *f0 = g->factors, *f1 = f0 + n * n;
+  double *v0 = g->work + n * n, *v1 = v0 + n;
+  for (int j = 0; j < nrhs; j++) {
+    for (int i = 0; i < n; i++) {
+      int index = i * g->b.row_stride + j * g->b.col_stride;
+      v0[i] = g->b.x[0][index];
+      v1[i] = g->b.x[1][index];
+    }
+    for (int i = 0; i < n; i++) {
+      int p = g->pivots[i];
+      double t0 = v0[i], t1 = v1[i];
+      v0[i] = v0[p];
+      v1[i] = v1[p];
+      v0[p] = t0;
+      v1[p] = t1;
+    }
+    for (int i = 1; i < n; i++) {
+      dd_real s(v0[i], v1[i]);
+      for (int k = 0; k < i; k++)
+        s -= dd_real(f0[i * n + k], f1[i * n + k]) * dd_real(v0[k], v1[k]);
+      v0[i] = s.x[0];
+      v1[i] = s.x[1];
+    }
+    for (int i = n - 1; i >= 0; i--) {
+      dd_real s(v0[i], v1[i]);
+      for (int k = i + 1; k < n; k++)
+        s -= dd_real(f0[i * n + k], f1[i * n + k]) * dd_real(v0[k], v1[k]);
+      s /= dd_real(f0[i * n + i], f1[i * n + i]);
+      v0[i] = s.x[0];
+      v1[i] = s.x[1];
+      int index = i * g->x.row_stride + j * g->x.col_stride;
+      g->x.x[0][index] = s.x[0];
+      g->x.x[1][index] = s.x[1];
+    }
+  }
+}
+
+/* Performs the serial part of the next stage (see c_dd_gesv_step) */
+static int dd_gesv_step(dd_gesv *g) {
+  int n = g->a.rows;
+  for (;;) {
+    int kb = n - g->block < qd::lu::block ? n - g->block : qd::lu::block;
+    switch (g->stage) {
+    case qd::lu::stage_start:
+      if (g->a.cols != n || g->b.rows != n || g->x.rows != n
+          || g->x.cols != g->b.cols)
+        return dd_gesv_finish(g, qd_gesv_invalid);
+      g->iterations = 0;
+      if (n == 0 || g->b.cols == 0)
+        return dd_gesv_finish(g, qd_gesv_refined);
+      g->anorm = qd::lu::load(g->a.x[0], n, g->a.row_stride, g->a.col_stride,
+          g->work);
+      g->dnorm = -1.0;
+      g->block = 0;
+      g->stage = qd::lu::stage_panel;
+      break;
+
+    case qd::lu::stage_panel:
+      if (g->block >= n) {
+        dd_gesv_start(g);
+        return dd_gesv_residual(g);
+      }
+      if (!qd::lu::panel(g->work, n, g->block, kb, g->pivots)) {
+        g->stage = qd::lu::stage_stalled;
+        break;
+      }
+      qd::lu::trsm(g->work, n, g->block, kb);
+      if (g->block + kb < n) {
+        g->stage = qd::lu::stage_update;
+        g->tiles = qd::lu::tiles(n - g->block - kb);
+        g->next_tile = 0;
+        return 1;
+      }
+      g->block = n;
+      break;
+
+    case qd::lu::stage_update:
+      g->block += kb;
+      g->stage = qd::lu::stage_panel;
+      break;
+
+    case qd::lu::stage_residual:
+      if (dd_gesv_refine(g))
+        return dd_gesv_residual(g);
+      break;
+
+    case qd::lu::stage_stalled:
+      if (!g->factors) {
+        g->status = qd_gesv_stalled;
+        return 0;
+      }
+      for (int i = 0; i < n; i++)
+        for (int j = 0; j < n; j++) {
+          int index = i * g->a.row_stride + j * g->a.col_stride;
+          g->factors[i * n + j] = g->a.x[0][index];
+          g->factors[n * n + i * n + j] = g->a.x[1][index];
+        }
+      g->block = 0;
+      g->stage = qd::lu::stage_factor;
+      break;
+
+    case qd::lu::stage_factor:
+      if (g->block >= n) {
+        dd_gesv_solve(g);
+        return dd_gesv_finish(g, qd_gesv_factored);
+      }
+      if (!dd_gesv_panel(g, g->block, kb))
+        return dd_gesv_finish(g, qd_gesv_singular);
+      if (g->block + kb < n) {
+        g->stage = qd::lu::stage_trsm;
+        g->tiles = (n - g->block - kb + qd::lu::tile - 1) / qd::lu::tile;
+        g->next_tile = 0;
+        return 1;
+      }
+      g->block = n;
+      break;
+
+    case qd::lu::stage_trsm:
+      dd_gesv_product(g);
+      g->stage = qd::lu::stage_product;
+      return 1;
+
+    case qd::lu::stage_product:
+      g->block += kb;
+      g->stage = qd::lu::stage_factor;
+      break;
+
+    default:
+      return 0;
+    }
+  }
+}
+
+/* Computes tiles of the current pass (see c_dd_gesv_pass) */
+static void dd_gesv_pass(const qd_lu_kernels *lu, const dd_blas_kernels *blas,
+    dd_gesv *g, double *work) {
+  switch (g->stage) {
+  case qd::lu::stage_update:
+    qd::lu::update(lu, g->work, g->a.rows, g->block, qd::lu::block,
+        &g->next_tile);
+    break;
+  case qd::lu::stage_residual:
+    if (g->b.cols == 1)
+      dd_gemv_tiles(blas, &g->gemv);
+    else
+      dd_gemm_tiles(blas, &g->gemm, work);
+    break;
+  case qd::lu::stage_trsm:
+    dd_gesv_trsm(g);
+    break;
+  case qd::lu::stage_product:
+    dd_gemm_tiles(blas, &g->gemm, work);
+    break;
+  }
+}
@@ -0,0 +1,100 @@
+/*
+ * dd_vector.h
+ *
+ * A vector of double-double numbers in structure-of-arrays layout: the
+ * high and low parts are stored in two separate 64-byte aligned planes,
+ * which can be passed directly to the batch functions (c_dd_add_n etc.)
+ * through array().
+ *
+ * Unlike an array of dd_real, the elements are not initialized when the
+ * vector is created. Use load to fill the vector from an existing array of
+ * dd_real, and store to copy it back; these use the SIMD transpose kernels
+ * (c_dd_to_soa and c_dd_to_aos).
+ */
+#ifndef _QD_DD_VECTOR_H
+#define _QD_DD_VECTOR_H
+
+#include <new>
+#include "c_dd.h"
+#include "qd_alloc.h"
+
+class dd_vector {
+public:
+  dd_vector() {
+    block_.ptr = 0;
+    block_.size = 0;
+    block_.huge = false;
+    array_.x[0] = array_.x[1] = 0;
+    array_.count = 0;
+  }
+
+  /* Creates a vector of n uninitialized elements. If huge_pages is true,
+     the planes are backed by huge pages when the OS allows it. Throws
+     std::bad_alloc if n is negative, if the size of the planes does not fit
+     in a size_t, or if the memory cannot be allocated. */
+  explicit dd_vector(int n, bool huge_pages = false) {
+    if (n < 0)
+      throw std::bad_alloc();
+    size_t stride = qd::aligned_count(static_cast<size_t>(n));
+    if (stride > static_cast<size_t>(-1) / (2 * sizeof(double)))
+      throw std::bad_alloc();
+    block_ = qd::aligned_malloc(2 * sizeof(double) * stride, huge_pages);
+    if (block_.ptr == 0)
+      throw std::bad_alloc();
+    array_.x[0] = static_cast<double *>(block_.ptr);
+    array_.x[1] = array_.x[0] + stride;
+    array_.count = n;
+  }
+
+  ~dd_vector() { qd::aligned_free(block_); }
+
+  dd_vector(dd_vector &&other) : block_(other.block_), array_(other.array_) {
+    other.block_.ptr = 0;
+    other.array_.count = 0;
+  }
+
+  dd_vector &operator=(dd_vector &&other) {
+    if (this != &other) {
+      qd::aligned_free(block_);
+      block_ = other.block_;
+      array_ = other.array_;
+      other.block_.ptr = 0;
+      other.array_.count = 0;
+    }
+    return *this;
+  }
+
+  int size() const { return array_.count; }
+
+  /* The structure-of-arrays view for the batch functions. */
+  dd_real_array &array() { return array_; }
+  const dd_real_array &array() const { return array_; }
+
+  /* Component plane k (0 = high parts, 1 = low parts). */
+  double *data(int k) { return array_.x[k]; }
+  const double *data(int k) const { return array_.x[k]; }
+
+  dd_real operator[](int i) const {
+    return dd_real(array_.x[0][i], array_.x[1][i]);
+  }
+
+  void set(int i, const dd_real &a) {
+    array_.x[0][i] = a.x[0];
+    array_.x[1][i] = a.x[1];
+  }
+
+  /* Copies size() elements from a into the vector. */
+  void load(const dd_real *a) { c_dd_to_soa(a, &array_); }
+
+  /* Copies the size() elements of the vector to a. */
+  void store(dd_real *a) const { c_dd_to_aos(&array_, a); }
+
+  dd_vector(const dd_vector &) = delete;
+  dd_vector &operator=(const dd_vector &) = delete;
+
+private:
+  qd::aligned_block block_;
+  dd_real_array array_;
+};
+
+#endif /* _QD_DD_VECTOR_H */
@@ -44,16 +44,15 @@ extern "C" {
 	extern double qd_log10(double a);
 	extern double qd_exp(double a);
 	extern double qd_atan2(double y, double x);
-	extern double qd_nan();
-	extern double qd_inf();
   extern double qd_floor(double a);
   extern double qd_ceil(double a);
 }
 
 namespace qd {
 
-static double _d_nan;
-static double _d_inf;
+/* Compile-time constants, so they do not depend on initialization order. */
+constexpr double _d_nan = __builtin_nan("");
+constexpr double _d_inf = __builtin_inf();
 
 /*********** Basic Functions ************/
 /* Computes fl(a+b) and err(a+b).  Assumes |a| >= |b|. */
@@ -136,6 +135,24 @@ inline double two_sqr(double a, double &err) {
 #endif
 }
 
+#ifdef QD_FMA_DISPATCH
+/* Computes fl(a*b) and err(a*b) using a fused multiply-subtract.
+   Only call this from code compiled with QD_FMA_TARGET. */
+QD_FMA_TARGET inline double two_prod_fma(double a, double b, double &err) {
+  double p = a * b;
+  err = __builtin_fma(a, b, -p);
+  return p;
+}
+
+/* Computes fl(a*a) and err(a*a) using a fused multiply-subtract.
+   Only call this from code compiled with QD_FMA_TARGET. */
+QD_FMA_TARGET inline double two_sqr_fma(double a, double &err) {
+  double p = a * a;
+  err = __builtin_fma(a, a, -p);
+  return p;
+}
+#endif
+
 /* Computes the nearest integer to d. */
 inline double nint(double d) {
   if (d == qd_floor(d))
@@ -148,6 +165,17 @@ inline double aint(double d) {
   return (d >= 0.0) ? qd_floor(d) : qd_ceil(d);
 }
 
+/* Computes the unbiased exponent of a positive normal number, so that
+   1 <= d * 2^-exponent(d) < 2. */
+inline int exponent(double d) {
+  union {
+    double d;
+    unsigned long long u;
+  } bits;
+  bits.d = d;
+  return static_cast<int>(bits.u >> 52) - 1023;
+}
+
 inline double sqr(double t) {
   return t * t;
 }
@@ -0,0 +1,315 @@
+/*
+ * mp_render.cpp
+ *
+ * Mandelbrot tile rendering (see c_mp.h).
+ *
+ * Like the batch kernels, the row kernels are compiled for SSE2, AVX2 and
+ * AVX-512 on Intel, and the widest version supported by the CPU is
+ * selected on first use. On other CPUs, the scalar versions in qd::generic are used.
+ *
+ * The quad-double kernels use the qd_vec functions in qd_batch.h, so this
+ * file must be included after qd_batch.cpp (see c_qd.cpp).
+ *
+ * Perturbation (mp_perturbation) iterates the difference dz between a
+ * pixel and the reference orbit Z:
+ *   dz = (2 * Z + dz) * dz + dc
+ * When |Z + dz| < |dz|, the difference has lost most of its precision
+ * (a "glitch"), so the pixel is rebased: dz is set to the full value
+ * Z + dz and iteration continues from the start of the reference orbit.
+ * This also happens when the pixel outlives the reference orbit. The
+ * lanes of a vector would use different reference points after rebasing,
+ * so there is only a scalar version.
+ */
+#include "qd_config.h"
+#include "dd_real.h"
+#include "qd_real.h"
+#include "c_mp.h"
+#include "qd_cpu.h"
+#include "simd.h"
+
+/* A single row of a tile, as passed to the row kernels. */
+struct mp_row {
+  qd_real x0;                  /* real part of the first pixel */
+  qd_real y;                   /* imaginary part of the row */
+  double step;
+  int width;
+  int max_iter;
+  int *out;
+  const volatile int *cancel;
+  const double *orbit;         /* for mp_perturbation: */
+  int orbit_len;
+  double dx0;                  /* real part of dc of the first pixel */
+  double dy;                   /* imaginary part of dc of the row */
+};
+
+/* Offsets of the lanes of a vector */
+static const double mp_lane_index[8] = { 0, 1, 2, 3, 4, 5, 6, 7 };
+
+namespace qd {
+namespace generic {
+
+inline bool mp_cancelled(const mp_row *r) {
+  return r->cancel && *r->cancel;
+}
+
+bool mp_row_d(const mp_row *r) {
+  double x0 = r->x0.x[0], y = r->y.x[0];
+
+  for (int col = 0; col < r->width; col++) {
+    double x = x0 + col * r->step;
+    double zr = x, zi = y;
+    int i;
+
+    for (i = 0; i < r->max_iter; i++) {
+      double p = zr * zr, q = zi * zi;
+      if (p + q > 4.0)
+        break;
+      zi = y + 2.0 * zr * zi;
+      zr = x + (p - q);
+      if ((i & 1023) == 1023 && mp_cancelled(r))
+        return false;
+    }
+    r->out[col] = (i == r->max_iter) ? -1 : i;
+    if (mp_cancelled(r))
+      return false;
+  }
+  return true;
+}
+
+/* Uses a fused version of z = z^2 + c that renormalizes the results only
+   once, instead of after every multiplication and addition. */
+bool mp_row_dd(const mp_row *r) {
+  double y0 = r->y.x[0], y1 = r->y.x[1];
+
+  for (int col = 0; col < r->width; col++) {
+    double x0, x1, t, e;
+
+    /* x = x0 + col * step */
+    x0 = qd::two_prod(col, r->step, e);
+    x0 = qd::two_sum(r->x0.x[0], x0, t);
+    t += e + r->x0.x[1];
+    x0 = qd::quick_two_sum(x0, t, x1);
+
+    double zr0 = x0, zr1 = x1, zi0 = y0, zi1 = y1;
+    int i;
+
+    for (i = 0; i < r->max_iter; i++) {
+      double p0, p1, q0, q1, m0, m1, s0, s1;
+
+      /* zr^2 and zi^2, without renormalizing */
+      p0 = qd::two_sqr(zr0, p1);
+      p1 += 2.0 * zr0 * zr1;
+      q0 = qd::two_sqr(zi0, q1);
+      q1 += 2.0 * zi0 * zi1;
+
+      if (p0 + q0 > 4.0)
+        break;
+
+      /* zi = y + 2 * zr * zi */
+      m0 = qd::two_prod(zr0, zi0, m1);
+      m1 += zr0 * zi1 + zr1 * zi0;
+      s0 = qd::two_sum(2.0 * m0, y0, t);
+      t += 2.0 * m1 + y1;
+      zi0 = qd::quick_two_sum(s0, t, zi1);
+
+      /* zr = x + (zr^2 - zi^2) */
+      s0 = qd::two_diff(p0, q0, s1);
+      s1 += p1 - q1;
+      s0 = qd::two_sum(s0, x0, t);
+      t += s1 + x1;
+      zr0 = qd::quick_two_sum(s0, t, zr1);
+
+      if ((i & 1023) == 1023 && mp_cancelled(r))
+        return false;
+    }
+    r->out[col] = (i == r->max_iter) ? -1 : i;
+    if (mp_cancelled(r))
+      return false;
+  }
+  return true;
+}
+
+bool mp_row_qd(const mp_row *r) {
+  for (int col = 0; col < r->width; col++) {
+    double p, e;
+
+    /* x = x0 + col * step */
+    p = qd::two_prod(col, r->step, e);
+    qd_real x = r->x0 + p + e;
+
+    qd_real zr = x, zi = r->y;
+    int i;
+
+    for (i = 0; i < r->max_iter; i++) {
+      qd_real zr2 = sqr(zr), zi2 = sqr(zi);
+      if (zr2.x[0] + zi2.x[0] > 4.0)
+        break;
+      zi = qd_real::sloppy_add(mul_pwr2(zr * zi, 2.0), r->y);
+      zr = qd_real::sloppy_add(qd_real::sloppy_add(zr2, -zi2), x);
+      if ((i & 1023) == 1023 && mp_cancelled(r))
+        return false;
+    }
+    r->out[col] = (i == r->max_iter) ? -1 : i;
+    if (mp_cancelled(r))
+      return false;
+  }
+  return true;
+}
+
+bool mp_row_perturbation(const mp_row *r) {
+  const double *z = r->orbit;
+  int last = r->orbit_len - 1;
+  double dci = r->dy;
+
+  for (int col = 0; col < r->width; col++) {
+    double dcr = r->dx0 + col * r->step;
+
+    /* z_1 = c, so start at point 1 of the reference orbit */
+    double dzr = dcr, dzi = dci;
+    int m = 1, i;
+
+    for (i = 0; i < r->max_iter; i++) {
+      double zr = z[2 * m] + dzr, zi = z[2 * m + 1] + dzi;
+      double mag = zr * zr + zi * zi;
+      if (mag > 4.0)
+        break;
+
+      if (mag < dzr * dzr + dzi * dzi || m == last) {
+        dzr = zr;
+        dzi = zi;
+        m = 0;
+      }
+
+      double ar = 2.0 * z[2 * m] + dzr, ai = 2.0 * z[2 * m + 1] + dzi;
+      double t = ar * dzr - ai * dzi + dcr;
+      dzi = ar * dzi + ai * dzr + dci;
+      dzr = t;
+      m++;
+
+      if ((i & 1023) == 1023 && mp_cancelled(r))
+        return false;
+    }
+    r->out[col] = (i == r->max_iter) ? -1 : i;
+    if (mp_cancelled(r))
+      return false;
+  }
+  return true;
+}
+
+}
+}
+
+#ifdef QD_FMA_DISPATCH
+
+namespace qd {
+namespace sse2 {
+#define QD_SIMD_TARGET QD_TARGET_SSE2
+#include "mp_render.h"
+#undef QD_SIMD_TARGET
+}
+
+namespace avx2 {
+#define QD_SIMD_TARGET QD_TARGET_AVX2
+#include "mp_render.h"
+#undef QD_SIMD_TARGET
+}
+
+namespace avx512 {
+#define QD_SIMD_TARGET QD_TARGET_AVX512
+#include "mp_render.h"
+#undef QD_SIMD_TARGET
+}
+}
+
+#endif /* QD_FMA_DISPATCH */
+
+/* Row kernels for a specific instruction set, indexed by mp_precision.
+   They return false if rendering was cancelled. */
+struct mp_render_kernels {
+  bool (*row[4])(const mp_row *);
+};
+
+#define QD_MP_RENDER_KERNELS(ns) { { ns::mp_row_d, ns::mp_row_dd, ns::mp_row_qd, \
+  qd::generic::mp_row_perturbation } }
+
+#ifdef QD_FMA_DISPATCH
+static const mp_render_kernels mp_render_sse2 = QD_MP_RENDER_KERNELS(qd::sse2);
+static const mp_render_kernels mp_render_avx2 = QD_MP_RENDER_KERNELS(qd::avx2);
+static const mp_render_kernels mp_render_avx512 = QD_MP_RENDER_KERNELS(qd::avx512);
+#else
+static const mp_render_kernels mp_render_generic = QD_MP_RENDER_KERNELS(qd::generic);
+#endif
+
+/* Returns the fastest row kernels for this CPU. */
+static const mp_render_kernels *mp_render_select(int cpu_features) {
+#ifdef QD_FMA_DISPATCH
+  if (cpu_features & qd::cpu_avx512)
+    return &mp_render_avx512;
+  if (cpu_features & qd::cpu_avx2)
+    return &mp_render_avx2;
+  return &mp_render_sse2;
+#else
+  return &mp_render_generic;
+#endif
+}
+
+/* Renders rows of the tile until all rows have been claimed or rendering
+   is cancelled. Rows are claimed with an atomic increment of next_row, so
+   any number of threads can render the same tile. */
+static void mp_render_tile(const mp_render_kernels *kernels, mp_tile *tile,
+    int *out, const volatile int *cancel) {
+  int precision = tile->precision;
+  if (precision < mp_double || precision > mp_perturbation)
+    return;
+  if (precision == mp_perturbation && (tile->orbit == 0 || tile->orbit_len < 2))
+    return;
+
+  qd_real step(tile->step);
+  qd_real x0 = qd_real(tile->center_re) - step * (tile->width * 0.5);
+  qd_real y0 = qd_real(tile->center_im) - step * (tile->height * 0.5);
+  mp_row r;
+
+  r.x0 = x0;
+  r.step = tile->step;
+  r.width = tile->width;
+  r.max_iter = tile->max_iter;
+  r.cancel = cancel;
+  r.orbit = tile->orbit;
+  r.orbit_len = tile->orbit_len;
+  r.dx0 = -tile->step * (tile->width * 0.5);
+
+  for (;;) {
+    if (cancel && *cancel)
+      return;
+    int row = __atomic_fetch_add(&tile->next_row, 1, __ATOMIC_RELAXED);
+    if (row >= tile->height)
+      return;
+    r.y = y0 + step * static_cast<double>(row);
+    r.dy = (row - tile->height * 0.5) * tile->step;
+    r.out = out + row * tile->width;
+    if (!kernels->row[precision](&r))
+      return;
+  }
+}
+
+/* Computes the reference orbit at the center of the tile. */
+static void mp_reference_orbit(mp_tile *tile, double *orbit) {
+  qd_real cr(tile->center_re), ci(tile->center_im);
+  qd_real zr = 0.0, zi = 0.0;
+  int n = 0;
+
+  for (;;) {
+    orbit[2 * n] = zr.x[0];
+    orbit[2 * n + 1] = zi.x[0];
+    n++;
+
+    qd_real zr2 = sqr(zr), zi2 = sqr(zi);
+    if (zr2.x[0] + zi2.x[0] > 4.0 || n == tile->max_iter + 2)
+      break;
+    zi = qd_real::sloppy_add(mul_pwr2(zr * zi, 2.0), ci);
+    zr = qd_real::sloppy_add(qd_real::sloppy_add(zr2, -zi2), cr);
+  }
+
+  tile->orbit = orbit;
+  tile->orbit_len = n;
+}
@@ -0,0 +1,169 @@
+/*
+ * mp_render.h
+ *
+ * Mandelbrot row kernels, iterating "width" pixels at a time. This file
+ * is included once for each of the SIMD namespaces in simd.h (see
+ * mp_render.cpp), and relies on the "vec" and "qd_vec" types declared in
+ * simd.h and qd_batch.h.
+ *
+ * All lanes iterate until every lane has escaped. Lanes that have escaped
+ * keep their last z (so they don't overflow) and stop counting. The
+ * results are identical to the scalar versions in qd::generic.
+ */
+
+/* Stores the iteration counts of the lanes, or of the first n lanes if
+   fewer than width pixels are left in the row. */
+QD_SIMD_TARGET inline void mp_store_counts(int *out, vec iter, int n,
+    int max_iter) {
+  double it[width];
+  store(it, iter);
+  if (n > width)
+    n = width;
+  for (int k = 0; k < n; k++)
+    out[k] = (it[k] == max_iter) ? -1 : static_cast<int>(it[k]);
+}
+
+/* Lanes col .. col + width - 1 that are inside the row */
+QD_SIMD_TARGET inline mask mp_lanes(vec col, int w) {
+  return is_lt(col, set1(static_cast<double>(w)));
+}
+
+QD_SIMD_TARGET bool mp_row_d(const mp_row *r) {
+  vec x0 = set1(r->x0.x[0]), y = set1(r->y.x[0]), step = set1(r->step);
+  vec four = set1(4.0), one = set1(1.0), two = set1(2.0);
+
+  for (int col = 0; col < r->width; col += width) {
+    vec c = set1(col) + load(mp_lane_index);
+    vec x = x0 + c * step;
+    vec zr = x, zi = y, iter = set1(0.0);
+    mask active = mp_lanes(c, r->width);
+
+    for (int i = 0; i < r->max_iter; i++) {
+      vec p = zr * zr, q = zi * zi;
+      active = mask_and(active, is_le(p + q, four));
+      if (!any(active))
+        break;
+      iter = select(active, iter + one, iter);
+      zi = select(active, y + two * zr * zi, zi);
+      zr = select(active, x + (p - q), zr);
+      if ((i & 1023) == 1023 && r->cancel && *r->cancel) {
+        zero_upper();
+        return false;
+      }
+    }
+    mp_store_counts(r->out + col, iter, r->width - col, r->max_iter);
+    if (r->cancel && *r->cancel) {
+      zero_upper();
+      return false;
+    }
+  }
+  zero_upper();
+  return true;
+}
+
+QD_SIMD_TARGET bool mp_row_dd(const mp_row *r) {
+  vec x0 = set1(r->x0.x[0]), x1 = set1(r->x0.x[1]);
+  vec y0 = set1(r->y.x[0]), y1 = set1(r->y.x[1]), step = set1(r->step);
+  vec four = set1(4.0), one = set1(1.0), two = set1(2.0);
+
+  for (int col = 0; col < r->width; col += width) {
+    vec c = set1(col) + load(mp_lane_index);
+    vec xr0, xr1, t, e;
+
+    /* x = x0 + col * step */
+    xr0 = two_prod(c, step, e);
+    xr0 = two_sum(x0, xr0, t);
+    t += e + x1;
+    xr0 = quick_two_sum(xr0, t, xr1);
+
+    vec zr0 = xr0, zr1 = xr1, zi0 = y0, zi1 = y1, iter = set1(0.0);
+    mask active = mp_lanes(c, r->width);
+
+    for (int i = 0; i < r->max_iter; i++) {
+      vec p0, p1, q0, q1, m0, m1, s0, s1;
+
+      /* zr^2 and zi^2, without renormalizing */
+      p0 = two_sqr(zr0, p1);
+      p1 += two * zr0 * zr1;
+      q0 = two_sqr(zi0, q1);
+      q1 += two * zi0 * zi1;
+
+      active = mask_and(active, is_le(p0 + q0, four));
+      if (!any(active))
+        break;
+      iter = select(active, iter + one, iter);
+
+      /* zi = y + 2 * zr * zi */
+      m0 = two_prod(zr0, zi0, m1);
+      m1 += zr0 * zi1 + zr1 * zi0;
+      s0 = two_sum(two * m0, y0, t);
+      t += two * m1 + y1;
+      s0 = quick_two_sum(s0, t, s1);
+      zi0 = select(active, s0, zi0);
+      zi1 = select(active, s1, zi1);
+
+      /* zr = x + (zr^2 - zi^2) */
+      s0 = two_diff(p0, q0, s1);
+      s1 += p1 - q1;
+      s0 = two_sum(s0, xr0, t);
+      t += s1 + xr1;
+      s0 = quick_two_sum(s0, t, s1);
+      zr0 = select(active, s0, zr0);
+      zr1 = select(active, s1, zr1);
+
+      if ((i & 1023) == 1023 && r->cancel && *r->cancel) {
+        zero_upper();
+        return false;
+      }
+    }
+    mp_store_counts(r->out + col, iter, r->width - col, r->max_iter);
+    if (r->cancel && *r->cancel) {
+      zero_upper();
+      return false;
+    }
+  }
+  zero_upper();
+  return true;
+}
+
+QD_SIMD_TARGET bool mp_row_qd(const mp_row *r) {
+  qd_vec x0 = set1(r->x0), y = set1(r->y);
+  vec step = set1(r->step), four = set1(4.0), one = set1(1.0);
+
+  for (int col = 0; col < r->width; col += width) {
+    vec c = set1(col) + load(mp_lane_index);
+    vec p, e;
+
+    /* x = x0 + col * step */
+    p = two_prod(c, step, e);
+    qd_vec x = add(add(x0, p), e);
+
+    qd_vec zr = x, zi = y;
+    vec iter = set1(0.0);
+    mask active = mp_lanes(c, r->width);
+
+    for (int i = 0; i < r->max_iter; i++) {
+      qd_vec zr2 = sqr(zr), zi2 = sqr(zi);
+
+      active = mask_and(active, is_le(zr2.x[0] + zi2.x[0], four));
+      if (!any(active))
+        break;
+      iter = select(active, iter + one, iter);
+
+      zi = select(active, sloppy_add(mul_pwr2(mul(zr, zi), 2.0), y), zi);
+      zr = select(active, sloppy_add(sloppy_add(zr2, neg(zi2)), x), zr);
+
+      if ((i & 1023) == 1023 && r->cancel && *r->cancel) {
+        zero_upper();
+        return false;
+      }
+    }
+    mp_store_counts(r->out + col, iter, r->width - col, r->max_iter);
+    if (r->cancel && *r->cancel) {
+      zero_upper();
+      return false;
+    }
+  }
+  zero_upper();
+  return true;
+}
@@ -0,0 +1,118 @@
+/*
+ * qd_alloc.h
+ *
+ * Allocation of uninitialized, 64-byte aligned memory for the component
+ * planes of dd_vector and qd_vector. 64 bytes is both the cache line size
+ * and the width of an AVX-512 register, so the batch kernels never split a
+ * load across cache lines.
+ *
+ * This header is not used by c_dd.cpp and c_qd.cpp, so the object files
+ * linked into Delphi do not depend on the C runtime or operating system.
+ */
+#ifndef _QD_QD_ALLOC_H
+#define _QD_QD_ALLOC_H
+
+#include <stddef.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#include <malloc.h>
+#else
+#include <stdlib.h>
+#include <sys/mman.h>
+#endif
+
+namespace qd {
+
+static const size_t alloc_alignment = 64;
+
+/* A block of memory returned by aligned_malloc. */
+struct aligned_block {
+  void *ptr;
+  size_t size;      /* size passed to the OS when huge is set */
+  bool huge;        /* true if backed by huge (large) pages */
+};
+
+/* Allocates size bytes with an alignment of alloc_alignment bytes. The
+   memory is not initialized. If huge_pages is true, an attempt is made to
+   back the memory with huge pages (Linux) or large pages (Windows, which
+   requires the SeLockMemoryPrivilege). If that fails, regular pages are
+   used. On failure, ptr is set to NULL. */
+inline aligned_block aligned_malloc(size_t size, bool huge_pages) {
+  aligned_block b;
+  b.ptr = 0;
+  b.size = size;
+  b.huge = false;
+  if (size == 0)
+    size = 1;
+
+#if defined(_WIN32)
+  if (huge_pages) {
+    size_t page = GetLargePageMinimum();
+    if (page != 0 && size <= static_cast<size_t>(-1) - (page - 1)) {
+      size_t rounded = (size + page - 1) & ~(page - 1);
+      b.ptr = VirtualAlloc(0, rounded, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES,
+                           PAGE_READWRITE);
+      if (b.ptr) {
+        b.size = rounded;
+        b.huge = true;
+        return b;
+      }
+    }
+  }
+  b.ptr = _aligned_malloc(size, alloc_alignment);
+#else
+#if defined(MADV_HUGEPAGE)
+  if (huge_pages) {
+    /* Transparent huge pages are 2MB on x86-64 and (usually) ARM64. The
+       kernel only uses them for 2MB aligned ranges, so round the size up;
+       mmap itself returns page aligned memory. */
+    const size_t page = 2 * 1024 * 1024;
+    size_t rounded = (size + page - 1) & ~(page - 1);
+    void *p = MAP_FAILED;
+    if (rounded >= size)    /* else the rounding wrapped around */
+      p = mmap(0, rounded, PROT_READ | PROT_WRITE,
+               MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p != MAP_FAILED) {
+      madvise(p, rounded, MADV_HUGEPAGE);
+      b.ptr = p;
+      b.size = rounded;
+      b.huge = true;
+      return b;
+    }
+  }
+#endif
+  if (posix_memalign(&b.ptr, alloc_alignment, size) != 0)
+    b.ptr = 0;
+#endif
+  return b;
+}
+
+/* Frees a block returned by aligned_malloc. */
+inline void aligned_free(const aligned_block &b) {
+  if (b.ptr == 0)
+    return;
+#if defined(_WIN32)
+  if (b.huge)
+    VirtualFree(b.ptr, 0, MEM_RELEASE);
+  else
+    _aligned_free(b.ptr);
+#else
+  if (b.huge)
+    munmap(b.ptr, b.size);
+  else
+    free(b.ptr);
+#endif
+}
+
+/* Returns n rounded up to a multiple of the number of doubles in
+   alloc_alignment bytes, so that each component plane starts at an
+   aligned address. */
+inline size_t aligned_count(size_t n) {
+  const size_t k = alloc_alignment / sizeof(double);
+  return (n + k - 1) & ~(k - 1);
+}
+
+}
+
+#endif /* _QD_QD_ALLOC_H */
@@ -0,0 +1,242 @@
+/*
+ * qd_batch.cpp
+ *
+ * Batch (array) versions of the quad-double arithmetic operators, used
+ * by the c_qd_*_n functions in c_qd.cpp. The numbers are stored in
+ * structure-of-arrays layout (see qd_real_array in c_qd.h).
+ *
+ * On Intel, the kernels are compiled for SSE2, AVX2 and AVX-512 and
+ * the widest version supported by the CPU is selected on first use. On
+ * other CPUs, only the scalar versions in qd::generic are used.
+ *
+ * The transcendental and polynomial kernels use the tables and templates
+ * in qd_real.cpp, so this file must be included after it (see c_qd.cpp).
+ */
+#include "qd_config.h"
+#include "qd_real.h"
+#include "c_qd.h"
+#include "qd_cpu.h"
+#include "simd.h"
+
+/* Accumulators of the compensated sum c_qd_sum_d. Element j is added to
+   accumulator k = j % qd_acc_count with a cascade of two_sums: s[0][k]
+   holds the sum, and s[1][k] to s[3][k] hold the rounding errors of the
+   levels above them. Like dd_acc in dd_batch.cpp, all instruction sets
+   add the elements in the same order. The dot product c_qd_dot_qd uses
+   the same accumulators, but adds to them with quad-double arithmetic. */
+enum { qd_acc_count = 8 };
+
+struct qd_acc {
+  double s[4][qd_acc_count];
+};
+
+namespace qd {
+namespace generic {
+
+inline qd_real load(const qd_real_array *a, int i) {
+  return qd_real(a->x[0][i], a->x[1][i], a->x[2][i], a->x[3][i]);
+}
+
+inline void store(qd_real_array *a, int i, const qd_real &b) {
+  a->x[0][i] = b.x[0];
+  a->x[1][i] = b.x[1];
+  a->x[2][i] = b.x[2];
+  a->x[3][i] = b.x[3];
+}
+
+void qd_add_n(const qd_real_array *a, const qd_real_array *b,
+    qd_real_array *c, int i) {
+  for (; i < c->count; i++)
+    store(c, i, load(a, i) + load(b, i));
+}
+
+void qd_sub_n(const qd_real_array *a, const qd_real_array *b,
+    qd_real_array *c, int i) {
+  for (; i < c->count; i++)
+    store(c, i, load(a, i) - load(b, i));
+}
+
+void qd_mul_n(const qd_real_array *a, const qd_real_array *b,
+    qd_real_array *c, int i) {
+  for (; i < c->count; i++)
+    store(c, i, load(a, i) * load(b, i));
+}
+
+void qd_fma_n(const qd_real_array *a, const qd_real_array *b,
+    qd_real_array *c, int i) {
+  for (; i < c->count; i++)
+    store(c, i, load(c, i) + load(a, i) * load(b, i));
+}
+
+void qd_axpy_n(const qd_real &alpha, const qd_real_array *x,
+    qd_real_array *y, int i) {
+  for (; i < y->count; i++)
+    store(y, i, load(y, i) + alpha * load(x, i));
+}
+
+void qd_sqr_n(const qd_real_array *a, qd_real_array *b, int i) {
+  for (; i < b->count; i++)
+    store(b, i, sqr(load(a, i)));
+}
+
+void qd_exp_n(const qd_real_array *a, qd_real_array *b, int i) {
+  for (; i < b->count; i++)
+    store(b, i, exp(load(a, i)));
+}
+
+void qd_log_n(const qd_real_array *a, qd_real_array *b, int i) {
+  for (; i < b->count; i++)
+    store(b, i, log(load(a, i)));
+}
+
+void qd_sincos_n(const qd_real_array *a, qd_real_array *s,
+    qd_real_array *c, int i) {
+  qd_real sin_a, cos_a;
+  for (; i < s->count; i++) {
+    sincos(load(a, i), sin_a, cos_a);
+    store(s, i, sin_a);
+    store(c, i, cos_a);
+  }
+}
+
+void qd_atan2_n(const qd_real_array *a, const qd_real_array *b,
+    qd_real_array *c, int i) {
+  for (; i < c->count; i++)
+    store(c, i, atan2(load(a, i), load(b, i)));
+}
+
+/* Element i of c[k] and up */
+struct qd_coef_array {
+  const qd_real_array *c;
+  int i;
+  qd_real operator()(int k) const { return load(c + k, i); }
+};
+
+void qd_polyeval_n(const qd_real *c, int n, const qd_real_array *x,
+    qd_real_array *y, int i) {
+  for (; i < y->count; i++)
+    store(y, i, polyeval(c, n, load(x, i)));
+}
+
+void qd_polyeval_set_n(const qd_real_array *c, int n, const qd_real &x,
+    qd_real_array *y, int i) {
+  for (; i < y->count; i++) {
+    qd_coef_array coef = { c, i };
+    store(y, i, qd_polyeval(coef, n, x));
+  }
+}
+
+void qd_sum_d(const double *a, int n, qd_acc *acc, int i) {
+  for (; i < n; i++) {
+    int k = i % qd_acc_count;
+    double e;
+    acc->s[0][k] = two_sum(acc->s[0][k], a[i], e);
+    acc->s[1][k] = two_sum(acc->s[1][k], e, e);
+    acc->s[2][k] = two_sum(acc->s[2][k], e, e);
+    acc->s[3][k] += e;
+  }
+}
+
+/* Accumulator k holds the quad-double sum s[0][k] + ... + s[3][k] */
+void qd_dot_qd(const qd_real_array *a, const qd_real_array *b, qd_acc *acc,
+    int i) {
+  for (; i < a->count; i++) {
+    int k = i % qd_acc_count;
+    qd_real s(acc->s[0][k], acc->s[1][k], acc->s[2][k], acc->s[3][k]);
+    s += load(a, i) * load(b, i);
+    for (int j = 0; j < 4; j++)
+      acc->s[j][k] = s.x[j];
+  }
+}
+
+/* Adds up the accumulators, in a fixed order */
+qd_real qd_acc_sum(const qd_acc *acc) {
+  qd_real s = 0.0;
+  for (int j = 0; j < 4; j++)
+    for (int k = 0; k < qd_acc_count; k++)
+      s += acc->s[j][k];
+  return s;
+}
+
+void qd_to_soa_n(const qd_real *a, qd_real_array *b, int i) {
+  for (; i < b->count; i++)
+    store(b, i, a[i]);
+}
+
+void qd_to_aos_n(const qd_real_array *a, qd_real *b, int i) {
+  for (; i < a->count; i++)
+    b[i] = load(a, i);
+}
+
+}
+}
+
+#ifdef QD_FMA_DISPATCH
+
+namespace qd {
+namespace sse2 {
+#define QD_SIMD_TARGET QD_TARGET_SSE2
+#include "qd_batch.h"
+#undef QD_SIMD_TARGET
+}
+
+namespace avx2 {
+#define QD_SIMD_TARGET QD_TARGET_AVX2
+#include "qd_batch.h"
+#undef QD_SIMD_TARGET
+}
+
+namespace avx512 {
+#define QD_SIMD_TARGET QD_TARGET_AVX512
+#include "qd_batch.h"
+#undef QD_SIMD_TARGET
+}
+}
+
+#endif /* QD_FMA_DISPATCH */
+
+/* Batch kernels for a specific instruction set. */
+struct qd_batch_kernels {
+  void (*add_n)(const qd_real_array *, const qd_real_array *, qd_real_array *, int);
+  void (*sub_n)(const qd_real_array *, const qd_real_array *, qd_real_array *, int);
+  void (*mul_n)(const qd_real_array *, const qd_real_array *, qd_real_array *, int);
+  void (*fma_n)(const qd_real_array *, const qd_real_array *, qd_real_array *, int);
+  void (*axpy_n)(const qd_real &, const qd_real_array *, qd_real_array *, int);
+  void (*sqr_n)(const qd_real_array *, qd_real_array *, int);
+  void (*exp_n)(const qd_real_array *, qd_real_array *, int);
+  void (*log_n)(const qd_real_array *, qd_real_array *, int);
+  void (*sincos_n)(const qd_real_array *, qd_real_array *, qd_real_array *, int);
+  void (*atan2_n)(const qd_real_array *, const qd_real_array *, qd_real_array *, int);
+  void (*polyeval_n)(const qd_real *, int, const qd_real_array *, qd_real_array *, int);
+  void (*polyeval_set_n)(const qd_real_array *, int, const qd_real &, qd_real_array *, int);
+  void (*sum_d)(const double *, int, qd_acc *, int);
+  void (*dot_qd)(const qd_real_array *, const qd_real_array *, qd_acc *, int);
+  void (*to_soa_n)(const qd_real *, qd_real_array *, int);
+  void (*to_aos_n)(const qd_real_array *, qd_real *, int);
+};
+
+#define QD_QD_BATCH_KERNELS(ns) { ns::qd_add_n, ns::qd_sub_n, ns::qd_mul_n, \
+  ns::qd_fma_n, ns::qd_axpy_n, ns::qd_sqr_n, ns::qd_exp_n, ns::qd_log_n, \
+  ns::qd_sincos_n, ns::qd_atan2_n, ns::qd_polyeval_n, ns::qd_polyeval_set_n, \
+  ns::qd_sum_d, ns::qd_dot_qd, ns::qd_to_soa_n, ns::qd_to_aos_n }
+
+#ifdef QD_FMA_DISPATCH
+static const qd_batch_kernels qd_batch_sse2 = QD_QD_BATCH_KERNELS(qd::sse2);
+static const qd_batch_kernels qd_batch_avx2 = QD_QD_BATCH_KERNELS(qd::avx2);
+static const qd_batch_kernels qd_batch_avx512 = QD_QD_BATCH_KERNELS(qd::avx512);
+#else
+static const qd_batch_kernels qd_batch_generic = QD_QD_BATCH_KERNELS(qd::generic);
+#endif
+
+/* Returns the fastest batch kernels for this CPU. */
+static const qd_batch_kernels *qd_batch_select(int cpu_features) {
+#ifdef QD_FMA_DISPATCH
+  if (cpu_features & qd::cpu_avx512)
+    return &qd_batch_avx512;
+  if (cpu_features & qd::cpu_avx2)
+    return &qd_batch_avx2;
+  return &qd_batch_sse2;
+#else
+  return &qd_batch_generic;
+#endif
+}
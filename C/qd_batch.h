@@ -0,0 +1,1108 @@
+/*
+ * qd_batch.h
+ *
+ * Quad-double batch kernels, operating on "width" numbers at a time.
+ * This file is included once for each of the SIMD namespaces in simd.h
+ * (see qd_batch.cpp), and relies on the "vec" type and functions declared
+ * there. The algorithms are identical to the ones in qd_inline.h, so the
+ * results are bitwise identical to the scalar versions.
+ *
+ * The only differences are renorm and ieee_add, which branch on
+ * intermediate values that differ per lane. The SIMD versions track the
+ * branch that each lane takes with masks instead.
+ *
+ * Like in dd_batch.h, exp, log and atan2 give the same results as the scalar
+ * versions, and the sums qd_sum_d and qd_dot_qd give the same results for
+ * all widths. sincos always uses all the Taylor terms, so its results may
+ * differ from the scalar version in the last bit, and pads the remaining
+ * elements to a whole vector.
+ */
+
+/* width quad-double numbers */
+struct qd_vec {
+  vec x[4];
+};
+
+QD_SIMD_TARGET inline qd_vec load(const qd_real_array *a, int i) {
+  qd_vec r;
+  r.x[0] = load(a->x[0] + i);
+  r.x[1] = load(a->x[1] + i);
+  r.x[2] = load(a->x[2] + i);
+  r.x[3] = load(a->x[3] + i);
+  return r;
+}
+
+QD_SIMD_TARGET inline void store(qd_real_array *a, int i, const qd_vec &b) {
+  store(a->x[0] + i, b.x[0]);
+  store(a->x[1] + i, b.x[1]);
+  store(a->x[2] + i, b.x[2]);
+  store(a->x[3] + i, b.x[3]);
+}
+
+/* Same as load and store, for the last n < width elements. The unused
+   lanes are set to zero. */
+QD_SIMD_TARGET inline qd_vec load_partial(const qd_real_array *a, int i,
+    int n) {
+  qd_vec r;
+  for (int k = 0; k < 4; k++)
+    r.x[k] = load_partial(a->x[k] + i, n);
+  return r;
+}
+
+QD_SIMD_TARGET inline void store_partial(qd_real_array *a, int i, int n,
+    const qd_vec &b) {
+  for (int k = 0; k < 4; k++)
+    store_partial(a->x[k] + i, b.x[k], n);
+}
+
+/* Broadcasts a quad-double constant to all lanes */
+QD_SIMD_TARGET inline qd_vec set1(const qd_real &a) {
+  qd_vec r;
+  for (int k = 0; k < 4; k++)
+    r.x[k] = set1(a.x[k]);
+  return r;
+}
+
+QD_SIMD_TARGET inline qd_vec select(mask m, const qd_vec &a,
+    const qd_vec &b) {
+  qd_vec r;
+  for (int k = 0; k < 4; k++)
+    r.x[k] = select(m, a.x[k], b.x[k]);
+  return r;
+}
+
+/********** Renormalization **********/
+/* One step of renorm: adds t to the component that each lane is currently
+   accumulating into (given by masks k0..k3), and moves that lane on to
+   the next component if the sum does not fit. The last component just
+   absorbs t. */
+QD_SIMD_TARGET inline void renorm_accum(vec &s0, vec &s1, vec &s2, vec &s3,
+    mask &k0, mask &k1, mask &k2, mask &k3, vec t) {
+  vec s, e;
+  mask nz;
+
+  s = select(k0, s0, select(k1, s1, select(k2, s2, s3)));
+  s = quick_two_sum(s, t, e);
+
+  s0 = select(k0, s, s0);
+  s1 = select(k0, e, select(k1, s, s1));
+  s2 = select(k1, e, select(k2, s, s2));
+  s3 = select(k2, e, select(k3, s, s3));
+
+  nz = is_nonzero(e);
+  k3 = mask_or(k3, mask_and(k2, nz));
+  k2 = mask_or(mask_andnot(k2, nz), mask_and(k1, nz));
+  k1 = mask_or(mask_andnot(k1, nz), mask_and(k0, nz));
+  k0 = mask_andnot(k0, nz);
+}
+
+QD_SIMD_TARGET inline void renorm(vec &c0, vec &c1, vec &c2, vec &c3,
+    vec c4) {
+  vec s0, s1, s2, s3;
+  vec o0 = c0, o1 = c1, o2 = c2, o3 = c3;
+  mask k0, k1, k2, k3, inf;
+
+  inf = is_inf(c0);
+
+  s0 = quick_two_sum(c3, c4, c4);
+  s0 = quick_two_sum(c2, s0, c3);
+  s0 = quick_two_sum(c1, s0, c2);
+  c0 = quick_two_sum(c0, s0, c1);
+
+  s0 = c0;
+  s1 = c1;
+  s2 = set1(0.0);
+  s3 = set1(0.0);
+  k0 = is_zero(s1);
+  k1 = is_nonzero(s1);
+  k2 = no_lanes();
+  k3 = no_lanes();
+
+  renorm_accum(s0, s1, s2, s3, k0, k1, k2, k3, c2);
+  renorm_accum(s0, s1, s2, s3, k0, k1, k2, k3, c3);
+  renorm_accum(s0, s1, s2, s3, k0, k1, k2, k3, c4);
+
+  /* qd::renorm leaves infinities untouched */
+  c0 = select(inf, o0, s0);
+  c1 = select(inf, o1, s1);
+  c2 = select(inf, o2, s2);
+  c3 = select(inf, o3, s3);
+}
+
+QD_SIMD_TARGET inline void renorm(vec &c0, vec &c1, vec &c2, vec &c3) {
+  vec s0, s1, s2, s3;
+  vec o0 = c0, o1 = c1, o2 = c2, o3 = c3;
+  mask k0, k1, k2, k3, inf;
+
+  inf = is_inf(c0);
+
+  s0 = quick_two_sum(c2, c3, c3);
+  s0 = quick_two_sum(c1, s0, c2);
+  c0 = quick_two_sum(c0, s0, c1);
+
+  s0 = c0;
+  s1 = c1;
+  s2 = set1(0.0);
+  s3 = set1(0.0);
+  k0 = is_zero(s1);
+  k1 = is_nonzero(s1);
+  k2 = no_lanes();
+  k3 = no_lanes();
+
+  renorm_accum(s0, s1, s2, s3, k0, k1, k2, k3, c2);
+  renorm_accum(s0, s1, s2, s3, k0, k1, k2, k3, c3);
+
+  c0 = select(inf, o0, s0);
+  c1 = select(inf, o1, s1);
+  c2 = select(inf, o2, s2);
+  c3 = select(inf, o3, s3);
+}
+
+/********** Additions ************/
+QD_SIMD_TARGET inline void three_sum(vec &a, vec &b, vec &c) {
+  vec t1, t2, t3;
+  t1 = two_sum(a, b, t2);
+  a  = two_sum(c, t1, t3);
+  b  = two_sum(t2, t3, c);
+}
+
+QD_SIMD_TARGET inline void three_sum2(vec &a, vec &b, vec &c) {
+  vec t1, t2, t3;
+  t1 = two_sum(a, b, t2);
+  a  = two_sum(c, t1, t3);
+  b = t2 + t3;
+}
+
+/* quad-double + double */
+QD_SIMD_TARGET inline qd_vec add(const qd_vec &a, vec b) {
+  vec c0, c1, c2, c3, e;
+  qd_vec r;
+
+  c0 = two_sum(a.x[0], b, e);
+  c1 = two_sum(a.x[1], e, e);
+  c2 = two_sum(a.x[2], e, e);
+  c3 = two_sum(a.x[3], e, e);
+
+  renorm(c0, c1, c2, c3, e);
+  r.x[0] = c0;
+  r.x[1] = c1;
+  r.x[2] = c2;
+  r.x[3] = c3;
+  return r;
+}
+
+/* quad-double + quad-double (qd_real::sloppy_add) */
+QD_SIMD_TARGET inline qd_vec sloppy_add(const qd_vec &a, const qd_vec &b) {
+  vec s0, s1, s2, s3;
+  vec t0, t1, t2, t3;
+  qd_vec r;
+
+  s0 = two_sum(a.x[0], b.x[0], t0);
+  s1 = two_sum(a.x[1], b.x[1], t1);
+  s2 = two_sum(a.x[2], b.x[2], t2);
+  s3 = two_sum(a.x[3], b.x[3], t3);
+
+  s1 = two_sum(s1, t0, t0);
+  three_sum(s2, t0, t1);
+  three_sum2(s3, t0, t2);
+  t0 = t0 + t1 + t3;
+
+  renorm(s0, s1, s2, s3, t0);
+  r.x[0] = s0;
+  r.x[1] = s1;
+  r.x[2] = s2;
+  r.x[3] = s3;
+  return r;
+}
+
+/* qd::quick_three_accum */
+QD_SIMD_TARGET inline vec quick_three_accum(vec &a, vec &b, vec c) {
+  vec s;
+  mask both;
+
+  s = two_sum(b, c, b);
+  s = two_sum(a, s, a);
+
+  both = mask_and(is_nonzero(a), is_nonzero(b));
+  b = select(is_zero(b), a, b);
+  a = select(both, a, s);
+  return select(both, s, set1(0.0));
+}
+
+/* Takes the next component for ieee_add: the first one of p if q is used
+   up or if it is larger in magnitude, else the first one of q. i and j
+   count the components taken from p and q in the active lanes. */
+QD_SIMD_TARGET inline vec ieee_next(qd_vec &p, qd_vec &q, vec &i, vec &j,
+    mask active) {
+  vec four = set1(4.0), one = set1(1.0), t;
+  mask tp;
+
+  tp = mask_and(is_lt(i, four),
+      mask_or(is_le(four, j), is_lt(abs(q.x[0]), abs(p.x[0]))));
+  t = select(tp, p.x[0], q.x[0]);
+
+  for (int n = 0; n < 3; n++) {
+    p.x[n] = select(tp, p.x[n + 1], p.x[n]);
+    q.x[n] = select(tp, q.x[n], q.x[n + 1]);
+  }
+  i = select(mask_and(active, tp), i + one, i);
+  j = select(mask_andnot(active, tp), j + one, j);
+  return t;
+}
+
+/* quad-double + quad-double (qd_real::ieee_add). Every component is taken
+   in the same step in all lanes, so only the index k of the next output
+   component differs per lane. It is tracked with the masks k0..k3, like
+   in renorm. Lanes that have filled x stop, and add the components they
+   have not taken to x[3]. */
+QD_SIMD_TARGET inline qd_vec ieee_add(const qd_vec &a, const qd_vec &b) {
+  qd_vec p = a, q = b, r;
+  vec i, j, s, t, u, v, zero;
+  vec x[4];
+  mask active, nz, k0, k1, k2, k3;
+
+  zero = set1(0.0);
+  active = is_eq(zero, zero);
+  i = j = zero;
+
+  u = ieee_next(p, q, i, j, active);
+  v = ieee_next(p, q, i, j, active);
+  u = quick_two_sum(u, v, v);
+
+  for (int n = 0; n < 4; n++)
+    x[n] = zero;
+  k0 = active;
+  k1 = k2 = k3 = no_lanes();
+
+  for (int n = 2; n < 8; n++) {
+    t = ieee_next(p, q, i, j, active);
+    s = quick_three_accum(u, v, t);
+
+    /* x[k] = s. If s is zero, k stays and x[k] is overwritten later. */
+    x[0] = select(k0, s, x[0]);
+    x[1] = select(k1, s, x[1]);
+    x[2] = select(k2, s, x[2]);
+    x[3] = select(k3, s, x[3]);
+
+    nz = is_nonzero(s);
+    active = mask_andnot(active, mask_and(k3, nz));
+    k3 = mask_or(mask_andnot(k3, nz), mask_and(k2, nz));
+    k2 = mask_or(mask_andnot(k2, nz), mask_and(k1, nz));
+    k1 = mask_or(mask_andnot(k1, nz), mask_and(k0, nz));
+    k0 = mask_andnot(k0, nz);
+  }
+
+  /* Lanes that used up both operands store the accumulator */
+  x[0] = select(k0, u, x[0]);
+  x[1] = select(k1, u, select(k0, v, x[1]));
+  x[2] = select(k2, u, select(k1, v, x[2]));
+  x[3] = select(k3, u, select(k2, v, x[3]));
+
+  /* add the rest. */
+  for (int n = 0; n < 4; n++)
+    x[3] = select(is_le(i, set1(n)), x[3] + a.x[n], x[3]);
+  for (int n = 0; n < 4; n++)
+    x[3] = select(is_le(j, set1(n)), x[3] + b.x[n], x[3]);
+
+  renorm(x[0], x[1], x[2], x[3]);
+  r.x[0] = x[0];
+  r.x[1] = x[1];
+  r.x[2] = x[2];
+  r.x[3] = x[3];
+  return r;
+}
+
+/* quad-double + quad-double */
+QD_SIMD_TARGET inline qd_vec add(const qd_vec &a, const qd_vec &b) {
+#ifndef QD_IEEE_ADD
+  return sloppy_add(a, b);
+#else
+  return ieee_add(a, b);
+#endif
+}
+
+QD_SIMD_TARGET inline qd_vec neg(const qd_vec &a) {
+  qd_vec r;
+  r.x[0] = -a.x[0];
+  r.x[1] = -a.x[1];
+  r.x[2] = -a.x[2];
+  r.x[3] = -a.x[3];
+  return r;
+}
+
+/********** Multiplications **********/
+QD_SIMD_TARGET inline qd_vec mul_pwr2(const qd_vec &a, double b) {
+  qd_vec r;
+  for (int k = 0; k < 4; k++)
+    r.x[k] = a.x[k] * set1(b);
+  return r;
+}
+
+/* quad-double * double */
+QD_SIMD_TARGET inline qd_vec mul(const qd_vec &a, vec b) {
+  vec p0, p1, p2, p3;
+  vec q0, q1, q2;
+  vec s0, s1, s2, s3, s4;
+  qd_vec r;
+
+  p0 = two_prod(a.x[0], b, q0);
+  p1 = two_prod(a.x[1], b, q1);
+  p2 = two_prod(a.x[2], b, q2);
+  p3 = a.x[3] * b;
+
+  s0 = p0;
+
+  s1 = two_sum(q0, p1, s2);
+
+  three_sum(s2, q1, p2);
+
+  three_sum2(q1, q2, p3);
+  s3 = q1;
+
+  s4 = q2 + p2;
+
+  renorm(s0, s1, s2, s3, s4);
+  r.x[0] = s0;
+  r.x[1] = s1;
+  r.x[2] = s2;
+  r.x[3] = s3;
+  return r;
+}
+
+/* quad-double * quad-double */
+QD_SIMD_TARGET inline qd_vec mul(const qd_vec &a, const qd_vec &b) {
+#ifdef QD_SLOPPY_MUL
+  vec p0, p1, p2, p3, p4, p5;
+  vec q0, q1, q2, q3, q4, q5;
+  vec t0, t1;
+  vec s0, s1, s2;
+  qd_vec r;
+
+  p0 = two_prod(a.x[0], b.x[0], q0);
+
+  p1 = two_prod(a.x[0], b.x[1], q1);
+  p2 = two_prod(a.x[1], b.x[0], q2);
+
+  p3 = two_prod(a.x[0], b.x[2], q3);
+  p4 = two_prod(a.x[1], b.x[1], q4);
+  p5 = two_prod(a.x[2], b.x[0], q5);
+
+  /* Start Accumulation */
+  three_sum(p1, p2, q0);
+
+  /* Six-Three Sum  of p2, q1, q2, p3, p4, p5. */
+  three_sum(p2, q1, q2);
+  three_sum(p3, p4, p5);
+  /* compute (s0, s1, s2) = (p2, q1, q2) + (p3, p4, p5). */
+  s0 = two_sum(p2, p3, t0);
+  s1 = two_sum(q1, p4, t1);
+  s2 = q2 + p5;
+  s1 = two_sum(s1, t0, t0);
+  s2 += (t0 + t1);
+
+  /* O(eps^3) order terms */
+  s1 += a.x[0]*b.x[3] + a.x[1]*b.x[2] + a.x[2]*b.x[1] + a.x[3]*b.x[0] +
+        q0 + q3 + q4 + q5;
+  renorm(p0, p1, s0, s1, s2);
+  r.x[0] = p0;
+  r.x[1] = p1;
+  r.x[2] = s0;
+  r.x[3] = s1;
+  return r;
+#else
+  vec p0, p1, p2, p3, p4, p5;
+  vec q0, q1, q2, q3, q4, q5;
+  vec p6, p7, p8, p9;
+  vec q6, q7, q8, q9;
+  vec r0, r1;
+  vec t0, t1;
+  vec s0, s1, s2;
+  qd_vec r;
+
+  p0 = two_prod(a.x[0], b.x[0], q0);
+
+  p1 = two_prod(a.x[0], b.x[1], q1);
+  p2 = two_prod(a.x[1], b.x[0], q2);
+
+  p3 = two_prod(a.x[0], b.x[2], q3);
+  p4 = two_prod(a.x[1], b.x[1], q4);
+  p5 = two_prod(a.x[2], b.x[0], q5);
+
+  /* Start Accumulation */
+  three_sum(p1, p2, q0);
+
+  /* Six-Three Sum  of p2, q1, q2, p3, p4, p5. */
+  three_sum(p2, q1, q2);
+  three_sum(p3, p4, p5);
+  /* compute (s0, s1, s2) = (p2, q1, q2) + (p3, p4, p5). */
+  s0 = two_sum(p2, p3, t0);
+  s1 = two_sum(q1, p4, t1);
+  s2 = q2 + p5;
+  s1 = two_sum(s1, t0, t0);
+  s2 += (t0 + t1);
+
+  /* O(eps^3) order terms */
+  p6 = two_prod(a.x[0], b.x[3], q6);
+  p7 = two_prod(a.x[1], b.x[2], q7);
+  p8 = two_prod(a.x[2], b.x[1], q8);
+  p9 = two_prod(a.x[3], b.x[0], q9);
+
+  /* Nine-Two-Sum of q0, s1, q3, q4, q5, p6, p7, p8, p9. */
+  q0 = two_sum(q0, q3, q3);
+  q4 = two_sum(q4, q5, q5);
+  p6 = two_sum(p6, p7, p7);
+  p8 = two_sum(p8, p9, p9);
+  /* Compute (t0, t1) = (q0, q3) + (q4, q5). */
+  t0 = two_sum(q0, q4, t1);
+  t1 += (q3 + q5);
+  /* Compute (r0, r1) = (p6, p7) + (p8, p9). */
+  r0 = two_sum(p6, p8, r1);
+  r1 += (p7 + p9);
+  /* Compute (q3, q4) = (t0, t1) + (r0, r1). */
+  q3 = two_sum(t0, r0, q4);
+  q4 += (t1 + r1);
+  /* Compute (t0, t1) = (q3, q4) + s1. */
+  t0 = two_sum(q3, s1, t1);
+  t1 += q4;
+
+  /* O(eps^4) terms -- Nine-One-Sum */
+  t1 += a.x[1] * b.x[3] + a.x[2] * b.x[2] + a.x[3] * b.x[1] +
+        q6 + q7 + q8 + q9 + s2;
+
+  renorm(p0, p1, s0, t0, t1);
+  r.x[0] = p0;
+  r.x[1] = p1;
+  r.x[2] = s0;
+  r.x[3] = t0;
+  return r;
+#endif
+}
+
+/********** Squaring **********/
+QD_SIMD_TARGET inline qd_vec sqr(const qd_vec &a) {
+  vec p0, p1, p2, p3, p4, p5;
+  vec q0, q1, q2, q3;
+  vec s0, s1;
+  vec t0, t1;
+  qd_vec r;
+
+  p0 = two_sqr(a.x[0], q0);
+  p1 = two_prod(set1(2.0) * a.x[0], a.x[1], q1);
+  p2 = two_prod(set1(2.0) * a.x[0], a.x[2], q2);
+  p3 = two_sqr(a.x[1], q3);
+
+  p1 = two_sum(q0, p1, q0);
+
+  q0 = two_sum(q0, q1, q1);
+  p2 = two_sum(p2, p3, p3);
+
+  s0 = two_sum(q0, p2, t0);
+  s1 = two_sum(q1, p3, t1);
+
+  s1 = two_sum(s1, t0, t0);
+  t0 += t1;
+
+  s1 = quick_two_sum(s1, t0, t0);
+  p2 = quick_two_sum(s0, s1, t1);
+  p3 = quick_two_sum(t1, t0, q0);
+
+  p4 = set1(2.0) * a.x[0] * a.x[3];
+  p5 = set1(2.0) * a.x[1] * a.x[2];
+
+  p4 = two_sum(p4, p5, p5);
+  q2 = two_sum(q2, q3, q3);
+
+  t0 = two_sum(p4, q2, t1);
+  t1 = t1 + p5 + q3;
+
+  p3 = two_sum(p3, t0, p4);
+  p4 = p4 + q0 + t1;
+
+  renorm(p0, p1, p2, p3, p4);
+  r.x[0] = p0;
+  r.x[1] = p1;
+  r.x[2] = p2;
+  r.x[3] = p3;
+  return r;
+}
+
+/*********** Divisions ************/
+/* quad-double / quad-double. Like sloppy_div and accurate_div in
+   qd_real.cpp, the residuals use the addition that matches the division. */
+QD_SIMD_TARGET inline qd_vec div(const qd_vec &a, const qd_vec &b) {
+  vec q0, q1, q2, q3;
+  qd_vec r;
+
+#ifdef QD_SLOPPY_DIV
+  q0 = a.x[0] / b.x[0];
+  r = sloppy_add(a, neg(mul(b, q0)));
+
+  q1 = r.x[0] / b.x[0];
+  r = sloppy_add(r, neg(mul(b, q1)));
+
+  q2 = r.x[0] / b.x[0];
+  r = sloppy_add(r, neg(mul(b, q2)));
+
+  q3 = r.x[0] / b.x[0];
+
+  renorm(q0, q1, q2, q3);
+#else
+  q0 = a.x[0] / b.x[0];
+  r = ieee_add(a, neg(mul(b, q0)));
+
+  q1 = r.x[0] / b.x[0];
+  r = ieee_add(r, neg(mul(b, q1)));
+
+  q2 = r.x[0] / b.x[0];
+  r = ieee_add(r, neg(mul(b, q2)));
+
+  q3 = r.x[0] / b.x[0];
+
+  r = ieee_add(r, neg(mul(b, q3)));
+  vec q4 = r.x[0] / b.x[0];
+
+  renorm(q0, q1, q2, q3, q4);
+#endif
+
+  r.x[0] = q0;
+  r.x[1] = q1;
+  r.x[2] = q2;
+  r.x[3] = q3;
+  return r;
+}
+
+/*********** Square Root ************/
+/* Same as sqrt in qd_real.cpp. Lanes that are zero give zero, and lanes
+   that are negative give NaN. */
+QD_SIMD_TARGET inline qd_vec sqrt(const qd_vec &a) {
+  qd_vec r, h;
+
+  r.x[0] = set1(1.0) / sqrt(a.x[0]);
+  r.x[1] = r.x[2] = r.x[3] = set1(0.0);
+  h = mul_pwr2(a, 0.5);
+
+  r = add(r, mul(add(neg(mul(h, sqr(r))), set1(0.5)), r));
+  r = add(r, mul(add(neg(mul(h, sqr(r))), set1(0.5)), r));
+  r = add(r, mul(add(neg(mul(h, sqr(r))), set1(0.5)), r));
+  r = mul(r, a);
+
+  r = select(is_lt(a.x[0], set1(0.0)), set1(qd_real::_nan), r);
+  return select(is_zero(a.x[0]), set1(qd_real(0.0)), r);
+}
+
+/*********** Exponential and Logarithm ************/
+/* Computes a * 2^m for integral m in [-2044, 2046] */
+QD_SIMD_TARGET inline qd_vec ldexp(const qd_vec &a, vec m) {
+  qd_vec r;
+  for (int k = 0; k < 4; k++)
+    r.x[k] = ldexp(a.x[k], m);
+  return r;
+}
+
+/* Looks up the entries j of a table of quad-double numbers */
+QD_SIMD_TARGET inline qd_vec gather(const double (*table)[4], vec j) {
+  qd_vec r;
+  j = j * set1(4.0);
+  for (int k = 0; k < 4; k++)
+    r.x[k] = gather(table[0] + k, j);
+  return r;
+}
+
+/* Same as exp in qd_real.cpp */
+QD_SIMD_TARGET inline qd_vec exp(const qd_vec &a) {
+  mask under, over, in, one;
+  qd_vec x, r, s, p;
+  vec k, m, j1, j2, c, r0;
+
+  under = is_le(a.x[0], set1(-709.0));
+  over = is_le(set1(709.0), a.x[0]);
+  in = is_lt(abs(a.x[0]), set1(709.0));
+  one = mask_and(mask_and(is_eq(a.x[0], set1(1.0)), is_zero(a.x[1])),
+                 mask_and(is_zero(a.x[2]), is_zero(a.x[3])));
+
+  /* Lanes that are out of range or NaN compute exp(0) instead */
+  x = select(in, a, set1(qd_real(0.0)));
+
+  k = floor(x.x[0] * set1(exp_inv_ln2) + set1(0.5));
+  m = floor(k * set1(1.0 / 4096.0));
+  j2 = k - m * set1(4096.0);
+  j1 = floor(j2 * set1(1.0 / 64.0));
+  j2 = j2 - j1 * set1(64.0);
+
+  r = add(x, -(k * set1(exp_ln2_hi)));
+  r = add(r, neg(mul(set1(qd_real(exp_ln2_lo[0], exp_ln2_lo[1], exp_ln2_lo[2],
+      exp_ln2_lo[3])), k)));
+  r0 = r.x[0];
+
+  c = set1(inv_fact[8][0]) + r0 * (set1(inv_fact[9][0]) +
+      r0 * set1(inv_fact[10][0]));
+  p = add(set1(qd_real(inv_fact[7][0], inv_fact[7][1], inv_fact[7][2],
+      inv_fact[7][3])), r0 * c);
+  for (int i = 6; i >= 0; i--)
+    p = add(set1(qd_real(inv_fact[i][0], inv_fact[i][1], inv_fact[i][2],
+        inv_fact[i][3])), mul(r, p));
+  p = add(mul(r, p), set1(0.5));
+  p = add(r, mul(sqr(r), p));
+
+  s = mul(gather(exp2_table1, j1), gather(exp2_table2, j2));
+  s = add(s, mul(s, p));
+  s = ldexp(s, m);
+
+  s = select(one, set1(qd_real::_e), s);
+  s = select(in, s, set1(qd_real::_nan));
+  s = select(under, set1(qd_real(0.0)), s);
+  s = select(over, set1(qd_real::_inf), s);
+  return s;
+}
+
+/* Same as log in qd_real.cpp */
+QD_SIMD_TARGET inline qd_vec log(const qd_vec &a) {
+  mask valid, tiny;
+  qd_vec m, u, w, p, s;
+  vec e, k, i, j, y, c, w0;
+
+  /* Lanes that are not positive and finite compute log(1) instead */
+  valid = mask_and(is_lt(set1(0.0), a.x[0]),
+                   is_lt(a.x[0], set1(qd_real::_inf.x[0])));
+  m = select(valid, a, set1(qd_real(1.0)));
+
+  tiny = is_lt(m.x[0], set1(2.2250738585072014e-308));
+  m = select(tiny, mul_pwr2(m, 18014398509481984.0), m);
+  e = select(tiny, set1(-54.0), set1(0.0));
+
+  k = exponent(m.x[0] * set1(4.0 / 3.0));
+  m = ldexp(m, -k);
+  e = e + k;
+
+  i = floor(m.x[0] * set1(64.0) + set1(0.5));
+  j = floor((m.x[0] * set1(64.0) / i - set1(1.0)) * set1(4096.0) + set1(0.5));
+  y = i * (set1(4096.0) + j) * set1(1.0 / 262144.0);
+
+  u = div(add(m, -y), add(m, y));
+  w = sqr(u);
+  w0 = w.x[0];
+
+  c = set1(inv_odd[5][0]) + w0 * set1(inv_odd[6][0]);
+  p = add(set1(qd_real(inv_odd[4])), w0 * c);
+  for (int n = 3; n >= 0; n--)
+    p = add(set1(qd_real(inv_odd[n])), mul(w, p));
+  p = mul(w, p);
+
+  s = add(add(mul(set1(qd_real::_log2), e), gather(log_table1, i - set1(48.0))),
+          gather(log_table2, j + set1(43.0)));
+  s = add(s, mul_pwr2(add(u, mul(u, p)), 2.0));
+
+  s = select(valid, s, set1(qd_real::_nan));
+  s = select(is_eq(a.x[0], set1(qd_real::_inf.x[0])), set1(qd_real::_inf), s);
+  return s;
+}
+
+/*********** Trigonometric Functions ************/
+/* Same as sin_taylor in qd_real.cpp, but always uses all 8 Taylor terms.
+   Assumes |a| <= pi/2048. */
+QD_SIMD_TARGET inline qd_vec sin_taylor(const qd_vec &a) {
+  qd_vec p, s, x;
+
+  x = neg(sqr(a));
+  s = a;
+  p = a;
+  for (int i = 0; i < n_inv_fact; i += 2) {
+    p = mul(p, x);
+    s = add(s, mul(p, set1(qd_real(inv_fact[i][0], inv_fact[i][1],
+        inv_fact[i][2], inv_fact[i][3]))));
+  }
+  return s;
+}
+
+/* Same as sincos in qd_real.cpp. The table entries are gathered, and the
+   final quadrant is chosen per lane using masks. Lanes with |a| >= 1e6 are
+   reduced by the scalar rem_pio2. */
+QD_SIMD_TARGET inline void sincos(const qd_vec &a, qd_vec &sin_a,
+    qd_vec &cos_a) {
+  qd_vec t, u, v, sin_t, cos_t, s, c;
+  vec q, j, k, abs_k, idx;
+  mask bad, zero_k, neg_k;
+
+  /* reduce modulo pi/2 (Cody-Waite) */
+  q = floor(a.x[0] * set1(inv_pio2) + set1(0.5));
+  t = a;
+  for (int i = 0; i < n_pio2_cw; i++)
+    t = add(t, -(q * set1(pio2_cw[i])));
+  j = q - set1(4.0) * floor(q * set1(0.25));
+  j = select(is_eq(j, set1(3.0)), set1(-1.0), j);
+
+  if (any(is_le(set1(1.0e6), abs(a.x[0])))) {
+    double ax[4][width], tx[4][width], jl[width];
+    for (int n = 0; n < 4; n++) {
+      store(ax[n], a.x[n]);
+      store(tx[n], t.x[n]);
+    }
+    store(jl, j);
+    for (int l = 0; l < width; l++)
+      if (qd_fabs(ax[0][l]) >= 1.0e6) {
+        qd_real tl;
+        int jj;
+        if (!::rem_pio2(qd_real(ax[0][l], ax[1][l], ax[2][l], ax[3][l]), tl,
+            jj))
+          jj = 4;
+        for (int n = 0; n < 4; n++)
+          tx[n][l] = tl.x[n];
+        jl[l] = jj;
+      }
+    for (int n = 0; n < 4; n++)
+      t.x[n] = load(tx[n]);
+    j = load(jl);
+  }
+
+  /* reduce modulo pi/1024 */
+  k = floor(t.x[0] / set1(qd_real::_pi1024.x[0]) + set1(0.5));
+  t = add(t, neg(mul(set1(qd_real::_pi1024), k)));
+  abs_k = abs(k);
+
+  /* Cannot reduce modulo pi/2 (a is not finite) or pi/1024 */
+  bad = mask_or(is_lt(set1(2.0), abs(j)), is_lt(set1(256.0), abs_k));
+
+  sin_t = sin_taylor(t);
+  cos_t = sqrt(add(neg(sqr(sin_t)), set1(1.0)));
+
+  /* (u, v) = (cos(k * pi/1024), sin(|k| * pi/1024)); (1, 0) if k = 0.
+     Lanes with k out of range (or NaN) look up entry 0. */
+  zero_k = is_zero(k);
+  idx = select(mask_and(is_le(set1(1.0), abs_k), is_le(abs_k, set1(256.0))),
+      abs_k - set1(1.0), set1(0.0));
+  u = select(zero_k, set1(qd_real(1.0)), gather(cos_table, idx));
+  v = select(zero_k, set1(qd_real(0.0)), gather(sin_table, idx));
+  neg_k = is_lt(k, set1(0.0));
+  v = select(neg_k, neg(v), v);
+
+  s = add(mul(u, sin_t), mul(v, cos_t));
+  c = add(mul(u, cos_t), neg(mul(v, sin_t)));
+
+  /* j = 1: (c, -s); j = -1: (-c, s); |j| = 2: (-s, -c) */
+  {
+    mask j1 = is_eq(abs(j), set1(1.0));
+    mask j2 = is_eq(abs(j), set1(2.0));
+    mask jn = is_lt(j, set1(0.0));
+    sin_a = select(j1, select(jn, neg(c), c), select(j2, neg(s), s));
+    cos_a = select(j1, select(jn, s, neg(s)), select(j2, neg(c), c));
+  }
+
+  sin_a = select(bad, set1(qd_real::_nan), sin_a);
+  cos_a = select(bad, set1(qd_real::_nan), cos_a);
+}
+
+/* Same as atan2 in qd_real.cpp, see atan2 in dd_batch.h. */
+QD_SIMD_TARGET inline qd_vec atan2(const qd_vec &y, const qd_vec &x) {
+  qd_vec ax, ay, t, num, den, v, w, p, z;
+  vec inf, f, k1, c1, k2, c2, c, w0;
+  mask regular, swap;
+
+  inf = set1(__builtin_inf());
+  regular = mask_and(
+      mask_and(is_nonzero(x.x[0]), is_lt(abs(x.x[0]), inf)),
+      mask_and(is_nonzero(y.x[0]), is_lt(abs(y.x[0]), inf)));
+  regular = mask_andnot(regular, is_eq(abs(x.x[0]), abs(y.x[0])));
+
+  /* The other lanes compute atan2(1/2, 1) */
+  ax = select(is_lt(x.x[0], set1(0.0)), neg(x), x);
+  ay = select(is_lt(y.x[0], set1(0.0)), neg(y), y);
+  ax = select(regular, ax, set1(qd_real(1.0)));
+  ay = select(regular, ay, set1(qd_real(0.5)));
+
+  swap = is_lt(ax.x[3], ay.x[3]);
+  for (int n = 2; n >= 0; n--)
+    swap = mask_or(is_lt(ax.x[n], ay.x[n]),
+        mask_and(is_eq(ay.x[n], ax.x[n]), swap));
+  t = ax;
+  ax = select(swap, ay, ax);
+  ay = select(swap, t, ay);
+
+  /* Scale the arguments to avoid overflow and underflow */
+  f = select(is_lt(set1(1e290), ax.x[0]), set1(2.40991986510288411e-181),
+      select(is_lt(ax.x[0], set1(1e-200)), set1(4.14951556888099290e+180),
+      set1(1.0)));
+  for (int n = 0; n < 4; n++) {
+    ax.x[n] = ax.x[n] * f;
+    ay.x[n] = ay.x[n] * f;
+  }
+
+  k1 = floor(ay.x[0] / ax.x[0] * set1(64.0) + set1(0.5));
+  c1 = k1 * set1(1.0 / 64.0);
+  num = add(ay, neg(mul(ax, c1)));
+  den = add(ax, mul(ay, c1));
+
+  k2 = floor(num.x[0] / den.x[0] * set1(4096.0) + set1(0.5));
+  c2 = k2 * set1(1.0 / 4096.0);
+  v = div(add(num, neg(mul(den, c2))), add(den, mul(num, c2)));
+
+  w = sqr(v);
+  w0 = w.x[0];
+
+  /* atan(v) = v - v w (1/3 - w (1/5 - ... - w (1/13 - w c))), with
+     w = v^2 and c = 1/15 - w/17 */
+  c = set1(inv_odd[6][0]) - w0 * set1(inv_odd[7][0]);
+  p = add(set1(qd_real(inv_odd[5])), -(w0 * c));
+  for (int n = 4; n >= 0; n--)
+    p = add(set1(qd_real(inv_odd[n])), neg(mul(w, p)));
+  p = mul(w, p);
+
+  z = add(add(gather(atan_table1, k1), gather(atan_table2, k2 + set1(32.0))),
+      add(v, neg(mul(v, p))));
+
+  z = select(swap, add(set1(qd_real::_pi2), neg(z)), z);
+  z = select(is_lt(x.x[0], set1(0.0)), add(set1(qd_real::_pi), neg(z)), z);
+  z = select(is_lt(y.x[0], set1(0.0)), neg(z), z);
+
+  if (!all(regular)) {
+    double yx[4][width], xx[4][width], zx[4][width], r[width];
+    for (int n = 0; n < 4; n++) {
+      store(yx[n], y.x[n]);
+      store(xx[n], x.x[n]);
+      store(zx[n], z.x[n]);
+    }
+    store(r, select(regular, set1(1.0), set1(0.0)));
+    for (int l = 0; l < width; l++)
+      if (r[l] == 0.0) {
+        qd_real zl = ::atan2(qd_real(yx[0][l], yx[1][l], yx[2][l], yx[3][l]),
+            qd_real(xx[0][l], xx[1][l], xx[2][l], xx[3][l]));
+        for (int n = 0; n < 4; n++)
+          zx[n][l] = zl.x[n];
+      }
+    for (int n = 0; n < 4; n++)
+      z.x[n] = load(zx[n]);
+  }
+  return z;
+}
+
+/*********** Polynomials ************/
+/* The same coefficients for all lanes */
+struct qd_coef_bcast {
+  const qd_real *c;
+  QD_SIMD_TARGET qd_vec operator()(int k) const { return set1(c[k]); }
+};
+
+/* Different coefficients for every lane: element i of c[k] and up */
+struct qd_coef_load {
+  const qd_real_array *c;
+  int i;
+  QD_SIMD_TARGET qd_vec operator()(int k) const { return load(c + k, i); }
+};
+
+/* Same as qd_estrin8 in qd_real.cpp */
+template <class Coef>
+QD_SIMD_TARGET inline qd_vec estrin8(const Coef &coef, int k,
+    const qd_vec &x, const qd_vec &x2, const qd_vec &x4) {
+  qd_vec p0 = add(coef(k), mul(coef(k + 1), x));
+  qd_vec p1 = add(coef(k + 2), mul(coef(k + 3), x));
+  qd_vec p2 = add(coef(k + 4), mul(coef(k + 5), x));
+  qd_vec p3 = add(coef(k + 6), mul(coef(k + 7), x));
+  return add(add(p0, mul(p1, x2)), mul(add(p2, mul(p3, x2)), x4));
+}
+
+/* Same as qd_polyeval in qd_real.cpp. Assumes n >= 0. */
+template <class Coef>
+QD_SIMD_TARGET inline qd_vec polyeval(const Coef &coef, int n,
+    const qd_vec &x) {
+  int k = (n + 1) & ~7;
+  qd_vec r;
+  if (k <= n) {
+    r = coef(n);
+    for (int i = n - 1; i >= k; i--)
+      r = add(mul(r, x), coef(i));
+    if (k == 0)
+      return r;
+  }
+
+  qd_vec x2 = sqr(x);
+  qd_vec x4 = sqr(x2);
+  qd_vec x8 = sqr(x4);
+  if (k > n) {
+    k -= 8;
+    r = estrin8(coef, k, x, x2, x4);
+  }
+  while (k > 0) {
+    k -= 8;
+    r = add(mul(r, x8), estrin8(coef, k, x, x2, x4));
+  }
+  return r;
+}
+
+/*********** Array Kernels ************/
+QD_SIMD_TARGET void qd_add_n(const qd_real_array *a, const qd_real_array *b,
+    qd_real_array *c, int i) {
+  for (; i <= c->count - width; i += width)
+    store(c, i, add(load(a, i), load(b, i)));
+  zero_upper();
+  generic::qd_add_n(a, b, c, i);
+}
+
+QD_SIMD_TARGET void qd_sub_n(const qd_real_array *a, const qd_real_array *b,
+    qd_real_array *c, int i) {
+  for (; i <= c->count - width; i += width)
+    store(c, i, add(load(a, i), neg(load(b, i))));
+  zero_upper();
+  generic::qd_sub_n(a, b, c, i);
+}
+
+QD_SIMD_TARGET void qd_mul_n(const qd_real_array *a, const qd_real_array *b,
+    qd_real_array *c, int i) {
+  for (; i <= c->count - width; i += width)
+    store(c, i, mul(load(a, i), load(b, i)));
+  zero_upper();
+  generic::qd_mul_n(a, b, c, i);
+}
+
+QD_SIMD_TARGET void qd_fma_n(const qd_real_array *a, const qd_real_array *b,
+    qd_real_array *c, int i) {
+  for (; i <= c->count - width; i += width)
+    store(c, i, add(load(c, i), mul(load(a, i), load(b, i))));
+  zero_upper();
+  generic::qd_fma_n(a, b, c, i);
+}
+
+QD_SIMD_TARGET void qd_axpy_n(const qd_real &alpha, const qd_real_array *x,
+    qd_real_array *y, int i) {
+  qd_vec a = set1(alpha);
+  for (; i <= y->count - width; i += width)
+    store(y, i, add(load(y, i), mul(a, load(x, i))));
+  zero_upper();
+  generic::qd_axpy_n(alpha, x, y, i);
+}
+
+QD_SIMD_TARGET void qd_sqr_n(const qd_real_array *a, qd_real_array *b,
+    int i) {
+  for (; i <= b->count - width; i += width)
+    store(b, i, sqr(load(a, i)));
+  zero_upper();
+  generic::qd_sqr_n(a, b, i);
+}
+
+QD_SIMD_TARGET void qd_exp_n(const qd_real_array *a, qd_real_array *b,
+    int i) {
+  for (; i <= b->count - width; i += width)
+    store(b, i, exp(load(a, i)));
+  if (i < b->count)
+    store_partial(b, i, b->count - i, exp(load_partial(a, i, b->count - i)));
+  zero_upper();
+}
+
+QD_SIMD_TARGET void qd_log_n(const qd_real_array *a, qd_real_array *b,
+    int i) {
+  for (; i <= b->count - width; i += width)
+    store(b, i, log(load(a, i)));
+  if (i < b->count)
+    store_partial(b, i, b->count - i, log(load_partial(a, i, b->count - i)));
+  zero_upper();
+}
+
+QD_SIMD_TARGET void qd_sincos_n(const qd_real_array *a, qd_real_array *s,
+    qd_real_array *c, int i) {
+  qd_vec sin_a, cos_a;
+  for (; i <= s->count - width; i += width) {
+    sincos(load(a, i), sin_a, cos_a);
+    store(s, i, sin_a);
+    store(c, i, cos_a);
+  }
+  if (i < s->count) {
+    sincos(load_partial(a, i, s->count - i), sin_a, cos_a);
+    store_partial(s, i, s->count - i, sin_a);
+    store_partial(c, i, s->count - i, cos_a);
+  }
+  zero_upper();
+}
+
+QD_SIMD_TARGET void qd_atan2_n(const qd_real_array *a,
+    const qd_real_array *b, qd_real_array *c, int i) {
+  for (; i <= c->count - width; i += width)
+    store(c, i, atan2(load(a, i), load(b, i)));
+  zero_upper();
+  generic::qd_atan2_n(a, b, c, i);
+}
+
+/* One polynomial at many points, and many polynomials at one point */
+QD_SIMD_TARGET void qd_polyeval_n(const qd_real *c, int n,
+    const qd_real_array *x, qd_real_array *y, int i) {
+  if (n >= 0) {
+    qd_coef_bcast coef = { c };
+    for (; i <= y->count - width; i += width)
+      store(y, i, polyeval(coef, n, load(x, i)));
+  }
+  zero_upper();
+  generic::qd_polyeval_n(c, n, x, y, i);
+}
+
+QD_SIMD_TARGET void qd_polyeval_set_n(const qd_real_array *c, int n,
+    const qd_real &x, qd_real_array *y, int i) {
+  if (n >= 0) {
+    qd_vec xv = set1(x);
+    for (; i <= y->count - width; i += width) {
+      qd_coef_load coef = { c, i };
+      store(y, i, polyeval(coef, n, xv));
+    }
+  }
+  zero_upper();
+  generic::qd_polyeval_set_n(c, n, x, y, i);
+}
+
+/* Compensated sum, with the accumulators (see qd_acc in qd_batch.cpp) in
+   qd_acc_count / width vectors per level. */
+const int acc_vecs = qd_acc_count / width;
+
+QD_SIMD_TARGET void qd_sum_d(const double *a, int n, qd_acc *acc, int i) {
+  vec s[4][acc_vecs];
+  for (int j = 0; j < 4; j++)
+    for (int k = 0; k < acc_vecs; k++)
+      s[j][k] = load(acc->s[j] + k * width);
+  for (; i <= n - qd_acc_count; i += qd_acc_count) {
+    for (int k = 0; k < acc_vecs; k++) {
+      vec e;
+      s[0][k] = two_sum(s[0][k], load(a + i + k * width), e);
+      s[1][k] = two_sum(s[1][k], e, e);
+      s[2][k] = two_sum(s[2][k], e, e);
+      s[3][k] += e;
+    }
+  }
+  for (int j = 0; j < 4; j++)
+    for (int k = 0; k < acc_vecs; k++)
+      store(acc->s[j] + k * width, s[j][k]);
+  zero_upper();
+  generic::qd_sum_d(a, n, acc, i);
+}
+
+QD_SIMD_TARGET void qd_dot_qd(const qd_real_array *a, const qd_real_array *b,
+    qd_acc *acc, int i) {
+  qd_vec s[acc_vecs];
+  for (int j = 0; j < 4; j++)
+    for (int k = 0; k < acc_vecs; k++)
+      s[k].x[j] = load(acc->s[j] + k * width);
+  for (; i <= a->count - qd_acc_count; i += qd_acc_count)
+    for (int k = 0; k < acc_vecs; k++)
+      s[k] = add(s[k], mul(load(a, i + k * width), load(b, i + k * width)));
+  for (int j = 0; j < 4; j++)
+    for (int k = 0; k < acc_vecs; k++)
+      store(acc->s[j] + k * width, s[k].x[j]);
+  zero_upper();
+  generic::qd_dot_qd(a, b, acc, i);
+}
+
+/* Array-of-structures to structure-of-arrays and back */
+QD_SIMD_TARGET void qd_to_soa_n(const qd_real *a, qd_real_array *b, int i) {
+  for (; i <= b->count - width; i += width) {
+    vec x0, x1, x2, x3;
+    deinterleave4(a[i].x, x0, x1, x2, x3);
+    store(b->x[0] + i, x0);
+    store(b->x[1] + i, x1);
+    store(b->x[2] + i, x2);
+    store(b->x[3] + i, x3);
+  }
+  zero_upper();
+  generic::qd_to_soa_n(a, b, i);
+}
+
+QD_SIMD_TARGET void qd_to_aos_n(const qd_real_array *a, qd_real *b, int i) {
+  for (; i <= a->count - width; i += width)
+    interleave4(b[i].x, load(a->x[0] + i), load(a->x[1] + i),
+      load(a->x[2] + i), load(a->x[3] + i));
+  zero_upper();
+  generic::qd_to_aos_n(a, b, i);
+}
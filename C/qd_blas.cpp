@@ -0,0 +1,266 @@
+/*
+ * qd_blas.cpp
+ *
+ * Quad-double matrix products (see c_blas.h).
+ *
+ * This follows dd_blas.cpp, with 4 components instead of 2, and with
+ * quad-double accumulators: the products are added with the quad-double
+ * operators, which renormalize after every addition. The kernels for the
+ * rows of c_qd_gemv are the dot product kernels in qd_batch.h, so this
+ * file must be included after qd_batch.cpp (see c_qd.cpp).
+ *
+ * The work buffer of c_qd_gemm holds the packed block of a (qd_gemm_tile
+ * rows and qd_gemm_depth columns), the packed block of b (qd_gemm_depth
+ * rows and qd_gemm_tile columns), and the accumulators of the tile, in 4
+ * planes of qd_gemm_tile x qd_gemm_tile doubles. In the packed panels,
+ * the 4 components of each column (row) of a panel are stored one after
+ * the other.
+ */
+#include "qd_config.h"
+#include "qd_real.h"
+#include "c_qd.h"
+#include "c_blas.h"
+#include "qd_cpu.h"
+#include "simd.h"
+
+enum {
+  qd_gemm_mr = 2,                    /* rows of a block of the kernels */
+  qd_gemm_tile = QD_QD_GEMM_TILE,
+  qd_gemm_depth = 128,               /* columns of a packed at once */
+  qd_gemm_plane = qd_gemm_tile * qd_gemm_tile,
+  qd_gemv_rows = 8                   /* rows of a gemv_cols kernel */
+};
+
+namespace qd {
+namespace generic {
+
+const int qd_gemm_nr = 1;
+
+/* Adds the products of kc columns of a packed panel of a and kc rows of a
+   packed panel of b (with panels of nr columns) to the accumulators of a
+   block of qd_gemm_mr x nr elements. Component q of element (r, c) of the
+   block is at s[q * qd_gemm_plane + r * ld + c]. If first is true, the
+   accumulators start at zero. */
+inline void qd_gemm_block_n(const double *a, const double *b, int kc, int nr,
+    double *s, int ld, bool first) {
+  for (int r = 0; r < qd_gemm_mr; r++)
+    for (int c = 0; c < nr; c++) {
+      double *t = s + r * ld + c;
+      qd_real sum = first ? qd_real(0.0) : qd_real(t[0], t[qd_gemm_plane],
+          t[2 * qd_gemm_plane], t[3 * qd_gemm_plane]);
+      for (int k = 0; k < kc; k++) {
+        const double *x = a + k * 4 * qd_gemm_mr + r, *y = b + k * 4 * nr + c;
+        sum += qd_real(x[0], x[qd_gemm_mr], x[2 * qd_gemm_mr], x[3 * qd_gemm_mr]) *
+            qd_real(y[0], y[nr], y[2 * nr], y[3 * nr]);
+      }
+      for (int q = 0; q < 4; q++)
+        t[q * qd_gemm_plane] = sum.x[q];
+    }
+}
+
+void qd_gemm_block(const double *a, const double *b, int kc, double *s,
+    int ld, bool first) {
+  qd_gemm_block_n(a, b, kc, qd_gemm_nr, s, ld, first);
+}
+
+/* Accumulates a(i, j) * x[j] over all columns j, for rows row .. row + n - 1
+   (n <= qd_gemv_rows) of a. Component q of row r is stored in
+   s[q * qd_gemv_rows + r]. */
+void qd_gemv_cols(const qd_matrix *a, const qd_matrix *x, int row, int n,
+    double *s) {
+  for (int r = 0; r < n; r++) {
+    int i = (row + r) * a->row_stride;
+    qd_real sum = 0.0;
+    for (int j = 0; j < a->cols; j++) {
+      int k = i + j * a->col_stride, l = j * x->row_stride;
+      sum += qd_real(a->x[0][k], a->x[1][k], a->x[2][k], a->x[3][k]) *
+          qd_real(x->x[0][l], x->x[1][l], x->x[2][l], x->x[3][l]);
+    }
+    for (int q = 0; q < 4; q++)
+      s[q * qd_gemv_rows + r] = sum.x[q];
+  }
+}
+
+}
+}
+
+#ifdef QD_FMA_DISPATCH
+
+namespace qd {
+namespace sse2 {
+#define QD_SIMD_TARGET QD_TARGET_SSE2
+#include "qd_blas.h"
+#undef QD_SIMD_TARGET
+}
+
+namespace avx2 {
+#define QD_SIMD_TARGET QD_TARGET_AVX2
+#include "qd_blas.h"
+#undef QD_SIMD_TARGET
+}
+
+namespace avx512 {
+#define QD_SIMD_TARGET QD_TARGET_AVX512
+#include "qd_blas.h"
+#undef QD_SIMD_TARGET
+}
+}
+
+#endif /* QD_FMA_DISPATCH */
+
+/* Matrix product kernels for a specific instruction set. */
+struct qd_blas_kernels {
+  int nr;                /* columns of a block of gemm_block */
+  void (*gemm_block)(const double *, const double *, int, double *, int, bool);
+  void (*gemv_cols)(const qd_matrix *, const qd_matrix *, int, int, double *);
+  void (*dot_qd)(const qd_real_array *, const qd_real_array *, qd_acc *, int);
+};
+
+#define QD_QD_BLAS_KERNELS(ns) { ns::qd_gemm_nr, ns::qd_gemm_block, \
+  ns::qd_gemv_cols, ns::qd_dot_qd }
+
+#ifdef QD_FMA_DISPATCH
+static const qd_blas_kernels qd_blas_sse2 = QD_QD_BLAS_KERNELS(qd::sse2);
+static const qd_blas_kernels qd_blas_avx2 = QD_QD_BLAS_KERNELS(qd::avx2);
+static const qd_blas_kernels qd_blas_avx512 = QD_QD_BLAS_KERNELS(qd::avx512);
+#else
+static const qd_blas_kernels qd_blas_generic = QD_QD_BLAS_KERNELS(qd::generic);
+#endif
+
+/* Returns the fastest matrix product kernels for this CPU. */
+static const qd_blas_kernels *qd_blas_select(int cpu_features) {
+#ifdef QD_FMA_DISPATCH
+  if (cpu_features & qd::cpu_avx512)
+    return &qd_blas_avx512;
+  if (cpu_features & qd::cpu_avx2)
+    return &qd_blas_avx2;
+  return &qd_blas_sse2;
+#else
+  return &qd_blas_generic;
+#endif
+}
+
+/* Packs rows i0 .. i0 + m - 1 and columns k0 .. k0 + kc - 1 of a */
+static void qd_gemm_pack_a(const qd_matrix *a, int i0, int m, int k0, int kc,
+    double *p) {
+  for (int i = 0; i < m; i += qd_gemm_mr)
+    for (int k = 0; k < kc; k++, p += 4 * qd_gemm_mr)
+      for (int r = 0; r < qd_gemm_mr; r++) {
+        int index = (i0 + i + r) * a->row_stride + (k0 + k) * a->col_stride;
+        bool inside = i + r < m;
+        for (int q = 0; q < 4; q++)
+          p[q * qd_gemm_mr + r] = inside ? a->x[q][index] : 0.0;
+      }
+}
+
+/* Packs rows k0 .. k0 + kc - 1 and columns j0 .. j0 + n - 1 of b, in panels
+   of nr columns */
+static void qd_gemm_pack_b(const qd_matrix *b, int k0, int kc, int j0, int n,
+    int nr, double *p) {
+  for (int j = 0; j < n; j += nr)
+    for (int k = 0; k < kc; k++, p += 4 * nr)
+      for (int c = 0; c < nr; c++) {
+        int index = (k0 + k) * b->row_stride + (j0 + j + c) * b->col_stride;
+        bool inside = j + c < n;
+        for (int q = 0; q < 4; q++)
+          p[q * nr + c] = inside ? b->x[q][index] : 0.0;
+      }
+}
+
+/* x[index] = alpha * sum + beta * x[index] */
+static inline void qd_blas_update(double *const *x, int index,
+    const qd_real &alpha, const qd_real &beta, const qd_real &sum) {
+  qd_real r = alpha * sum;
+  if (!beta.is_zero())
+    r += beta * qd_real(x[0][index], x[1][index], x[2][index], x[3][index]);
+  for (int q = 0; q < 4; q++)
+    x[q][index] = r.x[q];
+}
+
+/* Computes tiles of the product until all tiles have been claimed, like
+   dd_gemm_tiles. */
+static void qd_gemm_tiles(const qd_blas_kernels *kernels, qd_gemm *g,
+    double *work) {
+  const qd_matrix *a = &g->a, *b = &g->b, *c = &g->c;
+  if (a->rows != c->rows || b->cols != c->cols || a->cols != b->rows)
+    return;
+
+  int m = c->rows, n = c->cols, depth = a->cols, nr = kernels->nr;
+  int tiles_n = (n + qd_gemm_tile - 1) / qd_gemm_tile;
+  int tiles = ((m + qd_gemm_tile - 1) / qd_gemm_tile) * tiles_n;
+  qd_real alpha(g->alpha), beta(g->beta);
+  double *pa = work;
+  double *pb = pa + 4 * qd_gemm_tile * qd_gemm_depth;
+  double *s = pb + 4 * qd_gemm_depth * qd_gemm_tile;
+
+  for (;;) {
+    int tile = __atomic_fetch_add(&g->next_tile, 1, __ATOMIC_RELAXED);
+    if (tile >= tiles)
+      return;
+    int i0 = (tile / tiles_n) * qd_gemm_tile, j0 = (tile % tiles_n) * qd_gemm_tile;
+    int mc = m - i0 < qd_gemm_tile ? m - i0 : qd_gemm_tile;
+    int nc = n - j0 < qd_gemm_tile ? n - j0 : qd_gemm_tile;
+
+    for (int k0 = 0; k0 < depth; k0 += qd_gemm_depth) {
+      int kc = depth - k0 < qd_gemm_depth ? depth - k0 : qd_gemm_depth;
+      qd_gemm_pack_a(a, i0, mc, k0, kc, pa);
+      qd_gemm_pack_b(b, k0, kc, j0, nc, nr, pb);
+      for (int i = 0; i < mc; i += qd_gemm_mr)
+        for (int j = 0; j < nc; j += nr)
+          kernels->gemm_block(pa + i * 4 * kc, pb + j * 4 * kc, kc,
+              s + i * qd_gemm_tile + j, qd_gemm_tile, k0 == 0);
+    }
+
+    for (int i = 0; i < mc; i++)
+      for (int j = 0; j < nc; j++) {
+        const double *t = s + i * qd_gemm_tile + j;
+        qd_real sum = depth > 0 ? qd_real(t[0], t[qd_gemm_plane],
+            t[2 * qd_gemm_plane], t[3 * qd_gemm_plane]) : qd_real(0.0);
+        qd_blas_update(c->x, (i0 + i) * c->row_stride + (j0 + j) * c->col_stride,
+            alpha, beta, sum);
+      }
+  }
+}
+
+/* Computes tiles of rows of the product until all tiles have been claimed */
+static void qd_gemv_tiles(const qd_blas_kernels *kernels, qd_gemv *g) {
+  const qd_matrix *a = &g->a, *x = &g->x, *y = &g->y;
+  if (x->rows != a->cols || y->rows != a->rows || x->cols != 1 || y->cols != 1)
+    return;
+
+  int m = a->rows;
+  int tiles = (m + QD_GEMV_TILE - 1) / QD_GEMV_TILE;
+  qd_real alpha(g->alpha), beta(g->beta);
+
+  for (;;) {
+    int tile = __atomic_fetch_add(&g->next_tile, 1, __ATOMIC_RELAXED);
+    if (tile >= tiles)
+      return;
+    int i0 = tile * QD_GEMV_TILE;
+    int mc = m - i0 < QD_GEMV_TILE ? m - i0 : QD_GEMV_TILE;
+
+    if (a->col_stride == 1 && x->row_stride == 1) {
+      qd_real_array row, column = { { x->x[0], x->x[1], x->x[2], x->x[3] },
+          a->cols };
+      row.count = a->cols;
+      for (int i = i0; i < i0 + mc; i++) {
+        for (int q = 0; q < 4; q++)
+          row.x[q] = a->x[q] + i * a->row_stride;
+        qd_acc acc = { };
+        kernels->dot_qd(&row, &column, &acc, 0);
+        qd_blas_update(y->x, i * y->row_stride, alpha, beta,
+            qd::generic::qd_acc_sum(&acc));
+      }
+    } else {
+      for (int i = i0; i < i0 + mc; i += qd_gemv_rows) {
+        int n = i0 + mc - i < qd_gemv_rows ? i0 + mc - i : qd_gemv_rows;
+        double s[4 * qd_gemv_rows];
+        kernels->gemv_cols(a, x, i, n, s);
+        for (int r = 0; r < n; r++)
+          qd_blas_update(y->x, (i + r) * y->row_stride, alpha, beta,
+              qd_real(s[r], s[qd_gemv_rows + r], s[2 * qd_gemv_rows + r],
+              s[3 * qd_gemv_rows + r]));
+      }
+    }
+  }
+}
@@ -0,0 +1,68 @@
+/*
+ * qd_blas.h
+ *
+ * Quad-double matrix product kernels, operating on blocks that are
+ * "width" columns wide. This file is included once for each of the SIMD
+ * namespaces in simd.h (see qd_blas.cpp), after qd_batch.h. Like the
+ * batch kernels, the results are bitwise identical to the scalar versions
+ * in qd::generic.
+ */
+
+const int qd_gemm_nr = width;
+
+QD_SIMD_TARGET void qd_gemm_block(const double *a, const double *b, int kc,
+    double *s, int ld, bool first) {
+  qd_vec sum[qd_gemm_mr];
+  for (int r = 0; r < qd_gemm_mr; r++)
+    for (int q = 0; q < 4; q++)
+      sum[r].x[q] = first ? set1(0.0) : load(s + q * qd_gemm_plane + r * ld);
+
+  for (int k = 0; k < kc; k++, a += 4 * qd_gemm_mr, b += 4 * width) {
+    qd_vec y;
+    for (int q = 0; q < 4; q++)
+      y.x[q] = load(b + q * width);
+    for (int r = 0; r < qd_gemm_mr; r++) {
+      qd_vec x;
+      for (int q = 0; q < 4; q++)
+        x.x[q] = set1(a[q * qd_gemm_mr + r]);
+      sum[r] = add(sum[r], mul(x, y));
+    }
+  }
+
+  for (int r = 0; r < qd_gemm_mr; r++)
+    for (int q = 0; q < 4; q++)
+      store(s + q * qd_gemm_plane + r * ld, sum[r].x[q]);
+  zero_upper();
+}
+
+/* Accumulates qd_gemv_rows rows at once, if they are contiguous */
+QD_SIMD_TARGET void qd_gemv_cols(const qd_matrix *a, const qd_matrix *x,
+    int row, int n, double *s) {
+  if (n == qd_gemv_rows && a->row_stride == 1) {
+    const int vecs = qd_gemv_rows / width;
+    qd_vec sum[vecs];
+    for (int k = 0; k < vecs; k++)
+      for (int q = 0; q < 4; q++)
+        sum[k].x[q] = set1(0.0);
+
+    for (int j = 0; j < a->cols; j++) {
+      int i = row + j * a->col_stride, l = j * x->row_stride;
+      qd_vec v;
+      for (int q = 0; q < 4; q++)
+        v.x[q] = set1(x->x[q][l]);
+      for (int k = 0; k < vecs; k++) {
+        qd_vec u;
+        for (int q = 0; q < 4; q++)
+          u.x[q] = load(a->x[q] + i + k * width);
+        sum[k] = add(sum[k], mul(u, v));
+      }
+    }
+
+    for (int k = 0; k < vecs; k++)
+      for (int q = 0; q < 4; q++)
+        store(s + q * qd_gemv_rows + k * width, sum[k].x[q]);
+    zero_upper();
+    return;
+  }
+  generic::qd_gemv_cols(a, x, row, n, s);
+}
@@ -15,6 +15,12 @@
 #define QD_API __attribute__((regparm(3)))
 
 #endif 
+#elif defined(__linux__) && !defined(HP_ANDROID)
+
+// The Linux libraries are compiled with -fvisibility=hidden, so only the
+// functions marked with QD_API are exported from the shared library.
+#define QD_API __attribute__((visibility("default")))
+
 #else
 
 #define QD_API
@@ -46,6 +52,17 @@
 #define QD_ISNAN(x) ( __builtin_isnan(x) != 0 )
 #endif
 
+#if defined(__aarch64__)
+/* ARMv8 always supports fused multiply-add, so two_prod and two_sqr can use
+   a single fused multiply-subtract instead of Dekker's split. */
+#define QD_FMS(a, b, c) __builtin_fma(a, b, -(c))
+#elif defined(__x86_64__) || defined(__i386__)
+/* On Intel, FMA3 is optional. The multiplication kernels are compiled a
+   second time for FMA3 and selected at runtime (see qd_cpu.h). */
+#define QD_FMA_DISPATCH 1
+#define QD_FMA_TARGET __attribute__((target("fma")))
+#endif
+
 #ifdef HP_ACCURATE
 #define QD_IEEE_ADD 1
 #else
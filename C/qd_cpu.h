@@ -0,0 +1,86 @@
+/*
+ * qd_cpu.h
+ *
+ * Runtime detection of optional instruction set extensions. Used to select
+ * the FMA versions of the multiplication kernels and the widest available
+ * batch kernels (see simd.h) on Intel CPUs, so a single object file runs on
+ * any x86 CPU. The features are detected the first time they are needed.
+ */
+#ifndef _QD_CPU_H
+#define _QD_CPU_H
+
+#include "qd_config.h"
+
+#ifdef QD_FMA_DISPATCH
+#include <cpuid.h>
+#endif
+
+namespace qd {
+
+enum {
+  cpu_fma    = 1,  /* FMA3 */
+  cpu_avx2   = 2,  /* AVX2 (only reported together with FMA3) */
+  cpu_avx512 = 4,  /* AVX-512 Foundation (implies cpu_avx2) */
+
+  cpu_detected = 0x100  /* set by cached_cpu_features */
+};
+
+/* Returns the cpu_* flags for the extensions supported by both the CPU
+   and the operating system. Always returns 0 if QD_FMA_DISPATCH is not
+   defined (in which case FMA is either always or never used). */
+inline int cpu_features() {
+#ifdef QD_FMA_DISPATCH
+  unsigned int eax, ebx, ecx, edx;
+  unsigned int xcr0_lo, xcr0_hi;
+  int result = 0;
+
+  if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+    return 0;
+
+  /* FMA3 uses VEX encoding, which requires the OS to preserve the YMM
+     registers (OSXSAVE set and XCR0 bits 1 and 2 enabled). */
+  if ((ecx & bit_OSXSAVE) == 0 || (ecx & bit_AVX) == 0)
+    return 0;
+
+  __asm__ ("xgetbv" : "=a" (xcr0_lo), "=d" (xcr0_hi) : "c" (0));
+  if ((xcr0_lo & 6) != 6)
+    return 0;
+
+  if ((ecx & bit_FMA) == 0)
+    return 0;
+  result |= cpu_fma;
+
+  if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx))
+    return result;
+
+  if ((ebx & bit_AVX2) == 0)
+    return result;
+  result |= cpu_avx2;
+
+  /* AVX-512 also requires the OS to preserve the opmask registers and the
+     upper halves of the ZMM registers (XCR0 bits 5, 6 and 7). */
+  if ((ebx & bit_AVX512F) != 0 && (xcr0_lo & 0xE6) == 0xE6)
+    result |= cpu_avx512;
+
+  return result;
+#else
+  return 0;
+#endif
+}
+
+/* Returns cpu_features() | cpu_detected, detecting the features on the first
+   call only. cache must be a zero-initialized static variable. Threads that
+   call this at the same time for the first time all store the same value,
+   so no initialization call or lock is needed. */
+inline int cached_cpu_features(int *cache) {
+  int result = __atomic_load_n(cache, __ATOMIC_RELAXED);
+  if (__builtin_expect(result == 0, 0)) {
+    result = cpu_features() | cpu_detected;
+    __atomic_store_n(cache, result, __ATOMIC_RELAXED);
+  }
+  return result;
+}
+
+}
+
+#endif /* _QD_CPU_H */
@@ -0,0 +1,1155 @@
+/*
+ * qd_decimal.h
+ *
+ * Exact conversion of double-double and quad-double values to and from
+ * decimal strings. This file is included by both dd_real.cpp and
+ * qd_real.cpp, so everything in it is static.
+ *
+ * A value is handled as the exact sum of its components, using a small
+ * fixed-size big integer type, so no memory is allocated and the results
+ * do not depend on the rounding errors of multi-precision arithmetic.
+ * Digits are generated with the algorithm of Steele & White ("Dragon4")
+ * and Burger & Dybvig:
+ * - For a given number of digits, the digits are correctly rounded (ties to
+ *   even) from the exact value.
+ * - The shortest digits are the shortest ones that parse back to the same
+ *   components (see below).
+ *
+ * Parsing sets each component to the nearest double (ties to even) to the
+ * rest of the exact decimal value, as in a normalized expansion. The
+ * resolution of the result depends on the gaps between the components: the
+ * nearest double-double to 0.1 has a second component of about -5.55e-18,
+ * while 1 + 1e-200 has a second component of 1e-200. So every normalized
+ * value, including those with gaps, has a string that converts back to it.
+ * Digits are accumulated in 64-bit chunks, and scaled with exact big integer
+ * multiplications and divisions by powers of five.
+ */
+#ifndef _QD_DECIMAL_H
+#define _QD_DECIMAL_H
+
+#include <stdint.h>
+#include "inline.h"
+
+namespace qd {
+namespace decimal {
+
+/* Number of 32-bit limbs of a big integer. The largest numbers used are
+   about 2^4700: the numerator when parsing a number with max_digits digits
+   near the smallest normalized double. */
+const int big_limbs = 152;
+
+/* Enough digits for the exact decimal expansion of any finite value (at
+   most 309 integer and 1074 fractional digits), and for the midpoints
+   between the values that parsing rounds to (1075 fractional digits). When
+   parsing, any further digits only count as a nonzero "sticky" digit, so
+   the result is correctly rounded for any input. */
+const int max_digits = 1400;
+
+struct big {
+  int n;                     /* number of limbs in use */
+  uint32_t d[big_limbs];     /* least significant limb first */
+};
+
+static void big_set(big &a, uint64_t v) {
+  a.n = 0;
+  while (v != 0) {
+    a.d[a.n++] = static_cast<uint32_t>(v);
+    v >>= 32;
+  }
+}
+
+static bool big_is_zero(const big &a) {
+  return a.n == 0;
+}
+
+/* Number of significant bits */
+static int big_bits(const big &a) {
+  if (a.n == 0)
+    return 0;
+  return 32 * a.n - __builtin_clz(a.d[a.n - 1]);
+}
+
+static int big_cmp(const big &a, const big &b) {
+  if (a.n != b.n)
+    return a.n < b.n ? -1 : 1;
+  for (int i = a.n - 1; i >= 0; i--) {
+    if (a.d[i] != b.d[i])
+      return a.d[i] < b.d[i] ? -1 : 1;
+  }
+  return 0;
+}
+
+/* r = a + b. r may be the same as a or b. */
+static void big_sum(big &r, const big &a, const big &b) {
+  int n = a.n > b.n ? a.n : b.n;
+  uint64_t carry = 0;
+  for (int i = 0; i < n; i++) {
+    uint64_t s = carry;
+    if (i < a.n) s += a.d[i];
+    if (i < b.n) s += b.d[i];
+    r.d[i] = static_cast<uint32_t>(s);
+    carry = s >> 32;
+  }
+  r.n = n;
+  if (carry)
+    r.d[r.n++] = static_cast<uint32_t>(carry);
+}
+
+/* a += b */
+static void big_add(big &a, const big &b) {
+  big_sum(a, a, b);
+}
+
+/* a -= b. Requires a >= b. */
+static void big_sub(big &a, const big &b) {
+  int64_t borrow = 0;
+  for (int i = 0; i < a.n; i++) {
+    int64_t s = static_cast<int64_t>(a.d[i]) - borrow;
+    if (i < b.n)
+      s -= b.d[i];
+    borrow = s < 0;
+    a.d[i] = static_cast<uint32_t>(s + (borrow << 32));
+  }
+  while (a.n > 0 && a.d[a.n - 1] == 0)
+    a.n--;
+}
+
+/* a = b - a. Requires b >= a. */
+static void big_sub_from(big &a, const big &b) {
+  int64_t borrow = 0;
+  for (int i = 0; i < b.n; i++) {
+    int64_t s = static_cast<int64_t>(b.d[i]) - borrow;
+    if (i < a.n)
+      s -= a.d[i];
+    borrow = s < 0;
+    a.d[i] = static_cast<uint32_t>(s + (borrow << 32));
+  }
+  a.n = b.n;
+  while (a.n > 0 && a.d[a.n - 1] == 0)
+    a.n--;
+}
+
+/* Compares a + b with c */
+static int big_cmp_sum(const big &a, const big &b, const big &c) {
+  big t;
+  big_sum(t, a, b);
+  return big_cmp(t, c);
+}
+
+static void big_mul_small(big &a, uint32_t m) {
+  uint64_t carry = 0;
+  for (int i = 0; i < a.n; i++) {
+    uint64_t p = static_cast<uint64_t>(a.d[i]) * m + carry;
+    a.d[i] = static_cast<uint32_t>(p);
+    carry = p >> 32;
+  }
+  if (carry)
+    a.d[a.n++] = static_cast<uint32_t>(carry);
+}
+
+/* a *= 10^k */
+static void big_mul_pow10(big &a, int k) {
+  static const uint32_t pow10[10] = { 1, 10, 100, 1000, 10000, 100000,
+    1000000, 10000000, 100000000, 1000000000 };
+  for (; k >= 9; k -= 9)
+    big_mul_small(a, pow10[9]);
+  if (k > 0)
+    big_mul_small(a, pow10[k]);
+}
+
+/* a = 5^k */
+static void big_pow5(big &a, int k) {
+  static const uint32_t pow5[14] = { 1, 5, 25, 125, 625, 3125, 15625, 78125,
+    390625, 1953125, 9765625, 48828125, 244140625, 1220703125 };
+  big_set(a, 1);
+  for (; k >= 13; k -= 13)
+    big_mul_small(a, pow5[13]);
+  if (k > 0)
+    big_mul_small(a, pow5[k]);
+}
+
+/* a <<= bits */
+static void big_shl(big &a, int bits) {
+  if (a.n == 0 || bits == 0)
+    return;
+  int limbs = bits >> 5, shift = bits & 31;
+
+  /* Each limb is computed from the two source limbs it overlaps, from the
+     top down, so this works in place. */
+  for (int i = a.n + limbs; i >= 0; i--) {
+    int j = i - limbs;
+    uint32_t hi = (j >= 0 && j < a.n) ? a.d[j] : 0;
+    uint32_t lo = (j >= 1 && j <= a.n) ? a.d[j - 1] : 0;
+    a.d[i] = shift ? (hi << shift) | (lo >> (32 - shift)) : hi;
+  }
+  a.n += limbs + 1;
+  while (a.n > 0 && a.d[a.n - 1] == 0)
+    a.n--;
+}
+
+/* Returns bit i of a */
+static int big_bit(const big &a, int i) {
+  if ((i >> 5) >= a.n)
+    return 0;
+  return (a.d[i >> 5] >> (i & 31)) & 1;
+}
+
+/* Whether any of the bits below bit i are set */
+static bool big_any_below(const big &a, int i) {
+  int limb = i >> 5;
+  for (int k = 0; k < limb && k < a.n; k++) {
+    if (a.d[k] != 0)
+      return true;
+  }
+  if (limb < a.n && (a.d[limb] & ((1u << (i & 31)) - 1)) != 0)
+    return true;
+  return false;
+}
+
+/* Divides r by s, where the quotient must be less than 10, and returns
+   the quotient. r is set to the remainder. The most significant limb of s
+   must be in [8, 429496729], so the estimate below is either the quotient
+   or one less. */
+static int big_divmod(big &r, const big &s) {
+  if (r.n < s.n)
+    return 0;
+
+  uint32_t q = r.d[s.n - 1] / (s.d[s.n - 1] + 1);
+  if (q != 0) {
+    /* r -= q * s */
+    uint64_t carry = 0;
+    int64_t borrow = 0;
+    for (int i = 0; i < s.n; i++) {
+      uint64_t p = static_cast<uint64_t>(s.d[i]) * q + carry;
+      carry = p >> 32;
+      int64_t t = static_cast<int64_t>(r.d[i]) -
+        static_cast<int64_t>(static_cast<uint32_t>(p)) - borrow;
+      borrow = t < 0;
+      r.d[i] = static_cast<uint32_t>(t + (borrow << 32));
+    }
+    while (r.n > 0 && r.d[r.n - 1] == 0)
+      r.n--;
+  }
+
+  if (big_cmp(r, s) >= 0) {
+    q++;
+    big_sub(r, s);
+  }
+  return static_cast<int>(q);
+}
+
+/* Returns (hi * 2^32 + lo) / d, which must be less than 2^32, and sets rem
+   to the remainder. The estimate uses floating-point division, because
+   64-bit integer division calls a runtime library function on 32-bit
+   CPUs. It is off by at most one. */
+static uint32_t div_2by1(uint32_t hi, uint32_t lo, uint32_t d, uint32_t &rem) {
+  double est = (hi * 4294967296.0 + lo) / d;
+  uint32_t q = est >= 4294967295.0 ? 0xFFFFFFFFu : static_cast<uint32_t>(est);
+  uint64_t num = (static_cast<uint64_t>(hi) << 32) | lo;
+  int64_t r = static_cast<int64_t>(num - static_cast<uint64_t>(q) * d);
+  while (r < 0) {
+    q--;
+    r += d;
+  }
+  while (r >= static_cast<int64_t>(d)) {
+    q++;
+    r -= d;
+  }
+  rem = static_cast<uint32_t>(r);
+  return q;
+}
+
+/* q = u / v, and u = u % v (Knuth's algorithm D). v must not be zero. The
+   remainder is not shifted back after normalization, so it can only be
+   tested for zero. */
+static void big_div(big &q, big &u, const big &v) {
+  if (big_cmp(u, v) < 0) {
+    q.n = 0;
+    return;
+  }
+
+  int n = v.n, m = u.n - v.n;
+  if (n == 1) {
+    uint32_t rem = 0;
+    for (int i = u.n - 1; i >= 0; i--)
+      q.d[i] = div_2by1(rem, u.d[i], v.d[0], rem);
+    q.n = u.n;
+    while (q.n > 0 && q.d[q.n - 1] == 0)
+      q.n--;
+    big_set(u, rem);
+    return;
+  }
+
+  /* Normalize, so the top limb of v has its high bit set */
+  int shift = __builtin_clz(v.d[n - 1]);
+  uint32_t vn[big_limbs];
+  for (int i = n - 1; i >= 0; i--) {
+    uint32_t lo = (shift && i > 0) ? v.d[i - 1] >> (32 - shift) : 0;
+    vn[i] = shift ? (v.d[i] << shift) | lo : v.d[i];
+  }
+  int total = u.n;
+  big_shl(u, shift);
+  if (u.n == total)
+    u.d[total] = 0;
+  uint32_t *un = u.d;
+  uint32_t vtop = vn[n - 1];
+
+  for (int j = m; j >= 0; j--) {
+    /* Estimate the quotient limb from the top two limbs, and correct it
+       with the next limb. It is then at most one too large. */
+    uint64_t qhat, rhat;
+    if (un[j + n] >= vtop) {
+      qhat = 0xFFFFFFFFu;
+      rhat = static_cast<uint64_t>(un[j + n - 1]) + vtop;
+    } else {
+      uint32_t r32;
+      qhat = div_2by1(un[j + n], un[j + n - 1], vtop, r32);
+      rhat = r32;
+    }
+    while (rhat <= 0xFFFFFFFFu &&
+        qhat * vn[n - 2] > ((rhat << 32) | un[j + n - 2])) {
+      qhat--;
+      rhat += vtop;
+    }
+
+    /* un -= qhat * vn */
+    uint64_t carry = 0;
+    int64_t borrow = 0;
+    for (int i = 0; i < n; i++) {
+      uint64_t p = qhat * vn[i] + carry;
+      carry = p >> 32;
+      int64_t t = static_cast<int64_t>(un[i + j]) -
+        static_cast<int64_t>(static_cast<uint32_t>(p)) - borrow;
+      borrow = t < 0;
+      un[i + j] = static_cast<uint32_t>(t + (borrow << 32));
+    }
+    int64_t t = static_cast<int64_t>(un[j + n]) -
+      static_cast<int64_t>(carry) - borrow;
+    un[j + n] = static_cast<uint32_t>(t);
+
+    /* If that was negative, qhat was one too large: add vn back */
+    if (t < 0) {
+      qhat--;
+      carry = 0;
+      for (int i = 0; i < n; i++) {
+        uint64_t s = static_cast<uint64_t>(un[i + j]) + vn[i] + carry;
+        un[i + j] = static_cast<uint32_t>(s);
+        carry = s >> 32;
+      }
+      un[j + n] += static_cast<uint32_t>(carry);
+    }
+    q.d[j] = static_cast<uint32_t>(qhat);
+  }
+
+  q.n = m + 1;
+  while (q.n > 0 && q.d[q.n - 1] == 0)
+    q.n--;
+  u.n = n;
+  while (u.n > 0 && u.d[u.n - 1] == 0)
+    u.n--;
+}
+
+/* Shifts the numbers so that the most significant limb of s is in the
+   range required by big_divmod. */
+static int big_normalize_shift(const big &s) {
+  int bits = 32 - __builtin_clz(s.d[s.n - 1]);
+  return (28 - bits) & 31;
+}
+
+/* A finite value m * 2^e */
+struct exact {
+  big m;
+  int e;
+  bool negative;
+};
+
+/* Splits a finite double into m * 2^e, with m < 2^53. */
+static uint64_t split(double x, int &e) {
+  union {
+    double d;
+    uint64_t u;
+  } bits;
+  bits.d = x;
+  int biased = static_cast<int>((bits.u >> 52) & 0x7FF);
+  uint64_t m = bits.u & ((static_cast<uint64_t>(1) << 52) - 1);
+  if (biased == 0) {
+    e = -1074;
+    return m;
+  }
+  e = biased - 1075;
+  return m | (static_cast<uint64_t>(1) << 52);
+}
+
+/* Sets v to the exact sum of the n components of x. */
+static void exact_set(exact &v, const double *x, int n) {
+  uint64_t m[4];
+  int e[4], low = 0;
+  bool first = true;
+
+  for (int i = 0; i < n; i++) {
+    m[i] = split(x[i], e[i]);
+    if (m[i] != 0 && (first || e[i] < low)) {
+      low = e[i];
+      first = false;
+    }
+  }
+
+  /* Sum the components with the sign of x[0] and the other ones
+     separately, and subtract. */
+  big pos, neg, t;
+  big_set(pos, 0);
+  big_set(neg, 0);
+  bool negative = x[0] < 0.0 || (x[0] == 0.0 && 1.0 / x[0] < 0.0);
+  for (int i = 0; i < n; i++) {
+    if (m[i] == 0)
+      continue;
+    big_set(t, m[i]);
+    big_shl(t, e[i] - low);
+    if ((x[i] < 0.0) == negative)
+      big_add(pos, t);
+    else
+      big_add(neg, t);
+  }
+
+  if (big_cmp(pos, neg) < 0) {
+    big_sub(neg, pos);
+    v.m = neg;
+    negative = !negative;
+  } else {
+    big_sub(pos, neg);
+    v.m = pos;
+  }
+  v.e = low;
+  v.negative = negative;
+}
+
+/* Estimate of the decimal exponent of the first digit of a value in
+   [2^ebin, 2^(ebin + 1)). Either correct or one too small. */
+static int estimate_exponent(int ebin) {
+  double k = ebin * 0.30102999566398119521;
+  int result = static_cast<int>(k);
+  if (result > k)
+    result--;
+  return result;
+}
+
+/* Sets r and s so that v = r / s * 10^k, with 0.1 <= r / s < 1, and
+   returns k. The other numbers in more are scaled along with r. */
+static int scale(big &r, big &s, int e, int ebin, big *more[], int nmore) {
+  big_set(s, 1);
+  if (e >= 0) {
+    big_shl(r, e);
+    for (int i = 0; i < nmore; i++)
+      big_shl(*more[i], e);
+  } else {
+    big_shl(s, -e);
+  }
+
+  int k = estimate_exponent(ebin) + 1;
+  if (k >= 0) {
+    big_mul_pow10(s, k);
+  } else {
+    big_mul_pow10(r, -k);
+    for (int i = 0; i < nmore; i++)
+      big_mul_pow10(*more[i], -k);
+  }
+  return k;
+}
+
+/* Shifts all numbers so that s is normalized for big_divmod. */
+static void normalize(big &r, big &s, big *more[], int nmore) {
+  int shift = big_normalize_shift(s);
+  big_shl(s, shift);
+  big_shl(r, shift);
+  for (int i = 0; i < nmore; i++)
+    big_shl(*more[i], shift);
+}
+
+/* Sets lo and hi to the distances from the exact sum v of the n components
+   of x to the ends of the interval of decimal values that parse back to x,
+   scaled by 2^-low, and sets closed_lo and closed_hi if the ends themselves
+   parse back to x. Only the components from first on are checked. Returns
+   false if the interval does not contain v or is empty, which can only
+   happen if the components are not normalized.
+
+   A decimal value d parses back to x if d - x[0] - ... - x[k - 1] rounds to
+   x[k] for every k. That is, d - v is at least -(gap below x[k]) -
+   (x[k + 1] + ... + x[n - 1]) and at most (gap above x[k]) - (x[k + 1] +
+   ... + x[n - 1]), where the gaps are half the spacing of the doubles
+   around x[k]. Zero components have gaps of 2^-1075. */
+static bool margins(const double *x, int n, int first, int low, big &lo,
+    big &hi, bool &closed_lo, bool &closed_hi) {
+  big rest_pos, rest_neg, a, b, t;
+  big_set(rest_pos, 0);
+  big_set(rest_neg, 0);
+  for (int k = n - 1; k >= first; k--) {
+    int e;
+    uint64_t m = split(x[k], e);
+    bool closed = (m & 1) == 0;
+
+    /* Below a power of two, the next double towards zero is closer */
+    big away, toward;
+    big_set(away, 1);
+    big_shl(away, e - 1 - low);
+    big_set(toward, 1);
+    big_shl(toward, (m == (static_cast<uint64_t>(1) << 52) && e > -1074 ?
+      e - 2 : e - 1) - low);
+
+    /* a = gap below + rest, b = gap above - rest */
+    big_sum(a, x[k] < 0.0 ? away : toward, rest_pos);
+    big_sum(b, x[k] < 0.0 ? toward : away, rest_neg);
+    if (big_cmp(a, rest_neg) < 0 || big_cmp(b, rest_pos) < 0)
+      return false;
+    big_sub(a, rest_neg);
+    big_sub(b, rest_pos);
+
+    int c = k == n - 1 ? -1 : big_cmp(a, lo);
+    if (c < 0) {
+      lo = a;
+      closed_lo = closed;
+    } else if (c == 0) {
+      closed_lo = closed_lo && closed;
+    }
+    c = k == n - 1 ? -1 : big_cmp(b, hi);
+    if (c < 0) {
+      hi = b;
+      closed_hi = closed;
+    } else if (c == 0) {
+      closed_hi = closed_hi && closed;
+    }
+
+    big_set(t, m);
+    big_shl(t, e - low);
+    big_add(x[k] < 0.0 ? rest_neg : rest_pos, t);
+  }
+  return !big_is_zero(lo) || !big_is_zero(hi) || (closed_lo && closed_hi);
+}
+
+/* Generates the shortest digits of the nonzero exact sum v of the nx
+   components of x that parse back to x. Returns the number of digits, and
+   sets expn to the exponent of the first digit. */
+static int shortest_digits(const exact &v, const double *x, int nx, char *s,
+    int &expn) {
+  /* Scale everything so that all margins are multiples of 2 (zero
+     components have e = -1074) */
+  int low = 0;
+  for (int i = 0; i < nx; i++) {
+    int e;
+    split(x[i], e);
+    if (i == 0 || e - 3 < low)
+      low = e - 3;
+  }
+
+  /* If v would not parse back to x, fall back to the interval of the last
+     component, which at least gives the closest digits. */
+  big r = v.m, s_, mhi, mlo;
+  bool closed_lo, closed_hi;
+  if (!margins(x, nx, 0, low, mlo, mhi, closed_lo, closed_hi)) {
+    margins(x, nx, nx - 1, low, mlo, mhi, closed_lo, closed_hi);
+    closed_lo = closed_hi = false;
+  }
+
+  /* The digits are generated for |v|, which mirrors the interval */
+  if (v.negative) {
+    big t = mlo;
+    mlo = mhi;
+    mhi = t;
+    bool c = closed_lo;
+    closed_lo = closed_hi;
+    closed_hi = c;
+  }
+  big_shl(r, v.e - low);
+
+  /* v can be at an open end of the interval, if parsing rounded the last
+     component up to exactly half the spacing of an earlier one. Then
+     continue with a value just inside the interval. */
+  big one;
+  big_set(one, 1);
+  if (big_is_zero(mhi) && !closed_hi) {
+    big_sub(r, one);
+    big_sub(mlo, one);
+    mhi = one;
+  } else if (big_is_zero(mlo) && !closed_lo) {
+    big_add(r, one);
+    big_sub(mhi, one);
+    mlo = one;
+  }
+  int ebin = big_bits(r) - 1 + low;
+
+  big *more[2] = { &mhi, &mlo };
+  int k = scale(r, s_, low, ebin, more, 2);
+
+  /* If an end of the interval is closed, digits at that end are allowed */
+  if (big_cmp_sum(r, mhi, s_) + closed_hi > 0) {
+    big_mul_small(s_, 10);
+    k++;
+  }
+  normalize(r, s_, more, 2);
+
+  int n = 0;
+  for (;;) {
+    big_mul_small(r, 10);
+    big_mul_small(mhi, 10);
+    big_mul_small(mlo, 10);
+    int d = big_divmod(r, s_);
+
+    bool low_ok = big_cmp(r, mlo) - closed_lo < 0;
+    bool high_ok = big_cmp_sum(r, mhi, s_) + closed_hi > 0;
+    if (!low_ok && !high_ok) {
+      s[n++] = static_cast<char>('0' + d);
+      continue;
+    }
+
+    if (low_ok && high_ok) {
+      /* Both d and d + 1 are within the interval: pick the closest one */
+      big twice;
+      big_sum(twice, r, r);
+      int c = big_cmp(twice, s_);
+      high_ok = c > 0 || (c == 0 && (d & 1) != 0);
+    }
+    s[n++] = static_cast<char>('0' + (high_ok ? d + 1 : d));
+    break;
+  }
+
+  expn = k - 1;
+  return n;
+}
+
+/* Generates the correctly rounded digits of v: count significant digits
+   if fixed is false, or all digits down to 10^-count if fixed is true, but
+   no more than max. Returns the number of digits (0 if v rounds to zero in
+   fixed mode), and sets expn to the exponent of the first digit. The
+   exponent is meaningless if v is zero. */
+static int exact_digits(const exact &v, int count, bool fixed, char *s,
+    int max, int &expn) {
+  big r = v.m, s_;
+  int ebin = big_bits(v.m) - 1 + v.e;
+  int k = scale(r, s_, v.e, ebin, 0, 0);
+  if (big_cmp(r, s_) >= 0) {
+    big_mul_small(s_, 10);
+    k++;
+  }
+  normalize(r, s_, 0, 0);
+
+  /* v = r / s * 10^k, so the first digit has exponent k - 1 */
+  int n = fixed ? k + count : count;
+  if (n > max)
+    n = max;
+
+  if (n <= 0) {
+    /* The value is less than one unit of the last digit. It rounds to one
+       unit if it is more than half a unit. */
+    if (n == 0) {
+      big twice;
+      big_sum(twice, r, r);
+      if (big_cmp(twice, s_) > 0) {
+        s[0] = '1';
+        expn = k;
+        return 1;
+      }
+    }
+    expn = k - 1;
+    return 0;
+  }
+
+  for (int i = 0; i < n; i++) {
+    big_mul_small(r, 10);
+    s[i] = static_cast<char>('0' + big_divmod(r, s_));
+  }
+
+  expn = k - 1;
+  if (big_is_zero(r))
+    return n;
+
+  /* Round to nearest, ties to even */
+  big twice;
+  big_sum(twice, r, r);
+  int c = big_cmp(twice, s_);
+  if (c > 0 || (c == 0 && ((s[n - 1] - '0') & 1) != 0)) {
+    int j = n - 1;
+    while (j >= 0 && s[j] == '9')
+      s[j--] = '0';
+    if (j >= 0) {
+      s[j]++;
+    } else {
+      /* 99..9 rounded up to 100..0 */
+      s[0] = '1';
+      expn++;
+    }
+  }
+  return n;
+}
+
+/* Appends chars to a buffer of a given size, and counts the chars that
+   did not fit. */
+struct writer {
+  char *buf;
+  int size;
+  int len;
+
+  void put(char c) {
+    if (len < size - 1)
+      buf[len] = c;
+    len++;
+  }
+
+  void put(const char *str) {
+    while (*str)
+      put(*str++);
+  }
+
+  void put_zeros(int n) {
+    for (int i = 0; i < n; i++)
+      put('0');
+  }
+
+  void put_exponent(int expn) {
+    put('e');
+    put(expn < 0 ? '-' : '+');
+    if (expn < 0)
+      expn = -expn;
+    if (expn >= 100)
+      put(static_cast<char>('0' + expn / 100));
+    put(static_cast<char>('0' + (expn / 10) % 10));
+    put(static_cast<char>('0' + expn % 10));
+  }
+
+  /* Digits d[0 .. n - 1] of a value with exponent expn, in fixed notation
+     with frac digits after the point (or all remaining digits if frac is
+     negative) */
+  void put_fixed(const char *d, int n, int expn, int frac) {
+    if (expn >= 0) {
+      for (int i = 0; i <= expn; i++)
+        put(i < n ? d[i] : '0');
+    } else {
+      put('0');
+    }
+    if (frac < 0)
+      frac = n - 1 - expn;
+    if (frac > 0) {
+      put('.');
+      for (int j = 1; j <= frac; j++) {
+        int i = expn + j;
+        put(i >= 0 && i < n ? d[i] : '0');
+      }
+    }
+  }
+
+  /* Same in scientific notation */
+  void put_scientific(const char *d, int n, int expn, int frac) {
+    put(n > 0 ? d[0] : '0');
+    if (frac < 0)
+      frac = n - 1;
+    if (frac > 0) {
+      put('.');
+      for (int i = 1; i <= frac; i++)
+        put(i < n ? d[i] : '0');
+    }
+    put_exponent(expn);
+  }
+
+  int finish() {
+    if (size > 0)
+      buf[len < size ? len : size - 1] = 0;
+    return len;
+  }
+};
+
+/* Converts the n components of x to a string (see c_dd_to_string) */
+static int to_string(const double *x, int n, char *buf, int size,
+    int format, int precision) {
+  writer w = { buf, size, 0 };
+
+  for (int i = 0; i < n; i++) {
+    if (x[i] != x[i]) {
+      w.put("nan");
+      return w.finish();
+    }
+  }
+
+  exact v;
+  bool infinite = false;
+  for (int i = 0; i < n; i++)
+    infinite = infinite || x[i] - x[i] != 0.0;
+  if (infinite) {
+    if (x[0] < 0.0)
+      w.put('-');
+    w.put("inf");
+    return w.finish();
+  }
+
+  exact_set(v, x, n);
+  if (v.negative)
+    w.put('-');
+  if (precision < 0)
+    precision = 0;
+
+  char d[max_digits];
+  int nd = 0, expn = 0;
+  bool zero = big_is_zero(v.m);
+
+  switch (format) {
+  case qd_scientific:
+    if (!zero)
+      nd = exact_digits(v, precision + 1, false, d, max_digits, expn);
+    w.put_scientific(d, nd, expn, precision);
+    break;
+
+  case qd_fixed:
+    if (!zero)
+      nd = exact_digits(v, precision, true, d, max_digits, expn);
+    if (nd == 0)
+      expn = 0;
+    w.put_fixed(d, nd, expn, precision);
+    break;
+
+  default:
+    if (zero) {
+      w.put('0');
+    } else {
+      nd = shortest_digits(v, x, n, d, expn);
+      if (expn >= -5 && expn < 21)
+        w.put_fixed(d, nd, expn, -1);
+      else
+        w.put_scientific(d, nd, expn, -1);
+    }
+    break;
+  }
+  return w.finish();
+}
+
+/* Returns m * 2^e, which must be exactly representable as a double
+   (unless it overflows). m must be less than 2^54. */
+static double make_double(uint64_t m, int e) {
+  union {
+    double d;
+    uint64_t u;
+  } bits;
+  if (m == 0)
+    return 0.0;
+
+  /* Shift m to 53 bits */
+  uint32_t hi = static_cast<uint32_t>(m >> 32);
+  int len = hi ? 64 - __builtin_clz(hi) :
+    32 - __builtin_clz(static_cast<uint32_t>(m));
+  if (len > 53)
+    m >>= len - 53;
+  else
+    m <<= 53 - len;
+  e += len - 53;
+
+  int biased = e + 52 + 1023;
+  if (biased >= 2047) {
+    bits.u = static_cast<uint64_t>(2047) << 52;
+    return bits.d;
+  }
+  if (biased <= 0) {
+    m >>= 1 - biased;
+    biased = 0;
+  }
+  bits.u = (static_cast<uint64_t>(biased) << 52) |
+    (m & ((static_cast<uint64_t>(1) << 52) - 1));
+  return bits.d;
+}
+
+/* Returns the bits of a from bit i up, which must fit in 64 bits */
+static uint64_t big_bits_from(const big &a, int i) {
+  uint64_t r = 0;
+  for (int k = 2; k >= 0; k--) {
+    int limb = (i >> 5) + k;
+    uint64_t v = limb < a.n ? a.d[limb] : 0;
+    int pos = 32 * k - (i & 31);
+    if (pos >= 0)
+      r |= v << pos;
+    else
+      r |= v >> -pos;
+  }
+  return r;
+}
+
+/* Sets the n components of x to (-1)^negative * m * 2^e, where the exact
+   value is slightly larger than m * 2^e if sticky is true. Each component is
+   the nearest double (ties to even) to the rest of the value. Returns false
+   if m does not have enough bits to round the components correctly, which
+   cannot happen if e is at most -1076 or sticky is false. m is destroyed. */
+static bool set_components(big &m, int e, bool sticky, bool negative,
+    double *x, int n) {
+  for (int i = 0; i < n; i++) {
+    int bits = big_bits(m);
+    if (bits == 0) {
+      /* The rest is less than 2^e, which only rounds to zero for sure if
+         that is at most half the smallest denormal */
+      if (sticky && e > -1075)
+        return false;
+      x[i] = (i == 0 && negative) ? -0.0 : 0.0;
+      continue;
+    }
+
+    /* Round to 53 bits, but not below 2^-1074 */
+    int lsb = bits - 1 + e - 52;
+    if (lsb < -1074)
+      lsb = -1074;
+    int drop = lsb - e;
+    uint64_t top;
+    bool up = false;
+    if (drop <= 0) {
+      if (sticky)
+        return false;
+      top = big_bits_from(m, 0);
+      drop = 0;
+    } else {
+      top = big_bits_from(m, drop);
+      up = big_bit(m, drop - 1) &&
+        ((top & 1) != 0 || sticky || big_any_below(m, drop - 1));
+    }
+    if (up)
+      top++;
+    x[i] = make_double(top, e + drop);
+    if (negative && (top != 0 || i == 0))
+      x[i] = -x[i];
+
+    /* Continue with the difference between m and top * 2^drop. If top was
+       rounded up, this has the opposite sign, and the sticky part moves to
+       the other side. */
+    big t;
+    big_set(t, top);
+    big_shl(t, drop);
+    if (up) {
+      big_sub_from(m, t);
+      if (sticky) {
+        big_set(t, 1);
+        big_sub(m, t);
+      }
+      negative = !negative;
+    } else {
+      big_sub(m, t);
+    }
+  }
+
+  if (x[0] - x[0] != 0.0) {
+    /* Overflow */
+    for (int i = 1; i < n; i++)
+      x[i] = x[0];
+  }
+  return true;
+}
+
+/* m = m * 10^digits + chunk, and clears the chunk */
+static void add_chunk(big &m, uint64_t &chunk, int &digits) {
+  big t;
+  big_mul_pow10(m, digits);
+  big_set(t, chunk);
+  big_add(m, t);
+  chunk = 0;
+  digits = 0;
+}
+
+/* Reads chars from a string of len chars, or from a null-terminated string
+   if len is negative. */
+struct reader {
+  const char *s;
+  int len;
+  int pos;
+
+  char peek() const {
+    if (len >= 0 && pos >= len)
+      return 0;
+    return s[pos];
+  }
+
+  static bool is_digit(char c) {
+    return c >= '0' && c <= '9';
+  }
+
+  static char lower(char c) {
+    return (c >= 'A' && c <= 'Z') ? static_cast<char>(c + 32) : c;
+  }
+
+  /* Returns how many chars of word (in lower case) follow, ignoring case,
+     without consuming them */
+  int match(const char *word) {
+    int start = pos, n = 0;
+    while (word[n] != 0 && lower(peek()) == word[n]) {
+      pos++;
+      n++;
+    }
+    pos = start;
+    return n;
+  }
+};
+
+/* Parses a decimal number at the start of str (see c_dd_parse) into the n
+   components of x. Returns the number of chars used, or 0 if str does not
+   start with a number (then x is set to NaN). */
+static int parse(const char *str, int len, double *x, int n) {
+  reader r = { str, len, 0 };
+
+  char c = r.peek();
+  while (c == ' ' || (c >= '\t' && c <= '\r')) {
+    r.pos++;
+    c = r.peek();
+  }
+
+  bool negative = false;
+  if (c == '+' || c == '-') {
+    negative = c == '-';
+    r.pos++;
+    c = r.peek();
+  }
+
+  /* inf, infinity and nan, in any case */
+  int special = r.match("infinity");
+  if (special >= 3) {
+    r.pos += special == 8 ? 8 : 3;
+    for (int i = 0; i < n; i++)
+      x[i] = negative ? -qd::_d_inf : qd::_d_inf;
+    return r.pos;
+  }
+  if (r.match("nan") == 3) {
+    r.pos += 3;
+    for (int i = 0; i < n; i++)
+      x[i] = qd::_d_nan;
+    return r.pos;
+  }
+
+  /* Digits, accumulated in chunks of up to 19 digits. exp10 is the
+     exponent of the last digit that was used. */
+  big m;
+  big_set(m, 0);
+  uint64_t chunk = 0;
+  int chunk_digits = 0, digits = 0, exp10 = 0;
+  bool any_digits = false, point = false, sticky = false;
+
+  for (;; r.pos++) {
+    c = r.peek();
+    if (c == '.' && !point) {
+      point = true;
+      continue;
+    }
+    if (!reader::is_digit(c))
+      break;
+
+    any_digits = true;
+    if (digits == 0 && c == '0') {
+      /* Leading zero */
+      if (point)
+        exp10--;
+    } else if (digits < max_digits) {
+      chunk = chunk * 10 + static_cast<uint32_t>(c - '0');
+      chunk_digits++;
+      digits++;
+      if (point)
+        exp10--;
+      if (chunk_digits == 19)
+        add_chunk(m, chunk, chunk_digits);
+    } else {
+      if (c != '0')
+        sticky = true;
+      if (!point)
+        exp10++;
+    }
+  }
+  if (!any_digits) {
+    for (int i = 0; i < n; i++)
+      x[i] = qd::_d_nan;
+    return 0;
+  }
+
+  /* Exponent. If no digits follow the 'e', it is not part of the
+     number. */
+  c = r.peek();
+  if (c == 'e' || c == 'E') {
+    int start = r.pos;
+    r.pos++;
+    c = r.peek();
+    bool exp_negative = c == '-';
+    if (c == '+' || c == '-') {
+      r.pos++;
+      c = r.peek();
+    }
+    if (!reader::is_digit(c)) {
+      r.pos = start;
+    } else {
+      int e = 0;
+      for (; reader::is_digit(c); r.pos++, c = r.peek()) {
+        if (e < 100000)
+          e = e * 10 + (c - '0');
+      }
+      exp10 += exp_negative ? -e : e;
+    }
+  }
+
+  /* Digits that were not used only matter if they are not zero. Then
+     they are replaced by a single 1 digit, which rounds the same way. */
+  if (sticky) {
+    if (chunk_digits == 19)
+      add_chunk(m, chunk, chunk_digits);
+    chunk = chunk * 10 + 1;
+    chunk_digits++;
+    digits++;
+    exp10--;
+  }
+  add_chunk(m, chunk, chunk_digits);
+
+  /* Zero, or values that are certainly too large or too small (the first
+     digit has exponent digits - 1 + exp10) */
+  int lead = digits - 1 + exp10;
+  if (big_is_zero(m) || lead < -325) {
+    big_set(m, 0);
+    set_components(m, 0, false, negative, x, n);
+    return r.pos;
+  }
+  if (lead > 309) {
+    for (int i = 0; i < n; i++)
+      x[i] = negative ? -qd::_d_inf : qd::_d_inf;
+    return r.pos;
+  }
+
+  if (exp10 >= 0) {
+    big_mul_pow10(m, exp10);
+    set_components(m, 0, false, negative, x, n);
+  } else {
+    /* m / 10^k = m / 5^k * 2^-k. First try a quotient with enough bits for
+       n components without large gaps between them, and use the remainder
+       as the sticky part. If that is not enough, use all bits down to
+       2^-1076. */
+    int k = -exp10;
+    big s, q, u, v;
+    big_pow5(s, k);
+    for (int deep = 0; deep < 2; deep++) {
+      int shift = 53 * n + 64 - (big_bits(m) - big_bits(s));
+      if (deep || shift > 1076 - k)
+        shift = 1076 - k;
+      u = m;
+      v = s;
+      if (shift >= 0)
+        big_shl(u, shift);
+      else
+        big_shl(v, -shift);
+      big_div(q, u, v);
+      if (set_components(q, -k - shift, !big_is_zero(u), negative, x, n))
+        break;
+    }
+  }
+  return r.pos;
+}
+
+/* Sets s to the first count digits of the n components of x, correctly
+   rounded, followed by a null terminator. */
+static void to_digits(const double *x, int n, char *s, int &expn,
+    int count) {
+  exact v;
+
+  exact_set(v, x, n);
+  if (count < 0)
+    count = 0;
+  exact_digits(v, count, false, s, count, expn);
+  if (big_is_zero(v.m))
+    expn = 0;
+  s[count] = 0;
+}
+
+}
+}
+
+#endif /* _QD_DECIMAL_H */
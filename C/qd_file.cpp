@@ -0,0 +1,77 @@
+/*
+ * qd_file.cpp
+ *
+ * Headers of the binary file format for dd_real and qd_real arrays (see
+ * c_file.h). The library does not read or write files itself: the caller
+ * writes the header and the planes, or maps the file into memory and uses
+ * the planes at c_qd_file_offset.
+ */
+#include "qd_config.h"
+#include "c_file.h"
+
+static const char qd_file_magic[8] = { 'Q', 'D', 'A', 'R', 'R', 'A', 'Y', 0 };
+
+/* Alignment of the planes */
+static const long long qd_file_align = 64;
+
+static void qd_file_init(qd_file_header *h, int components, int layout,
+    long long count) {
+  for (int i = 0; i < 8; i++)
+    h->magic[i] = qd_file_magic[i];
+  h->version = QD_FILE_VERSION;
+  h->byte_order = QD_FILE_BYTE_ORDER;
+  h->components = components;
+  h->layout = layout;
+#ifdef HP_ACCURATE
+  h->accurate = 1;
+#else
+  h->accurate = 0;
+#endif
+  h->header_size = sizeof(qd_file_header);
+  h->count = count;
+  h->stride = layout == qd_file_soa
+      ? (count * 8 + qd_file_align - 1) & ~(qd_file_align - 1) : count * 8;
+  for (int i = 0; i < 16; i++)
+    h->reserved[i] = 0;
+}
+
+static long long qd_file_offset(const qd_file_header *h, int k) {
+  return h->header_size + (h->layout == qd_file_soa ? k * h->stride : 0);
+}
+
+static long long qd_file_size(const qd_file_header *h) {
+  if (h->layout == qd_file_soa)
+    return h->header_size + h->components * h->stride;
+  return h->header_size + h->count * h->components * 8;
+}
+
+static int qd_file_check(const qd_file_header *h, long long size) {
+  if (size >= 0 && size < static_cast<long long>(sizeof(qd_file_header)))
+    return qd_file_invalid;
+  for (int i = 0; i < 8; i++)
+    if (h->magic[i] != qd_file_magic[i])
+      return qd_file_invalid;
+  if (h->byte_order != QD_FILE_BYTE_ORDER)
+    return qd_file_byte_order;
+  if (h->version > QD_FILE_VERSION)
+    return qd_file_version;
+
+  /* Newer versions may add fields to the header, but keep the planes
+     aligned */
+  if (h->version < 1 || (h->components != 2 && h->components != 4) ||
+      (h->layout != qd_file_soa && h->layout != qd_file_aos) ||
+      h->header_size < static_cast<int>(sizeof(qd_file_header)) ||
+      (h->header_size & (qd_file_align - 1)) != 0 || h->count < 0)
+    return qd_file_invalid;
+
+  /* Also rejects counts so large that the size would overflow */
+  if (h->count > (1LL << 56))
+    return qd_file_invalid;
+  if (h->layout == qd_file_soa &&
+      (h->stride < h->count * 8 || (h->stride & (qd_file_align - 1)) != 0 ||
+       h->stride > h->count * 8 + qd_file_align))
+    return qd_file_invalid;
+  if (size >= 0 && size < qd_file_size(h))
+    return qd_file_invalid;
+  return qd_file_ok;
+}
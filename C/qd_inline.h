@@ -20,12 +20,8 @@
 #endif
 
 /********** Constructors **********/
-inline qd_real::qd_real(double x0, double x1, double x2, double x3) {
-  x[0] = x0;
-  x[1] = x1;
-  x[2] = x2;
-  x[3] = x3;
-}
+constexpr qd_real::qd_real(double x0, double x1, double x2, double x3)
+  : x{x0, x1, x2, x3} {}
 
 inline qd_real::qd_real(const double *xx) {
   x[0] = xx[0];
@@ -713,6 +709,145 @@ inline qd_real sqr(const qd_real &a) {
 
 }
 
+#ifdef QD_FMA_DISPATCH
+/********** FMA Variants **********/
+/* These are identical to sloppy_mul, accurate_mul and sqr above, except 
+   that they use two_prod_fma and two_sqr_fma. */
+QD_FMA_TARGET inline qd_real qd_real::sloppy_mul_fma(const qd_real &a, 
+                                                     const qd_real &b) {
+  double p0, p1, p2, p3, p4, p5;
+  double q0, q1, q2, q3, q4, q5;
+  double t0, t1;
+  double s0, s1, s2;
+
+  p0 = qd::two_prod_fma(a[0], b[0], q0);
+
+  p1 = qd::two_prod_fma(a[0], b[1], q1);
+  p2 = qd::two_prod_fma(a[1], b[0], q2);
+
+  p3 = qd::two_prod_fma(a[0], b[2], q3);
+  p4 = qd::two_prod_fma(a[1], b[1], q4);
+  p5 = qd::two_prod_fma(a[2], b[0], q5);
+
+  qd::three_sum(p1, p2, q0);
+
+  qd::three_sum(p2, q1, q2);
+  qd::three_sum(p3, p4, p5);
+  s0 = qd::two_sum(p2, p3, t0);
+  s1 = qd::two_sum(q1, p4, t1);
+  s2 = q2 + p5;
+  s1 = qd::two_sum(s1, t0, t0);
+  s2 += (t0 + t1);
+
+  s1 += a[0]*b[3] + a[1]*b[2] + a[2]*b[1] + a[3]*b[0] + q0 + q3 + q4 + q5;
+  qd::renorm(p0, p1, s0, s1, s2);
+  return qd_real(p0, p1, s0, s1);
+}
+
+QD_FMA_TARGET inline qd_real qd_real::accurate_mul_fma(const qd_real &a, 
+                                                       const qd_real &b) {
+  double p0, p1, p2, p3, p4, p5;
+  double q0, q1, q2, q3, q4, q5;
+  double p6, p7, p8, p9;
+  double q6, q7, q8, q9;
+  double r0, r1;
+  double t0, t1;
+  double s0, s1, s2;
+
+  p0 = qd::two_prod_fma(a[0], b[0], q0);
+
+  p1 = qd::two_prod_fma(a[0], b[1], q1);
+  p2 = qd::two_prod_fma(a[1], b[0], q2);
+
+  p3 = qd::two_prod_fma(a[0], b[2], q3);
+  p4 = qd::two_prod_fma(a[1], b[1], q4);
+  p5 = qd::two_prod_fma(a[2], b[0], q5);
+
+  qd::three_sum(p1, p2, q0);
+
+  qd::three_sum(p2, q1, q2);
+  qd::three_sum(p3, p4, p5);
+  s0 = qd::two_sum(p2, p3, t0);
+  s1 = qd::two_sum(q1, p4, t1);
+  s2 = q2 + p5;
+  s1 = qd::two_sum(s1, t0, t0);
+  s2 += (t0 + t1);
+
+  p6 = qd::two_prod_fma(a[0], b[3], q6);
+  p7 = qd::two_prod_fma(a[1], b[2], q7);
+  p8 = qd::two_prod_fma(a[2], b[1], q8);
+  p9 = qd::two_prod_fma(a[3], b[0], q9);
+
+  q0 = qd::two_sum(q0, q3, q3);
+  q4 = qd::two_sum(q4, q5, q5);
+  p6 = qd::two_sum(p6, p7, p7);
+  p8 = qd::two_sum(p8, p9, p9);
+  t0 = qd::two_sum(q0, q4, t1);
+  t1 += (q3 + q5);
+  r0 = qd::two_sum(p6, p8, r1);
+  r1 += (p7 + p9);
+  q3 = qd::two_sum(t0, r0, q4);
+  q4 += (t1 + r1);
+  t0 = qd::two_sum(q3, s1, t1);
+  t1 += q4;
+
+  t1 += a[1] * b[3] + a[2] * b[2] + a[3] * b[1] + q6 + q7 + q8 + q9 + s2;
+
+  qd::renorm(p0, p1, s0, t0, t1);
+  return qd_real(p0, p1, s0, t0);
+}
+
+QD_FMA_TARGET inline qd_real mul_fma(const qd_real &a, const qd_real &b) {
+#ifdef QD_SLOPPY_MUL
+  return qd_real::sloppy_mul_fma(a, b);
+#else
+  return qd_real::accurate_mul_fma(a, b);
+#endif
+}
+
+QD_FMA_TARGET inline qd_real sqr_fma(const qd_real &a) {
+  double p0, p1, p2, p3, p4, p5;
+  double q0, q1, q2, q3;
+  double s0, s1;
+  double t0, t1;
+  
+  p0 = qd::two_sqr_fma(a[0], q0);
+  p1 = qd::two_prod_fma(2.0 * a[0], a[1], q1);
+  p2 = qd::two_prod_fma(2.0 * a[0], a[2], q2);
+  p3 = qd::two_sqr_fma(a[1], q3);
+
+  p1 = qd::two_sum(q0, p1, q0);
+
+  q0 = qd::two_sum(q0, q1, q1);
+  p2 = qd::two_sum(p2, p3, p3);
+
+  s0 = qd::two_sum(q0, p2, t0);
+  s1 = qd::two_sum(q1, p3, t1);
+
+  s1 = qd::two_sum(s1, t0, t0);
+  t0 += t1;
+
+  s1 = qd::quick_two_sum(s1, t0, t0);
+  p2 = qd::quick_two_sum(s0, s1, t1);
+  p3 = qd::quick_two_sum(t1, t0, q0);
+
+  p4 = 2.0 * a[0] * a[3];
+  p5 = 2.0 * a[1] * a[2];
+
+  p4 = qd::two_sum(p4, p5, p5);
+  q2 = qd::two_sum(q2, q3, q3);
+
+  t0 = qd::two_sum(p4, q2, t1);
+  t1 = t1 + p5 + q3;
+
+  p3 = qd::two_sum(p3, t0, p4);
+  p4 = p4 + q0 + t1;
+
+  qd::renorm(p0, p1, p2, p3, p4);
+  return qd_real(p0, p1, p2, p3);
+}
+#endif
+
 /********** Self-Multiplication **********/
 /* quad-double *= double */
 inline qd_real &qd_real::operator*=(double a) {
@@ -0,0 +1,45 @@
+/*
+ * qd_libm.cpp
+ *
+ * Implementations of the helper functions that c_dd.cpp and c_qd.cpp import
+ * (see inline.h), using the C runtime. When linking with Delphi, these are
+ * provided by Neslib.MultiPrecision.pas instead, so this file is only part
+ * of the Linux libraries for use from C/C++ (see BuildLinux.sh).
+ *
+ * The functions are weak, so an application that links with the static
+ * libraries can still provide its own versions. The shared libraries are
+ * built with -fvisibility=hidden, so there the calls are bound to these
+ * versions when the library is linked, and cannot be replaced.
+ */
+#include <cmath>
+#include "qd_config.h"
+
+#define QD_WEAK __attribute__((weak))
+
+extern "C" {
+
+QD_WEAK double qd_ldexp(double a, int p) {
+  return std::ldexp(a, p);
+}
+
+QD_WEAK double qd_log(double a) {
+  return std::log(a);
+}
+
+QD_WEAK double qd_exp(double a) {
+  return std::exp(a);
+}
+
+QD_WEAK double qd_atan2(double y, double x) {
+  return std::atan2(y, x);
+}
+
+QD_WEAK double qd_floor(double a) {
+  return std::floor(a);
+}
+
+QD_WEAK double qd_ceil(double a) {
+  return std::ceil(a);
+}
+
+}
@@ -0,0 +1,239 @@
+/*
+ * qd_lu.cpp
+ *
+ * LU factorization with partial pivoting in double precision, for the
+ * mixed-precision solvers in dd_solve.cpp and qd_solve.cpp (see
+ * c_solve.h). This file is included by both c_dd.cpp and c_qd.cpp, so
+ * everything in it is static.
+ *
+ * The matrix is stored row by row, and factored in place in steps of
+ * QD_GESV_BLOCK columns. Each step factors a panel of columns (panel),
+ * computes the rows of U to the right of the panel (trsm), and then
+ * subtracts the product of the columns of L below the panel and those rows
+ * of U from the rest of the matrix. This update does almost all the work.
+ * It is split into tiles of lu::tile x lu::tile elements, which are claimed
+ * with an atomic increment of next_tile, like the tiles of c_dd_gemm.
+ *
+ * The update kernel is compiled for SSE2, AVX2 and AVX-512 on Intel (see
+ * qd_lu.h), and the widest version supported by the CPU is selected on
+ * first use. It does not use fused multiply-adds, so all versions give the
+ * same results.
+ */
+#ifndef _QD_LU_CPP
+#define _QD_LU_CPP
+
+#include "qd_config.h"
+#include "c_solve.h"
+#include "qd_cpu.h"
+#include "simd.h"
+
+namespace qd {
+namespace lu {
+
+enum {
+  block = QD_GESV_BLOCK,
+  tile = 64,             /* rows and columns of the tiles of the update */
+  mr = 4                 /* rows of a block of the SIMD kernels */
+};
+
+/* Stages of the solvers. The stages marked "pass" are followed by a call
+   to c_dd_gesv_pass (c_qd_gesv_pass). */
+enum {
+  stage_start = 0,
+  stage_panel,           /* factoring the next double-precision panel */
+  stage_update,          /* pass: updating the double-precision factors */
+  stage_residual,        /* pass: computing the residual */
+  stage_stalled,         /* waiting for the factors buffer */
+  stage_factor,          /* factoring the next extended-precision panel */
+  stage_trsm,            /* pass: computing rows of U of the extended factors */
+  stage_product,         /* pass: updating the extended factors */
+  stage_done
+};
+
+/* Largest finite double */
+const double max_double = 1.79769313486231570815e+308;
+
+}
+
+namespace generic {
+
+/* c[i * ld + j] -= l[i * ld + k] * u[k * ld + j], for all k < kb in order,
+   i < rows and j < cols */
+static void lu_update_block(double *c, const double *l, const double *u,
+    int ld, int kb, int rows, int cols) {
+  for (int i = 0; i < rows; i++)
+    for (int k = 0; k < kb; k++) {
+      double x = l[i * ld + k];
+      for (int j = 0; j < cols; j++)
+        c[i * ld + j] -= x * u[k * ld + j];
+    }
+}
+
+}
+}
+
+#ifdef QD_FMA_DISPATCH
+
+namespace qd {
+namespace sse2 {
+#define QD_SIMD_TARGET QD_TARGET_SSE2
+#include "qd_lu.h"
+#undef QD_SIMD_TARGET
+}
+
+namespace avx2 {
+#define QD_SIMD_TARGET QD_TARGET_AVX2
+#include "qd_lu.h"
+#undef QD_SIMD_TARGET
+}
+
+namespace avx512 {
+#define QD_SIMD_TARGET QD_TARGET_AVX512
+#include "qd_lu.h"
+#undef QD_SIMD_TARGET
+}
+}
+
+#endif /* QD_FMA_DISPATCH */
+
+/* LU update kernel for a specific instruction set. */
+struct qd_lu_kernels {
+  void (*update_block)(double *, const double *, const double *, int, int, int, int);
+};
+
+#ifdef QD_FMA_DISPATCH
+static const qd_lu_kernels qd_lu_sse2 = { qd::sse2::lu_update_block };
+static const qd_lu_kernels qd_lu_avx2 = { qd::avx2::lu_update_block };
+static const qd_lu_kernels qd_lu_avx512 = { qd::avx512::lu_update_block };
+#else
+static const qd_lu_kernels qd_lu_generic = { qd::generic::lu_update_block };
+#endif
+
+/* Returns the fastest LU update kernel for this CPU. */
+static const qd_lu_kernels *qd_lu_select(int cpu_features) {
+#ifdef QD_FMA_DISPATCH
+  if (cpu_features & qd::cpu_avx512)
+    return &qd_lu_avx512;
+  if (cpu_features & qd::cpu_avx2)
+    return &qd_lu_avx2;
+  return &qd_lu_sse2;
+#else
+  return &qd_lu_generic;
+#endif
+}
+
+namespace qd {
+namespace lu {
+
+static inline double abs(double a) { return a < 0.0 ? -a : a; }
+
+/* Copies the leading parts x of an n x n matrix to lu (row by row), and
+   returns the largest sum of the absolute values of a row */
+static double load(const double *x, int n, int row_stride, int col_stride,
+    double *lu) {
+  double norm = 0.0;
+  for (int i = 0; i < n; i++) {
+    double sum = 0.0;
+    for (int j = 0; j < n; j++) {
+      double v = x[i * row_stride + j * col_stride];
+      lu[i * n + j] = v;
+      sum += abs(v);
+    }
+    if (!(sum <= norm))
+      norm = sum;
+  }
+  return norm;
+}
+
+/* Factors columns j0 .. j0 + kb - 1, swapping whole rows. Returns false if
+   a pivot is zero (or not finite). */
+static bool panel(double *lu, int n, int j0, int kb, int *pivots) {
+  for (int j = j0; j < j0 + kb; j++) {
+    int p = j;
+    double max = abs(lu[j * n + j]);
+    for (int i = j + 1; i < n; i++)
+      if (abs(lu[i * n + j]) > max) {
+        max = abs(lu[i * n + j]);
+        p = i;
+      }
+    if (!(max > 0.0 && max <= max_double))
+      return false;
+    pivots[j] = p;
+    if (p != j)
+      for (int c = 0; c < n; c++) {
+        double t = lu[j * n + c];
+        lu[j * n + c] = lu[p * n + c];
+        lu[p * n + c] = t;
+      }
+
+    const double *row = lu + j * n;
+    for (int i = j + 1; i < n; i++) {
+      double *r = lu + i * n;
+      double l = r[j] / row[j];
+      r[j] = l;
+      for (int c = j + 1; c < j0 + kb; c++)
+        r[c] -= l * row[c];
+    }
+  }
+  return true;
+}
+
+/* Computes rows j0 .. j0 + kb - 1 of U right of the panel */
+static void trsm(double *lu, int n, int j0, int kb) {
+  for (int j = j0; j < j0 + kb; j++)
+    for (int i = j + 1; i < j0 + kb; i++) {
+      double l = lu[i * n + j];
+      for (int c = j0 + kb; c < n; c++)
+        lu[i * n + c] -= l * lu[j * n + c];
+    }
+}
+
+/* Number of tiles of the update of an m x m matrix */
+static int tiles(int m) {
+  int t = (m + tile - 1) / tile;
+  return t * t;
+}
+
+/* Subtracts the product of columns j0 .. j0 + kb - 1 of L and rows j0 ..
+   j0 + kb - 1 of U from the rest of the matrix, until all tiles have been
+   claimed */
+static void update(const qd_lu_kernels *kernels, double *lu, int n, int j0,
+    int kb, int *next_tile) {
+  int s = j0 + kb, m = n - s, tiles_n = (m + tile - 1) / tile;
+  for (;;) {
+    int t = __atomic_fetch_add(next_tile, 1, __ATOMIC_RELAXED);
+    if (t >= tiles_n * tiles_n)
+      return;
+    int i0 = s + (t / tiles_n) * tile, c0 = s + (t % tiles_n) * tile;
+    int rows = n - i0 < tile ? n - i0 : tile;
+    int cols = n - c0 < tile ? n - c0 : tile;
+    kernels->update_block(lu + i0 * n + c0, lu + i0 * n + j0, lu + j0 * n + c0,
+        n, kb, rows, cols);
+  }
+}
+
+/* Solves lu * x = v in place */
+static void solve(const double *lu, int n, const int *pivots, double *v) {
+  for (int i = 0; i < n; i++) {
+    double t = v[i];
+    v[i] = v[pivots[i]];
+    v[pivots[i]] = t;
+  }
+  for (int i = 1; i < n; i++) {
+    double s = v[i];
+    for (int j = 0; j < i; j++)
+      s -= lu[i * n + j] * v[j];
+    v[i] = s;
+  }
+  for (int i = n - 1; i >= 0; i--) {
+    double s = v[i];
+    for (int j = i + 1; j < n; j++)
+      s -= lu[i * n + j] * v[j];
+    v[i] = s / lu[i * n + i];
+  }
+}
+
+}
+}
+
+#endif /* _QD_LU_CPP */
@@ -0,0 +1,42 @@
+/*
+ * qd_lu.h
+ *
+ * Update kernel of the double-precision LU factorization. This file is
+ * included once for each of the SIMD namespaces in simd.h (see qd_lu.cpp).
+ * Like the scalar version in qd::generic, every element is updated with a
+ * multiplication and a subtraction per product, in the same order, so the
+ * results are bitwise identical.
+ */
+
+/* Updates blocks of lu::mr rows and 2 vectors of columns, keeping them in
+   registers. The remaining rows and columns use the scalar version. */
+QD_SIMD_TARGET static void lu_update_block(double *c, const double *l,
+    const double *u, int ld, int kb, int rows, int cols) {
+  int m = rows - rows % lu::mr, n = cols - cols % (2 * width);
+  for (int i = 0; i < m; i += lu::mr)
+    for (int j = 0; j < n; j += 2 * width) {
+      vec c0[lu::mr], c1[lu::mr];
+      for (int r = 0; r < lu::mr; r++) {
+        c0[r] = load(c + (i + r) * ld + j);
+        c1[r] = load(c + (i + r) * ld + j + width);
+      }
+      for (int k = 0; k < kb; k++) {
+        vec u0 = load(u + k * ld + j), u1 = load(u + k * ld + j + width);
+        for (int r = 0; r < lu::mr; r++) {
+          vec x = set1(l[(i + r) * ld + k]);
+          c0[r] = c0[r] - x * u0;
+          c1[r] = c1[r] - x * u1;
+        }
+      }
+      for (int r = 0; r < lu::mr; r++) {
+        store(c + (i + r) * ld + j, c0[r]);
+        store(c + (i + r) * ld + j + width, c1[r]);
+      }
+    }
+  zero_upper();
+
+  if (n < cols)
+    generic::lu_update_block(c + n, l, u + n, ld, kb, m, cols - n);
+  if (m < rows)
+    generic::lu_update_block(c + m * ld, l + m * ld, u, ld, kb, rows - m, cols);
+}
@@ -13,6 +13,8 @@
 
 #include "qd_config.h"
 #include "qd_real.h"
+#include "qd_decimal.h"
+#include "qd_rem_pio2.cpp"
 
 #ifndef QD_INLINE
 #include <qd/qd_inline.h>
@@ -183,11 +185,118 @@ qd_real pow(const qd_real &a, const qd_real &b) {
   return exp(b * log(a));
 }
 
+namespace qd {
+
+/* Coefficients of a polynomial in an array of qd_real */
+struct qd_coef_ptr {
+  const qd_real *c;
+  qd_real operator()(int k) const { return c[k]; }
+};
+
+/* Evaluates coef(k) + coef(k + 1) x + ... + coef(k + 7) x^7 with Estrin's
+   scheme. x2 and x4 are x^2 and x^4. */
+template <class Coef>
+inline qd_real qd_estrin8(const Coef &coef, int k, const qd_real &x,
+    const qd_real &x2, const qd_real &x4) {
+  qd_real p0 = coef(k) + coef(k + 1) * x;
+  qd_real p1 = coef(k + 2) + coef(k + 3) * x;
+  qd_real p2 = coef(k + 4) + coef(k + 5) * x;
+  qd_real p3 = coef(k + 6) + coef(k + 7) * x;
+  return (p0 + p1 * x2) + (p2 + p3 * x2) * x4;
+}
+
+/* Evaluates coef(0) + coef(1) x + ... + coef(n) x^n. The coefficients are
+   split into blocks of 8, which are evaluated with Estrin's scheme and
+   combined with Horner's method in powers of x^8. Unlike the terms of
+   Horner's method, the blocks do not depend on each other, so their
+   operations can overlap. The leading (n + 1) % 8 coefficients use
+   Horner's method. polyeval in qd_batch.h uses the same operations, so
+   the batch functions give bitwise identical results. */
+template <class Coef>
+inline qd_real qd_polyeval(const Coef &coef, int n, const qd_real &x) {
+  if (n < 0)
+    return 0.0;
+
+  int k = (n + 1) & ~7;  /* coefficients in whole blocks */
+  qd_real r;
+  if (k <= n) {
+    r = coef(n);
+    for (int i = n - 1; i >= k; i--)
+      r = r * x + coef(i);
+    if (k == 0)
+      return r;
+  }
+
+  qd_real x2 = sqr(x);
+  qd_real x4 = sqr(x2);
+  qd_real x8 = sqr(x4);
+  if (k > n) {
+    k -= 8;
+    r = qd_estrin8(coef, k, x, x2, x4);
+  }
+  while (k > 0) {
+    k -= 8;
+    r = r * x8 + qd_estrin8(coef, k, x, x2, x4);
+  }
+  return r;
+}
+
+}
+
+/* Evaluates the polynomial c[0] + c[1] x + ... + c[n] x^n. */
+qd_real polyeval(const qd_real *c, int n, const qd_real &x) {
+  qd::qd_coef_ptr coef = { c };
+  return qd::qd_polyeval(coef, n, x);
+}
+
+/* Finds a root of the polynomial c[0] + c[1] x + ... + c[n] x^n with
+   Newton's method, starting at x0. The iteration stops when the value of
+   the polynomial is less than thresh (or the machine epsilon if thresh is
+   zero) times the largest coefficient. The derivative is evaluated along
+   with the polynomial with Horner's method, so no memory is allocated.
+   Returns NaN if there is no convergence after max_iter iterations. */
+qd_real polyroot(const qd_real *c, int n, 
+    const qd_real &x0, int max_iter, double thresh) {
+  if (n < 0) {
+    qd_real::error("(qd_real::polyroot): Negative degree.");
+    return qd_real::_nan;
+  }
+
+  qd_real x = x0;
+  double max_c = qd_fabs(to_double(c[0]));
+
+  if (thresh == 0.0)
+    thresh = qd_real::_eps;
+  for (int i = 1; i <= n; i++) {
+    double v = qd_fabs(to_double(c[i]));
+    if (v > max_c)
+      max_c = v;
+  }
+  thresh *= max_c;
+
+  for (int i = 0; i < max_iter; i++) {
+    qd_real f = c[n];
+    qd_real d = 0.0;
+    for (int k = n - 1; k >= 0; k--) {
+      d = d * x + f;
+      f = f * x + c[k];
+    }
+    if (abs(f) < thresh)
+      return x;
+    x -= f / d;
+  }
+
+  qd_real::error("(qd_real::polyroot): Failed to converge.");
+  return qd_real::_nan;
+}
+
 qd_real npwr(const qd_real &a, int n) {
   return pow(a, n);
 }
 
-/* Divisions */
+/* Divisions
+   The residuals use the addition that matches the name of the division, so
+   the results of sloppy_div and accurate_div do not depend on QD_IEEE_ADD. */
 /* quad-double / double-double */
 qd_real qd_real::sloppy_div(const qd_real &a, const dd_real &b) {
   double q0, q1, q2, q3;
@@ -195,13 +304,13 @@ qd_real qd_real::sloppy_div(const qd_real &a, const dd_real &b) {
   qd_real qd_b(b);
 
   q0 = a[0] / b._hi();
-  r = a - q0 * qd_b;
+  r = sloppy_add(a, -(q0 * qd_b));
 
   q1 = r[0] / b._hi();
-  r -= (q1 * qd_b);
+  r = sloppy_add(r, -(q1 * qd_b));
 
   q2 = r[0] / b._hi();
-  r -= (q2 * qd_b);
+  r = sloppy_add(r, -(q2 * qd_b));
 
   q3 = r[0] / b._hi();
 
@@ -215,16 +324,16 @@ qd_real qd_real::accurate_div(const qd_real &a, const dd_real &b) {
   qd_real qd_b(b);
 
   q0 = a[0] / b._hi();
-  r = a - q0 * qd_b;
+  r = ieee_add(a, -(q0 * qd_b));
 
   q1 = r[0] / b._hi();
-  r -= (q1 * qd_b);
+  r = ieee_add(r, -(q1 * qd_b));
 
   q2 = r[0] / b._hi();
-  r -= (q2 * qd_b);
+  r = ieee_add(r, -(q2 * qd_b));
 
   q3 = r[0] / b._hi();
-  r -= (q3 * qd_b);
+  r = ieee_add(r, -(q3 * qd_b));
 
   q4 = r[0] / b._hi();
 
@@ -239,13 +348,13 @@ qd_real qd_real::sloppy_div(const qd_real &a, const qd_real &b) {
   qd_real r;
 
   q0 = a[0] / b[0];
-  r = a - (b * q0);
+  r = sloppy_add(a, -(b * q0));
 
   q1 = r[0] / b[0];
-  r -= (b * q1);
+  r = sloppy_add(r, -(b * q1));
 
   q2 = r[0] / b[0];
-  r -= (b * q2);
+  r = sloppy_add(r, -(b * q2));
 
   q3 = r[0] / b[0];
 
@@ -260,17 +369,17 @@ qd_real qd_real::accurate_div(const qd_real &a, const qd_real &b) {
   qd_real r;
 
   q0 = a[0] / b[0];
-  r = a - (b * q0);
+  r = ieee_add(a, -(b * q0));
 
   q1 = r[0] / b[0];
-  r -= (b * q1);
+  r = ieee_add(r, -(b * q1));
 
   q2 = r[0] / b[0];
-  r -= (b * q2);
+  r = ieee_add(r, -(b * q2));
 
   q3 = r[0] / b[0];
 
-  r -= (b * q3);
+  r = ieee_add(r, -(b * q3));
   double q4 = r[0] / b[0];
 
   ::renorm(q0, q1, q2, q3, q4);
@@ -402,18 +511,289 @@ static const double inv_fact[n_inv_fact][4] = {
    -2.87777179307447918e-50,  4.27110689256293549e-67}
 };
 
+/* exp2_table1[j] = 2^(j/64) */
+static const double exp2_table1[64][4] = {
+  { 1.00000000000000000e+00,  0.00000000000000000e+00,
+    0.00000000000000000e+00,  0.00000000000000000e+00},
+  { 1.01088928605170048e+00, -1.52347786033685772e-17,
+   -1.20527773363982030e-33, -9.72300512942379793e-51},
+  { 1.02189714865411663e+00,  5.10922502897344389e-17,
+    7.88422656496927442e-34, -5.46319004478189928e-51},
+  { 1.03302487902122841e+00,  7.60083887402708849e-18,
+    4.17547660336499600e-34, -1.97823556525579783e-50},
+  { 1.04427378242741375e+00,  8.55188970553796489e-17,
+   -4.33079108057472302e-33, -1.31794076971486231e-49},
+  { 1.05564517836055716e+00,  1.75932573877209198e-18,
+   -1.30396724977978377e-34,  5.11556957263781903e-51},
+  { 1.06714040067682370e+00, -7.89985396684158212e-17,
+    2.48773924323047907e-33, -4.57141561511467581e-50},
+  { 1.07876079775711986e+00, -6.65666043605659260e-17,
+   -3.65812580131923691e-33,  3.28560259936462696e-49},
+  { 1.09050773266525769e+00, -3.04678207981247115e-17,
+    2.01705487848848619e-33, -1.08660297954896498e-49},
+  { 1.10238258330784089e+00,  5.26603687157069439e-17,
+    6.45805397536721411e-34, -1.36654753615889667e-50},
+  { 1.11438674259589243e+00,  1.04102784568455710e-16,
+    1.47570167344000314e-33,  5.99381972287214556e-50},
+  { 1.12652161860824185e+00,  5.16585675879545674e-17,
+   -5.65916686170716220e-34,  1.06937665978116979e-50},
+  { 1.13878863475669156e+00,  8.91281267602540778e-17,
+   -2.00741463283249449e-33,  1.22849227938519767e-49},
+  { 1.15118922995298267e+00,  3.25071021886382721e-17,
+    8.89091931637927160e-34,  5.87931931402221152e-50},
+  { 1.16372485877757748e+00,  3.82920483692409350e-17,
+    7.19709831987676327e-34,  1.06789886243940300e-50},
+  { 1.17639699165028122e+00,  5.55420325421807896e-17,
+   -1.48842929343368512e-33,  2.57369925211864695e-52},
+  { 1.18920711500272103e+00,  3.98201523146564611e-17,
+    1.14195965688545340e-33, -5.89155489118859865e-50},
+  { 1.20215673145270308e+00,  6.64498149925230124e-17,
+   -3.85685255336907654e-33,  1.54616330765464697e-49},
+  { 1.21524735998046896e+00, -7.71263069268148813e-17,
+    4.71720614288499817e-33, -1.53415199149669264e-49},
+  { 1.22848053610687002e+00, -1.89878163130252995e-17,
+    6.18469453652103848e-34,  3.98730055612386220e-50},
+  { 1.24185781207348400e+00,  4.65802759183693679e-17,
+   -2.31439910378785986e-33, -1.64627996692954004e-49},
+  { 1.25538075702469110e+00, -6.71138982129687842e-18,
+   -5.76846264325028353e-35,  9.00013012681466601e-52},
+  { 1.26905095719173322e+00,  2.66793213134218610e-18,
+   -5.01723570938719050e-35,  9.30400836733111947e-52},
+  { 1.28287001607877826e+00,  1.71359491824356097e-17,
+    7.25131491282819462e-34, -2.27090822184964989e-50},
+  { 1.29683955465100964e+00,  2.53825027948883150e-17,
+    1.68678246461832500e-34, -6.74487358840368561e-51},
+  { 1.31096121152476441e+00, -7.18153613551945386e-17,
+   -2.12629266743969557e-34, -1.69637018421520805e-50},
+  { 1.32523664315974132e+00, -2.85873121003886137e-17,
+    7.62021406397260431e-34,  9.50271103593005018e-52},
+  { 1.33966752405330292e+00,  8.92728259483173198e-17,
+   -7.69657983531899255e-34, -6.71555163539311918e-51},
+  { 1.35425554693689265e+00,  7.70094837980298946e-17,
+   -2.24074836437395029e-33, -8.44219480507483112e-50},
+  { 1.36900242297459052e+00,  9.59379791911884877e-17,
+   -4.88674958784947177e-33, -6.32720561232265393e-50},
+  { 1.38390988196383202e+00, -6.77051165879478629e-17,
+    5.25954134785524272e-34,  1.96651034808177802e-50},
+  { 1.39897967253831124e+00, -9.61421320905132307e-17,
+    3.97465190077505680e-33, -8.79555578067970596e-50},
+  { 1.41421356237309515e+00, -9.66729331345291345e-17,
+    4.13867530869941356e-33,  4.93554699146835091e-50},
+  { 1.42961333839197002e+00, -1.20316424890536552e-17,
+    3.96492532243389365e-35, -6.84663070173211278e-52},
+  { 1.44518080697704665e+00, -3.02375813499398732e-17,
+   -1.77301195820250092e-33,  2.70688329669943861e-50},
+  { 1.46091779418064704e+00, -5.60037718607521580e-17,
+   -4.80948804890004401e-33, -1.88882651761183751e-49},
+  { 1.47682614593949935e+00, -3.48399455689279580e-17,
+   -1.21157704523090580e-34,  8.67804655062785703e-52},
+  { 1.49290772829126484e+00,  1.41929201542840358e-17,
+    2.77326329344780505e-34,  1.59067501595058345e-50},
+  { 1.50916442759342284e+00, -1.01645532775429504e-16,
+    2.04191706967403438e-34, -1.80435983600406577e-51},
+  { 1.52559815074453842e+00, -1.10249417123425609e-16,
+   -2.99382882637137806e-33,  1.42905078892933404e-49},
+  { 1.54221082540794074e+00,  7.94983480969762086e-17,
+   -9.15995637410036730e-34, -4.19895011349359141e-50},
+  { 1.55900440023783693e+00,  3.78120705335752750e-17,
+    5.94230221045385633e-35, -2.91003956213942611e-51},
+  { 1.57598084510788650e+00, -1.01369164712783040e-17,
+    5.43913851556220713e-34, -3.97623762353563518e-51},
+  { 1.59314215134226700e+00, -1.00944065423119637e-16,
+    4.60848399034962572e-33,  2.78218440037848977e-49},
+  { 1.61049033194925428e+00,  2.47071925697978879e-17,
+    1.06968477888935898e-33,  6.52798271583963301e-50},
+  { 1.62802742185734783e+00, -6.71295508470708409e-17,
+    1.86124288813399584e-33, -1.57495496065815074e-49},
+  { 1.64575547815396495e+00, -1.01256799136747726e-16,
+   -6.73838498803664271e-34,  1.05186557013275035e-50},
+  { 1.66367658032673638e+00,  5.89099269671309967e-17,
+    2.37785299276765025e-33,  1.25700395376422086e-49},
+  { 1.68179283050742900e+00,  8.19901002058149652e-17,
+    5.10351519472809316e-33,  1.81863750110087405e-49},
+  { 1.70010635371852348e+00, -8.02371937039770025e-18,
+    4.50894675051846528e-34, -3.68363028539750740e-50},
+  { 1.71861929812247793e+00, -1.85138041826311099e-17,
+    6.41562962530571010e-34,  3.04272775575540268e-50},
+  { 1.73733383527370622e+00,  3.16438929929295695e-17,
+    2.46812086524635183e-33, -1.13301280811776210e-49},
+  { 1.75625216037329945e+00,  2.96014069544887331e-17,
+    1.23348227448930022e-33, -6.93013428989434781e-50},
+  { 1.77537649252652119e+00,  6.42973179655657203e-17,
+   -3.05903038196122316e-33, -1.23011539177311179e-49},
+  { 1.79470907500310717e+00,  1.82274584279120868e-17,
+    1.42176433874694971e-33, -4.85699068192859344e-50},
+  { 1.81425217550039886e+00, -9.96953153892034882e-17,
+   -5.86224914377491775e-33, -2.99366273588733877e-50},
+  { 1.83400808640934243e+00,  3.28310722424562720e-17,
+   -6.42508934795304248e-34,  1.98781255181644475e-50},
+  { 1.85397912508338547e+00,  9.76188749072759354e-17,
+    4.61481577205566482e-33, -5.18914406937457414e-50},
+  { 1.87416763411029996e+00, -6.12276341300414256e-17,
+    5.28588559402507397e-33, -1.83531825898648191e-49},
+  { 1.89457598158696561e+00,  3.40340353521652967e-17,
+    1.72475099549343225e-33, -8.15727567617066201e-50},
+  { 1.91520656139714740e+00, -1.06199460561959626e-16,
+   -3.05776975679132549e-33, -1.31152587168659481e-49},
+  { 1.93606179349229435e+00,  1.03323859606763257e-16,
+    6.05301367682062275e-33, -7.36768909642599082e-50},
+  { 1.95714412417540018e+00,  8.96076779103666777e-17,
+   -9.63267661361827588e-34,  5.00533969034423796e-50},
+  { 1.97845602638795093e+00,  4.03887531092781666e-17,
+    3.58120371667786224e-34, -1.25697291677754663e-50}
+};
+
+/* exp2_table2[j] = 2^(j/4096) */
+static const double exp2_table2[64][4] = {
+  { 1.00000000000000000e+00,  0.00000000000000000e+00,
+    0.00000000000000000e+00,  0.00000000000000000e+00},
+  { 1.00016923970530214e+00,  9.33618533547846199e-17,
+    3.77297954885090085e-33, -2.92789109669646077e-50},
+  { 1.00033850805268232e+00, -5.14133393131895707e-18,
+    3.65532984508913994e-34, -3.29680664601377120e-52},
+  { 1.00050780504698755e+00,  6.96242402202057255e-17,
+    5.20646484360987195e-34,  2.36712394290176557e-51},
+  { 1.00067713069306641e+00, -5.11512329768566764e-17,
+    6.98198098827029290e-34, -2.71149289272365122e-50},
+  { 1.00084648499576745e+00,  8.42299002458648658e-17,
+    2.36970468083963275e-33,  1.06809383932378651e-49},
+  { 1.00101586795994102e+00, -2.82452207477616781e-17,
+   -1.95728551891328399e-33, -1.14663974106762790e-49},
+  { 1.00118527959043746e+00, -7.18042456559213167e-17,
+   -4.76259460142737668e-33,  1.97839146910037581e-49},
+  { 1.00135471989210822e+00, -1.89737284167929934e-17,
+   -1.14644761608474571e-34,  1.05842115163373934e-50},
+  { 1.00152418886980565e+00,  9.06044106726912173e-17,
+   -9.28795936877474031e-34,  4.43635732244043223e-50},
+  { 1.00169368652838320e+00, -7.17327634990031998e-17,
+    6.07647560689104756e-33, -2.92141104263257906e-49},
+  { 1.00186321287269431e+00, -1.33071962467226607e-17,
+   -3.85443386097781554e-34,  3.49823583019978879e-50},
+  { 1.00203276790759399e+00,  2.57269259432211180e-17,
+    6.79751255613789265e-34,  4.25883291837477541e-50},
+  { 1.00220235163793792e+00, -3.92993778548451721e-17,
+    2.22740945016647608e-33, -1.20441860970250968e-49},
+  { 1.00237196406858220e+00,  8.46137724799471750e-17,
+   -1.15795350476069741e-33, -3.61197314173478002e-50},
+  { 1.00254160520438451e+00, -4.19488324163994025e-17,
+   -1.10867727371575753e-33,  7.01737189351653540e-50},
+  { 1.00271127505020252e+00, -3.63661592869226394e-17,
+   -6.58076018413558387e-34,  3.36523784602358193e-50},
+  { 1.00288097361089523e+00, -2.61094406324393831e-17,
+    1.20560913995705683e-33, -7.29132271757225561e-50},
+  { 1.00305070089132231e+00,  1.75307847798233211e-17,
+    1.13393213893456063e-33, -3.66682301967373369e-50},
+  { 1.00322045689634431e+00,  5.75392352562826744e-17,
+   -2.67723202763627634e-33, -3.40775265864841949e-50},
+  { 1.00339024163082269e+00, -8.68492200511795617e-18,
+   -3.48402050975972235e-34,  1.15143421078605223e-51},
+  { 1.00356005509961932e+00,  9.49003543098177759e-17,
+   -2.72838479693459377e-34, -7.66507342925921104e-51},
+  { 1.00372989730759765e+00, -8.71038060581842237e-17,
+    1.08618280977421918e-33,  5.15068746853218753e-50},
+  { 1.00389976825962091e+00,  3.49589169585715450e-17,
+   -2.94144759791575889e-33,  1.63091457630643435e-49},
+  { 1.00406966796055408e+00,  9.75378754984024100e-17,
+    5.64300142720863840e-33,  2.38861612277076875e-49},
+  { 1.00423959641526284e+00, -1.05762211962928569e-16,
+    5.83707943855262434e-33,  4.55523430718271115e-50},
+  { 1.00440955362861284e+00,  4.20918873812712593e-17,
+    2.17971061415864798e-33,  6.93021754229628934e-51},
+  { 1.00457953960547175e+00, -1.67001668575547876e-17,
+    8.56552273127180632e-34, -3.94318130306203909e-50},
+  { 1.00474955435070723e+00, -1.62314635541245144e-17,
+    9.28530603331304279e-35, -3.60787429919634828e-51},
+  { 1.00491959786918805e+00,  2.30285392780281171e-17,
+   -4.94345170697772961e-34,  1.93312471990685993e-50},
+  { 1.00508967016578388e+00,  1.64180469767730324e-17,
+   -1.40120338097898451e-34, -5.89374115454619152e-51},
+  { 1.00525977124536503e+00,  3.72669843182841367e-17,
+   -6.47401139805376556e-34, -1.95959141624002108e-50},
+  { 1.00542990111280273e+00,  9.49918653545503176e-17,
+    2.69197614795285565e-33, -8.35433093292531747e-50},
+  { 1.00560005977296929e+00, -8.68093131444458157e-17,
+    1.70120132411898593e-33, -1.59002204795664499e-49},
+  { 1.00577024723073705e+00,  4.00054749103011688e-17,
+    1.31925963209617013e-33,  3.04703405199427896e-50},
+  { 1.00594046349098010e+00,  7.19049911150997400e-17,
+    5.87388840736458866e-33,  3.10526963148443244e-49},
+  { 1.00611070855857299e+00, -1.39080686710657830e-17,
+   -1.04608842475341479e-33, -4.77678205797069749e-51},
+  { 1.00628098243839093e+00, -8.14020864257304965e-17,
+    9.81687621053626949e-34, -2.57820873561551302e-50},
+  { 1.00645128513531001e+00, -5.76215104374953425e-17,
+   -2.57074696660737495e-33, -3.16108076535327070e-51},
+  { 1.00662161665420724e+00,  6.74527847731045680e-17,
+    3.78807035520293397e-33, -9.10692615752350757e-50},
+  { 1.00679197699996070e+00,  1.89985572403462958e-17,
+   -9.63431595756658515e-34, -6.06761779089857987e-51},
+  { 1.00696236617744894e+00, -9.63743003231640716e-17,
+    5.37739172125896523e-34,  1.23435871430003821e-50},
+  { 1.00713278419155117e+00, -1.25286544624539789e-17,
+    6.73461401738595970e-34, -2.79661439597634760e-50},
+  { 1.00730323104714792e+00,  3.02057888784369419e-17,
+    2.28748779695564659e-33,  1.44301557327295204e-49},
+  { 1.00747370674912040e+00, -4.86939425860856491e-17,
+   -2.15005825118530979e-33, -1.11570720395992782e-49},
+  { 1.00764421130235027e+00,  5.22402993768745317e-17,
+    1.56859855755260687e-33,  7.74578329914616053e-50},
+  { 1.00781474471172072e+00, -9.36154355147845591e-17,
+    2.73525232969860712e-33, -2.83307417379033090e-51},
+  { 1.00798530698211497e+00, -8.65251323306194957e-17,
+    3.95202635576858745e-33, -2.25660248162962055e-49},
+  { 1.00815589811841755e+00, -3.25205875608430806e-17,
+    2.46355206137317856e-33,  5.56269049118908157e-50},
+  { 1.00832651812551388e+00, -9.91723226806091428e-17,
+   -5.54888559019883709e-33,  1.90652316294578819e-50},
+  { 1.00849716700828984e+00, -7.13604740416252277e-17,
+    4.98539917129953777e-33, -2.53233146019919102e-49},
+  { 1.00866784477163240e+00, -1.72686837122432199e-17,
+    1.49699250027049461e-33,  2.66046582165873359e-50},
+  { 1.00883855142042944e+00, -6.61995469367394011e-17,
+   -1.37180394060118324e-33, -7.57170571975211778e-51},
+  { 1.00900928695956926e+00,  3.56545690151302038e-17,
+   -3.04973969952342772e-33,  8.64910071163218509e-50},
+  { 1.00918005139394151e+00,  3.71731001370881786e-17,
+    2.33846700487585834e-33,  1.38069491497105758e-49},
+  { 1.00935084472843628e+00,  7.06257240682552768e-17,
+   -2.69254581845265407e-33, -4.94464010719697495e-50},
+  { 1.00952166696794476e+00, -1.43214123034288193e-17,
+    1.18343254028162626e-33, -8.44147373080522644e-50},
+  { 1.00969251811735861e+00,  1.56681880131341096e-17,
+   -7.81531085085694012e-34,  5.30174323419224883e-50},
+  { 1.00986339818157078e+00, -1.10436957803936884e-16,
+    2.26009746193166539e-33,  1.03797211931030463e-49},
+  { 1.01003430716547449e+00, -5.76731742716039802e-17,
+   -2.78217177127226696e-33,  1.65517038098333125e-49},
+  { 1.01020524507396425e+00,  4.83548497844038274e-18,
+    2.61454310671247391e-34,  9.21760306711661842e-51},
+  { 1.01037621191193527e+00,  7.01512128971544210e-17,
+   -5.58161827166019262e-33, -2.15819082018296171e-49},
+  { 1.01054720768428363e+00,  7.16180287361957384e-17,
+   -2.02563561553844543e-34,  2.06739786346335088e-50},
+  { 1.01071823239590608e+00,  1.05046591340840500e-16,
+    2.18415845005431430e-33,  3.31082552151282184e-50}
+};
+
+/* 4096/log(2), and exp_ln2_hi + exp_ln2_lo = log(2)/4096, where exp_ln2_hi
+   has 30 significant bits */
+static const double exp_inv_ln2 = 5.90927888748119403e+03;
+static const double exp_ln2_hi = 1.69225385661775363e-04;
+static const double exp_ln2_lo[4] = {
+   2.17117535129069265e-13, -9.78675807011760187e-30,
+  -1.39447748919859131e-46,  1.52706013696078601e-63
+};
+
 qd_real exp(const qd_real &a) {
-  /* Strategy:  We first reduce the size of x by noting that
-     
-          exp(kr + m * log(2)) = 2^m * exp(r)^k
+  /* Strategy:  We write a = (4096 m + 64 j1 + j2) * log(2)/4096 + r, where
+     m, j1 and j2 are integers with 0 <= j1, j2 < 64, so that
 
-     where m and k are integers.  By choosing m appropriately
-     we can make |kr| <= log(2) / 2 = 0.347.  Then exp(r) is 
-     evaluated using the familiar Taylor series.  Reducing the 
-     argument substantially speeds up the convergence.       */  
+          exp(a) = 2^m * 2^(j1/64) * 2^(j2/4096) * exp(r)
 
-  const double k = 65536.0;
-  const double inv_k = 1.0 / k;
+     with |r| <= log(2)/8192 = 8.5e-5.  The powers of two are looked up in
+     exp2_table1 and exp2_table2, and exp(r) - 1 is evaluated with the
+     Taylor series up to r^13.  Since r is so small, the last three terms
+     only need double precision.                                            */
 
   if (a[0] <= -709.0)
     return 0.0;
@@ -427,59 +807,368 @@ qd_real exp(const qd_real &a) {
   if (a.is_one())
     return qd_real::_e;
 
-  double m = qd_floor(a.x[0] / qd_real::_log2.x[0] + 0.5);
-  qd_real r = mul_pwr2(a - qd_real::_log2 * m, inv_k);
-  qd_real s, p, t;
-  double thresh = inv_k * qd_real::_eps;
+  if (a.isnan())
+    return qd_real::_nan;
+
+  double k = qd_floor(a.x[0] * exp_inv_ln2 + 0.5);
+  double m = qd_floor(k * (1.0 / 4096.0));
+  int j = static_cast<int>(k - m * 4096.0);
+
+  /* k * exp_ln2_hi is exact, since |k| < 2^22 */
+  qd_real r = (a - k * exp_ln2_hi) -
+      qd_real(exp_ln2_lo[0], exp_ln2_lo[1], exp_ln2_lo[2], exp_ln2_lo[3]) * k;
+  double c, r0 = r.x[0];
+  qd_real p, s;
+
+  /* exp(r) - 1 = r + r^2 (1/2 + r (1/6 + r (1/24 + ... r (1/10! + r c)))) */
+  c = inv_fact[8][0] + r0 * (inv_fact[9][0] + r0 * inv_fact[10][0]);
+  p = qd_real(inv_fact[7][0], inv_fact[7][1], inv_fact[7][2], inv_fact[7][3]) +
+      r0 * c;
+  for (int i = 6; i >= 0; i--)
+    p = qd_real(inv_fact[i][0], inv_fact[i][1], inv_fact[i][2], inv_fact[i][3]) +
+        r * p;
+  p = r * p + 0.5;
+  p = r + sqr(r) * p;
+
+  s = qd_real(exp2_table1[j >> 6][0], exp2_table1[j >> 6][1],
+              exp2_table1[j >> 6][2], exp2_table1[j >> 6][3]) *
+      qd_real(exp2_table2[j & 63][0], exp2_table2[j & 63][1],
+              exp2_table2[j & 63][2], exp2_table2[j & 63][3]);
+  s = s + s * p;
 
-  p = sqr(r);
-  s = r + mul_pwr2(p, 0.5);
-  int i = 0;
-  do {
-	p *= r;
-	t = p * qd_real(inv_fact[i][0], inv_fact[i][1], inv_fact[i][2], inv_fact[i][3]);
-	i++;
-    s += t;
-  } while (qd_fabs(to_double(t)) > thresh && i < 9);
-
-  s = mul_pwr2(s, 2.0) + sqr(s);
-  s = mul_pwr2(s, 2.0) + sqr(s);
-  s = mul_pwr2(s, 2.0) + sqr(s);
-  s = mul_pwr2(s, 2.0) + sqr(s);
-  s = mul_pwr2(s, 2.0) + sqr(s);
-  s = mul_pwr2(s, 2.0) + sqr(s);
-  s = mul_pwr2(s, 2.0) + sqr(s);
-  s = mul_pwr2(s, 2.0) + sqr(s);
-  s = mul_pwr2(s, 2.0) + sqr(s);
-  s = mul_pwr2(s, 2.0) + sqr(s);
-  s = mul_pwr2(s, 2.0) + sqr(s);
-  s = mul_pwr2(s, 2.0) + sqr(s);
-  s = mul_pwr2(s, 2.0) + sqr(s);
-  s = mul_pwr2(s, 2.0) + sqr(s);
-  s = mul_pwr2(s, 2.0) + sqr(s);
-  s = mul_pwr2(s, 2.0) + sqr(s);
-  s += 1.0;
   return ldexp(s, static_cast<int>(m));
 }
 
+/* inv_odd[i] = 1/(2i + 3) */
+static const int n_inv_odd = 15;
+static const double inv_odd[n_inv_odd][4] = {
+  { 3.33333333333333315e-01,  1.85037170770859413e-17,
+    1.02716263700652573e-33,  5.70189804819668373e-50},
+  { 2.00000000000000011e-01, -1.11022302462515660e-17,
+    6.16297582203915507e-34, -3.42113882891801062e-50},
+  { 1.42857142857142849e-01,  7.93016446160826056e-18,
+    4.40212558717082456e-34,  2.44367059208429303e-50},
+  { 1.11111111111111105e-01,  6.16790569236198044e-18,
+    3.42387545668841910e-34,  1.90063268273222791e-50},
+  { 9.09090909090909116e-02, -2.52323414687535584e-18,
+    7.00338161595358511e-35, -1.94382888006705143e-51},
+  { 7.69230769230769273e-02, -4.27008855625060232e-18,
+    2.37037531616890580e-34, -1.31582262650692716e-50},
+  { 6.66666666666666657e-02,  9.25185853854297104e-19,
+    1.28395329625815722e-35,  1.78184314006146374e-52},
+  { 5.88235294117647051e-02,  8.16340459283203327e-19,
+    1.13289996728660931e-35,  1.57221453534835036e-52},
+  { 5.26315789473684181e-02,  2.92163953848725389e-18,
+    1.62183574264188273e-34,  9.00299691820529010e-51},
+  { 4.76190476190476164e-02,  2.64338815386942019e-18,
+    1.46737519572360819e-34,  8.14556864028097676e-51},
+  { 4.34782608695652162e-02,  1.20676415720125708e-18,
+    3.34944338154301878e-35,  9.29657290466850634e-52},
+  { 4.00000000000000008e-02, -8.32667268468867375e-19,
+   -3.08148791101957743e-35,  6.41463530422126931e-52},
+  { 3.70370370370370350e-02,  2.05596856412066015e-18,
+    1.14129181889613970e-34,  6.33544227577409303e-51},
+  { 3.44827586206896547e-02,  4.78544407166015744e-19,
+    6.64113773926633044e-36,  9.21643003480067451e-53},
+  { 3.22580645161290314e-02,  8.95341148891255250e-19,
+    2.48507089598353006e-35,  6.89745731636695631e-52}
+};
+
+/* log_table1[i] = log((i + 48)/64) */
+static const double log_table1[49][4] = {
+  {-2.87682072451780901e-01, -2.60716061644256398e-17,
+    1.07080257601929532e-33,  4.99382196396351530e-50},
+  {-2.67062785249045254e-01,  7.32891532732016949e-18,
+   -3.90872227917107262e-34,  3.64605828891817459e-50},
+  {-2.46860077931525784e-01, -1.36174337174836802e-17,
+    6.87982472333716820e-34, -4.07304118102128646e-50},
+  {-2.27057450635346075e-01, -9.55141576273848843e-18,
+   -1.86621305696821593e-34,  1.04695126549637441e-51},
+  {-2.07639364778244490e-01, -1.20532432166861289e-17,
+   -6.93429586164248683e-34,  3.25593735758732929e-50},
+  {-1.88591169807550030e-01,  7.43216421919692505e-18,
+    6.24231702947889109e-34,  6.21218943689046331e-51},
+  {-1.69899036795397473e-01,  4.86800876443907079e-19,
+    2.76151803443973633e-35,  1.73421898901513215e-51},
+  {-1.51549898127200933e-01, -5.16695936846155944e-18,
+    2.63492858713270898e-34, -1.51045809649550767e-50},
+  {-1.33531392624522627e-01,  3.66445766366008474e-18,
+   -1.95436113958553631e-34,  1.82302914445908730e-50},
+  {-1.15831815525121701e-01, -4.33848436980809596e-18,
+    1.96601631521978760e-34,  1.70211657626679835e-51},
+  {-9.84400728132525243e-02,  4.43900963367513588e-18,
+   -1.99055888925173173e-34, -3.99852756038030179e-51},
+  {-8.13456394539524008e-02, -5.07707635593116993e-18,
+    1.14877643671529610e-34, -6.25922709844384513e-51},
+  {-6.45385211375711781e-02,  6.47048666169293300e-18,
+    1.59435278597175671e-34, -9.72126499921790037e-51},
+  {-4.80092191863606063e-02, -1.43909033472922047e-18,
+    4.41961825729638841e-35,  1.82908726095173097e-51},
+  {-3.17486983145802981e-02, -3.03822630846808579e-18,
+   -5.93872646591806295e-35,  4.35355841781001654e-51},
+  {-1.57483569681391676e-02, -1.00215786305289737e-18,
+    1.32309542182516880e-35, -5.73297395014998625e-52},
+  { 0.00000000000000000e+00,  0.00000000000000000e+00,
+    0.00000000000000000e+00,  0.00000000000000000e+00},
+  { 1.55041865359652545e-02, -3.27832102289242913e-19,
+   -1.59046794668987791e-35, -3.72463962057804990e-52},
+  { 3.07716586667536873e-02,  1.04317320290059678e-18,
+   -7.24613405845466539e-35,  5.21350700567110430e-51},
+  { 4.58095360312942013e-02,  1.90295986647425706e-18,
+    1.67290750010996809e-35, -1.02787046986502163e-51},
+  { 6.06246218164348399e-02,  2.64240259387269342e-18,
+   -1.01865915083775443e-34, -6.12703301266365050e-51},
+  { 7.52234212375875316e-02, -5.93060419629324072e-18,
+   -1.04565800848806988e-34,  7.35781749823829427e-52},
+  { 8.96121586896871380e-02, -5.42681293366471353e-18,
+   -3.36431433625778959e-34, -2.00470755135246164e-50},
+  { 1.03796793681643559e-01,  5.47772415726659013e-18,
+    1.50165355734577708e-34,  9.61373583871788943e-51},
+  { 1.17783035656383456e-01, -1.19716857475936773e-18,
+    1.60740737380817151e-35, -9.42358689605012462e-53},
+  { 1.31576357788719261e-01,  1.11230008797295880e-17,
+   -5.56501655013182157e-34,  9.41792996117436796e-51},
+  { 1.45182009844497889e-01,  8.24241878302247539e-18,
+   -6.13108514412931241e-34, -4.90720528159557860e-51},
+  { 1.58605030176638573e-01,  1.12570038721825922e-17,
+   -7.51932018824944019e-34, -2.66165142765958258e-50},
+  { 1.71850256926659228e-01, -6.02245382101137048e-18,
+   -1.03828966742422261e-34, -5.47186770189322582e-51},
+  { 1.84922338494011990e-01,  3.02366141535740643e-18,
+    9.45093050866946605e-36,  2.33225911548777987e-52},
+  { 1.97825743329919868e-01,  1.28211943729801419e-17,
+   -5.92600121813120754e-34, -3.88551996134599290e-50},
+  { 2.10564769107349642e-01, -4.24940531472989533e-18,
+   -7.86893169556700587e-35,  2.80462850589529556e-51},
+  { 2.23143551314209765e-01, -9.09127059732479905e-18,
+    6.29376658087669013e-34, -3.82773669581154894e-50},
+  { 2.35566071312766911e-01, -2.39433714951873546e-18,
+    3.21481474761634302e-35, -1.88471737921002492e-52},
+  { 2.47836163904581269e-01, -1.24322095787025232e-17,
+   -4.66382522518501231e-34, -3.69540438710631354e-50},
+  { 2.59957524436926046e-01,  2.06980693897893503e-17,
+    1.70440438462878569e-34,  3.87204284578277576e-51},
+  { 2.71933715483641758e-01,  7.83319637697442012e-19,
+    1.68984761193603737e-36, -6.30831316599607007e-53},
+  { 2.83768173130644619e-01, -2.03266558112665612e-17,
+   -6.28047223628448006e-34,  1.97419530714335556e-50},
+  { 2.95464212893835898e-01, -2.16461086040598997e-17,
+   -5.87196257971975792e-34,  1.85560929567120513e-50},
+  { 3.07025035294911874e-01, -1.23199162001019643e-17,
+    6.72145553180849054e-34, -3.26488653882383910e-50},
+  { 3.18453731118534589e-01,  2.71147793673262360e-17,
+   -5.65484933287671292e-34,  3.01126992486174288e-50},
+  { 3.29753286372467980e-01,  2.12202061619694602e-18,
+    2.68304048747813354e-35, -6.55960991254707521e-52},
+  { 3.40926586970593193e-01,  1.74671364435447471e-17,
+    2.60264742948303536e-34, -1.69894851463384256e-50},
+  { 3.51976423157178198e-01, -1.29538930301919629e-17,
+    4.52277121473713276e-34, -2.77988924470290811e-50},
+  { 3.62905493689368475e-01, -2.14923614553109720e-17,
+   -4.04996399113208030e-34,  1.49439151524013695e-50},
+  { 3.73716409793584059e-01,  2.18362112811981843e-17,
+    8.11814177446841491e-34,  8.26138089936397479e-50},
+  { 3.84411698910332056e-01, -1.61214970076467292e-17,
+    1.09838125786579494e-33,  1.35897264229580024e-50},
+  { 3.94993808240868993e-01, -1.51137244183361680e-17,
+   -1.01519626416454202e-33,  4.17792360629415466e-50},
+  { 4.05465108108164385e-01, -2.88113802596264264e-18,
+    1.00829464351127865e-34, -7.26822014712052638e-51}
+};
+
+/* log_table2[j] = log(1 + (j - 43)/4096) */
+static const double log_table2[87][4] = {
+  {-1.05535400910351639e-02, -7.25941568955685737e-19,
+    4.66537573785383985e-35,  6.56510028287046146e-52},
+  {-1.03068397073983672e-02, -4.15318605037396561e-19,
+    1.02829935997150268e-35, -2.90798514553488496e-52},
+  {-1.00602001698304171e-02, -6.99930610388006035e-20,
+   -5.30704368434393872e-36, -1.96476187250297607e-52},
+  {-9.81362144832462202e-03,  7.67951156294011725e-19,
+   -3.41752441256661383e-35, -9.50296617402243005e-52},
+  {-9.56710351289647917e-03, -1.59233596916934183e-19,
+    3.46499843486352157e-36,  2.70182810145136135e-52},
+  {-9.32064633358366083e-03,  1.74334655630909496e-19,
+    4.95116155626340919e-37, -3.57574934633662558e-54},
+  {-9.07424988044598299e-03,  7.03273931262190493e-19,
+   -4.58202703999233057e-35,  2.16109451368994836e-51},
+  {-8.82791412356538803e-03,  7.46920175987228859e-19,
+    4.22916607652186022e-35, -2.66348539316735426e-51},
+  {-8.58163903304592218e-03, -7.45733849720802199e-19,
+    4.25143634617962786e-35,  2.41563070479750567e-51},
+  {-8.33542457901371818e-03, -7.73762132676292010e-19,
+   -1.71418724101407845e-35, -8.94547214254183509e-52},
+  {-8.08927073161696576e-03, -3.18865459328876563e-20,
+   -1.17991073826573977e-36, -8.95662623363252644e-54},
+  {-7.84317746102589260e-03, -2.76470815412490379e-19,
+   -1.43730600409990097e-36, -6.40760109020880673e-53},
+  {-7.59714473743274693e-03,  1.64947995953690743e-20,
+   -1.21250973034502192e-36, -6.40304688103473952e-53},
+  {-7.35117253105177070e-03,  4.25754943905035243e-19,
+   -1.05170670039606654e-35, -2.22927928071645735e-52},
+  {-7.10526081211917959e-03,  2.71409101480605997e-19,
+    2.03094535941758287e-35,  2.41155083581585278e-52},
+  {-6.85940955089314307e-03,  2.74935414239585585e-19,
+    2.35159976958332359e-36,  1.11564015952047470e-52},
+  {-6.61361871765376013e-03, -1.44151082837087378e-19,
+    1.10946290490685482e-35, -1.25413155241459895e-52},
+  {-6.36788828270304016e-03, -3.93987537392698576e-19,
+   -1.25779154318940875e-35, -1.30243327590528596e-51},
+  {-6.12221821636488046e-03,  2.68022041624835466e-19,
+    1.03118428227226163e-35, -1.77915928435624037e-52},
+  {-5.87660848898504187e-03, -4.75710012466222170e-20,
+   -1.28601059699159542e-36,  2.71604170440258956e-53},
+  {-5.63105907093113325e-03,  2.17894955518924119e-21,
+   -1.18040029063924734e-37,  1.92754790526965832e-54},
+  {-5.38556993259258539e-03,  4.22348051636940245e-19,
+    5.59798560876456974e-36,  1.41107347540669715e-52},
+  {-5.14014104438062936e-03, -3.79635005375019904e-19,
+   -2.67440022179715161e-36, -1.01368454820556283e-53},
+  {-4.89477237672828087e-03,  1.91480938067756941e-19,
+   -5.82537029662833228e-36,  1.38069079941912513e-52},
+  {-4.64946390009030996e-03, -6.71556280062807567e-20,
+    1.82364936803557416e-36,  1.51958779436254771e-52},
+  {-4.40421558494322792e-03,  1.78603825731136695e-19,
+   -3.67670200480651847e-36, -1.33049533666069954e-52},
+  {-4.15902740178526048e-03,  2.31054411158582917e-19,
+    1.92212992165078163e-35,  1.13100516928053527e-51},
+  {-3.91389932113632866e-03, -4.28089862306812556e-19,
+    9.42111490371931561e-36,  1.88290248671623717e-52},
+  {-3.66883131353802974e-03,  4.74847786934895450e-20,
+    1.73687045449681668e-36,  9.75991619702762256e-53},
+  {-3.42382334955360990e-03, -2.12116865935615057e-19,
+   -7.48194070782120764e-36, -2.15782869152434014e-52},
+  {-3.17887539976794992e-03,  1.10603559691361961e-19,
+    7.14897944401500008e-36, -2.10050635834098394e-53},
+  {-2.93398743478753832e-03, -1.78581282679738599e-19,
+   -6.49216735772759718e-36, -3.66771177286785827e-52},
+  {-2.68915942524045482e-03, -1.02341239659220654e-19,
+    5.54488360992164079e-36, -5.98784376473308965e-53},
+  {-2.44439134177634569e-03, -9.43423178917747073e-20,
+    5.23619578027197234e-36,  1.33369085720151058e-52},
+  {-2.19968315506640462e-03,  3.01886627508348795e-20,
+    7.39946811962445440e-37, -3.40221808171017730e-53},
+  {-1.95503483580335060e-03,  4.23089975868117194e-20,
+    3.78615554528245057e-37,  1.81143574909166511e-54},
+  {-1.71044635470140758e-03, -2.38579359016768071e-20,
+   -9.40982498894543990e-37,  6.04037026615035458e-53},
+  {-1.46591768249628319e-03, -8.74510533618092990e-20,
+   -1.97132553192003464e-36,  1.02155562156783561e-52},
+  {-1.22144878994514768e-03, -4.60703402474547451e-20,
+   -2.53632155396887035e-36,  2.07859529744266429e-53},
+  {-9.77039647826612742e-04, -4.34891950935811583e-20,
+    5.59078432895191125e-37, -3.81827534127069888e-53},
+  {-7.32690226940710941e-04, -4.06074485988407647e-21,
+    1.03127440280835299e-37,  8.38949183205406540e-55},
+  {-4.88400498108874513e-04,  4.83364011033017519e-20,
+    1.99107196114985101e-36, -2.06204706389024200e-54},
+  {-2.44170432173914482e-04,  2.52627502647402595e-20,
+    3.35540289457963923e-37,  1.47634606165792044e-53},
+  { 0.00000000000000000e+00,  0.00000000000000000e+00,
+    0.00000000000000000e+00,  0.00000000000000000e+00},
+  { 2.44110827527362707e-04,  1.77171796530404887e-21,
+    1.55406825140337388e-38,  6.73525468350217047e-55},
+  { 4.88162079501351187e-04,  1.35619766115681169e-21,
+   -2.25413668111019923e-38, -1.37913004756348224e-55},
+  { 7.32153784993847521e-04, -4.73965273886891506e-20,
+    4.33640616932105643e-38, -1.34010029284958269e-54},
+  { 9.76085973055458925e-04, -2.87911565340967140e-20,
+   -1.08570000455863480e-36, -7.23129422156501268e-54},
+  { 1.21995867271553881e-03,  2.73637967322885053e-20,
+   -1.04369304915093790e-36, -3.09735323257927786e-53},
+  { 1.46377191298220741e-03,  4.67881719509121933e-20,
+    1.35109377082871636e-36, -4.11787995166071385e-53},
+  { 1.70752572284237243e-03, -4.06053447156312446e-20,
+   -2.54563683411902425e-36,  8.52828974295308647e-53},
+  { 1.95122013126174934e-03,  1.02198352357159588e-19,
+   -3.99141348350355726e-36,  2.71498352260199356e-52},
+  { 2.19485516718488302e-03,  1.87574730904519332e-19,
+    6.86072313163292356e-36, -2.28457275236147827e-52},
+  { 2.43843085953516754e-03,  1.97929480221573571e-19,
+   -7.86294546261613165e-36, -1.41479515324938330e-52},
+  { 2.68194723721486717e-03, -4.57894805082501185e-20,
+    1.06735517489578950e-36,  3.23384250610635507e-53},
+  { 2.92540432910513588e-03,  1.77224490363642349e-19,
+   -1.74692536502436529e-36, -5.01303269530030327e-53},
+  { 3.16880216406604034e-03,  5.44643647432984855e-20,
+    5.78110605354753732e-36,  2.49762834483484395e-52},
+  { 3.41214077093657774e-03, -1.38978902986614071e-20,
+    2.66411755371262205e-37, -7.26134134836823087e-54},
+  { 3.65542017853469781e-03, -3.07962086256581250e-20,
+   -1.41925643540511732e-37, -7.46483503642389986e-54},
+  { 3.89864041565732289e-03,  1.25416590383049728e-19,
+   -3.23099314372743820e-36, -1.42572076807978779e-52},
+  { 4.14180151108036864e-03,  3.36398021396031531e-19,
+    7.48124644141701547e-36,  1.66025874020855510e-52},
+  { 4.38490349355876493e-03, -1.45614591485570386e-19,
+    1.95269736229446785e-36,  5.09742137392417975e-53},
+  { 4.62794639182647315e-03,  3.57388820338121514e-19,
+    1.07281826845919161e-35, -2.58498823457275676e-52},
+  { 4.87093023459651223e-03,  3.05979323121979191e-19,
+   -3.99639142772401789e-36, -1.89194174843820286e-53},
+  { 5.11385505056097429e-03, -3.16333083527133018e-19,
+   -1.20713497065786111e-35,  1.27902951525951738e-51},
+  { 5.35672086839104455e-03,  3.75754673069286935e-19,
+   -7.42284580914562935e-37,  1.91071665820531907e-53},
+  { 5.59952771673702821e-03, -4.15380125578459267e-19,
+   -7.49797747566495533e-36, -3.30041675342517531e-52},
+  { 5.84227562422836091e-03, -2.99774986840257440e-19,
+    1.44337852989071463e-36,  6.64211894237662783e-53},
+  { 6.08496461947363732e-03, -6.85749739498745228e-20,
+    1.42291508711011544e-36, -7.80009112177694709e-53},
+  { 6.32759473106062759e-03,  5.57674101250218903e-20,
+   -3.21070119205450405e-36, -1.78239977824940404e-52},
+  { 6.57016598755629823e-03, -1.92052037888950597e-19,
+    2.45951921245021778e-36,  7.31071336699155944e-53},
+  { 6.81267841750683115e-03, -2.15099916705227399e-20,
+   -1.32775051023347637e-36, -5.57816489229275898e-54},
+  { 7.05513204943764623e-03,  1.85123378022074868e-20,
+   -9.38142938654087391e-37,  4.08533536396551937e-53},
+  { 7.29752691185341952e-03, -4.31229393509403542e-20,
+    2.21617579825122852e-37,  2.07013554080149375e-53},
+  { 7.53986303323810406e-03, -3.09140992297371426e-19,
+   -7.33450325115303559e-36, -5.15555887698687663e-52},
+  { 7.78214044205494896e-03, -1.28191791233438450e-20,
+    6.19199181458104848e-37,  4.71690023469354918e-54},
+  { 8.02435916674652111e-03,  8.56640443816977447e-19,
+    1.81079636648502840e-36,  5.83753603339600255e-53},
+  { 8.26651923573472683e-03, -9.55484337350411144e-20,
+   -4.88667121068534207e-36, -2.46846688569554842e-52},
+  { 8.50862067742082402e-03,  1.97311419580425625e-19,
+   -1.00284123916154727e-35, -4.77902827470725828e-52},
+  { 8.75066352018545254e-03, -1.08344472404459438e-19,
+    5.84424027317741332e-37, -2.09248723251204459e-53},
+  { 8.99264779238864720e-03, -8.15034169533909709e-19,
+    2.41103452323992467e-35,  5.62060444646844869e-52},
+  { 9.23457352236985857e-03, -5.63323119544618154e-19,
+    3.16315811347683223e-35, -5.69833655463117181e-52},
+  { 9.47644073844797555e-03,  5.30247316740690789e-19,
+   -2.70299274384075045e-36, -8.83542884435249402e-53},
+  { 9.71824946892134618e-03, -5.41214469458391938e-20,
+   -1.76333280623680329e-36,  1.19976523507260895e-53},
+  { 9.95999974206778979e-03,  4.82809504725551005e-19,
+   -3.99602408694927167e-36,  1.83770800722886304e-52},
+  { 1.02016915861446265e-02,  6.10370079051234250e-19,
+    1.46840436129044225e-36,  5.55768546745219870e-53},
+  { 1.04433250293886910e-02,  4.07574277155848148e-19,
+   -1.22774811111719131e-35, -5.30727653176606683e-52}
+};
+
 /* Logarithm.  Computes log(x) in quad-double precision.
    This is a natural logarithm (i.e., base e).            */
 qd_real log(const qd_real &a) {
-  /* Strategy.  The Taylor series for log converges much more
-     slowly than that of exp, due to the lack of the factorial
-     term in the denominator.  Hence this routine instead tries
-     to determine the root of the function
+  /* Strategy:  We write a = 2^e * m with 0.75 <= m < 1.5, and approximate
+     m by y = i/64 * (1 + j/4096), where i and j are integers, so that
 
-         f(x) = exp(x) - a
+          log(a) = e log(2) + log(i/64) + log(1 + j/4096) + log(m/y).
 
-     using Newton iteration.  The iteration is given by
+     The two logarithms are looked up in log_table1 and log_table2.  Since
+     |m/y - 1| < 1.3e-4, the series
 
-         x' = x - f(x)/f'(x) 
-            = x - (1 - a * exp(-x))
-            = x + a * exp(-x) - 1.
-           
-     Two iteration is needed, since Newton's iteration 
-     approximately doubles the number of digits per iteration. */
+          log(m/y) = 2 atanh(u) = 2 (u + u^3/3 + u^5/5 + ...),
+
+     where u = (m - y)/(m + y), converges quickly: the terms up to u^15
+     are enough.  The last two need only double precision.               */
 
   if (a.is_one()) {
     return 0.0;
@@ -494,13 +1183,45 @@ qd_real log(const qd_real &a) {
     return -qd_real::_inf;
   }
 
-  qd_real x = qd_log(a[0]);   /* Initial approximation */
+  if (a.isnan())
+    return qd_real::_nan;
+
+  if (a.isinf())
+    return qd_real::_inf;
+
+  qd_real m = a;
+  double e = 0.0;
 
-  x = x + a * exp(-x) - 1.0;
-  x = x + a * exp(-x) - 1.0;
-  x = x + a * exp(-x) - 1.0;
+  /* Subnormal numbers are scaled by 2^54 first */
+  if (m[0] < 2.2250738585072014e-308) {
+    m = mul_pwr2(m, 18014398509481984.0);
+    e = -54.0;
+  }
 
-  return x;
+  int k = qd::exponent(m[0] * (4.0 / 3.0));
+  m = ldexp(m, -k);
+  e += k;
+
+  double i = qd_floor(m[0] * 64.0 + 0.5);
+  double j = qd_floor((m[0] * 64.0 / i - 1.0) * 4096.0 + 0.5);
+  double y = i * (4096.0 + j) * (1.0 / 262144.0);   /* exact */
+  int ti = static_cast<int>(i) - 48, tj = static_cast<int>(j) + 43;
+
+  qd_real u = (m - y) / (m + y);
+  qd_real w = sqr(u);
+  double c, w0 = w[0];
+  qd_real p, s;
+
+  /* atanh(u) = u + u w (1/3 + w (1/5 + ... + w (1/11 + w c))), with
+     w = u^2 and c = 1/13 + w/15 */
+  c = inv_odd[5][0] + w0 * inv_odd[6][0];
+  p = qd_real(inv_odd[4]) + w0 * c;
+  for (int n = 3; n >= 0; n--)
+    p = qd_real(inv_odd[n]) + w * p;
+  p = w * p;
+
+  s = qd_real::_log2 * e + qd_real(log_table1[ti]) + qd_real(log_table2[tj]);
+  return s + mul_pwr2(u + u * p, 2.0);
 }
 
 qd_real log10(const qd_real &a) {
@@ -1610,6 +2331,48 @@ static qd_real cos_taylor(const qd_real &a) {
   return s;
 }
 
+/* 2/pi, and pi/2 split into pieces of 33 bits for the Cody-Waite
+   reduction in rem_pio2 */
+static const double inv_pio2 = 6.36619772367581382e-01;
+static const int n_pio2_cw = 9;
+static const double pio2_cw[n_pio2_cw] = {
+  1.57079632673412561e+00,  6.07710050630396598e-11,
+  2.02226624871116646e-21,  8.47842763968524269e-32,
+  2.06836569553604390e-40,  1.28584756791468308e-50,
+  2.54630579580372525e-60,  3.11974927395737693e-70,
+  1.95117911228650668e-80
+};
+
+/* Reduces a modulo pi/2: computes t and j with a = t + j * pi/2 (modulo
+   2 pi), |t| <= pi/4 (approximately) and -1 <= j <= 2.  Returns false if
+   a is not finite. */
+static bool rem_pio2(const qd_real &a, qd_real &t, int &j) {
+  if (qd_fabs(a.x[0]) < 1.0e6) {
+    /* Cody-Waite.  Since |q| < 2^20, the products q * pio2_cw[i] are
+       exact, and the leading bits of a cancel exactly. */
+    double q = qd_floor(a.x[0] * inv_pio2 + 0.5);
+    t = a;
+    for (int i = 0; i < n_pio2_cw; i++)
+      t = t - q * pio2_cw[i];
+    j = static_cast<int>(q - 4.0 * qd_floor(q * 0.25));
+    if (j == 3)
+      j = -1;
+    return true;
+  }
+
+  if (a.isnan() || a.isinf())
+    return false;
+
+  /* Payne-Hanek */
+  double y[qd::pio2::frac_words];
+  j = qd::pio2::rem_pio2(a.x, 4, y);
+  qd_real f = y[0];
+  for (int i = 1; i < qd::pio2::frac_words; i++)
+    f += y[i];
+  t = f * qd_real::_pi2;
+  return true;
+}
+
 qd_real sin(const qd_real &a) {
 
   /* Strategy.  To compute sin(x), we choose integers a, b so that
@@ -1625,24 +2388,19 @@ qd_real sin(const qd_real &a) {
     return 0.0;
   }
 
-  // approximately reduce modulo 2*pi
-  qd_real z = nint(a / qd_real::_2pi);
-  qd_real r = a - qd_real::_2pi * z;
+  // reduce modulo pi/2 and then modulo pi/1024
+  qd_real r, t;
+  int j;
+  if (!rem_pio2(a, t, j)) {
+    qd_real::error("(qd_real::sin): Cannot reduce modulo pi/2.");
+    return qd_real::_nan;
+  }
 
-  // approximately reduce modulo pi/2 and then modulo pi/1024
-  double q = qd_floor(r.x[0] / qd_real::_pi2[0] + 0.5);
-  qd_real t = r - qd_real::_pi2 * q;
-  int j = static_cast<int>(q);
-  q = qd_floor(t.x[0] / qd_real::_pi1024[0] + 0.5);
+  double q = qd_floor(t.x[0] / qd_real::_pi1024[0] + 0.5);
   t -= qd_real::_pi1024 * q;
   int k = static_cast<int>(q);
   int abs_k = qd_abs(k);
 
-  if (j < -2 || j > 2) {
-    qd_real::error("(qd_real::sin): Cannot reduce modulo pi/2.");
-    return qd_real::_nan;
-  }
-
   if (abs_k > 256) {
     qd_real::error("(qd_real::sin): Cannot reduce modulo pi/1024.");
     return qd_real::_nan;
@@ -1701,24 +2459,19 @@ qd_real cos(const qd_real &a) {
     return 1.0;
   }
 
-  // approximately reduce modulo 2*pi
-  qd_real z = nint(a / qd_real::_2pi);
-  qd_real r = a - qd_real::_2pi * z;
+  // reduce modulo pi/2 and then modulo pi/1024
+  qd_real r, t;
+  int j;
+  if (!rem_pio2(a, t, j)) {
+    qd_real::error("(qd_real::cos): Cannot reduce modulo pi/2.");
+    return qd_real::_nan;
+  }
 
-  // approximately reduce modulo pi/2 and then modulo pi/1024
-  double q = qd_floor(r.x[0] / qd_real::_pi2.x[0] + 0.5);
-  qd_real t = r - qd_real::_pi2 * q;
-  int j = static_cast<int>(q);
-  q = qd_floor(t.x[0] / qd_real::_pi1024.x[0] + 0.5);
+  double q = qd_floor(t.x[0] / qd_real::_pi1024.x[0] + 0.5);
   t -= qd_real::_pi1024 * q;
   int k = static_cast<int>(q);
   int abs_k = qd_abs(k);
 
-  if (j < -2 || j > 2) {
-    qd_real::error("(qd_real::cos): Cannot reduce modulo pi/2.");
-    return qd_real::_nan;
-  }
-
   if (abs_k > 256) {
     qd_real::error("(qd_real::cos): Cannot reduce modulo pi/1024.");
     return qd_real::_nan;
@@ -1780,25 +2533,20 @@ void sincos(const qd_real &a, qd_real &sin_a, qd_real &cos_a) {
     return;
   }
 
-  // approximately reduce by 2*pi
-  qd_real z = nint(a / qd_real::_2pi);
-  qd_real t = a - qd_real::_2pi * z;
-
-  // approximately reduce by pi/2 and then by pi/1024.
-  double q = qd_floor(t.x[0] / qd_real::_pi2.x[0] + 0.5);
-  t -= qd_real::_pi2 * q;
-  int j = static_cast<int>(q);
-  q = qd_floor(t.x[0] / qd_real::_pi1024.x[0] + 0.5);
-  t -= qd_real::_pi1024 * q;
-  int k = static_cast<int>(q);
-  int abs_k = qd_abs(k);
-
-  if (j < -2 || j > 2) {
+  // reduce by pi/2 and then by pi/1024.
+  qd_real t;
+  int j;
+  if (!rem_pio2(a, t, j)) {
     qd_real::error("(qd_real::sincos): Cannot reduce modulo pi/2.");
     cos_a = sin_a = qd_real::_nan;
     return;
   }
 
+  double q = qd_floor(t.x[0] / qd_real::_pi1024.x[0] + 0.5);
+  t -= qd_real::_pi1024 * q;
+  int k = static_cast<int>(q);
+  int abs_k = qd_abs(k);
+
   if (abs_k > 256) {
     qd_real::error("(qd_real::sincos): Cannot reduce modulo pi/1024.");
     cos_a = sin_a = qd_real::_nan;
@@ -1867,23 +2615,298 @@ qd_real atan(const qd_real &a) {
   return atan2(a, qd_real(1.0));
 }
 
+/* atan_table1[k] = atan(k/64) */
+static const double atan_table1[65][4] = {
+  { 0.00000000000000000e+00,  0.00000000000000000e+00,
+    0.00000000000000000e+00,  0.00000000000000000e+00},
+  { 1.56237286204768313e-02, -4.91360013656630395e-19,
+   -2.59516032808422527e-35,  5.81886619080972410e-52},
+  { 3.12398334302682774e-02, -1.18844271158774798e-18,
+    7.45281327870637750e-35, -5.27390389695396248e-51},
+  { 4.68407129159696539e-02, -1.65567744225495210e-19,
+   -6.82831505313156339e-36,  8.29543117270357981e-53},
+  { 6.24188099959573500e-02, -1.54907563082950458e-18,
+   -2.34479542988483444e-35, -1.03054220066941319e-51},
+  { 7.79666338315423008e-02,  5.80455187314335664e-18,
+    1.63813333172025021e-34,  1.05602693178159950e-50},
+  { 9.34767811585894698e-02, -6.28447259954209545e-18,
+   -1.87471331628899162e-34,  8.95341932155086554e-52},
+  { 1.08941956989865793e-01,  6.82671220724095851e-18,
+    1.40864838686817856e-34,  5.89114646424114393e-51},
+  { 1.24354994546761438e-01, -3.12532414245393831e-18,
+   -1.79148445366540565e-34,  9.89085839018838186e-51},
+  { 1.39708874289163648e-01, -2.95798642473158131e-18,
+    3.30268988673599132e-35, -1.66919774503742168e-52},
+  { 1.54996741923940973e-01,  9.58541559411432383e-18,
+    4.78701458285604430e-35,  1.91363587548993256e-51},
+  { 1.70211925285474408e-01, -3.54116407980212514e-18,
+   -1.00513453359416609e-34, -3.32345178535843562e-51},
+  { 1.85347949995694761e-01,  4.18069226884307898e-18,
+   -1.70676213142867057e-34,  2.36521046823615399e-51},
+  { 2.00398553825878512e-01,  3.13995428718444929e-18,
+   -5.20548045089133773e-35, -2.83338804515479760e-51},
+  { 2.15357699697738048e-01,  4.73816013007873289e-19,
+   -3.93066763880894657e-35,  1.53232841199372074e-51},
+  { 2.30219587276843718e-01,  1.23134045291427032e-17,
+   -1.21705033827667857e-34,  2.12969648079438906e-51},
+  { 2.44978663126864143e-01,  1.06987556187344514e-17,
+    1.00791048366543036e-34,  5.81408114888796683e-51},
+  { 2.59629629408257512e-01,  1.92387549246153041e-17,
+    1.13886988512806221e-33,  7.34854848461782679e-50},
+  { 2.74167451119658789e-01,  8.26135357516377348e-18,
+   -7.54742220168786388e-34,  2.19763713838901996e-51},
+  { 2.88587361894077410e-01, -1.42836995737725708e-17,
+    1.22054910265734609e-34,  1.11815524680047563e-51},
+  { 3.02884868374971417e-01, -1.10108279030013690e-17,
+   -4.86313718271363709e-34,  1.49473110258581668e-50},
+  { 3.17055753209147029e-01, -1.89392892429264215e-17,
+   -6.88411652888438366e-34, -1.55483721927739520e-50},
+  { 3.31096076704132103e-01, -7.95261037579379870e-18,
+   -5.86523001516060791e-34,  4.13696111301150040e-50},
+  { 3.45002177207105132e-01, -2.29388047555783039e-17,
+    9.68893435794470879e-34,  3.16421279224742056e-50},
+  { 3.58770670270572245e-01, -2.46238155826386349e-17,
+   -1.66821397077478928e-34, -2.23251469415110674e-51},
+  { 3.72398446676754202e-01,  1.96123115048456534e-17,
+    1.02371080979295405e-34, -2.18224027329756452e-51},
+  { 3.85882669398073752e-01,  2.37882273249194087e-17,
+    9.78337159304069859e-34,  1.76790474223553502e-50},
+  { 3.99220769575252543e-01,  2.24659810561704206e-17,
+   -6.04951163869100507e-34,  1.08663872138401204e-50},
+  { 4.12410441597387323e-01, -1.58765222777068909e-17,
+   -1.50007141469592235e-34,  1.84615616625727769e-51},
+  { 4.25449637370042266e-01,  2.33155307418928847e-17,
+    5.97476350024003228e-34, -3.80990098390424525e-52},
+  { 4.38336559857957830e-01, -2.49427703062654091e-17,
+    1.22477652720650194e-33, -4.37732077305534298e-50},
+  { 4.51069655988523499e-01, -2.27037952294204745e-17,
+    1.32512360470808301e-33,  8.14489258855413966e-50},
+  { 4.63647609000806094e-01,  2.26987774529616871e-17,
+   -5.24735638283916490e-34, -3.45952270189924636e-50},
+  { 4.76069330322761219e-01,  1.46544873322567134e-17,
+    1.34362851705458723e-33,  4.88383979358493140e-52},
+  { 4.88333951056405535e-01, -1.13732361893295846e-17,
+   -6.81313494883312010e-34,  1.54275635119427422e-50},
+  { 5.00440813147294161e-01, -4.71816750855187565e-17,
+   -2.40320883120116593e-33, -4.30682412656222794e-50},
+  { 5.12389460310737732e-01, -2.54627814728558035e-17,
+    9.79330621059321564e-34, -2.32418402337633950e-50},
+  { 5.24179628782913243e-01,  5.52009411964166575e-18,
+    1.22996596252602529e-34, -9.80155522593060209e-51},
+  { 5.35811237960463704e-01, -4.06379568348255750e-18,
+   -1.36182309177596328e-34,  4.99016528322362035e-51},
+  { 5.47284380987436925e-01,  4.92370967139625499e-17,
+    6.70530548174356674e-35, -2.48687401714468688e-51},
+  { 5.58599315343562441e-01, -5.45563054859162639e-18,
+    4.15877221209126157e-35, -2.22156588022372173e-51},
+  { 5.69756453482978431e-01,  1.22550620850541836e-17,
+   -3.83587757536200209e-34, -1.01355834712116255e-50},
+  { 5.80756353567670414e-01, -1.44146437819306691e-17,
+   -1.11721054517778503e-33, -1.44875277891096271e-50},
+  { 5.91599710335111384e-01,  4.92049545368677175e-17,
+    2.83374833936131945e-33, -1.69884036109308521e-49},
+  { 6.02287346134964152e-01,  2.95043073722840231e-17,
+    3.07226279312621343e-33,  6.22317210926715156e-50},
+  { 6.12820202165241357e-01, -3.15520618485862261e-17,
+    2.49250750160754113e-33,  1.34791633880183714e-49},
+  { 6.23199329934065904e-01,  2.67240388514009508e-17,
+    1.34956042304011067e-33,  2.13995999531490551e-50},
+  { 6.33425882969144594e-01, -2.72907674360152756e-17,
+   -9.74326670184629572e-34,  4.23190420169485756e-50},
+  { 6.43501108793284371e-01,  1.58347850514442862e-17,
+   -4.47913628291336767e-34,  3.92846943582029353e-50},
+  { 6.53426341180761927e-01,  3.58006348573400954e-17,
+   -2.14252320765749770e-33, -1.05634620408173034e-49},
+  { 6.63202992706093286e-01, -3.07605486442964900e-17,
+   -1.30905997001554247e-33, -7.44224388351195936e-50},
+  { 6.72832547593763208e-01, -1.89931500971470508e-17,
+   -1.04801171020203884e-33, -5.27659549331095609e-50},
+  { 6.82316554874748071e-01,  6.94322367156000774e-18,
+    3.90481630575412581e-34,  1.05239355360773655e-50},
+  { 6.91656621853199871e-01, -8.11715119228579578e-18,
+   -2.59017127995822535e-34, -5.40940486026203845e-51},
+  { 7.00854407884450192e-01, -1.98762623433581612e-17,
+    5.72682898634176184e-34,  2.00871299801750481e-50},
+  { 7.09911618463524907e-01, -4.59716645058488703e-17,
+   -1.34225745104417378e-33, -3.33143697944001204e-50},
+  { 7.18829999621624527e-01, -2.14783884444569830e-17,
+    8.21709460548978462e-34,  5.55392522411937536e-50},
+  { 7.27611332626510676e-01,  2.56932569739183885e-18,
+    1.71170013223075293e-34, -9.80739958821387261e-51},
+  { 7.36257428981428097e-01,  3.47393764829945672e-17,
+    3.02323064034476730e-33, -9.71730584553519913e-50},
+  { 7.44770125716075149e-01,  3.70831584913554675e-17,
+    1.57571786568944114e-33, -3.94508395725004471e-50},
+  { 7.53151280962194414e-01, -2.42569346591820681e-17,
+    5.73373331028881165e-34,  3.99684263201625520e-50},
+  { 7.61402769805578417e-01,  9.85003033275282190e-18,
+    7.17694878195220708e-34,  3.82086919654418627e-50},
+  { 7.69526480405658297e-01, -3.70499190560272129e-17,
+   -3.83583486458198955e-34,  6.00462944945578901e-52},
+  { 7.77524310373347793e-01, -2.66764909519445022e-17,
+    5.28290838880653026e-34,  4.17143206718355802e-50},
+  { 7.85398163397448279e-01,  3.06161699786838302e-17,
+   -7.48692452429584916e-34,  2.78113555215841320e-50}
+};
+
+/* atan_table2[k] = atan((k - 32)/4096) */
+static const double atan_table2[65][4] = {
+  {-7.81234106010111114e-03, -1.52476084924874749e-19,
+   -1.03019699441587778e-36, -4.55955979706814840e-53},
+  {-7.56821487459730709e-03,  3.39493952125539228e-19,
+   -1.18273451676948165e-35,  2.87574380211900916e-52},
+  {-7.32408778697816142e-03,  1.85763499216561921e-19,
+   -4.34559727355359928e-36,  2.03307912863275166e-52},
+  {-7.07995982633782134e-03, -2.23118687865995943e-19,
+    2.13828445854753854e-35,  5.82798562253108234e-52},
+  {-6.83583102177105859e-03, -3.28938913705392696e-19,
+   -7.58367230130567447e-36, -5.07753498301975336e-52},
+  {-6.59170140237324773e-03, -2.89380818143564605e-19,
+    1.39313074257462860e-35,  5.40725952627570647e-52},
+  {-6.34757099724034615e-03, -1.25785210318369155e-19,
+    4.28084466795270217e-36,  6.63183791865443748e-55},
+  {-6.10343983546887334e-03,  2.62770151535843054e-19,
+    1.59355362287953675e-35,  2.24670518237078294e-52},
+  {-5.85930794615588911e-03,  2.19033658397414091e-19,
+    1.84467329242971237e-35, -1.61995940617898273e-52},
+  {-5.61517535839897459e-03,  5.01955993505814458e-20,
+   -2.18788755512640129e-36,  7.94465069824296305e-53},
+  {-5.37104210129621049e-03,  1.49348950424495029e-19,
+    7.52026825967442704e-36,  5.39885325197571014e-52},
+  {-5.12690820394615544e-03,  1.17843231531078430e-19,
+   -1.10118179636307721e-35, -1.71400390898103637e-52},
+  {-4.88277369544782604e-03, -3.76782281313993522e-19,
+    6.41779008922922155e-36, -6.19714827839987073e-52},
+  {-4.63863860490067777e-03,  1.25315081875569793e-19,
+    2.79773730494426205e-36,  3.34543825034303828e-53},
+  {-4.39450296140457899e-03, -3.35717387707248761e-19,
+    1.73032004084523859e-35, -3.31221015826435488e-53},
+  {-4.15036679405979703e-03, -2.07617922301773216e-19,
+   -3.24681441555370959e-36,  3.05051147433118331e-52},
+  {-3.90623013196697176e-03, -7.02385262363964414e-20,
+    3.81777551718711079e-37, -3.95328204225917473e-53},
+  {-3.66209300422709735e-03, -3.91668187145044581e-20,
+    1.27522965903133029e-36,  7.32703165518982376e-53},
+  {-3.41795543994150106e-03, -2.04481268647664399e-19,
+    3.63972520332371639e-36,  2.79686191738561058e-52},
+  {-3.17381746821182283e-03, -2.01549206768739688e-19,
+   -6.31558278590488818e-36, -4.14319235190690484e-52},
+  {-2.92967911813999358e-03, -8.23091681638925965e-20,
+    5.13234263702165419e-36, -1.34656430286589980e-52},
+  {-2.68554041882821488e-03,  1.15010438710480094e-19,
+   -6.35070985119504743e-36, -3.33483226747566887e-52},
+  {-2.44140139937893763e-03, -7.07052202155181108e-20,
+    2.01947541391906828e-36,  1.60922116160417003e-52},
+  {-2.19726208889484305e-03,  2.08797029479202007e-19,
+    9.61259904674823995e-36, -2.56546386885265863e-52},
+  {-1.95312251647881876e-03,  7.33126723756371621e-20,
+   -3.84654061955258634e-36,  2.97225719001549239e-52},
+  {-1.70898271123394105e-03, -5.17418189395423146e-20,
+   -1.73454729677427643e-36, -1.15225524477542894e-52},
+  {-1.46484270226345252e-03,  4.54355623056954604e-20,
+   -1.66347184070030258e-37, -1.01448763111925826e-55},
+  {-1.22070251867074085e-03, -7.17031500961301642e-20,
+   -3.60245860881892395e-36, -2.18060296956074963e-52},
+  {-9.76562189559319459e-04,  2.90330625499426262e-20,
+    2.32050842610207080e-36, -1.05182497552361231e-52},
+  {-7.32421744032805120e-04,  2.17001956215392108e-20,
+    1.32428511761022790e-36, -7.84581736539451711e-53},
+  {-4.88281211194898290e-04,  1.44569743155695780e-20,
+    1.28566852729243329e-36, -2.18023641043766311e-53},
+  {-2.44140620149361771e-04,  7.22802186877753722e-21,
+    1.24208608458494827e-37,  2.78989538724855431e-55},
+  { 0.00000000000000000e+00,  0.00000000000000000e+00,
+    0.00000000000000000e+00,  0.00000000000000000e+00},
+  { 2.44140620149361771e-04, -7.22802186877753722e-21,
+   -1.24208608458494827e-37, -2.78989538724855431e-55},
+  { 4.88281211194898290e-04, -1.44569743155695780e-20,
+   -1.28566852729243329e-36,  2.18023641043766311e-53},
+  { 7.32421744032805120e-04, -2.17001956215392108e-20,
+   -1.32428511761022790e-36,  7.84581736539451711e-53},
+  { 9.76562189559319459e-04, -2.90330625499426262e-20,
+   -2.32050842610207080e-36,  1.05182497552361231e-52},
+  { 1.22070251867074085e-03,  7.17031500961301642e-20,
+    3.60245860881892395e-36,  2.18060296956074963e-52},
+  { 1.46484270226345252e-03, -4.54355623056954604e-20,
+    1.66347184070030258e-37,  1.01448763111925826e-55},
+  { 1.70898271123394105e-03,  5.17418189395423146e-20,
+    1.73454729677427643e-36,  1.15225524477542894e-52},
+  { 1.95312251647881876e-03, -7.33126723756371621e-20,
+    3.84654061955258634e-36, -2.97225719001549239e-52},
+  { 2.19726208889484305e-03, -2.08797029479202007e-19,
+   -9.61259904674823995e-36,  2.56546386885265863e-52},
+  { 2.44140139937893763e-03,  7.07052202155181108e-20,
+   -2.01947541391906828e-36, -1.60922116160417003e-52},
+  { 2.68554041882821488e-03, -1.15010438710480094e-19,
+    6.35070985119504743e-36,  3.33483226747566887e-52},
+  { 2.92967911813999358e-03,  8.23091681638925965e-20,
+   -5.13234263702165419e-36,  1.34656430286589980e-52},
+  { 3.17381746821182283e-03,  2.01549206768739688e-19,
+    6.31558278590488818e-36,  4.14319235190690484e-52},
+  { 3.41795543994150106e-03,  2.04481268647664399e-19,
+   -3.63972520332371639e-36, -2.79686191738561058e-52},
+  { 3.66209300422709735e-03,  3.91668187145044581e-20,
+   -1.27522965903133029e-36, -7.32703165518982376e-53},
+  { 3.90623013196697176e-03,  7.02385262363964414e-20,
+   -3.81777551718711079e-37,  3.95328204225917473e-53},
+  { 4.15036679405979703e-03,  2.07617922301773216e-19,
+    3.24681441555370959e-36, -3.05051147433118331e-52},
+  { 4.39450296140457899e-03,  3.35717387707248761e-19,
+   -1.73032004084523859e-35,  3.31221015826435488e-53},
+  { 4.63863860490067777e-03, -1.25315081875569793e-19,
+   -2.79773730494426205e-36, -3.34543825034303828e-53},
+  { 4.88277369544782604e-03,  3.76782281313993522e-19,
+   -6.41779008922922155e-36,  6.19714827839987073e-52},
+  { 5.12690820394615544e-03, -1.17843231531078430e-19,
+    1.10118179636307721e-35,  1.71400390898103637e-52},
+  { 5.37104210129621049e-03, -1.49348950424495029e-19,
+   -7.52026825967442704e-36, -5.39885325197571014e-52},
+  { 5.61517535839897459e-03, -5.01955993505814458e-20,
+    2.18788755512640129e-36, -7.94465069824296305e-53},
+  { 5.85930794615588911e-03, -2.19033658397414091e-19,
+   -1.84467329242971237e-35,  1.61995940617898273e-52},
+  { 6.10343983546887334e-03, -2.62770151535843054e-19,
+   -1.59355362287953675e-35, -2.24670518237078294e-52},
+  { 6.34757099724034615e-03,  1.25785210318369155e-19,
+   -4.28084466795270217e-36, -6.63183791865443748e-55},
+  { 6.59170140237324773e-03,  2.89380818143564605e-19,
+   -1.39313074257462860e-35, -5.40725952627570647e-52},
+  { 6.83583102177105859e-03,  3.28938913705392696e-19,
+    7.58367230130567447e-36,  5.07753498301975336e-52},
+  { 7.07995982633782134e-03,  2.23118687865995943e-19,
+   -2.13828445854753854e-35, -5.82798562253108234e-52},
+  { 7.32408778697816142e-03, -1.85763499216561921e-19,
+    4.34559727355359928e-36, -2.03307912863275166e-52},
+  { 7.56821487459730709e-03, -3.39493952125539228e-19,
+    1.18273451676948165e-35, -2.87574380211900916e-52},
+  { 7.81234106010111114e-03,  1.52476084924874749e-19,
+    1.03019699441587778e-36,  4.55955979706814840e-53}
+};
+
 qd_real atan2(const qd_real &y, const qd_real &x) {
-  /* Strategy: Instead of using Taylor series to compute 
-     arctan, we instead use Newton's iteration to solve
-     the equation
+  /* Strategy:  By symmetry, we can assume that 0 <= y <= x, and adjust
+     the result afterwards.  We write
 
-        sin(z) = y/r    or    cos(z) = x/r
+          atan(y/x) = atan(c1) + atan(c2) + atan(v),
 
-     where r = sqrt(x^2 + y^2).
-     The iteration is given by
+     where c1 = k1/64 is the nearest multiple of 1/64 to y/x, and
+     c2 = k2/4096 is the nearest multiple of 1/4096 to the quotient
+     (y - c1 x)/(x + c1 y), using the identity
 
-        z' = z + (y - sin(z)) / cos(z)          (for equation 1)
-        z' = z - (x - cos(z)) / sin(z)          (for equation 2)
+          atan(y/x) - atan(c) = atan((y - c x)/(x + c y)).
 
-     Here, x and y are normalized so that x^2 + y^2 = 1.
-     If |x| > |y|, then first iteration is used since the 
-     denominator is larger.  Otherwise, the second is used.
-  */
+     The arctangents of c1 and c2 are looked up in atan_table1 and
+     atan_table2.  Both reductions are applied to the numerator and the
+     denominator separately, so that only one division is needed.  Since
+     |v| <= 1/8192, the series
+
+          atan(v) = v - v^3/3 + v^5/5 - ...
+
+     converges quickly: the terms up to v^17 are enough.  The last two
+     need only double precision.                                         */
+
+  if (x.isnan() || y.isnan())
+    return qd_real::_nan;
 
   if (x.is_zero()) {
     
@@ -1906,33 +2929,60 @@ qd_real atan2(const qd_real &y, const qd_real &x) {
     return (y.is_positive()) ? qd_real::_3pi4 : -qd_real::_pi4;
   }
 
-  qd_real r = sqrt(sqr(x) + sqr(y));
-  qd_real xx = x / r;
-  qd_real yy = y / r;
-
-  /* Compute double precision approximation to atan. */
-  qd_real z = qd_atan2(to_double(y), to_double(x));
-  qd_real sin_z, cos_z;
-
-  if (qd_fabs(xx.x[0]) > qd_fabs(yy.x[0])) {
-    /* Use Newton iteration 1.  z' = z + (y - sin(z)) / cos(z)  */
-    sincos(z, sin_z, cos_z);
-    z += (yy - sin_z) / cos_z;
-    sincos(z, sin_z, cos_z);
-    z += (yy - sin_z) / cos_z;
-    sincos(z, sin_z, cos_z);
-    z += (yy - sin_z) / cos_z;
-  } else {
-    /* Use Newton iteration 2.  z' = z - (x - cos(z)) / sin(z)  */
-    sincos(z, sin_z, cos_z);
-    z -= (xx - cos_z) / sin_z;
-    sincos(z, sin_z, cos_z);
-    z -= (xx - cos_z) / sin_z;
-    sincos(z, sin_z, cos_z);
-    z -= (xx - cos_z) / sin_z;
+  if (y.isinf()) {
+    return (y.is_positive()) ? qd_real::_pi2 : -qd_real::_pi2;
+  } else if (x.isinf()) {
+    if (x.is_positive())
+      return 0.0;
+    return (y.is_positive()) ? qd_real::_pi : -qd_real::_pi;
+  }
+
+  qd_real ax = abs(x), ay = abs(y);
+  bool swap = (ay > ax);
+  if (swap) {
+    qd_real t = ax;
+    ax = ay;
+    ay = t;
   }
 
-  return z;
+  /* Scale the arguments to avoid overflow and underflow */
+  if (ax[0] > 1e290) {
+    ax = mul_pwr2(ax, 2.40991986510288411e-181);   /* 2^-600 */
+    ay = mul_pwr2(ay, 2.40991986510288411e-181);
+  } else if (ax[0] < 1e-200) {
+    ax = mul_pwr2(ax, 4.14951556888099290e+180);   /* 2^600 */
+    ay = mul_pwr2(ay, 4.14951556888099290e+180);
+  }
+
+  double k1 = qd_floor(ay[0] / ax[0] * 64.0 + 0.5);
+  double c1 = k1 * (1.0 / 64.0);
+  qd_real num = ay - ax * c1;
+  qd_real den = ax + ay * c1;
+
+  double k2 = qd_floor(num[0] / den[0] * 4096.0 + 0.5);
+  double c2 = k2 * (1.0 / 4096.0);
+  qd_real v = (num - den * c2) / (den + num * c2);
+
+  qd_real w = sqr(v);
+  double c, w0 = w[0];
+  qd_real p, z;
+  int t1 = static_cast<int>(k1), t2 = static_cast<int>(k2) + 32;
+
+  /* atan(v) = v - v w (1/3 - w (1/5 - ... - w (1/13 - w c))), with
+     w = v^2 and c = 1/15 - w/17 */
+  c = inv_odd[6][0] - w0 * inv_odd[7][0];
+  p = qd_real(inv_odd[5]) - w0 * c;
+  for (int n = 4; n >= 0; n--)
+    p = qd_real(inv_odd[n]) - w * p;
+  p = w * p;
+
+  z = qd_real(atan_table1[t1]) + qd_real(atan_table2[t2]) + (v - v * p);
+
+  if (swap)
+    z = qd_real::_pi2 - z;
+  if (x.is_negative())
+    z = qd_real::_pi - z;
+  return (y.is_negative()) ? -z : z;
 }
 
 
@@ -2075,4 +3125,36 @@ qd_real atanh(const qd_real &a) {
 QD_API qd_real fmod(const qd_real &a, const qd_real &b) {
   qd_real n = aint(a / b);
   return (a - b * n);
-}
\ No newline at end of file
+}
+
+/* Sets s to the first precision digits of a, correctly rounded, followed
+   by a null terminator. s must have room for precision + 1 chars. expn is
+   set to the exponent of the first digit. */
+void qd_real::to_digits(char *s, int &expn, int precision) const {
+  qd::decimal::to_digits(x, 4, s, expn, precision);
+}
+
+/* Writes a to s in the given format (a qd_format value). Returns the
+   length of the string, which does not fit if it is not less than size. */
+int qd_real::to_string(char *s, int size, int format, int precision) const {
+  return qd::decimal::to_string(x, 4, s, size, format, precision);
+}
+
+/* Parses a decimal number at the start of s (see c_dd_parse). Returns the
+   number of chars used, or 0 (and sets a to NaN) if s does not start with
+   a number. */
+int qd_real::parse(const char *s, int len, qd_real &a) {
+  return qd::decimal::parse(s, len, a.x, 4);
+}
+
+/* The result is NaN if s is not a number, or has other chars after it. */
+qd_real::qd_real(const char *s) {
+  int n = parse(s, -1, *this);
+  if (n == 0 || s[n] != 0)
+    *this = _nan;
+}
+
+qd_real &qd_real::operator=(const char *s) {
+  *this = qd_real(s);
+  return *this;
+}
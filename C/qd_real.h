@@ -39,32 +39,33 @@ struct qd_real {
   void quick_accum(double d, double &e);
   void quick_prod_accum(double a, double b, double &e);
 
-  qd_real(double x0, double x1, double x2, double x3);
+  constexpr qd_real(double x0, double x1, double x2, double x3);
   explicit qd_real(const double *xx);
 
-  static qd_real _2pi;
-  static qd_real _pi;
-  static qd_real _3pi4;
-  static qd_real _pi2;
-  static qd_real _pi4;
-  static qd_real _e;
-  static qd_real _log2;
-  static qd_real _log10;
-  static qd_real _nan;
-  static qd_real _inf;
+  static const qd_real _2pi;
+  static const qd_real _pi;
+  static const qd_real _3pi4;
+  static const qd_real _pi2;
+  static const qd_real _pi4;
+  static const qd_real _e;
+  static const qd_real _log2;
+  static const qd_real _log10;
+  static const qd_real _nan;
+  static const qd_real _inf;
 
   static const double _eps;
   static const double _min_normalized;
-  static qd_real _max;
-  static qd_real _safe_max;
+  static const qd_real _max;
+  static const qd_real _safe_max;
   static const int _ndigits;
 
-  static qd_real _pi1024;
+  static const qd_real _pi1024;
 
   qd_real();
   qd_real(const dd_real &dd);
   qd_real(double d);
   qd_real(int i);
+  qd_real(const char *s);
 
   double operator[](int i) const;
   double &operator[](int i);
@@ -88,6 +89,10 @@ struct qd_real {
 
   static qd_real sloppy_mul(const qd_real &a, const qd_real &b);
   static qd_real accurate_mul(const qd_real &a, const qd_real &b);
+#ifdef QD_FMA_DISPATCH
+  QD_FMA_TARGET static qd_real sloppy_mul_fma(const qd_real &a, const qd_real &b);
+  QD_FMA_TARGET static qd_real accurate_mul_fma(const qd_real &a, const qd_real &b);
+#endif
 
   qd_real &operator*=(double a);
   qd_real &operator*=(const dd_real &a);
@@ -116,6 +121,8 @@ struct qd_real {
   bool is_negative() const;
 
   void to_digits(char *s, int &expn, int precision = _ndigits) const;
+  int to_string(char *s, int size, int format = qd_shortest, int precision = _ndigits) const;
+  static int parse(const char *s, int len, qd_real &a);
 };
 
 QD_API qd_real polyeval(const qd_real *c, int n, const qd_real &x);
@@ -158,6 +165,14 @@ QD_API qd_real operator/(const qd_real &a, double b);
 QD_API qd_real operator/(double a, const qd_real &b);
 
 QD_API qd_real sqr(const qd_real &a);
+
+#ifdef QD_FMA_DISPATCH
+/* Same as operator* and sqr, but using a fused multiply-subtract for the
+   product error terms. Only call these if the CPU supports FMA3. */
+QD_API QD_FMA_TARGET qd_real mul_fma(const qd_real &a, const qd_real &b);
+QD_API QD_FMA_TARGET qd_real sqr_fma(const qd_real &a);
+#endif
+
 QD_API qd_real sqrt(const qd_real &a);
 QD_API qd_real pow(const qd_real &a, int n);
 QD_API qd_real pow(const qd_real &a, const qd_real &b);
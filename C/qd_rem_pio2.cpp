@@ -0,0 +1,157 @@
+/*
+ * qd_rem_pio2.cpp
+ *
+ * Reduction of huge arguments of the trigonometric functions modulo pi/2
+ * (Payne-Hanek), for dd_real.cpp and qd_real.cpp. This file is included by
+ * both c_dd.cpp and c_qd.cpp, so everything in it is static.
+ *
+ * A double x = m * 2^e (with an integer m < 2^53) is multiplied by 2/pi
+ * in fixed point, with pio2::frac_words 32-bit words after the binary
+ * point. Only the integer part modulo 4 is needed, so the words of 2/pi
+ * that only add multiples of 4 are skipped, and a table of 1408 bits of
+ * 2/pi is enough for any double. Like in qd_repro.cpp, the words are
+ * accumulated in 64-bit integers, and carried into the next word at the
+ * end.
+ */
+#ifndef _QD_REM_PIO2_CPP
+#define _QD_REM_PIO2_CPP
+
+#include <stdint.h>
+#include "qd_config.h"
+
+namespace qd {
+namespace pio2 {
+
+enum {
+  frac_words = 10,       /* words of the result after the binary point */
+  table_words = 44       /* words of two_over_pi */
+};
+
+/* 2/pi = sum of two_over_pi[i] * 2^(-32 (i + 1)) */
+static const uint32_t two_over_pi[table_words] = {
+  0xA2F9836E, 0x4E441529, 0xFC2757D1, 0xF534DDC0, 0xDB629599, 0x3C439041,
+  0xFE5163AB, 0xDEBBC561, 0xB7246E3A, 0x424DD2E0, 0x06492EEA, 0x09D1921C,
+  0xFE1DEB1C, 0xB129A73E, 0xE88235F5, 0x2EBB4484, 0xE99C7026, 0xB45F7E41,
+  0x3991D639, 0x835339F4, 0x9C845F8B, 0xBDF9283B, 0x1FF897FF, 0xDE05980F,
+  0xEF2F118B, 0x5A0A6D1F, 0x6D367ECF, 0x27CB09B7, 0x4F463F66, 0x9E5FEA2D,
+  0x7527BAC7, 0xEBE5F17B, 0x3D0739F7, 0x8A5292EA, 0x6BFB5FB1, 0x1F8D5D08,
+  0x56033046, 0xFC7B6BAB, 0xF0CFBC20, 0x9AF4361D, 0xA9E39161, 0x5EE61B08,
+  0x6599855F, 0x14A06840
+};
+
+/* Adds the finite, non-negative x times 2/pi to acc. acc[0] holds the
+   integer part (modulo 2^64), and acc[i] the i-th word after the binary
+   point. */
+static void accumulate(double x, uint64_t *acc) {
+  union {
+    double d;
+    uint64_t u;
+  } bits;
+  bits.d = x;
+  int biased = static_cast<int>((bits.u >> 52) & 0x7FF);
+  uint64_t m = bits.u & ((static_cast<uint64_t>(1) << 52) - 1);
+  int e = -1074;
+  if (biased != 0) {
+    m |= static_cast<uint64_t>(1) << 52;
+    e = biased - 1075;
+  }
+  if (m == 0)
+    return;
+
+  /* x = (m * 2^s) * 2^(32 q), with 0 <= s < 32. m * 2^s < 2^85 is split
+     into three words mw. */
+  int q = (e >= 0) ? e / 32 : -((31 - e) / 32);
+  int s = e - 32 * q;
+  uint64_t lo = m << s;
+  uint32_t mw[3];
+  mw[0] = static_cast<uint32_t>(lo);
+  mw[1] = static_cast<uint32_t>(lo >> 32);
+  mw[2] = (s == 0) ? 0 : static_cast<uint32_t>(m >> (64 - s));
+
+  /* mw[u] * two_over_pi[w] has weight 2^(-32 t), with t = w + 1 - q - u.
+     Its high word goes to acc[t - 1]. Words with t < 0 are multiples of
+     2^32, and therefore of 4. */
+  for (int u = 0; u < 3; u++) {
+    if (mw[u] == 0)
+      continue;
+    int w0 = q + u - 1, w1 = frac_words + q + u;
+    if (w0 < 0)
+      w0 = 0;
+    if (w1 > table_words - 1)
+      w1 = table_words - 1;
+    for (int w = w0; w <= w1; w++) {
+      int t = w + 1 - q - u;
+      uint64_t p = static_cast<uint64_t>(mw[u]) * two_over_pi[w];
+      if (t <= frac_words)
+        acc[t] += p & 0xFFFFFFFF;
+      if (t >= 1)
+        acc[t - 1] += p >> 32;
+    }
+  }
+}
+
+/* Carries the words of acc into the next ones, so that acc[1..frac_words]
+   are in [0, 2^32) */
+static void normalize(uint64_t *acc) {
+  for (int t = frac_words; t >= 1; t--) {
+    acc[t - 1] += acc[t] >> 32;
+    acc[t] &= 0xFFFFFFFF;
+  }
+}
+
+/* Reduces x[0] + ... + x[n - 1] (finite) modulo pi/2. Returns j in
+   [-1, 2] and sets y[0..frac_words) so that
+
+     x[0] + ... + x[n - 1] = (j + y[0] + ... + y[frac_words - 1]) * pi/2
+
+   modulo 2 pi, with |y[0] + ... + y[frac_words - 1]| <= 1/2. The y[i] are
+   exact: they are 32-bit integers times 2^(-32 (i + 1)). */
+static int rem_pio2(const double *x, int n, double *y) {
+  uint64_t pos[frac_words + 1], neg[frac_words + 1];
+  uint32_t r[frac_words + 1];
+
+  for (int t = 0; t <= frac_words; t++)
+    pos[t] = neg[t] = 0;
+  for (int i = 0; i < n; i++) {
+    if (x[i] < 0.0)
+      accumulate(-x[i], neg);
+    else
+      accumulate(x[i], pos);
+  }
+  normalize(pos);
+  normalize(neg);
+
+  /* r = pos - neg, modulo 2^32 */
+  uint64_t borrow = 0;
+  for (int t = frac_words; t >= 0; t--) {
+    uint64_t d = pos[t] - neg[t] - borrow;
+    r[t] = static_cast<uint32_t>(d);
+    borrow = (t > 0) ? (d >> 63) : 0;
+  }
+
+  /* Round to the nearest integer. If the fraction f is at least 1/2, y is
+     f - 1 = -(1 - f), and 1 - f is the two's complement of f. */
+  int j = static_cast<int>(r[0] & 3);
+  double scale = 1.0;
+  if (r[1] & 0x80000000) {
+    uint64_t carry = 1;
+    for (int t = frac_words; t >= 1; t--) {
+      uint64_t v = static_cast<uint64_t>(~r[t]) + carry;
+      r[t] = static_cast<uint32_t>(v);
+      carry = v >> 32;
+    }
+    j = (j + 1) & 3;
+    scale = -1.0;
+  }
+
+  for (int t = 1; t <= frac_words; t++) {
+    scale *= 2.3283064365386962891e-10;   /* 2^-32 */
+    y[t - 1] = r[t] * scale;
+  }
+  return (j == 3) ? -1 : j;
+}
+
+}
+}
+
+#endif /* _QD_REM_PIO2_CPP */
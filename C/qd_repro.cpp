@@ -0,0 +1,233 @@
+/*
+ * qd_repro.cpp
+ *
+ * Reproducible sums (see c_repro.h). The limbs of a qd_repro hold signed
+ * 32-bit digits in 64-bit integers, so up to 2^31 doubles can be added
+ * before the digits have to be normalized (carried into the next limb).
+ * The functions below normalize after every block of repro_block
+ * elements, and at the end, so a qd_repro is always normalized between
+ * calls: every limb except the last one is in [0, 2^32), and the sign of
+ * the sum is the sign of the last limb.
+ */
+#include <stdint.h>
+#include "qd_config.h"
+#include "inline.h"
+#include "c_repro.h"
+
+/* Elements added between normalizations. Each element adds at most two
+   doubles (a product and its error), and each double adds less than 2^32
+   to a limb. */
+static const int repro_block = 1 << 28;
+
+/* Bits of the significand of a double. A double spans at most 3 limbs. */
+static const int repro_mantissa_bits = 53;
+
+static void repro_clear(qd_repro *r) {
+  for (int i = 0; i < QD_REPRO_LIMBS; i++)
+    r->limb[i] = 0;
+  r->special = 0;
+  r->reserved = 0;
+}
+
+/* Adds the finite double x. */
+static inline void repro_add(qd_repro *r, double x) {
+  union {
+    double d;
+    uint64_t u;
+  } bits;
+  bits.d = x;
+  int biased = static_cast<int>((bits.u >> 52) & 0x7FF);
+  uint64_t m = bits.u & ((static_cast<uint64_t>(1) << 52) - 1);
+
+  /* x = m * 2^pos units of 2^-1074 */
+  int pos = 0;
+  if (biased != 0) {
+    m |= static_cast<uint64_t>(1) << 52;
+    pos = biased - 1;
+  }
+
+  int i = pos >> 5, s = pos & 31;
+  uint64_t lo = m << s;
+  uint64_t hi = (m >> 1) >> (63 - s);
+
+  /* Negate the digits if x is negative */
+  int64_t neg = -static_cast<int64_t>(bits.u >> 63);
+  r->limb[i] += (static_cast<int64_t>(lo & 0xFFFFFFFF) ^ neg) - neg;
+  r->limb[i + 1] += (static_cast<int64_t>(lo >> 32) ^ neg) - neg;
+  r->limb[i + 2] += (static_cast<int64_t>(hi) ^ neg) - neg;
+}
+
+/* Adds the double x, which may be infinite or NaN. */
+static inline void repro_add_special(qd_repro *r, double x) {
+  if (x != x)
+    r->special |= qd_repro_nan;
+  else if (x == qd::_d_inf)
+    r->special |= qd_repro_pos_inf;
+  else if (x == -qd::_d_inf)
+    r->special |= qd_repro_neg_inf;
+  else
+    repro_add(r, x);
+}
+
+/* Carries the excess of every limb into the next one */
+static void repro_normalize(qd_repro *r) {
+  for (int i = 0; i < QD_REPRO_LIMBS - 1; i++) {
+    int64_t carry = r->limb[i] >> 32;
+    r->limb[i] &= 0xFFFFFFFF;
+    r->limb[i + 1] += carry;
+  }
+}
+
+static void repro_sum(qd_repro *r, const double *a, int n) {
+  for (int k = 0; k < n; k += repro_block) {
+    int end = n - k > repro_block ? k + repro_block : n;
+    for (int i = k; i < end; i++)
+      repro_add_special(r, a[i]);
+    repro_normalize(r);
+  }
+}
+
+/* a * b = p + e exactly, unless the product underflows */
+static void repro_dot(qd_repro *r, const double *a, const double *b, int n) {
+  for (int k = 0; k < n; k += repro_block) {
+    int end = n - k > repro_block ? k + repro_block : n;
+    for (int i = k; i < end; i++) {
+      double e, p = qd::two_prod(a[i], b[i], e);
+      if (p - p == 0.0) {
+        repro_add(r, p);
+        repro_add(r, e);
+      } else
+        repro_add_special(r, p);
+    }
+    repro_normalize(r);
+  }
+}
+
+static void repro_sqr(qd_repro *r, const double *a, int n) {
+  for (int k = 0; k < n; k += repro_block) {
+    int end = n - k > repro_block ? k + repro_block : n;
+    for (int i = k; i < end; i++) {
+      double e, p = qd::two_sqr(a[i], e);
+      if (p - p == 0.0) {
+        repro_add(r, p);
+        repro_add(r, e);
+      } else
+        repro_add_special(r, p);
+    }
+    repro_normalize(r);
+  }
+}
+
+static void repro_merge(qd_repro *r, const qd_repro *b) {
+  for (int i = 0; i < QD_REPRO_LIMBS; i++)
+    r->limb[i] += b->limb[i];
+  r->special |= b->special;
+  repro_normalize(r);
+}
+
+/* Limb i of the normalized, non-negative sum of r, or 0 past the end */
+static uint64_t repro_limb(const qd_repro *r, int i) {
+  return i < QD_REPRO_LIMBS ? static_cast<uint64_t>(r->limb[i]) : 0;
+}
+
+/* Bits [pos, pos + 64) of the normalized, non-negative sum of r */
+static uint64_t repro_bits(const qd_repro *r, int pos) {
+  int i = pos >> 5, s = pos & 31;
+  uint64_t lo = repro_limb(r, i) | (repro_limb(r, i + 1) << 32);
+  uint64_t hi = repro_limb(r, i + 2) | (repro_limb(r, i + 3) << 32);
+  return s != 0 ? (lo >> s) | (hi << (64 - s)) : lo;
+}
+
+/* Whether any of the bits below pos of the normalized, non-negative sum of
+   r are set */
+static bool repro_sticky(const qd_repro *r, int pos) {
+  int i = pos >> 5, s = pos & 31;
+  for (int k = 0; k < i; k++)
+    if (r->limb[k] != 0)
+      return true;
+  return (r->limb[i] & ((static_cast<int64_t>(1) << s) - 1)) != 0;
+}
+
+/* The nearest double (ties to even) to the normalized, non-negative sum of
+   r */
+static double repro_round(const qd_repro *r) {
+  int top = QD_REPRO_LIMBS - 1;
+  while (top >= 0 && r->limb[top] == 0)
+    top--;
+  if (top < 0)
+    return 0.0;
+
+  /* Index of the highest bit that is set */
+  int high = 32 * top + 63 - __builtin_clzll(static_cast<uint64_t>(r->limb[top]));
+
+  /* The value is m * 2^shift units */
+  int shift = high >= repro_mantissa_bits ? high - (repro_mantissa_bits - 1) : 0;
+  uint64_t m;
+  if (shift == 0) {
+    m = repro_bits(r, 0) & ((static_cast<uint64_t>(1) << repro_mantissa_bits) - 1);
+  } else {
+    uint64_t x = repro_bits(r, shift - 1);
+    bool half = (x & 1) != 0;
+    m = (x >> 1) & ((static_cast<uint64_t>(1) << repro_mantissa_bits) - 1);
+    if (half && ((m & 1) != 0 || repro_sticky(r, shift - 1)))
+      m++;
+    if (m == static_cast<uint64_t>(1) << repro_mantissa_bits) {
+      m >>= 1;
+      shift++;
+    }
+  }
+
+  /* Subnormal numbers have a biased exponent of 0 */
+  int biased = (m >> 52) != 0 ? shift + 1 : 0;
+  if (biased >= 0x7FF)
+    return qd::_d_inf;
+
+  union {
+    double d;
+    uint64_t u;
+  } bits;
+  bits.u = (static_cast<uint64_t>(biased) << 52) |
+      (m & ((static_cast<uint64_t>(1) << 52) - 1));
+  return bits.d;
+}
+
+/* Rounds the sum of r to n components. Each component is the nearest double
+   to the rest of the sum, which is computed exactly in a copy of r. */
+template <int n>
+static void repro_result(const qd_repro *r, double *x) {
+  if (r->special != 0) {
+    double s = (r->special & qd_repro_nan) != 0 ||
+        r->special == (qd_repro_pos_inf | qd_repro_neg_inf)
+        ? qd::_d_nan : (r->special == qd_repro_pos_inf ? qd::_d_inf : -qd::_d_inf);
+    for (int k = 0; k < n; k++)
+      x[k] = k == 0 ? s : 0.0;
+    return;
+  }
+
+  qd_repro rest, mag;
+  for (int i = 0; i < QD_REPRO_LIMBS; i++)
+    rest.limb[i] = r->limb[i];
+
+  /* The components after an infinity are zero */
+  bool overflow = false;
+  for (int k = 0; k < n; k++) {
+    if (overflow) {
+      x[k] = 0.0;
+      continue;
+    }
+
+    bool neg = rest.limb[QD_REPRO_LIMBS - 1] < 0;
+    for (int i = 0; i < QD_REPRO_LIMBS; i++)
+      mag.limb[i] = neg ? -rest.limb[i] : rest.limb[i];
+    if (neg)
+      repro_normalize(&mag);
+
+    double y = repro_round(&mag);
+    x[k] = neg ? -y : y;
+    overflow = y == qd::_d_inf;
+    if (!overflow) {
+      repro_add(&rest, -x[k]);
+      repro_normalize(&rest);
+    }
+  }
+}
@@ -0,0 +1,365 @@
+/*
+ * qd_solve.cpp
+ *
+ * Quad-double linear solver with mixed-precision iterative refinement
+ * (see c_solve.h).
+ *
+ * This follows dd_solve.cpp, with 4 components instead of 2: the work
+ * buffer holds the double-precision factors, the residual r (4 planes of
+ * n x nrhs doubles) and the correction d, and the factors buffer holds 4
+ * planes of n x n doubles. Each refinement step adds about as many bits to
+ * x as the double-precision factorization gets right, so the refinement
+ * takes about twice as many steps as the double-double one.
+ */
+#include "qd_config.h"
+#include "qd_real.h"
+#include "c_solve.h"
+#include "qd_lu.cpp"
+
+static inline qd_real qd_gesv_get(double *const *x, int index) {
+  return qd_real(x[0][index], x[1][index], x[2][index], x[3][index]);
+}
+
+static inline void qd_gesv_set(double *const *x, int index, const qd_real &a) {
+  for (int q = 0; q < 4; q++)
+    x[q][index] = a.x[q];
+}
+
+/* Sets alpha to -1 and beta to 1, for c = -a * b + c */
+static void qd_gesv_subtract(double *alpha, double *beta) {
+  for (int q = 0; q < 4; q++) {
+    alpha[q] = q == 0 ? -1.0 : 0.0;
+    beta[q] = q == 0 ? 1.0 : 0.0;
+  }
+}
+
+/* Sets f to the planes of the quad-double factors */
+static void qd_gesv_factors(const qd_gesv *g, double **f) {
+  int n = g->a.rows;
+  for (int q = 0; q < 4; q++)
+    f[q] = g->factors ? g->factors + q * n * n : 0;
+}
+
+/* Finishes the solver with the given status */
+static int qd_gesv_finish(qd_gesv *g, int status) {
+  g->status = status;
+  g->stage = qd::lu::stage_done;
+  return 0;
+}
+
+/* Solves the first approximation of x from the leading parts of b */
+static void qd_gesv_start(qd_gesv *g) {
+  int n = g->a.rows, nrhs = g->b.cols;
+  double *d = g->work + n * n + 4 * n * nrhs;
+  for (int j = 0; j < nrhs; j++) {
+    for (int i = 0; i < n; i++)
+      d[j * n + i] = g->b.x[0][i * g->b.row_stride + j * g->b.col_stride];
+    qd::lu::solve(g->work, n, g->pivots, d + j * n);
+    for (int i = 0; i < n; i++)
+      qd_gesv_set(g->x.x, i * g->x.row_stride + j * g->x.col_stride,
+          qd_real(d[j * n + i]));
+  }
+}
+
+/* Sets up the pass that computes the residual r = b - a * x */
+static int qd_gesv_residual(qd_gesv *g) {
+  int n = g->a.rows, nrhs = g->b.cols;
+  double *r0 = g->work + n * n;
+  qd_matrix r = { { r0, r0 + n * nrhs, r0 + 2 * n * nrhs, r0 + 3 * n * nrhs },
+      n, nrhs, 1, n };
+  for (int j = 0; j < nrhs; j++)
+    for (int i = 0; i < n; i++)
+      qd_gesv_set(r.x, j * n + i,
+          qd_gesv_get(g->b.x, i * g->b.row_stride + j * g->b.col_stride));
+
+  if (nrhs == 1) {
+    g->gemv.a = g->a;
+    g->gemv.x = g->x;
+    g->gemv.y = r;
+    qd_gesv_subtract(g->gemv.alpha, g->gemv.beta);
+    g->gemv.next_tile = 0;
+    g->tiles = (n + QD_GEMV_TILE - 1) / QD_GEMV_TILE;
+  } else {
+    g->gemm.a = g->a;
+    g->gemm.b = g->x;
+    g->gemm.c = r;
+    qd_gesv_subtract(g->gemm.alpha, g->gemm.beta);
+    g->gemm.next_tile = 0;
+    g->tiles = ((n + QD_QD_GEMM_TILE - 1) / QD_QD_GEMM_TILE)
+        * ((nrhs + QD_QD_GEMM_TILE - 1) / QD_QD_GEMM_TILE);
+  }
+  g->stage = qd::lu::stage_residual;
+  return 1;
+}
+
+/* Checks the residual, and adds the next correction to x. Returns false if
+   x is accurate enough, or if the refinement stalled. */
+static bool qd_gesv_refine(qd_gesv *g) {
+  int n = g->a.rows, nrhs = g->b.cols;
+  double *r0 = g->work + n * n, *d = r0 + 4 * n * nrhs;
+  double rnorm = 0.0, xnorm = 0.0, dnorm = 0.0;
+  for (int j = 0; j < nrhs; j++)
+    for (int i = 0; i < n; i++) {
+      double r = qd::lu::abs(r0[j * n + i]);
+      double x = qd::lu::abs(g->x.x[0][i * g->x.row_stride + j * g->x.col_stride]);
+      if (!(r <= rnorm))
+        rnorm = r;
+      if (x > xnorm)
+        xnorm = x;
+    }
+  if (rnorm <= g->anorm * xnorm * 4.0 * qd_real::_eps) {
+    qd_gesv_finish(g, qd_gesv_refined);
+    return false;
+  }
+  if (g->iterations >= g->max_iterations) {
+    g->stage = qd::lu::stage_stalled;
+    return false;
+  }
+
+  for (int j = 0; j < nrhs; j++) {
+    for (int i = 0; i < n; i++)
+      d[j * n + i] = r0[j * n + i];
+    qd::lu::solve(g->work, n, g->pivots, d + j * n);
+  }
+  for (int k = 0; k < n * nrhs; k++)
+    if (!(qd::lu::abs(d[k]) <= dnorm))
+      dnorm = qd::lu::abs(d[k]);
+  if (!(dnorm <= (g->dnorm < 0.0 ? qd::lu::max_double : 0.5 * g->dnorm))) {
+    g->stage = qd::lu::stage_stalled;
+    return false;
+  }
+
+  for (int j = 0; j < nrhs; j++)
+    for (int i = 0; i < n; i++) {
+      int index = i * g->x.row_stride + j * g->x.col_stride;
+      qd_gesv_set(g->x.x, index, qd_gesv_get(g->x.x, index) + d[j * n + i]);
+    }
+  g->iterations++;
+  g->dnorm = dnorm;
+  return true;
+}
+
+/* Factors columns j0 .. j0 + kb - 1 of the quad-double factors, like
+   qd::lu::panel. Returns false if a pivot is zero. */
+static bool qd_gesv_panel(qd_gesv *g, double *const *f, int j0, int kb) {
+  int n = g->a.rows;
+  for (int j = j0; j < j0 + kb; j++) {
+    int p = j;
+    double max = qd::lu::abs(f[0][j * n + j]);
+    for (int i = j + 1; i < n; i++)
+      if (qd::lu::abs(f[0][i * n + j]) > max) {
+        max = qd::lu::abs(f[0][i * n + j]);
+        p = i;
+      }
+    if (!(max > 0.0))
+      return false;
+    g->pivots[j] = p;
+    if (p != j)
+      for (int c = 0; c < n; c++) {
+        qd_real t = qd_gesv_get(f, j * n + c);
+        qd_gesv_set(f, j * n + c, qd_gesv_get(f, p * n + c));
+        qd_gesv_set(f, p * n + c, t);
+      }
+
+    qd_real pivot = qd_gesv_get(f, j * n + j);
+    for (int i = j + 1; i < n; i++) {
+      qd_real l = qd_gesv_get(f, i * n + j) / pivot;
+      qd_gesv_set(f, i * n + j, l);
+      for (int c = j + 1; c < j0 + kb; c++)
+        qd_gesv_set(f, i * n + c,
+            qd_gesv_get(f, i * n + c) - l * qd_gesv_get(f, j * n + c));
+    }
+  }
+  return true;
+}
+
+/* Computes tiles of columns of the rows of U right of the panel, until all
+   tiles have been claimed */
+static void qd_gesv_trsm(qd_gesv *g, double *const *f) {
+  int n = g->a.rows, j0 = g->block, s = j0 + qd::lu::block;
+  for (;;) {
+    int t = __atomic_fetch_add(&g->next_tile, 1, __ATOMIC_RELAXED);
+    int c0 = s + t * qd::lu::tile;
+    if (c0 >= n)
+      return;
+    int c1 = n - c0 < qd::lu::tile ? n : c0 + qd::lu::tile;
+    for (int j = j0; j < s; j++)
+      for (int i = j + 1; i < s; i++) {
+        qd_real l = qd_gesv_get(f, i * n + j);
+        for (int c = c0; c < c1; c++)
+          qd_gesv_set(f, i * n + c,
+              qd_gesv_get(f, i * n + c) - l * qd_gesv_get(f, j * n + c));
+      }
+  }
+}
+
+/* Sets up the update of the rest of the quad-double factors:
+   a22 = -l21 * u12 + a22 */
+static void qd_gesv_product(qd_gesv *g, double *const *f) {
+  int n = g->a.rows, j0 = g->block, s = j0 + qd::lu::block, m = n - s;
+  qd_matrix l = { { f[0] + s * n + j0, f[1] + s * n + j0, f[2] + s * n + j0,
+      f[3] + s * n + j0 }, m, qd::lu::block, n, 1 };
+  qd_matrix u = { { f[0] + j0 * n + s, f[1] + j0 * n + s, f[2] + j0 * n + s,
+      f[3] + j0 * n + s }, qd::lu::block, m, n, 1 };
+  qd_matrix a = { { f[0] + s * n + s, f[1] + s * n + s, f[2] + s * n + s,
+      f[3] + s * n + s }, m, m, n, 1 };
+  g->gemm.a = l;
+  g->gemm.b = u;
+  g->gemm.c = a;
+  qd_gesv_subtract(g->gemm.alpha, g->gemm.beta);
+  g->gemm.next_tile = 0;
+  g->tiles = ((m + QD_QD_GEMM_TILE - 1) / QD_QD_GEMM_TILE)
+      * ((m + QD_QD_GEMM_TILE - 1) / QD_QD_GEMM_TILE);
+}
+
+/* Solves x with the quad-double factors */
+static void qd_gesv_solve(qd_gesv *g, double *const *f) {
+  int n = g->a.rows, nrhs = g->b.cols;
+  double *v0 = g->work + n * n;
+  double *const v[4] = { v0, v0 + n, v0 + 2 * n, v0 + 3 * n };
+  for (int j = 0; j < nrhs; j++) {
+    for (int i = 0; i < n; i++)
+      qd_gesv_set(v, i,
+          qd_gesv_get(g->b.x, i * g->b.row_stride + j * g->b.col_stride));
+    for (int i = 0; i < n; i++) {
+      qd_real t = qd_gesv_get(v, i);
+      qd_gesv_set(v, i, qd_gesv_get(v, g->pivots[i]));
+      qd_gesv_set(v, g->pivots[i], t);
+    }
+    for (int i = 1; i < n; i++) {
+      qd_real s = qd_gesv_get(v, i);
+      for (int k = 0; k < i; k++)
+        s -= qd_gesv_get(f, i * n + k) * qd_gesv_get(v, k);
+      qd_gesv_set(v, i, s);
+    }
+    for (int i = n - 1; i >= 0; i--) {
+      qd_real s = qd_gesv_get(v, i);
+      for (int k = i + 1; k < n; k++)
+        s -= qd_gesv_get(f, i * n + k) * qd_gesv_get(v, k);
+      s /= qd_gesv_get(f, i * n + i);
+      qd_gesv_set(v, i, s);
+      qd_gesv_set(g->x.x, i * g->x.row_stride + j * g->x.col_stride, s);
+    }
+  }
+}
+
+/* Performs the serial part of the next stage (see c_qd_gesv_step) */
+static int qd_gesv_step(qd_gesv *g) {
+  int n = g->a.rows;
+  double *f[4];
+  qd_gesv_factors(g, f);
+  for (;;) {
+    int kb = n - g->block < qd::lu::block ? n - g->block : qd::lu::block;
+    switch (g->stage) {
+    case qd::lu::stage_start:
+      if (g->a.cols != n || g->b.rows != n || g->x.rows != n
+          || g->x.cols != g->b.cols)
+        return qd_gesv_finish(g, qd_gesv_invalid);
+      g->iterations = 0;
+      if (n == 0 || g->b.cols == 0)
+        return qd_gesv_finish(g, qd_gesv_refined);
+      g->anorm = qd::lu::load(g->a.x[0], n, g->a.row_stride, g->a.col_stride,
+          g->work);
+      g->dnorm = -1.0;
+      g->block = 0;
+      g->stage = qd::lu::stage_panel;
+      break;
+
+    case qd::lu::stage_panel:
+      if (g->block >= n) {
+        qd_gesv_start(g);
+        return qd_gesv_residual(g);
+      }
+      if (!qd::lu::panel(g->work, n, g->block, kb, g->pivots)) {
+        g->stage = qd::lu::stage_stalled;
+        break;
+      }
+      qd::lu::trsm(g->work, n, g->block, kb);
+      if (g->block + kb < n) {
+        g->stage = qd::lu::stage_update;
+        g->tiles = qd::lu::tiles(n - g->block - kb);
+        g->next_tile = 0;
+        return 1;
+      }
+      g->block = n;
+      break;
+
+    case qd::lu::stage_update:
+      g->block += kb;
+      g->stage = qd::lu::stage_panel;
+      break;
+
+    case qd::lu::stage_residual:
+      if (qd_gesv_refine(g))
+        return qd_gesv_residual(g);
+      break;
+
+    case qd::lu::stage_stalled:
+      if (!g->factors) {
+        g->status = qd_gesv_stalled;
+        return 0;
+      }
+      for (int i = 0; i < n; i++)
+        for (int j = 0; j < n; j++)
+          qd_gesv_set(f, i * n + j,
+              qd_gesv_get(g->a.x, i * g->a.row_stride + j * g->a.col_stride));
+      g->block = 0;
+      g->stage = qd::lu::stage_factor;
+      break;
+
+    case qd::lu::stage_factor:
+      if (g->block >= n) {
+        qd_gesv_solve(g, f);
+        return qd_gesv_finish(g, qd_gesv_factored);
+      }
+      if (!qd_gesv_panel(g, f, g->block, kb))
+        return qd_gesv_finish(g, qd_gesv_singular);
+      if (g->block + kb < n) {
+        g->stage = qd::lu::stage_trsm;
+        g->tiles = (n - g->block - kb + qd::lu::tile - 1) / qd::lu::tile;
+        g->next_tile = 0;
+        return 1;
+      }
+      g->block = n;
+      break;
+
+    case qd::lu::stage_trsm:
+      qd_gesv_product(g, f);
+      g->stage = qd::lu::stage_product;
+      return 1;
+
+    case qd::lu::stage_product:
+      g->block += kb;
+      g->stage = qd::lu::stage_factor;
+      break;
+
+    default:
+      return 0;
+    }
+  }
+}
+
+/* Computes tiles of the current pass (see c_qd_gesv_pass) */
+static void qd_gesv_pass(const qd_lu_kernels *lu, const qd_blas_kernels *blas,
+    qd_gesv *g, double *work) {
+  int n = g->a.rows;
+  double *f[4];
+  qd_gesv_factors(g, f);
+  switch (g->stage) {
+  case qd::lu::stage_update:
+    qd::lu::update(lu, g->work, n, g->block, qd::lu::block, &g->next_tile);
+    break;
+  case qd::lu::stage_residual:
+    if (g->b.cols == 1)
+      qd_gemv_tiles(blas, &g->gemv);
+    else
+      qd_gemm_tiles(blas, &g->gemm, work);
+    break;
+  case qd::lu::stage_trsm:
+    qd_gesv_trsm(g, f);
+    break;
+  case qd::lu::stage_product:
+    qd_gemm_tiles(blas, &g->gemm, work);
+    break;
+  }
+}
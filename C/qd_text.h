@@ -0,0 +1,230 @@
+/*
+ * qd_text.h
+ *
+ * Reading and writing whole tables of double-double or quad-double values
+ * in text form (see qd_text in c_dd.h). This file is included by both
+ * c_dd.cpp and c_qd.cpp, so everything in it is static.
+ *
+ * The work is split into QD_TEXT_CHUNKS parts, which are claimed with an
+ * atomic increment of next_chunk, like the rows in mp_render.cpp:
+ * - Reading splits the text at equal byte offsets. A part contains the rows
+ *   that start in it, including the end of its last row (which may lie in
+ *   the next part), so rows are never split. The first pass counts the rows
+ *   of each part, and the second pass parses them.
+ * - Writing splits the rows into parts of equal size. The first pass
+ *   measures the text of each part, and the second pass formats it.
+ * The call that finishes the last part of a first pass turns the counts
+ * into the positions where the parts start, so the second pass knows where
+ * to store the rows (reading) or the text (writing) of each part.
+ *
+ * The values are converted with the functions in qd_decimal.h, so reading
+ * and writing a table gives the same results as c_dd_parse and
+ * c_dd_to_string for each value.
+ */
+#ifndef _QD_TEXT_H
+#define _QD_TEXT_H
+
+#include "qd_decimal.h"
+
+namespace qd {
+namespace text {
+
+/* Largest length passed to decimal::parse */
+const int max_len = 0x7fffffff;
+
+/* Claims the next part of the work, or returns -1 if all parts have been
+   claimed. */
+static inline int claim(qd_text *t) {
+  int i = __atomic_fetch_add(&t->next_chunk, 1, __ATOMIC_RELAXED);
+  return i < QD_TEXT_CHUNKS ? i : -1;
+}
+
+/* Stores the count of part i of a first pass. If this was the last part to
+   finish, converts the counts into start positions and returns true. Then
+   t->chunk[QD_TEXT_CHUNKS] is the total. */
+static inline bool finish(qd_text *t, int i, long long count) {
+  t->chunk[i] = count;
+  if (__atomic_add_fetch(&t->done_chunks, 1, __ATOMIC_ACQ_REL) != QD_TEXT_CHUNKS)
+    return false;
+
+  long long total = 0;
+  for (int k = 0; k < QD_TEXT_CHUNKS; k++) {
+    long long n = t->chunk[k];
+    t->chunk[k] = total;
+    total += n;
+  }
+  t->chunk[QD_TEXT_CHUNKS] = total;
+  return true;
+}
+
+/* First char of part i when reading. QD_TEXT_CHUNKS is a power of two, so
+   this does not need a 64-bit division. */
+static inline long long text_start(const qd_text *t, int i) {
+  return t->size * i / QD_TEXT_CHUNKS;
+}
+
+/* First row of part i when writing */
+static inline int row_start(const qd_text *t, int i) {
+  return static_cast<int>(static_cast<long long>(t->rows) * i / QD_TEXT_CHUNKS);
+}
+
+static inline bool is_eol(char c) {
+  return c == '\n' || c == '\r';
+}
+
+/* Whether a row starts at position p (< t->size): the start of a line that
+   is not empty */
+static inline bool row_at(const qd_text *t, long long p) {
+  return (p == 0 || t->text[p - 1] == '\n') && !is_eol(t->text[p]);
+}
+
+/* Skips spaces and tabs (unless they separate the columns) */
+static inline long long skip_blanks(const qd_text *t, long long p) {
+  while (p < t->size && (t->text[p] == ' ' || t->text[p] == '\t') &&
+      t->text[p] != t->separator)
+    p++;
+  return p;
+}
+
+/* Returns the position after the end of the line that contains p */
+static inline long long next_line(const qd_text *t, long long p) {
+  while (p < t->size && t->text[p] != '\n')
+    p++;
+  return p < t->size ? p + 1 : p;
+}
+
+/* Number of fields in the first row */
+static inline int count_columns(const qd_text *t) {
+  long long p = 0;
+  while (p < t->size && !row_at(t, p))
+    p++;
+  if (p == t->size)
+    return 0;
+
+  int columns = 1;
+  for (; p < t->size && t->text[p] != '\n'; p++)
+    columns += t->text[p] == t->separator;
+  return columns;
+}
+
+static inline void count(qd_text *t) {
+  int i;
+  while ((i = claim(t)) >= 0) {
+    long long end = text_start(t, i + 1);
+    long long rows = 0;
+    if (i == 0 && t->columns == 0)
+      t->columns = count_columns(t);
+    for (long long p = text_start(t, i); p < end; p++)
+      rows += row_at(t, p);
+    if (finish(t, i, rows))
+      t->rows = static_cast<int>(t->chunk[QD_TEXT_CHUNKS]);
+  }
+}
+
+/* Parses the row that starts at p into row r of the table. Returns the
+   start of the next line, and adds the number of invalid fields to
+   errors. */
+template <int n>
+static inline long long parse_row(qd_text *t, long long p, int r, int &errors) {
+  const char *s = t->text;
+  double x[n];
+
+  for (int c = 0; c < t->columns; c++) {
+    bool last = c == t->columns - 1;
+    int len = 0;
+
+    /* decimal::parse would skip a line break, so check for an empty
+       field first */
+    p = skip_blanks(t, p);
+    if (p < t->size && !is_eol(s[p]) && s[p] != t->separator) {
+      long long rest = t->size - p;
+      len = decimal::parse(s + p, rest < max_len ? static_cast<int>(rest) : max_len, x, n);
+      p = skip_blanks(t, p + len);
+    }
+
+    bool valid = len > 0 &&
+        (p == t->size || is_eol(s[p]) || (!last && s[p] == t->separator));
+    if (!valid) {
+      errors++;
+      for (int k = 0; k < n; k++)
+        x[k] = qd::_d_nan;
+      while (p < t->size && !is_eol(s[p]) && (last || s[p] != t->separator))
+        p++;
+    }
+    if (!last && p < t->size && s[p] == t->separator)
+      p++;
+
+    for (int k = 0; k < n; k++)
+      t->x[c * n + k][r] = x[k];
+  }
+  return next_line(t, p);
+}
+
+template <int n>
+static inline void parse(qd_text *t) {
+  int i, errors = 0;
+  while ((i = claim(t)) >= 0) {
+    long long end = text_start(t, i + 1);
+    int r = static_cast<int>(t->chunk[i]);
+    long long p = text_start(t, i);
+    while (p < end) {
+      if (row_at(t, p))
+        p = parse_row<n>(t, p, r++, errors);
+      else
+        p++;
+    }
+  }
+  if (errors != 0)
+    __atomic_fetch_add(&t->errors, errors, __ATOMIC_RELAXED);
+}
+
+static inline void load(const qd_text *t, int c, int r, double *x, int n) {
+  for (int k = 0; k < n; k++)
+    x[k] = t->x[c * n + k][r];
+}
+
+template <int n>
+static inline void measure(qd_text *t) {
+  int i;
+  double x[n];
+  while ((i = claim(t)) >= 0) {
+    long long len = 0;
+    for (int r = row_start(t, i); r < row_start(t, i + 1); r++) {
+      for (int c = 0; c < t->columns; c++) {
+        load(t, c, r, x, n);
+        len += decimal::to_string(x, n, 0, 0, t->format, t->precision) + 1;
+      }
+    }
+    if (finish(t, i, len))
+      t->size = t->chunk[QD_TEXT_CHUNKS];
+  }
+}
+
+/* Each value is followed by a separator or a line break, which overwrites
+   the null terminator that decimal::to_string adds. So the text of a part
+   never touches the next part. */
+template <int n>
+static inline void format(qd_text *t) {
+  int i;
+  double x[n];
+  while ((i = claim(t)) >= 0) {
+    long long p = t->chunk[i], end = t->chunk[i + 1];
+    for (int r = row_start(t, i); r < row_start(t, i + 1); r++) {
+      for (int c = 0; c < t->columns; c++) {
+        long long room = end - p;
+        if (room <= 0)
+          break;
+        load(t, c, r, x, n);
+        p += decimal::to_string(x, n, t->text + p,
+            room < max_len ? static_cast<int>(room) : max_len, t->format, t->precision);
+        if (p < end)
+          t->text[p++] = c == t->columns - 1 ? '\n' : static_cast<char>(t->separator);
+      }
+    }
+  }
+}
+
+}  // namespace text
+}  // namespace qd
+
+#endif  /* _QD_TEXT_H */
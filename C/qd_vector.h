@@ -0,0 +1,105 @@
+/*
+ * qd_vector.h
+ *
+ * A vector of quad-double numbers in structure-of-arrays layout: the
+ * 4 components are stored in four separate 64-byte aligned planes,
+ * which can be passed directly to the batch functions (c_qd_add_n etc.)
+ * through array().
+ *
+ * Unlike an array of qd_real, the elements are not initialized when the
+ * vector is created. Use load to fill the vector from an existing array of
+ * qd_real, and store to copy it back; these use the SIMD transpose kernels
+ * (c_qd_to_soa and c_qd_to_aos).
+ */
+#ifndef _QD_QD_VECTOR_H
+#define _QD_QD_VECTOR_H
+
+#include <new>
+#include "c_qd.h"
+#include "qd_alloc.h"
+
+class qd_vector {
+public:
+  qd_vector() {
+    block_.ptr = 0;
+    block_.size = 0;
+    block_.huge = false;
+    array_.x[0] = array_.x[1] = array_.x[2] = array_.x[3] = 0;
+    array_.count = 0;
+  }
+
+  /* Creates a vector of n uninitialized elements. If huge_pages is true,
+     the planes are backed by huge pages when the OS allows it. Throws
+     std::bad_alloc if n is negative, if the size of the planes does not fit
+     in a size_t, or if the memory cannot be allocated. */
+  explicit qd_vector(int n, bool huge_pages = false) {
+    if (n < 0)
+      throw std::bad_alloc();
+    size_t stride = qd::aligned_count(static_cast<size_t>(n));
+    if (stride > static_cast<size_t>(-1) / (4 * sizeof(double)))
+      throw std::bad_alloc();
+    block_ = qd::aligned_malloc(4 * sizeof(double) * stride, huge_pages);
+    if (block_.ptr == 0)
+      throw std::bad_alloc();
+    array_.x[0] = static_cast<double *>(block_.ptr);
+    array_.x[1] = array_.x[0] + stride;
+    array_.x[2] = array_.x[1] + stride;
+    array_.x[3] = array_.x[2] + stride;
+    array_.count = n;
+  }
+
+  ~qd_vector() { qd::aligned_free(block_); }
+
+  qd_vector(qd_vector &&other) : block_(other.block_), array_(other.array_) {
+    other.block_.ptr = 0;
+    other.array_.count = 0;
+  }
+
+  qd_vector &operator=(qd_vector &&other) {
+    if (this != &other) {
+      qd::aligned_free(block_);
+      block_ = other.block_;
+      array_ = other.array_;
+      other.block_.ptr = 0;
+      other.array_.count = 0;
+    }
+    return *this;
+  }
+
+  int size() const { return array_.count; }
+
+  /* The structure-of-arrays view for the batch functions. */
+  qd_real_array &array() { return array_; }
+  const qd_real_array &array() const { return array_; }
+
+  /* Component plane k (0 = most significant, 3 = least significant). */
+  double *data(int k) { return array_.x[k]; }
+  const double *data(int k) const { return array_.x[k]; }
+
+  qd_real operator[](int i) const {
+    return qd_real(array_.x[0][i], array_.x[1][i], array_.x[2][i],
+                   array_.x[3][i]);
+  }
+
+  void set(int i, const qd_real &a) {
+    array_.x[0][i] = a.x[0];
+    array_.x[1][i] = a.x[1];
+    array_.x[2][i] = a.x[2];
+    array_.x[3][i] = a.x[3];
+  }
+
+  /* Copies size() elements from a into the vector. */
+  void load(const qd_real *a) { c_qd_to_soa(a, &array_); }
+
+  /* Copies the size() elements of the vector to a. */
+  void store(qd_real *a) const { c_qd_to_aos(&array_, a); }
+
+  qd_vector(const qd_vector &) = delete;
+  qd_vector &operator=(const qd_vector &) = delete;
+
+private:
+  qd::aligned_block block_;
+  qd_real_array array_;
+};
+
+#endif /* _QD_QD_VECTOR_H */
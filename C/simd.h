@@ -0,0 +1,436 @@
+/*
+ * simd.h
+ *
+ * SIMD versions of the basic building blocks in inline.h, used by the batch
+ * (array) functions. Each instruction set gets its own namespace (qd::sse2,
+ * qd::avx2 and qd::avx512) containing a "vec" type that holds "width"
+ * doubles, and the same set of functions operating on that type.
+ *
+ * The kernels built on top of these (see dd_batch.h and qd_batch.h) are
+ * compiled once for each namespace, and the widest one supported by the CPU
+ * is selected at runtime (see qd_cpu.h). All versions produce bitwise
+ * identical results to the scalar functions in inline.h.
+ *
+ * Kernels must call zero_upper before calling scalar code, to avoid the
+ * penalty for switching between AVX and SSE instructions (GCC does not
+ * insert vzeroupper instructions for functions with a target attribute).
+ *
+ * On ARM, no SIMD versions are provided and the batch functions simply loop
+ * over the scalar functions.
+ */
+#ifndef _QD_SIMD_H
+#define _QD_SIMD_H
+
+#include "qd_config.h"
+#include "inline.h"
+
+#ifdef QD_FMA_DISPATCH
+
+#define QD_TARGET_SSE2
+#define QD_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#define QD_TARGET_AVX512 __attribute__((target("avx512f,avx2,fma")))
+
+/*********** SSE2 (2 lanes) ************/
+namespace qd {
+namespace sse2 {
+
+typedef __m128d vec;
+enum { width = 2 };
+
+inline vec load(const double *p) { return _mm_loadu_pd(p); }
+inline void store(double *p, vec a) { _mm_storeu_pd(p, a); }
+
+/* Load and store the first n (0 < n < width) lanes. The other lanes are
+   loaded as zero. With width 2, n is always 1. */
+inline vec load_partial(const double *p, int /* n */) { return _mm_load_sd(p); }
+inline void store_partial(double *p, vec a, int /* n */) { _mm_store_sd(p, a); }
+
+/* Transposes between "width" consecutive pairs/quadruples of doubles
+   (array-of-structures) and 2 or 4 vectors (structure-of-arrays). */
+inline void deinterleave2(const double *p, vec &x0, vec &x1) {
+  vec a = load(p), b = load(p + 2);
+  x0 = _mm_unpacklo_pd(a, b);
+  x1 = _mm_unpackhi_pd(a, b);
+}
+
+inline void interleave2(double *p, vec x0, vec x1) {
+  store(p, _mm_unpacklo_pd(x0, x1));
+  store(p + 2, _mm_unpackhi_pd(x0, x1));
+}
+
+inline void deinterleave4(const double *p, vec &x0, vec &x1, vec &x2,
+    vec &x3) {
+  vec a0 = load(p), a1 = load(p + 2), b0 = load(p + 4), b1 = load(p + 6);
+  x0 = _mm_unpacklo_pd(a0, b0);
+  x1 = _mm_unpackhi_pd(a0, b0);
+  x2 = _mm_unpacklo_pd(a1, b1);
+  x3 = _mm_unpackhi_pd(a1, b1);
+}
+
+inline void interleave4(double *p, vec x0, vec x1, vec x2, vec x3) {
+  store(p, _mm_unpacklo_pd(x0, x1));
+  store(p + 2, _mm_unpacklo_pd(x2, x3));
+  store(p + 4, _mm_unpackhi_pd(x0, x1));
+  store(p + 6, _mm_unpackhi_pd(x2, x3));
+}
+inline vec set1(double a) { return _mm_set1_pd(a); }
+inline vec abs(vec a) { return _mm_andnot_pd(set1(-0.0), a); }
+inline void zero_upper() { }
+
+/* Per-lane conditions. A mask has all bits set in lanes where the
+   condition is true. */
+typedef __m128d mask;
+inline mask no_lanes() { return _mm_setzero_pd(); }
+inline mask is_zero(vec a) { return _mm_cmpeq_pd(a, _mm_setzero_pd()); }
+inline mask is_nonzero(vec a) { return _mm_cmpneq_pd(a, _mm_setzero_pd()); }
+inline mask is_inf(vec a) { return _mm_cmpeq_pd(abs(a), set1(__builtin_inf())); }
+inline mask mask_and(mask a, mask b) { return _mm_and_pd(a, b); }
+inline mask mask_or(mask a, mask b) { return _mm_or_pd(a, b); }
+inline mask mask_andnot(mask a, mask b) { return _mm_andnot_pd(b, a); }
+inline bool any(mask m) { return _mm_movemask_pd(m) != 0; }
+inline bool all(mask m) { return _mm_movemask_pd(m) == 3; }
+
+/* Returns a in lanes where m is set, and b in the other lanes. */
+inline vec select(mask m, vec a, vec b) {
+  return _mm_or_pd(_mm_and_pd(m, a), _mm_andnot_pd(m, b));
+}
+
+inline mask is_eq(vec a, vec b) { return _mm_cmpeq_pd(a, b); }
+inline mask is_lt(vec a, vec b) { return _mm_cmplt_pd(a, b); }
+inline mask is_le(vec a, vec b) { return _mm_cmple_pd(a, b); }
+
+inline vec sqrt(vec a) { return _mm_sqrt_pd(a); }
+
+/* SSE2 has no rounding instruction. Rounds |a| to an integer by adding and
+   subtracting 2^52, and corrects the lanes that were rounded up. */
+inline vec floor(vec a) {
+  vec big = set1(4503599627370496.0);
+  vec r = (abs(a) + big) - big;
+  r = _mm_or_pd(r, _mm_and_pd(a, set1(-0.0)));
+  r -= _mm_and_pd(_mm_cmpgt_pd(r, a), set1(1.0));
+  return select(_mm_cmplt_pd(abs(a), big), r, a);
+}
+
+/* Returns p[i] for the integral lanes i in [0, 2^31). */
+inline vec gather(const double *p, vec i) {
+  __m128i k = _mm_cvttpd_epi32(i);
+  return _mm_setr_pd(p[_mm_cvtsi128_si32(k)],
+                     p[_mm_cvtsi128_si32(_mm_shuffle_epi32(k, 1))]);
+}
+
+/* Returns 2^k for integral k in [-1022, 1023]. */
+inline vec pow2(vec k) {
+  __m128i e = _mm_castpd_si128(k + set1(4503599627371519.0));
+  return _mm_castsi128_pd(_mm_slli_epi64(e, 52));
+}
+
+/* Returns the unbiased exponent of a positive normal number. */
+inline vec exponent(vec a) {
+  __m128i e = _mm_srli_epi64(_mm_castpd_si128(a), 52);
+  return _mm_or_pd(_mm_castsi128_pd(e), set1(4503599627370496.0)) -
+    set1(4503599627371519.0);
+}
+
+/* Returns a positive normal number scaled to [1, 2). */
+inline vec mantissa(vec a) {
+  vec m = _mm_castsi128_pd(_mm_set1_epi64x(0x000FFFFFFFFFFFFFLL));
+  return _mm_or_pd(_mm_and_pd(a, m), set1(1.0));
+}
+
+/* Same as qd::split. Lanes that exceed the split threshold are scaled
+   down and up again using blends instead of branches. */
+inline void split(vec a, vec &hi, vec &lo) {
+  mask big = _mm_cmpgt_pd(abs(a), set1(_QD_SPLIT_THRESH));
+  vec scale = select(big, set1(268435456.0), set1(1.0));
+  vec temp;
+  a = select(big, a * set1(3.7252902984619140625e-09), a);
+  temp = set1(_QD_SPLITTER) * a;
+  hi = temp - (temp - a);
+  lo = a - hi;
+  hi *= scale;
+  lo *= scale;
+}
+
+/* Computes fl(a*b) and err(a*b). */
+inline vec two_prod(vec a, vec b, vec &err) {
+  vec a_hi, a_lo, b_hi, b_lo;
+  vec p = a * b;
+  split(a, a_hi, a_lo);
+  split(b, b_hi, b_lo);
+  err = ((a_hi * b_hi - p) + a_hi * b_lo + a_lo * b_hi) + a_lo * b_lo;
+  return p;
+}
+
+/* Computes fl(a*a) and err(a*a). */
+inline vec two_sqr(vec a, vec &err) {
+  vec hi, lo;
+  vec q = a * a;
+  split(a, hi, lo);
+  err = ((hi * hi - q) + set1(2.0) * hi * lo) + lo * lo;
+  return q;
+}
+
+#define QD_SIMD_TARGET QD_TARGET_SSE2
+#include "simd_inline.h"
+#undef QD_SIMD_TARGET
+
+}
+}
+
+/*********** AVX2 + FMA3 (4 lanes) ************/
+namespace qd {
+namespace avx2 {
+
+typedef __m256d vec;
+enum { width = 4 };
+
+QD_TARGET_AVX2 inline vec load(const double *p) { return _mm256_loadu_pd(p); }
+QD_TARGET_AVX2 inline void store(double *p, vec a) { _mm256_storeu_pd(p, a); }
+
+QD_TARGET_AVX2 inline __m256i lanes_below(int n) {
+  return _mm256_cmpgt_epi64(_mm256_set1_epi64x(n), _mm256_set_epi64x(3, 2, 1, 0));
+}
+QD_TARGET_AVX2 inline vec load_partial(const double *p, int n) {
+  return _mm256_maskload_pd(p, lanes_below(n));
+}
+QD_TARGET_AVX2 inline void store_partial(double *p, vec a, int n) {
+  _mm256_maskstore_pd(p, lanes_below(n), a);
+}
+
+QD_TARGET_AVX2 inline void deinterleave2(const double *p, vec &x0, vec &x1) {
+  vec a = load(p), b = load(p + 4);
+  x0 = _mm256_permute4x64_pd(_mm256_unpacklo_pd(a, b), 0xD8);
+  x1 = _mm256_permute4x64_pd(_mm256_unpackhi_pd(a, b), 0xD8);
+}
+
+QD_TARGET_AVX2 inline void interleave2(double *p, vec x0, vec x1) {
+  x0 = _mm256_permute4x64_pd(x0, 0xD8);
+  x1 = _mm256_permute4x64_pd(x1, 0xD8);
+  store(p, _mm256_unpacklo_pd(x0, x1));
+  store(p + 4, _mm256_unpackhi_pd(x0, x1));
+}
+
+/* A 4x4 transpose, which is its own inverse */
+QD_TARGET_AVX2 inline void transpose4(vec &x0, vec &x1, vec &x2, vec &x3) {
+  vec t0 = _mm256_unpacklo_pd(x0, x1);
+  vec t1 = _mm256_unpackhi_pd(x0, x1);
+  vec t2 = _mm256_unpacklo_pd(x2, x3);
+  vec t3 = _mm256_unpackhi_pd(x2, x3);
+  x0 = _mm256_permute2f128_pd(t0, t2, 0x20);
+  x1 = _mm256_permute2f128_pd(t1, t3, 0x20);
+  x2 = _mm256_permute2f128_pd(t0, t2, 0x31);
+  x3 = _mm256_permute2f128_pd(t1, t3, 0x31);
+}
+
+QD_TARGET_AVX2 inline void deinterleave4(const double *p, vec &x0, vec &x1,
+    vec &x2, vec &x3) {
+  x0 = load(p);
+  x1 = load(p + 4);
+  x2 = load(p + 8);
+  x3 = load(p + 12);
+  transpose4(x0, x1, x2, x3);
+}
+
+QD_TARGET_AVX2 inline void interleave4(double *p, vec x0, vec x1, vec x2,
+    vec x3) {
+  transpose4(x0, x1, x2, x3);
+  store(p, x0);
+  store(p + 4, x1);
+  store(p + 8, x2);
+  store(p + 12, x3);
+}
+QD_TARGET_AVX2 inline vec set1(double a) { return _mm256_set1_pd(a); }
+QD_TARGET_AVX2 inline vec abs(vec a) { return _mm256_andnot_pd(set1(-0.0), a); }
+QD_TARGET_AVX2 inline void zero_upper() { _mm256_zeroupper(); }
+
+typedef __m256d mask;
+QD_TARGET_AVX2 inline mask no_lanes() { return _mm256_setzero_pd(); }
+QD_TARGET_AVX2 inline mask is_zero(vec a) { return _mm256_cmp_pd(a, _mm256_setzero_pd(), _CMP_EQ_OQ); }
+QD_TARGET_AVX2 inline mask is_nonzero(vec a) { return _mm256_cmp_pd(a, _mm256_setzero_pd(), _CMP_NEQ_UQ); }
+QD_TARGET_AVX2 inline mask is_inf(vec a) { return _mm256_cmp_pd(abs(a), set1(__builtin_inf()), _CMP_EQ_OQ); }
+QD_TARGET_AVX2 inline mask mask_and(mask a, mask b) { return _mm256_and_pd(a, b); }
+QD_TARGET_AVX2 inline mask mask_or(mask a, mask b) { return _mm256_or_pd(a, b); }
+QD_TARGET_AVX2 inline mask mask_andnot(mask a, mask b) { return _mm256_andnot_pd(b, a); }
+QD_TARGET_AVX2 inline bool any(mask m) { return _mm256_movemask_pd(m) != 0; }
+QD_TARGET_AVX2 inline bool all(mask m) { return _mm256_movemask_pd(m) == 15; }
+QD_TARGET_AVX2 inline vec select(mask m, vec a, vec b) { return _mm256_blendv_pd(b, a, m); }
+
+QD_TARGET_AVX2 inline mask is_eq(vec a, vec b) { return _mm256_cmp_pd(a, b, _CMP_EQ_OQ); }
+QD_TARGET_AVX2 inline mask is_lt(vec a, vec b) { return _mm256_cmp_pd(a, b, _CMP_LT_OQ); }
+QD_TARGET_AVX2 inline mask is_le(vec a, vec b) { return _mm256_cmp_pd(a, b, _CMP_LE_OQ); }
+
+QD_TARGET_AVX2 inline vec sqrt(vec a) { return _mm256_sqrt_pd(a); }
+QD_TARGET_AVX2 inline vec floor(vec a) { return _mm256_floor_pd(a); }
+
+QD_TARGET_AVX2 inline vec gather(const double *p, vec i) {
+  return _mm256_i32gather_pd(p, _mm256_cvttpd_epi32(i), 8);
+}
+
+QD_TARGET_AVX2 inline vec pow2(vec k) {
+  __m256i e = _mm256_castpd_si256(k + set1(4503599627371519.0));
+  return _mm256_castsi256_pd(_mm256_slli_epi64(e, 52));
+}
+
+QD_TARGET_AVX2 inline vec exponent(vec a) {
+  __m256i e = _mm256_srli_epi64(_mm256_castpd_si256(a), 52);
+  return _mm256_or_pd(_mm256_castsi256_pd(e), set1(4503599627370496.0)) -
+    set1(4503599627371519.0);
+}
+
+QD_TARGET_AVX2 inline vec mantissa(vec a) {
+  vec m = _mm256_castsi256_pd(_mm256_set1_epi64x(0x000FFFFFFFFFFFFFLL));
+  return _mm256_or_pd(_mm256_and_pd(a, m), set1(1.0));
+}
+
+/* Computes fl(a*b) and err(a*b). */
+QD_TARGET_AVX2 inline vec two_prod(vec a, vec b, vec &err) {
+  vec p = a * b;
+  err = _mm256_fmsub_pd(a, b, p);
+  return p;
+}
+
+/* Computes fl(a*a) and err(a*a). */
+QD_TARGET_AVX2 inline vec two_sqr(vec a, vec &err) {
+  vec p = a * a;
+  err = _mm256_fmsub_pd(a, a, p);
+  return p;
+}
+
+#define QD_SIMD_TARGET QD_TARGET_AVX2
+#include "simd_inline.h"
+#undef QD_SIMD_TARGET
+
+}
+}
+
+/*********** AVX-512 (8 lanes) ************/
+namespace qd {
+namespace avx512 {
+
+typedef __m512d vec;
+enum { width = 8 };
+
+QD_TARGET_AVX512 inline vec load(const double *p) { return _mm512_loadu_pd(p); }
+QD_TARGET_AVX512 inline void store(double *p, vec a) { _mm512_storeu_pd(p, a); }
+QD_TARGET_AVX512 inline vec load_partial(const double *p, int n) {
+  return _mm512_maskz_loadu_pd((__mmask8)((1 << n) - 1), p);
+}
+QD_TARGET_AVX512 inline void store_partial(double *p, vec a, int n) {
+  _mm512_mask_storeu_pd(p, (__mmask8)((1 << n) - 1), a);
+}
+
+/* Picks lanes from a (indices 0-7) and b (indices 8-15) */
+QD_TARGET_AVX512 inline vec permute(vec a, vec b, int i0, int i1, int i2,
+    int i3, int i4, int i5, int i6, int i7) {
+  return _mm512_permutex2var_pd(a,
+    _mm512_setr_epi64(i0, i1, i2, i3, i4, i5, i6, i7), b);
+}
+
+QD_TARGET_AVX512 inline void deinterleave2(const double *p, vec &x0, vec &x1) {
+  vec a = load(p), b = load(p + 8);
+  x0 = permute(a, b, 0, 2, 4, 6, 8, 10, 12, 14);
+  x1 = permute(a, b, 1, 3, 5, 7, 9, 11, 13, 15);
+}
+
+QD_TARGET_AVX512 inline void interleave2(double *p, vec x0, vec x1) {
+  store(p, permute(x0, x1, 0, 8, 1, 9, 2, 10, 3, 11));
+  store(p + 8, permute(x0, x1, 4, 12, 5, 13, 6, 14, 7, 15));
+}
+
+QD_TARGET_AVX512 inline void deinterleave4(const double *p, vec &x0, vec &x1,
+    vec &x2, vec &x3) {
+  vec a = load(p), b = load(p + 8), c = load(p + 16), d = load(p + 24);
+  vec t0 = permute(a, b, 0, 4, 8, 12, 1, 5, 9, 13);
+  vec t1 = permute(a, b, 2, 6, 10, 14, 3, 7, 11, 15);
+  vec t2 = permute(c, d, 0, 4, 8, 12, 1, 5, 9, 13);
+  vec t3 = permute(c, d, 2, 6, 10, 14, 3, 7, 11, 15);
+  x0 = permute(t0, t2, 0, 1, 2, 3, 8, 9, 10, 11);
+  x1 = permute(t0, t2, 4, 5, 6, 7, 12, 13, 14, 15);
+  x2 = permute(t1, t3, 0, 1, 2, 3, 8, 9, 10, 11);
+  x3 = permute(t1, t3, 4, 5, 6, 7, 12, 13, 14, 15);
+}
+
+QD_TARGET_AVX512 inline void interleave4(double *p, vec x0, vec x1, vec x2,
+    vec x3) {
+  vec t0 = permute(x0, x1, 0, 1, 2, 3, 8, 9, 10, 11);
+  vec t1 = permute(x2, x3, 0, 1, 2, 3, 8, 9, 10, 11);
+  vec t2 = permute(x0, x1, 4, 5, 6, 7, 12, 13, 14, 15);
+  vec t3 = permute(x2, x3, 4, 5, 6, 7, 12, 13, 14, 15);
+  store(p, permute(t0, t1, 0, 4, 8, 12, 1, 5, 9, 13));
+  store(p + 8, permute(t0, t1, 2, 6, 10, 14, 3, 7, 11, 15));
+  store(p + 16, permute(t2, t3, 0, 4, 8, 12, 1, 5, 9, 13));
+  store(p + 24, permute(t2, t3, 2, 6, 10, 14, 3, 7, 11, 15));
+}
+QD_TARGET_AVX512 inline vec set1(double a) { return _mm512_set1_pd(a); }
+QD_TARGET_AVX512 inline vec abs(vec a) { return _mm512_abs_pd(a); }
+QD_TARGET_AVX512 inline void zero_upper() { _mm256_zeroupper(); }
+
+typedef __mmask8 mask;
+QD_TARGET_AVX512 inline mask no_lanes() { return 0; }
+QD_TARGET_AVX512 inline mask is_zero(vec a) { return _mm512_cmp_pd_mask(a, _mm512_setzero_pd(), _CMP_EQ_OQ); }
+QD_TARGET_AVX512 inline mask is_nonzero(vec a) { return _mm512_cmp_pd_mask(a, _mm512_setzero_pd(), _CMP_NEQ_UQ); }
+QD_TARGET_AVX512 inline mask is_inf(vec a) { return _mm512_cmp_pd_mask(abs(a), set1(__builtin_inf()), _CMP_EQ_OQ); }
+QD_TARGET_AVX512 inline mask mask_and(mask a, mask b) { return a & b; }
+QD_TARGET_AVX512 inline mask mask_or(mask a, mask b) { return a | b; }
+QD_TARGET_AVX512 inline mask mask_andnot(mask a, mask b) { return a & ~b; }
+QD_TARGET_AVX512 inline bool any(mask m) { return m != 0; }
+QD_TARGET_AVX512 inline bool all(mask m) { return m == 0xff; }
+QD_TARGET_AVX512 inline vec select(mask m, vec a, vec b) { return _mm512_mask_blend_pd(m, b, a); }
+
+QD_TARGET_AVX512 inline mask is_eq(vec a, vec b) { return _mm512_cmp_pd_mask(a, b, _CMP_EQ_OQ); }
+QD_TARGET_AVX512 inline mask is_lt(vec a, vec b) { return _mm512_cmp_pd_mask(a, b, _CMP_LT_OQ); }
+QD_TARGET_AVX512 inline mask is_le(vec a, vec b) { return _mm512_cmp_pd_mask(a, b, _CMP_LE_OQ); }
+
+QD_TARGET_AVX512 inline vec sqrt(vec a) { return _mm512_sqrt_pd(a); }
+QD_TARGET_AVX512 inline vec floor(vec a) {
+  return _mm512_roundscale_pd(a, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC);
+}
+
+QD_TARGET_AVX512 inline vec gather(const double *p, vec i) {
+  return _mm512_i32gather_pd(_mm512_cvttpd_epi32(i), p, 8);
+}
+
+QD_TARGET_AVX512 inline vec pow2(vec k) {
+  __m512i e = _mm512_castpd_si512(k + set1(4503599627371519.0));
+  return _mm512_castsi512_pd(_mm512_slli_epi64(e, 52));
+}
+
+/* AVX-512F has no floating point bitwise operations, so these use the
+   integer versions. */
+QD_TARGET_AVX512 inline vec exponent(vec a) {
+  __m512i e = _mm512_srli_epi64(_mm512_castpd_si512(a), 52);
+  e = _mm512_or_si512(e, _mm512_castpd_si512(set1(4503599627370496.0)));
+  return _mm512_castsi512_pd(e) - set1(4503599627371519.0);
+}
+
+QD_TARGET_AVX512 inline vec mantissa(vec a) {
+  __m512i m = _mm512_and_si512(_mm512_castpd_si512(a),
+    _mm512_set1_epi64(0x000FFFFFFFFFFFFFLL));
+  m = _mm512_or_si512(m, _mm512_castpd_si512(set1(1.0)));
+  return _mm512_castsi512_pd(m);
+}
+
+/* Computes fl(a*b) and err(a*b). */
+QD_TARGET_AVX512 inline vec two_prod(vec a, vec b, vec &err) {
+  vec p = a * b;
+  err = _mm512_fmsub_pd(a, b, p);
+  return p;
+}
+
+/* Computes fl(a*a) and err(a*a). */
+QD_TARGET_AVX512 inline vec two_sqr(vec a, vec &err) {
+  vec p = a * a;
+  err = _mm512_fmsub_pd(a, a, p);
+  return p;
+}
+
+#define QD_SIMD_TARGET QD_TARGET_AVX512
+#include "simd_inline.h"
+#undef QD_SIMD_TARGET
+
+}
+}
+
+#endif /* QD_FMA_DISPATCH */
+
+#endif /* _QD_SIMD_H */
@@ -0,0 +1,52 @@
+/*
+ * simd_inline.h
+ *
+ * Instruction set independent building blocks for the SIMD namespaces in
+ * simd.h. This file is included once inside each of these namespaces, after
+ * the "vec" type has been declared and QD_SIMD_TARGET has been defined.
+ * These are the same as their scalar counterparts in inline.h.
+ */
+
+/* Computes fl(a+b) and err(a+b).  Assumes |a| >= |b|. */
+QD_SIMD_TARGET inline vec quick_two_sum(vec a, vec b, vec &err) {
+  vec s = a + b;
+  err = b - (s - a);
+  return s;
+}
+
+/* Computes fl(a-b) and err(a-b).  Assumes |a| >= |b| */
+QD_SIMD_TARGET inline vec quick_two_diff(vec a, vec b, vec &err) {
+  vec s = a - b;
+  err = (a - s) - b;
+  return s;
+}
+
+/* Computes fl(a+b) and err(a+b).  */
+QD_SIMD_TARGET inline vec two_sum(vec a, vec b, vec &err) {
+  vec s = a + b;
+  vec bb = s - a;
+  err = (a - (s - bb)) + (b - bb);
+  return s;
+}
+
+/* Computes fl(a-b) and err(a-b).  */
+QD_SIMD_TARGET inline vec two_diff(vec a, vec b, vec &err) {
+  vec s = a - b;
+  vec bb = s - a;
+  err = (a - (s - bb)) - (b + bb);
+  return s;
+}
+
+/* Computes the nearest integer to a. */
+QD_SIMD_TARGET inline vec nint(vec a) {
+  vec f = floor(a);
+  return select(is_eq(a, f), a, floor(a + set1(0.5)));
+}
+
+/* Computes a * 2^m for integral m in [-2044, 2046]. The scaling is done in
+   two steps, so that both powers of two are normal numbers and the result
+   is rounded only once, like qd_ldexp. */
+QD_SIMD_TARGET inline vec ldexp(vec a, vec m) {
+  vec h = floor(m * set1(0.5));
+  return a * pow2(h) * pow2(m - h);
+}
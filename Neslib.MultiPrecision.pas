@@ -29,13 +29,31 @@ unit Neslib.MultiPrecision;
   This configuration sacrifices a bit of accuracy for increase speed. If
   accuracy is more important than speed for your purposes, then you can compile
   the library with the MP_ACCURATE define. This will make many calculations a
-  bit slower but more accurate. }
+  bit slower but more accurate.
+
+  Prebuilt binaries
+  -----------------
+  The batch functions (AddN, ExpN etc.), vectors, matrices, exact sums, text
+  and file functions, RenderMandelbrot, PolyEval/PolyRoot and the sloppy and
+  accurate versions of the operators need C binaries built from the current
+  sources in the C subdirectory. So far, only the Linux binaries have been
+  rebuilt. On other platforms, these features are not available, and Init and
+  ToString use the previous Pascal implementations (which treat the Shortest
+  format as Scientific, and do not accept INF and NAN). After rebuilding the
+  binaries for your platform with the Build* scripts in the C subdirectory,
+  you can compile the library with the MP_REBUILT_BINARIES define to enable
+  these features. }
 
 {$SCOPEDENUMS ON}
 
+{$IF Defined(LINUX64)}
+  {$DEFINE MP_REBUILT_BINARIES}
+{$ENDIF}
+
 interface
 
 uses
+  System.Classes,
   System.SysUtils,
   System.Math;
 
@@ -58,6 +76,11 @@ function MultiPrecisionInit: UInt32;
     MultiPrecisionInit }
 procedure MultiPrecisionReset(const AState: UInt32);
 
+const
+  { Whether the features that need rebuilt C binaries are available on this
+    platform. See "Prebuilt binaries" at the top of this unit. }
+  MultiPrecisionRebuiltBinaries = {$IF Defined(MP_REBUILT_BINARIES)}True{$ELSE}False{$ENDIF};
+
 type
   { Formats used for converting a multi-precision floating-point value to a
     string. }
@@ -66,7 +89,13 @@ type
     Fixed,
 
     { Scientific format }
-    Scientific);
+    Scientific,
+
+    { Shortest string that converts back to the same value. Uses Fixed format
+      for values between 1e-5 and 1e21, and Scientific format otherwise. The
+      precision is ignored. If MultiPrecisionRebuiltBinaries is False, this is
+      the same as Scientific (and the precision is used). }
+    Shortest);
 
 type
   { 128-bit floating-point type, comprised of two double-precision
@@ -84,9 +113,11 @@ type
     function GetExp: UInt64; inline;
     procedure SetExp(const Value: UInt64); inline;
     function GetSpecialType: TFloatSpecial; inline;
+  {$IF not Defined(MP_REBUILT_BINARIES)}
   private
     procedure ToDigits(const S: TArray<Char>; var Exponent: Integer;
       const Precision: Integer);
+  {$ENDIF}
   {$ENDREGION 'Internal Declarations'}
   public
     { Various ways to explicitly initialize a DoubleDouble value.
@@ -96,7 +127,10 @@ type
         Hi, Lo: the two Double values that make up this DoubleDouble.
         S: a string representation of the DoubleDouble floating-point value.
           Uses the system-wide format settings if FormatSettings is not
-          specified.
+          specified. Each component is the nearest Double to the rest of the
+          exact value, so the result of ToString in the Shortest format
+          converts back to the same value. Also accepts INF and NAN. If S is
+          not a valid number, the value is set to NaN.
         FormatSettings: the format settings used for the string S }
     procedure Init; overload; inline;
     procedure Init(const Value: Double); overload; inline;
@@ -161,6 +195,25 @@ type
     class operator Divide(const A: Double; const B: DoubleDouble): DoubleDouble; inline; static;
     class operator Divide(const A: DoubleDouble; const B: Double): DoubleDouble; inline; static;
 
+  {$IF Defined(MP_REBUILT_BINARIES)}
+    { Sloppy and accurate versions of the arithmetic operators.
+      The operators above use the sloppy algorithms by default, or the
+      accurate ones when compiled with the MP_ACCURATE define. These
+      versions always use the given algorithm, so you can use the faster
+      sloppy versions in performance-critical code and the accurate versions
+      where accuracy matters, without recompiling the library.
+
+      The accurate additions and subtractions satisfy IEEE-style error
+      bounds. The sloppy ones can lose accuracy when A and B have opposite
+      signs and nearly cancel. }
+    class function SloppyAdd(const A, B: DoubleDouble): DoubleDouble; inline; static;
+    class function AccurateAdd(const A, B: DoubleDouble): DoubleDouble; inline; static;
+    class function SloppySubtract(const A, B: DoubleDouble): DoubleDouble; inline; static;
+    class function AccurateSubtract(const A, B: DoubleDouble): DoubleDouble; inline; static;
+    class function SloppyDivide(const A, B: DoubleDouble): DoubleDouble; inline; static;
+    class function AccurateDivide(const A, B: DoubleDouble): DoubleDouble; inline; static;
+  {$ENDIF}
+
     { Whether this value equals 0.
       This is a bit faster than comparing against 0. }
     function IsZero: Boolean; inline;
@@ -208,9 +261,10 @@ type
       Parameters:
         FormatSettings: (optional) the format settings to use (mostly for the
           decimal separator).
-        Format: (optional) output format. Either Fixed or Scientific.
-        Precision: (optional) number of digits in the output. Defaults to 31
-          (the maximum appropriate precision for a DoubleDouble value). }
+        Format: (optional) output format. Fixed, Scientific or Shortest.
+        Precision: (optional) number of digits after the decimal point.
+          Defaults to 31 (the maximum appropriate precision for a DoubleDouble
+          value). Ignored for the Shortest format. }
     function ToString(const Format: TMPFloatFormat = TMPFloatFormat.Scientific;
       const Precision: Integer = 31): String; overload; inline;
     function ToString(const FormatSettings: TFormatSettings;
@@ -223,9 +277,10 @@ type
         Value: the DoubleDouble value to convert.
         FormatSettings: (optional) the format settings to use (mostly for the
           decimal separator).
-        Format: (optional) output format. Either Fixed or Scientific.
-        Precision: (optional) number of digits in the output. Defaults to 31
-          (the maximum appropriate precision for a DoubleDouble value). }
+        Format: (optional) output format. Fixed, Scientific or Shortest.
+        Precision: (optional) number of digits after the decimal point.
+          Defaults to 31 (the maximum appropriate precision for a DoubleDouble
+          value). Ignored for the Shortest format. }
     class function ToString(const Value: DoubleDouble;
       const Format: TMPFloatFormat = TMPFloatFormat.Scientific;
       const Precision: Integer = 31): String; overload; inline; static;
@@ -365,9 +420,11 @@ type
     function GetExp: UInt64; inline;
     procedure SetExp(const Value: UInt64); inline;
     function GetSpecialType: TFloatSpecial; inline;
+  {$IF not Defined(MP_REBUILT_BINARIES)}
   private
     procedure ToDigits(const S: TArray<Char>; var Exponent: Integer;
       const Precision: Integer);
+  {$ENDIF}
   {$ENDREGION 'Internal Declarations'}
   public
     { Various ways to explicitly initialize a QuadDouble value.
@@ -377,7 +434,10 @@ type
         X0, X1, X2, X3: the four Double values that make up this QuadDouble.
         S: a string representation of the QuadDouble floating-point value.
           Uses the system-wide format settings if FormatSettings is not
-          specified.
+          specified. Each component is the nearest Double to the rest of the
+          exact value, so the result of ToString in the Shortest format
+          converts back to the same value. Also accepts INF and NAN. If S is
+          not a valid number, the value is set to NaN.
         FormatSettings: the format settings used for the string S }
     procedure Init; overload; inline;
     procedure Init(const Value: Double); overload; inline;
@@ -466,6 +526,19 @@ type
     class operator Divide(const A: DoubleDouble; const B: QuadDouble): QuadDouble; inline; static;
     class operator Divide(const A: QuadDouble; const B: DoubleDouble): QuadDouble; inline; static;
 
+  {$IF Defined(MP_REBUILT_BINARIES)}
+    { Sloppy and accurate versions of the arithmetic operators.
+      See DoubleDouble.SloppyAdd for details. }
+    class function SloppyAdd(const A, B: QuadDouble): QuadDouble; inline; static;
+    class function AccurateAdd(const A, B: QuadDouble): QuadDouble; inline; static;
+    class function SloppySubtract(const A, B: QuadDouble): QuadDouble; inline; static;
+    class function AccurateSubtract(const A, B: QuadDouble): QuadDouble; inline; static;
+    class function SloppyMultiply(const A, B: QuadDouble): QuadDouble; inline; static;
+    class function AccurateMultiply(const A, B: QuadDouble): QuadDouble; inline; static;
+    class function SloppyDivide(const A, B: QuadDouble): QuadDouble; inline; static;
+    class function AccurateDivide(const A, B: QuadDouble): QuadDouble; inline; static;
+  {$ENDIF}
+
     { Whether this value equals 0.
       This is a bit faster than comparing against 0. }
     function IsZero: Boolean; inline;
@@ -517,9 +590,10 @@ type
       Parameters:
         FormatSettings: (optional) the format settings to use (mostly for the
           decimal separator).
-        Format: (optional) output format. Either Fixed or Scientific.
-        Precision: (optional) number of digits in the output. Defaults to 62
-          (the maximum appropriate precision for a QuadDouble value). }
+        Format: (optional) output format. Fixed, Scientific or Shortest.
+        Precision: (optional) number of digits after the decimal point.
+          Defaults to 62 (the maximum appropriate precision for a QuadDouble
+          value). Ignored for the Shortest format. }
     function ToString(const Format: TMPFloatFormat = TMPFloatFormat.Scientific;
       const Precision: Integer = 62): String; overload; inline;
     function ToString(const FormatSettings: TFormatSettings;
@@ -532,9 +606,10 @@ type
         Value: the QuadDouble value to convert.
         FormatSettings: (optional) the format settings to use (mostly for the
           decimal separator).
-        Format: (optional) output format. Either Fixed or Scientific.
-        Precision: (optional) number of digits in the output. Defaults to 62
-          (the maximum appropriate precision for a QuadDouble value). }
+        Format: (optional) output format. Fixed, Scientific or Shortest.
+        Precision: (optional) number of digits after the decimal point.
+          Defaults to 62 (the maximum appropriate precision for a QuadDouble
+          value). Ignored for the Shortest format. }
     class function ToString(const Value: QuadDouble;
       const Format: TMPFloatFormat = TMPFloatFormat.Scientific;
       const Precision: Integer = 62): String; overload; inline; static;
@@ -677,6 +752,183 @@ type
                                         3.07507889307840487279e+259));
   end;
 
+{$IF Defined(MP_REBUILT_BINARIES)}
+type
+  { A structure-of-arrays view of a number of DoubleDouble values, as used by
+    the batch functions (AddN, MultiplyN etc.). Instead of an array of
+    DoubleDouble records, the high and low parts of the values are stored in
+    two separate arrays of Doubles, so that the batch functions can process
+    multiple values at once using SIMD instructions.
+    Value I consists of (X[0] + I)^ and (X[1] + I)^. }
+  TDoubleDoubleArrays = record
+  public
+    { Pointers to the first element of the high (X[0]) and low (X[1]) parts
+      of the values. }
+    X: array [0..1] of PDouble;
+
+    { The number of values }
+    Count: Integer;
+  public
+    { Initializes the view.
+
+      Parameters:
+        Hi: pointer to the first high part.
+        Lo: pointer to the first low part.
+        Count: the number of values. }
+    procedure Init(const Hi, Lo: PDouble; const Count: Integer); inline;
+
+    { Copies Count values from an array of DoubleDouble values into the
+      arrays (Load), or from the arrays to an array of DoubleDouble values
+      (Store). This uses SIMD instructions to separate or combine the high
+      and low parts, and is much faster than copying the values one by one.
+
+      Parameters:
+        Source/Target: pointer to the first DoubleDouble value. }
+    procedure Load(const Source: PDoubleDouble); inline;
+    procedure Store(const Target: PDoubleDouble); inline;
+  end;
+
+  { A structure-of-arrays view of a number of QuadDouble values, as used by
+    the batch functions (AddN, MultiplyN etc.). The 4 components of the
+    values are stored in 4 separate arrays of Doubles.
+    Value I consists of (X[0] + I)^, (X[1] + I)^, (X[2] + I)^ and (X[3] + I)^. }
+  TQuadDoubleArrays = record
+  public
+    { Pointers to the first element of each of the 4 components of the
+      values. }
+    X: array [0..3] of PDouble;
+
+    { The number of values }
+    Count: Integer;
+  public
+    { Initializes the view.
+
+      Parameters:
+        X0..X3: pointers to the first element of each component.
+        Count: the number of values. }
+    procedure Init(const X0, X1, X2, X3: PDouble; const Count: Integer); inline;
+
+    { Copies Count values from an array of QuadDouble values into the arrays
+      (Load), or from the arrays to an array of QuadDouble values (Store).
+      See TDoubleDoubleArrays.Load. }
+    procedure Load(const Source: PQuadDouble); inline;
+    procedure Store(const Target: PQuadDouble); inline;
+  end;
+
+type
+  { A vector of DoubleDouble values in structure-of-arrays layout, that can be
+    passed to the batch functions through its Arrays property. The high and
+    low parts are stored in two separate blocks of memory, each aligned to 64
+    bytes (the size of a cache line and of an AVX-512 register).
+
+    Unlike a dynamic array of DoubleDouble values, the values are not
+    initialized when the vector is created. }
+  TDoubleDoubleVector = class
+  private
+    FArrays: TDoubleDoubleArrays;
+    FMemory: Pointer;
+    FMappedSize: NativeInt;
+    FLargePages: Boolean;
+    function GetItem(const AIndex: Integer): DoubleDouble; inline;
+    procedure SetItem(const AIndex: Integer; const AValue: DoubleDouble); inline;
+  public
+    { Creates the vector.
+
+      Parameters:
+        ACount: the number of values.
+        ALargePages: (optional) whether to use large pages for the memory.
+          This reduces TLB misses for very large vectors. It is only supported
+          on Windows, and requires that the user has the "Lock pages in
+          memory" privilege. If large pages are not available, regular
+          memory is used. }
+    constructor Create(const ACount: Integer; const ALargePages: Boolean = False);
+
+    { Creates a vector from a stream or file written by SaveToStream or
+      SaveToFile (or by C code using C/c_file.h). Raises EReadError if the
+      data is invalid, contains QuadDouble values, or was written on a CPU
+      with a different byte order.
+
+      CreateFromFile maps the file into memory, so the values are not read
+      until they are used. The mapping is copy-on-write: changes to the
+      vector are not written to the file. Files in array-of-structures
+      layout are read into memory instead.
+
+      Parameters:
+        AStream: the stream to read from, at the start of the data.
+        AFilename: the file to map.
+        ALargePages: (optional) see Create. }
+    constructor CreateFromStream(const AStream: TStream;
+      const ALargePages: Boolean = False);
+    constructor CreateFromFile(const AFilename: String);
+    destructor Destroy; override;
+
+    { Writes the vector to a stream or file in a binary format that
+      CreateFromFile can map into memory (see C/c_file.h): a 64-byte header,
+      followed by the high and low parts, each padded to a multiple of 64
+      bytes. }
+    procedure SaveToStream(const AStream: TStream);
+    procedure SaveToFile(const AFilename: String);
+
+    { Copies Count values from an array of DoubleDouble values into the
+      vector (Load) or from the vector to an array of DoubleDouble values
+      (Store). See TDoubleDoubleArrays.Load. }
+    procedure Load(const ASource: PDoubleDouble); inline;
+    procedure Store(const ATarget: PDoubleDouble); inline;
+
+    { The number of values }
+    property Count: Integer read FArrays.Count;
+
+    { Structure-of-arrays view for use with the batch functions }
+    property Arrays: TDoubleDoubleArrays read FArrays;
+
+    { The values }
+    property Items[const AIndex: Integer]: DoubleDouble read GetItem write SetItem; default;
+  end;
+
+type
+  { A vector of QuadDouble values in structure-of-arrays layout. The 4
+    components are stored in 4 separate blocks of memory, each aligned to 64
+    bytes. See TDoubleDoubleVector. }
+  TQuadDoubleVector = class
+  private
+    FArrays: TQuadDoubleArrays;
+    FMemory: Pointer;
+    FMappedSize: NativeInt;
+    FLargePages: Boolean;
+    function GetItem(const AIndex: Integer): QuadDouble; inline;
+    procedure SetItem(const AIndex: Integer; const AValue: QuadDouble); inline;
+  public
+    { Creates the vector. See TDoubleDoubleVector.Create. }
+    constructor Create(const ACount: Integer; const ALargePages: Boolean = False);
+
+    { Creates a vector from a stream or file written by SaveToStream or
+      SaveToFile. See TDoubleDoubleVector.CreateFromStream. }
+    constructor CreateFromStream(const AStream: TStream;
+      const ALargePages: Boolean = False);
+    constructor CreateFromFile(const AFilename: String);
+    destructor Destroy; override;
+
+    { Writes the vector to a stream or file. See
+      TDoubleDoubleVector.SaveToStream. }
+    procedure SaveToStream(const AStream: TStream);
+    procedure SaveToFile(const AFilename: String);
+
+    { Copies Count values from an array of QuadDouble values into the vector
+      (Load) or from the vector to an array of QuadDouble values (Store). }
+    procedure Load(const ASource: PQuadDouble); inline;
+    procedure Store(const ATarget: PQuadDouble); inline;
+
+    { The number of values }
+    property Count: Integer read FArrays.Count;
+
+    { Structure-of-arrays view for use with the batch functions }
+    property Arrays: TQuadDoubleArrays read FArrays;
+
+    { The values }
+    property Items[const AIndex: Integer]: QuadDouble read GetItem write SetItem; default;
+  end;
+{$ENDIF}
+
 { The 4 basic aritmetic operators (+, -, *, /) that work on two Double values
   and return a DoubleDouble result.
 
@@ -877,6 +1129,40 @@ function NRoot(const A: QuadDouble; const N: Integer): QuadDouble; overload; inl
 function Ldexp(const A: DoubleDouble; const Exp: Integer): DoubleDouble; overload; inline;
 function Ldexp(const A: QuadDouble; Exp: Integer): QuadDouble; overload; inline;
 
+{$IF Defined(MP_REBUILT_BINARIES)}
+{ Evaluates a polynomial.
+
+  Parameters:
+    C: the coefficients of the polynomial, starting with the constant term.
+      So the polynomial is C[0] + C[1] * X + ... + C[N] * X^N, where N is
+      High(C).
+    X: the value to evaluate the polynomial at.
+
+  Returns:
+    The value of the polynomial at X.
+
+  The coefficients are evaluated in blocks of 8 using Estrin's scheme, so the
+  CPU can overlap more operations than with Horner's method. }
+function PolyEval(const C: array of DoubleDouble; const X: DoubleDouble): DoubleDouble; overload; inline;
+function PolyEval(const C: array of QuadDouble; const X: QuadDouble): QuadDouble; overload; inline;
+
+{ Finds a root of a polynomial using Newton's method.
+
+  Parameters:
+    C: the coefficients of the polynomial. See PolyEval.
+    X0: the initial approximation of the root.
+    MaxIterations: (optional) the maximum number of iterations.
+
+  Returns:
+    A value where the polynomial is less than the machine epsilon times the
+    largest coefficient, or NaN if no such value is found within
+    MaxIterations iterations. }
+function PolyRoot(const C: array of DoubleDouble; const X0: DoubleDouble;
+  const MaxIterations: Integer = 32): DoubleDouble; overload;
+function PolyRoot(const C: array of QuadDouble; const X0: QuadDouble;
+  const MaxIterations: Integer = 64): QuadDouble; overload;
+{$ENDIF}
+
 { Calculates the exponential of A (e^A).
 
   Parameters:
@@ -1541,7 +1827,621 @@ function InRange(const Value, Min, Max: QuadDouble): Boolean; overload; inline;
 function EnsureRange(const Value, Min, Max: DoubleDouble): DoubleDouble; overload;
 function EnsureRange(const Value, Min, Max: QuadDouble): QuadDouble; overload;
 
+{$IF Defined(MP_REBUILT_BINARIES)}
+{ Batch versions of the 4 basic arithmetic operators (+, -, *, /) on arrays of
+  DoubleDouble values. These are much faster than calling the operators for
+  each value separately.
+
+  Parameters:
+    A: first operands.
+    B: second operands.
+    Result: arrays that receive the results. This determines the number of
+      values that are processed. A and B must contain at least this many
+      values. Result may be the same as A or B.
+
+  The results are identical to those of the regular operators. }
+procedure AddN(const A, B, Result: TDoubleDoubleArrays); overload; inline;
+procedure SubtractN(const A, B, Result: TDoubleDoubleArrays); overload; inline;
+procedure MultiplyN(const A, B, Result: TDoubleDoubleArrays); overload; inline;
+procedure DivideN(const A, B, Result: TDoubleDoubleArrays); inline;
+
+{ Batch version of Sqr.
+
+  Parameters:
+    A: the values to square.
+    Result: arrays that receive the results. This determines the number of
+      values that are processed. A must contain at least this many values.
+      Result may be the same as A. }
+procedure SqrN(const A, Result: TDoubleDoubleArrays); overload; inline;
+
+{ Multiplies arrays of DoubleDouble values and adds the products to another
+  array (Result := Result + A * B).
+
+  Parameters:
+    A: first operands.
+    B: second operands.
+    Result: arrays with the values to add to, that also receive the results.
+      This determines the number of values that are processed. A and B must
+      contain at least this many values. }
+procedure MultiplyAddN(const A, B, Result: TDoubleDoubleArrays); overload; inline;
+
+{ Multiplies an array of DoubleDouble values by a single value and adds the
+  products to another array (Result := Result + A * B). This is the axpy
+  routine of the BLAS.
+
+  Parameters:
+    A: the value to multiply by.
+    B: the values to multiply.
+    Result: arrays with the values to add to, that also receive the results.
+      This determines the number of values that are processed. B must
+      contain at least this many values. }
+procedure MultiplyAddN(const A: DoubleDouble;
+  const B, Result: TDoubleDoubleArrays); overload; inline;
+
+{ Batch versions of the +, - and * operators on arrays of QuadDouble values.
+
+  Parameters:
+    A: first operands.
+    B: second operands.
+    Result: arrays that receive the results. This determines the number of
+      values that are processed. A and B must contain at least this many
+      values. Result may be the same as A or B.
+
+  The results are identical to those of the regular operators. }
+procedure AddN(const A, B, Result: TQuadDoubleArrays); overload; inline;
+procedure SubtractN(const A, B, Result: TQuadDoubleArrays); overload; inline;
+procedure MultiplyN(const A, B, Result: TQuadDoubleArrays); overload; inline;
+
+{ Batch version of Sqr for QuadDouble values. }
+procedure SqrN(const A, Result: TQuadDoubleArrays); overload; inline;
+
+{ Multiplies arrays of QuadDouble values and adds the products to another
+  array (Result := Result + A * B). }
+procedure MultiplyAddN(const A, B, Result: TQuadDoubleArrays); overload; inline;
+
+{ Multiplies an array of QuadDouble values by a single value and adds the
+  products to another array (Result := Result + A * B). }
+procedure MultiplyAddN(const A: QuadDouble;
+  const B, Result: TQuadDoubleArrays); overload; inline;
+
+{ Batch versions of Exp and Ln.
+
+  Parameters:
+    A: the input values.
+    Result: arrays that receive the results. This determines the number of
+      values that are processed. A must contain at least this many values.
+      Result may be the same as A.
+
+  These evaluate multiple values at once using SIMD instructions. They give
+  exactly the same results as Exp and Ln. }
+procedure ExpN(const A, Result: TDoubleDoubleArrays); overload; inline;
+procedure ExpN(const A, Result: TQuadDoubleArrays); overload; inline;
+procedure LnN(const A, Result: TDoubleDoubleArrays); overload; inline;
+procedure LnN(const A, Result: TQuadDoubleArrays); overload; inline;
+
+{ Batch version of SinCos.
+
+  Parameters:
+    A: the angles in radians.
+    SinA: arrays that receive the sines. This determines the number of values
+      that are processed. A and CosA must contain at least this many values.
+    CosA: arrays that receive the cosines.
+
+  This always uses the maximum number of series terms that SinCos uses. As a
+  result, it is at least as accurate as SinCos, but may differ from it in the
+  last bit. }
+procedure SinCosN(const A, SinA, CosA: TDoubleDoubleArrays); overload; inline;
+procedure SinCosN(const A, SinA, CosA: TQuadDoubleArrays); overload; inline;
+
+{ Batch version of ArcTan2.
+
+  Parameters:
+    Y: the Y-coordinates.
+    X: the X-coordinates.
+    Result: arrays that receive the angles in radians. This determines the
+      number of values that are processed. Y and X must contain at least this
+      many values. Result may be the same as Y or X.
+
+  This gives exactly the same results as ArcTan2. }
+procedure ArcTan2N(const Y, X, Result: TDoubleDoubleArrays); overload; inline;
+procedure ArcTan2N(const Y, X, Result: TQuadDoubleArrays); overload; inline;
+
+{ Batch versions of PolyEval, that evaluate one polynomial at many values, or
+  many polynomials at one value.
+
+  Parameters:
+    C: the coefficients of the polynomial (see PolyEval), or of the
+      polynomials: element J of C[K] is coefficient K of polynomial J.
+    X: the values or value to evaluate the polynomial(s) at.
+    Result: arrays that receive the results. This determines the number of
+      values (or polynomials) that are processed. X (or the arrays in C)
+      must contain at least this many values. Result may be the same as X.
+
+  These evaluate multiple values at once using SIMD instructions. The results
+  are identical to those of PolyEval. }
+procedure PolyEvalN(const C: array of DoubleDouble;
+  const X, Result: TDoubleDoubleArrays); overload; inline;
+procedure PolyEvalN(const C: array of TDoubleDoubleArrays;
+  const X: DoubleDouble; const Result: TDoubleDoubleArrays); overload; inline;
+procedure PolyEvalN(const C: array of QuadDouble;
+  const X, Result: TQuadDoubleArrays); overload; inline;
+procedure PolyEvalN(const C: array of TQuadDoubleArrays;
+  const X: QuadDouble; const Result: TQuadDoubleArrays); overload; inline;
+
+{ Compensated sums and dot products of arrays of Double values, or (DotN
+  only) of TDoubleDoubleArrays and TQuadDoubleArrays views.
+
+  Parameters:
+    A: the values to add, or the first operands.
+    B: the second operands. This must contain at least as many values as A.
+    Result: receives the sum or dot product.
+
+  These add the values using SIMD instructions and accumulate the rounding
+  errors separately, which is much faster than adding the values to a
+  DoubleDouble or QuadDouble one by one, and about as accurate. Large arrays
+  are split into parts of a fixed size that are processed on all CPU cores.
+  The results of the parts are added in a fixed order, so the result does
+  not depend on the number of cores. The QuadDouble dot product adds the
+  products in QuadDouble arithmetic, and is as accurate as adding them one by
+  one. }
+procedure SumN(const A: array of Double; out Result: DoubleDouble); overload;
+procedure SumN(const A: array of Double; out Result: QuadDouble); overload;
+procedure DotN(const A, B: array of Double; out Result: DoubleDouble); overload;
+procedure DotN(const A, B: TDoubleDoubleArrays; out Result: DoubleDouble); overload;
+procedure DotN(const A, B: TQuadDoubleArrays; out Result: QuadDouble); overload;
+
+type
+  { Accumulates the exact sum of Double values, products and squares.
+
+    The values are added to a fixed-point integer representation that covers
+    the whole range of the Double type, without any rounding. So the sum does
+    not depend on the order in which the values are added, and accumulators
+    that were filled by different threads can be merged in any order. The sum
+    is only rounded once, by ToDoubleDouble or ToQuadDouble, to the nearest
+    DoubleDouble or QuadDouble value.
+
+    This is slower than SumN and DotN, but the results are reproducible
+    between runs and machines, whatever the number of CPU cores.
+
+    Corresponds to qd_repro in C/c_repro.h. }
+  TExactSum = record
+  private
+    FLimbs: array [0..67] of Int64;
+    FSpecial: Integer;
+    FReserved: Integer;
+  public
+    { Sets the sum to zero. }
+    procedure Init; inline;
+
+    { Adds the values in A (Add), the products A[I] * B[I] (AddProducts) or
+      the squares A[I] * A[I] (AddSquares) to the sum. For AddProducts, B
+      must contain at least as many values as A. Products and squares are
+      exact, unless they underflow (that is, are smaller than about 1e-292). }
+    procedure Add(const A: array of Double); inline;
+    procedure AddProducts(const A, B: array of Double); inline;
+    procedure AddSquares(const A: array of Double); inline;
+
+    { Adds the sum of another accumulator to this sum. }
+    procedure Merge(const Other: TExactSum); inline;
+
+    { Rounds the sum to a DoubleDouble or QuadDouble. The result is NaN if a
+      NaN (or both infinities) was added, and infinite if an infinity was
+      added or the sum is too large. }
+    function ToDoubleDouble: DoubleDouble; inline;
+    function ToQuadDouble: QuadDouble; inline;
+  end;
+
+{ Reproducible sums, dot products and norms (the square root of the sum of
+  squares) of arrays of Double values.
+
+  Parameters:
+    A: the values to add, or the first operands.
+    B: the second operands. This must contain at least as many values as A.
+    Result: receives the sum, dot product or norm.
+
+  These use TExactSum, so the sum or dot product is the exact result rounded
+  to the nearest DoubleDouble or QuadDouble. Like SumN and DotN, large arrays
+  are split into parts that are processed on all CPU cores. Since the parts
+  are added exactly, the results are the same for any number of cores, and
+  for any order of the values. }
+procedure ExactSumN(const A: array of Double; out Result: DoubleDouble); overload;
+procedure ExactSumN(const A: array of Double; out Result: QuadDouble); overload;
+procedure ExactDotN(const A, B: array of Double; out Result: DoubleDouble); overload;
+procedure ExactDotN(const A, B: array of Double; out Result: QuadDouble); overload;
+procedure ExactNormN(const A: array of Double; out Result: DoubleDouble); overload;
+procedure ExactNormN(const A: array of Double; out Result: QuadDouble); overload;
+
+type
+  { A view of a matrix of DoubleDouble values, as used by MultiplyMatrixN
+    and MultiplyMatrixVectorN. Like in TDoubleDoubleArrays, the high and low
+    parts are stored in two separate arrays of Doubles. The element in row I
+    and column J (starting at 0) consists of
+    (X[0] + I * RowStride + J * ColStride)^ and
+    (X[1] + I * RowStride + J * ColStride)^.
+
+    Corresponds to dd_matrix in C/c_blas.h. }
+  TDoubleDoubleMatrix = record
+  public
+    { Pointers to the high (X[0]) and low (X[1]) part of the element in the
+      first row and column. }
+    X: array [0..1] of PDouble;
+
+    { The number of rows and columns }
+    Rows: Integer;
+    Cols: Integer;
+
+    { The distance (in Doubles) between the elements of two consecutive rows
+      and columns. A matrix that is stored row by row has a RowStride of
+      Cols and a ColStride of 1. }
+    RowStride: Integer;
+    ColStride: Integer;
+  public
+    { Initializes a view of a matrix that is stored row by row.
+
+      Parameters:
+        Arrays: the elements of the matrix, row by row. This must contain at
+          least Rows * Cols values.
+        Rows: the number of rows.
+        Cols: the number of columns. }
+    procedure Init(const Arrays: TDoubleDoubleArrays; const Rows,
+      Cols: Integer); inline;
+
+    { Returns a view of the transpose of the matrix. The elements are not
+      copied. }
+    function Transpose: TDoubleDoubleMatrix; inline;
+  end;
+
+  { A view of a matrix of QuadDouble values. The element in row I and column
+    J consists of (X[K] + I * RowStride + J * ColStride)^ with K = 0..3.
+    See TDoubleDoubleMatrix.
+
+    Corresponds to qd_matrix in C/c_blas.h. }
+  TQuadDoubleMatrix = record
+  public
+    { Pointers to each of the 4 components of the element in the first row
+      and column. }
+    X: array [0..3] of PDouble;
+
+    { The number of rows and columns }
+    Rows: Integer;
+    Cols: Integer;
+
+    { The distance (in Doubles) between the elements of two consecutive rows
+      and columns. }
+    RowStride: Integer;
+    ColStride: Integer;
+  public
+    { Initializes a view of a matrix that is stored row by row. See
+      TDoubleDoubleMatrix.Init. }
+    procedure Init(const Arrays: TQuadDoubleArrays; const Rows,
+      Cols: Integer); inline;
+
+    { Returns a view of the transpose of the matrix. The elements are not
+      copied. }
+    function Transpose: TQuadDoubleMatrix; inline;
+  end;
+
+{ Matrix products, like the gemm and gemv routines of the BLAS:
+  C := Alpha * A * B + Beta * C (MultiplyMatrixN) and
+  Y := Alpha * A * X + Beta * Y (MultiplyMatrixVectorN).
+
+  Parameters:
+    Alpha: the value to multiply the product by.
+    A: a matrix of M rows and K columns.
+    B: a matrix of K rows and N columns.
+    X: a vector of at least K values.
+    Beta: the value to multiply C or Y by before adding the product. If this
+      is zero, C or Y is not read (so it does not have to be initialized).
+    C: a matrix of M rows and N columns that receives the result.
+    Y: a vector of at least M values that receives the result.
+
+  C and Y must not overlap A, B or X. Use TDoubleDoubleMatrix.Transpose to
+  multiply by the transpose of a matrix.
+
+  The products are computed in native code, in square tiles of C. For each
+  tile, the rows of A and columns of B are copied to a buffer in the order
+  in which SIMD instructions process them. The DoubleDouble versions add the
+  products with a compensated sum that is only normalized every 16 products,
+  which is several times faster than using the DoubleDouble operators and
+  about as accurate. The QuadDouble versions use QuadDouble arithmetic.
+
+  The tiles are divided over a number of tasks (one per CPU core). Every
+  element is computed in the same way whatever tile it is in, so the result
+  does not depend on the number of cores. }
+procedure MultiplyMatrixN(const Alpha: DoubleDouble; const A,
+  B: TDoubleDoubleMatrix; const Beta: DoubleDouble;
+  const C: TDoubleDoubleMatrix); overload;
+procedure MultiplyMatrixN(const Alpha: QuadDouble; const A,
+  B: TQuadDoubleMatrix; const Beta: QuadDouble;
+  const C: TQuadDoubleMatrix); overload;
+procedure MultiplyMatrixVectorN(const Alpha: DoubleDouble;
+  const A: TDoubleDoubleMatrix; const X: TDoubleDoubleArrays;
+  const Beta: DoubleDouble; const Y: TDoubleDoubleArrays); overload;
+procedure MultiplyMatrixVectorN(const Alpha: QuadDouble;
+  const A: TQuadDoubleMatrix; const X: TQuadDoubleArrays;
+  const Beta: QuadDouble; const Y: TQuadDoubleArrays); overload;
+
+type
+  { Result of SolveMatrixN }
+  TMatrixSolveResult = (
+    { The solution was computed with a factorization of A in Double
+      precision, and refined to full DoubleDouble or QuadDouble accuracy. }
+    Refined,
+
+    { A is too ill-conditioned to refine a solution using Double precision,
+      so the solution was computed with a factorization of A in DoubleDouble
+      or QuadDouble precision. }
+    Factored,
+
+    { A is singular. The solution is undefined. }
+    Singular);
+
+{ Solves a system of linear equations A * X = B, like the gesv routine of
+  LAPACK.
+
+  Parameters:
+    A: a matrix of N rows and N columns.
+    B: a matrix of N rows and M columns (the right-hand sides).
+    X: a matrix of N rows and M columns that receives the solution. This
+      must not overlap A or B.
+
+  Returns:
+    How the solution was computed, or whether A is singular.
+
+  Most of the work of solving a system is the LU factorization of A. This
+  is done in Double precision, which is much faster than factoring in
+  DoubleDouble or QuadDouble precision. The solution is then refined: each
+  step computes the residual R = B - A * X like MultiplyMatrixN, solves a
+  correction from A * D = R with the Double factors, and adds it to X, until
+  the residual is as small as that of a solution computed in full
+  precision. This usually takes 2 steps for DoubleDouble and 4 for
+  QuadDouble. If A is too ill-conditioned for Double precision (that is,
+  if the corrections do not get smaller), A is factored in DoubleDouble or
+  QuadDouble precision instead.
+
+  Both factorizations are blocked: each step factors a few columns, and then
+  updates the rest of the matrix with a matrix product, which is divided
+  over a number of tasks (one per CPU core) like MultiplyMatrixN. The
+  result does not depend on the number of cores. }
+function SolveMatrixN(const A, B,
+  X: TDoubleDoubleMatrix): TMatrixSolveResult; overload;
+function SolveMatrixN(const A, B,
+  X: TQuadDoubleMatrix): TMatrixSolveResult; overload;
+
+type
+  { Precision used by RenderMandelbrot }
+  TMandelbrotPrecision = (
+    { Iterate in Double precision }
+    Double,
+
+    { Iterate in DoubleDouble precision }
+    DoubleDouble,
+
+    { Iterate in QuadDouble precision }
+    QuadDouble,
+
+    { Iterate a single reference orbit (at the center of the image) in
+      QuadDouble precision, and the difference of each pixel to this orbit
+      in Double precision. This is about as fast as Double, at
+      magnifications that require QuadDouble precision. }
+    Perturbation);
+
+{ Renders the Mandelbrot set using all CPU cores.
+
+  Parameters:
+    APrecision: the precision to use for the iterations.
+    ACenterRe, ACenterIm: the point in the center of the image.
+    AStep: the distance between two pixels.
+    AWidth, AHeight: the size of the image in pixels.
+    AMaxIterations: maximum number of iterations per pixel.
+    AOutput: pointer to AWidth * AHeight Integers that receive the number of
+      iterations of each pixel (row by row), or -1 if the pixel did not
+      escape within AMaxIterations iterations.
+    ACancel: (optional) pointer to a flag that can be set to a nonzero value
+      from another thread to stop rendering. The output is incomplete in that
+      case.
+
+  The iterations are Z := Z * Z + C, starting with Z = C, until the squared
+  magnitude of Z exceeds 4. The pixel in column Col and row Row corresponds
+  to C = (ACenterRe + (Col - AWidth / 2) * AStep) +
+  (ACenterIm + (Row - AHeight / 2) * AStep) * i.
+
+  The iterations are performed in native code, using SIMD instructions to
+  iterate multiple pixels at once. CPUCount - 1 tasks and the calling thread
+  render the rows. Each of them claims the next row with an atomic next-row
+  counter shared by all of them.
+
+  With TMandelbrotPrecision.Perturbation, pixels whose difference to the
+  reference orbit loses its precision (glitches) are automatically rebased to
+  the start of the orbit. This requires a temporary buffer of
+  2 * (AMaxIterations + 2) Doubles. }
+procedure RenderMandelbrot(const APrecision: TMandelbrotPrecision;
+  const ACenterRe, ACenterIm: QuadDouble; const AStep: Double;
+  const AWidth, AHeight, AMaxIterations: Integer; const AOutput: PInteger;
+  const ACancel: PInteger = nil);
+
+{ Reads a table of DoubleDouble or QuadDouble values from text (such as a CSV
+  file) using all CPU cores.
+
+  Parameters:
+    AText: pointer to the text, for example a memory-mapped file. The text
+      does not need to be null-terminated.
+    ASize: the length of the text in bytes.
+    AColumns: is set to a vector with the values of each column. You must
+      free these vectors.
+    ASeparator: (optional) the character between the columns.
+
+  Returns:
+    The number of fields that are missing or are not a valid number. These
+    values are set to NaN.
+
+  Each row is a line of text. Empty lines are skipped. The number of columns
+  is the number of fields in the first row. The values must use a '.' as
+  decimal separator, and are converted like DoubleDouble.Init and
+  QuadDouble.Init.
+
+  The text is split into parts at line boundaries. These are converted in
+  native code by a number of tasks (one per CPU core), in two passes: one to
+  count the rows, and one to convert them. }
+function ReadText(const AText: Pointer; const ASize: NativeInt;
+  out AColumns: TArray<TDoubleDoubleVector>;
+  const ASeparator: AnsiChar = ','): Integer; overload;
+function ReadText(const AText: Pointer; const ASize: NativeInt;
+  out AColumns: TArray<TQuadDoubleVector>;
+  const ASeparator: AnsiChar = ','): Integer; overload;
+
+{ Writes a table of DoubleDouble or QuadDouble values to text (such as a CSV
+  file) using all CPU cores.
+
+  Parameters:
+    AColumns: the values of each column. All columns must have the same
+      number of values (rows).
+    AFormat: (optional) the format of the values. See DoubleDouble.ToString.
+    APrecision: (optional) the number of digits after the decimal point. Not
+      used for the Shortest format.
+    ASeparator: (optional) the character between the columns.
+
+  Returns:
+    The text, with a line break (#10) after each row. The values use a '.'
+    as decimal separator, and 'nan', 'inf' and '-inf' for special values.
+
+  The rows are split into parts. These are converted in native code by a
+  number of tasks (one per CPU core), in two passes: one to measure the
+  text, and one to convert the values. }
+function WriteText(const AColumns: array of TDoubleDoubleArrays;
+  const AFormat: TMPFloatFormat = TMPFloatFormat.Shortest;
+  const APrecision: Integer = 0;
+  const ASeparator: AnsiChar = ','): TBytes; overload;
+function WriteText(const AColumns: array of TQuadDoubleArrays;
+  const AFormat: TMPFloatFormat = TMPFloatFormat.Shortest;
+  const APrecision: Integer = 0;
+  const ASeparator: AnsiChar = ','): TBytes; overload;
+{$ENDIF}
+
 {$REGION 'Internal Declarations'}
+{$IF Defined(MP_REBUILT_BINARIES)}
+type
+  { Corresponds to mp_tile in C/c_mp.h }
+  _TMandelbrotTile = record
+    CenterRe: QuadDouble;
+    CenterIm: QuadDouble;
+    Step: Double;
+    Orbit: PDouble;
+    Precision: Integer;
+    Width: Integer;
+    Height: Integer;
+    MaxIterations: Integer;
+    NextRow: Integer;
+    OrbitLen: Integer;
+  end;
+
+  { Corresponds to dd_gemm and dd_gemv in C/c_blas.h. For dd_gemv, B and C
+    are the vectors x and y. }
+  _TDDMatrixProduct = record
+    A: TDoubleDoubleMatrix;
+    B: TDoubleDoubleMatrix;
+    C: TDoubleDoubleMatrix;
+    Alpha: DoubleDouble;
+    Beta: DoubleDouble;
+    NextTile: Integer;
+  end;
+
+  { Corresponds to qd_gemm and qd_gemv in C/c_blas.h }
+  _TQDMatrixProduct = record
+    A: TQuadDoubleMatrix;
+    B: TQuadDoubleMatrix;
+    C: TQuadDoubleMatrix;
+    Alpha: QuadDouble;
+    Beta: QuadDouble;
+    NextTile: Integer;
+  end;
+
+  { Corresponds to dd_gesv in C/c_solve.h }
+  _TDDSolver = record
+    A: TDoubleDoubleMatrix;
+    B: TDoubleDoubleMatrix;
+    X: TDoubleDoubleMatrix;
+    Work: PDouble;
+    Factors: PDouble;
+    Pivots: PInteger;
+    MaxIterations: Integer;
+    Iterations: Integer;
+    Status: Integer;
+    Tiles: Integer;
+    Stage: Integer;
+    Block: Integer;
+    NextTile: Integer;
+    ANorm: Double;
+    DNorm: Double;
+    Gemm: _TDDMatrixProduct;
+    Gemv: _TDDMatrixProduct;
+  end;
+
+  { Corresponds to qd_gesv in C/c_solve.h }
+  _TQDSolver = record
+    A: TQuadDoubleMatrix;
+    B: TQuadDoubleMatrix;
+    X: TQuadDoubleMatrix;
+    Work: PDouble;
+    Factors: PDouble;
+    Pivots: PInteger;
+    MaxIterations: Integer;
+    Iterations: Integer;
+    Status: Integer;
+    Tiles: Integer;
+    Stage: Integer;
+    Block: Integer;
+    NextTile: Integer;
+    ANorm: Double;
+    DNorm: Double;
+    Gemm: _TQDMatrixProduct;
+    Gemv: _TQDMatrixProduct;
+  end;
+
+  { Corresponds to qd_string in C/c_dd.h }
+  _TDecimalString = record
+    Buffer: PByte;
+    Size: Integer;
+    Format: Integer;
+    Precision: Integer;
+  end;
+
+type
+  { Corresponds to qd_text in C/c_dd.h }
+  _TText = record
+    Size: Int64;
+    Text: PByte;
+    X: Pointer;
+    Columns: Integer;
+    Rows: Integer;
+    Separator: Integer;
+    Format: Integer;
+    Precision: Integer;
+    Errors: Integer;
+    NextChunk: Integer;
+    DoneChunks: Integer;
+    Chunk: array [0..256] of Int64;
+  end;
+
+  { One pass of the text functions in C/c_dd.h and C/c_qd.h }
+  _TTextPass = procedure(var Text: _TText);
+
+type
+  { Corresponds to qd_file_header in C/c_file.h }
+  _TFileHeader = record
+    Magic: array [0..7] of Byte;
+    Version: Integer;
+    ByteOrder: Integer;
+    Components: Integer;
+    Layout: Integer;
+    Accurate: Integer;
+    HeaderSize: Integer;
+    Count: Int64;
+    Stride: Int64;
+    Reserved: array [0..15] of Byte;
+  end;
+{$ENDIF}
+
 {$IF Defined(WIN32)}
   const _PU = '_';
   {$IF Defined(MP_ACCURATE)}
@@ -1592,6 +2492,14 @@ function EnsureRange(const Value, Min, Max: QuadDouble): QuadDouble; overload;
   {$ELSE}
     const _LIB_MP = 'libmp_android64.a';
   {$ENDIF}
+{$ELSEIF Defined(LINUX64)}
+  {$DEFINE USE_LIB}
+  const _PU = '';
+  {$IF Defined(MP_ACCURATE)}
+    const _LIB_MP = 'libmp-accurate_linux64.a';
+  {$ELSE}
+    const _LIB_MP = 'libmp_linux64.a';
+  {$ENDIF}
 {$ELSE}
   {$MESSAGE Error 'Unsupported CPU'}
 {$ENDIF}
@@ -1643,6 +2551,23 @@ procedure _qd_div_qd_dd(const A: QuadDouble; const B: DoubleDouble; out Res: Qua
 procedure _qd_div_dd_qd(const A: DoubleDouble; const B: QuadDouble; out Res: QuadDouble); overload; external {$IFDEF USE_LIB}_LIB_MP{$ENDIF} name _PU + 'c_qd_div_dd_qd';
 procedure _qd_div(const A, B: QuadDouble; out Res: QuadDouble); overload; external {$IFDEF USE_LIB}_LIB_MP{$ENDIF} name _PU + 'c_qd_div';
 
+{$IF Defined(MP_REBUILT_BINARIES)}
+procedure _dd_add_sloppy(const A, B: DoubleDouble; out Res: DoubleDouble); external {$IFDEF USE_LIB}_LIB_MP{$ENDIF} name _PU + 'c_dd_add_sloppy';
+procedure _dd_add_accurate(const A, B: DoubleDouble; out Res: DoubleDouble); external {$IFDEF USE_LIB}_LIB_MP{$ENDIF} name _PU + 'c_dd_add_accurate';
+procedure _dd_sub_sloppy(const A, B: DoubleDouble; out Res: DoubleDouble); external {$IFDEF USE_LIB}_LIB_MP{$ENDIF} name _PU + 'c_dd_sub_sloppy';
+procedure _dd_sub_accurate(const A, B: DoubleDouble; out Res: DoubleDouble); external {$IFDEF USE_LIB}_LIB_MP{$ENDIF} name _PU + 'c_dd_sub_accurate';
+procedure _dd_div_sloppy(const A, B: DoubleDouble; out Res: DoubleDouble); external {$IFDEF USE_LIB}_LIB_MP{$ENDIF} name _PU + 'c_dd_div_sloppy';
+procedure _dd_div_accurate(const A, B: DoubleDouble; out Res: DoubleDouble); external {$IFDEF USE_LIB}_LIB_MP{$ENDIF} name _PU + 'c_dd_div_accurate';
+procedure _qd_add_sloppy(const A, B: QuadDouble; out Res: QuadDouble); external {$IFDEF USE_LIB}_LIB_MP{$ENDIF} name _PU + 'c_qd_add_sloppy';
+procedure _qd_add_accurate(const A, B: QuadDouble; out Res: QuadDouble); external {$IFDEF USE_LIB}_LIB_MP{$ENDIF} name _PU + 'c_qd_add_accurate';
+procedure _qd_sub_sloppy(const A, B: QuadDouble; out Res: QuadDouble); external {$IFDEF USE_LIB}_LIB_MP{$ENDIF} name _PU + 'c_qd_sub_sloppy';
+procedure _qd_sub_accurate(const A, B: QuadDouble; out Res: QuadDouble); external {$IFDEF USE_LIB}_LIB_MP{$ENDIF} name _PU + 'c_qd_sub_accurate';
+procedure _qd_mul_sloppy(const A, B: QuadDouble; out Res: QuadDouble); external {$IFDEF USE_LIB}_LIB_MP{$ENDIF} name _PU + 'c_qd_mul_sloppy';
+procedure _qd_mul_accurate(const A, B: QuadDouble; out Res: QuadDouble); external {$IFDEF USE_LIB}_LIB_MP{$ENDIF} name _PU + 'c_qd_mul_accurate';
+procedure _qd_div_sloppy(const A, B: QuadDouble; out Res: QuadDouble); external {$IFDEF USE_LIB}_LIB_MP{$ENDIF} name _PU + 'c_qd_div_sloppy';
+procedure _qd_div_accurate(const A, B: QuadDouble; out Res: QuadDouble); external {$IFDEF USE_LIB}_LIB_MP{$ENDIF} name _PU + 'c_qd_div_accurate';
+{$ENDIF}
+
 //function _dd_comp(const A, B: DoubleDouble): Integer; overload; external {$IFDEF USE_LIB}_LIB_MP{$ENDIF} name _PU + 'c_dd_comp';
 //function _dd_comp_dd_d(const A: DoubleDouble; const B: PDouble): Integer; overload; external {$IFDEF USE_LIB}_LIB_MP{$ENDIF} name _PU + 'c_dd_comp_dd_d';
 //function _dd_comp_d_dd(const A: PDouble; const B: DoubleDouble): Integer; overload; external {$IFDEF USE_LIB}_LIB_MP{$ENDIF} name _PU + 'c_dd_comp_d_dd';
@@ -1740,6 +2665,12 @@ procedure _qd_cosh(const A: QuadDouble; out Res: QuadDouble); overload; external
 
 procedure _dd_sincosh(const A: DoubleDouble; out S, C: DoubleDouble); overload; external {$IFDEF USE_LIB}_LIB_MP{$ENDIF} name _PU + 'c_dd_sincosh';
 procedure _qd_sincosh(const A: QuadDouble; out S, C: QuadDouble); overload; external {$IFDEF USE_LIB}_LIB_MP{$ENDIF} name _PU + 'c_qd_sincosh';
+{$IF Defined(MP_REBUILT_BINARIES)}
+procedure _dd_polyeval(const C: PDoubleDouble; const N: Integer; const A: DoubleDouble; out Res: DoubleDouble); external {$IFDEF USE_LIB}_LIB_MP{$ENDIF} name _PU + 'c_dd_polyeval';
+procedure _qd_polyeval(const C: PQuadDouble; const N: Integer; const A: QuadDouble; out Res: QuadDouble); external {$IFDEF USE_LIB}_LIB_MP{$ENDIF} name _PU + 'c_qd_polyeval';
+procedure _dd_polyroot(const C: PDoubleDouble; const N: Integer; var A: DoubleDouble; const MaxIter: Integer); external {$IFDEF USE_LIB}_LIB_MP{$ENDIF} name _PU + 'c_dd_polyroot';
+procedure _qd_polyroot(const C: PQuadDouble; const N: Integer; var A: QuadDouble; const MaxIter: Integer); external {$IFDEF USE_LIB}_LIB_MP{$ENDIF} name _PU + 'c_qd_polyroot';
+{$ENDIF}
 
 procedure _dd_tanh(const A: DoubleDouble; out Res: DoubleDouble); overload; external {$IFDEF USE_LIB}_LIB_MP{$ENDIF} name _PU + 'c_dd_tanh';
 procedure _qd_tanh(const A: QuadDouble; out Res: QuadDouble); overload; external {$IFDEF USE_LIB}_LIB_MP{$ENDIF} name _PU + 'c_qd_tanh';
@@ -1753,6 +2684,74 @@ procedure _qd_acosh(const A: QuadDouble; out Res: QuadDouble); overload; externa
 procedure _dd_atanh(const A: DoubleDouble; out Res: DoubleDouble); overload; external {$IFDEF USE_LIB}_LIB_MP{$ENDIF} name _PU + 'c_dd_atanh';
 procedure _qd_atanh(const A: QuadDouble; out Res: QuadDouble); overload; external {$IFDEF USE_LIB}_LIB_MP{$ENDIF} name _PU + 'c_qd_atanh';
 
+{$IF Defined(MP_REBUILT_BINARIES)}
+procedure _dd_add_n(const A, B, Res: TDoubleDoubleArrays); external {$IFDEF USE_LIB}_LIB_MP{$ENDIF} name _PU + 'c_dd_add_n';
+procedure _dd_sub_n(const A, B, Res: TDoubleDoubleArrays); external {$IFDEF USE_LIB}_LIB_MP{$ENDIF} name _PU + 'c_dd_sub_n';
+procedure _dd_mul_n(const A, B, Res: TDoubleDoubleArrays); external {$IFDEF USE_LIB}_LIB_MP{$ENDIF} name _PU + 'c_dd_mul_n';
+procedure _dd_div_n(const A, B, Res: TDoubleDoubleArrays); external {$IFDEF USE_LIB}_LIB_MP{$ENDIF} name _PU + 'c_dd_div_n';
+procedure _dd_fma_n(const A, B, Res: TDoubleDoubleArrays); external {$IFDEF USE_LIB}_LIB_MP{$ENDIF} name _PU + 'c_dd_fma_n';
+procedure _dd_axpy(const A: DoubleDouble; const B, Res: TDoubleDoubleArrays); external {$IFDEF USE_LIB}_LIB_MP{$ENDIF} name _PU + 'c_dd_axpy';
+procedure _dd_sqr_n(const A, Res: TDoubleDoubleArrays); external {$IFDEF USE_LIB}_LIB_MP{$ENDIF} name _PU + 'c_dd_sqr_n';
+procedure _qd_add_n(const A, B, Res: TQuadDoubleArrays); external {$IFDEF USE_LIB}_LIB_MP{$ENDIF} name _PU + 'c_qd_add_n';
+procedure _qd_sub_n(const A, B, Res: TQuadDoubleArrays); external {$IFDEF USE_LIB}_LIB_MP{$ENDIF} name _PU + 'c_qd_sub_n';
+procedure _qd_mul_n(const A, B, Res: TQuadDoubleArrays); external {$IFDEF USE_LIB}_LIB_MP{$ENDIF} name _PU + 'c_qd_mul_n';
+procedure _qd_fma_n(const A, B, Res: TQuadDoubleArrays); external {$IFDEF USE_LIB}_LIB_MP{$ENDIF} name _PU + 'c_qd_fma_n';
+procedure _qd_axpy(const A: QuadDouble; const B, Res: TQuadDoubleArrays); external {$IFDEF USE_LIB}_LIB_MP{$ENDIF} name _PU + 'c_qd_axpy';
+procedure _qd_sqr_n(const A, Res: TQuadDoubleArrays); external {$IFDEF USE_LIB}_LIB_MP{$ENDIF} name _PU + 'c_qd_sqr_n';
+procedure _dd_exp_n(const A, Res: TDoubleDoubleArrays); external {$IFDEF USE_LIB}_LIB_MP{$ENDIF} name _PU + 'c_dd_exp_n';
+procedure _dd_log_n(const A, Res: TDoubleDoubleArrays); external {$IFDEF USE_LIB}_LIB_MP{$ENDIF} name _PU + 'c_dd_log_n';
+procedure _dd_sincos_n(const A, S, C: TDoubleDoubleArrays); external {$IFDEF USE_LIB}_LIB_MP{$ENDIF} name _PU + 'c_dd_sincos_n';
+procedure _qd_exp_n(const A, Res: TQuadDoubleArrays); external {$IFDEF USE_LIB}_LIB_MP{$ENDIF} name _PU + 'c_qd_exp_n';
+procedure _qd_log_n(const A, Res: TQuadDoubleArrays); external {$IFDEF USE_LIB}_LIB_MP{$ENDIF} name _PU + 'c_qd_log_n';
+procedure _qd_sincos_n(const A, S, C: TQuadDoubleArrays); external {$IFDEF USE_LIB}_LIB_MP{$ENDIF} name _PU + 'c_qd_sincos_n';
+procedure _dd_atan2_n(const Y, X, Res: TDoubleDoubleArrays); external {$IFDEF USE_LIB}_LIB_MP{$ENDIF} name _PU + 'c_dd_atan2_n';
+procedure _qd_atan2_n(const Y, X, Res: TQuadDoubleArrays); external {$IFDEF USE_LIB}_LIB_MP{$ENDIF} name _PU + 'c_qd_atan2_n';
+procedure _dd_polyeval_n(const C: PDoubleDouble; const N: Integer; const A, Res: TDoubleDoubleArrays); external {$IFDEF USE_LIB}_LIB_MP{$ENDIF} name _PU + 'c_dd_polyeval_n';
+procedure _dd_polyeval_set_n(const C: Pointer; const N: Integer; const A: DoubleDouble; const Res: TDoubleDoubleArrays); external {$IFDEF USE_LIB}_LIB_MP{$ENDIF} name _PU + 'c_dd_polyeval_set_n';
+procedure _qd_polyeval_n(const C: PQuadDouble; const N: Integer; const A, Res: TQuadDoubleArrays); external {$IFDEF USE_LIB}_LIB_MP{$ENDIF} name _PU + 'c_qd_polyeval_n';
+procedure _qd_polyeval_set_n(const C: Pointer; const N: Integer; const A: QuadDouble; const Res: TQuadDoubleArrays); external {$IFDEF USE_LIB}_LIB_MP{$ENDIF} name _PU + 'c_qd_polyeval_set_n';
+procedure _dd_sum_d(const A: PDouble; const N: Integer; out Res: DoubleDouble); external {$IFDEF USE_LIB}_LIB_MP{$ENDIF} name _PU + 'c_dd_sum_d';
+procedure _dd_dot_d(const A, B: PDouble; const N: Integer; out Res: DoubleDouble); external {$IFDEF USE_LIB}_LIB_MP{$ENDIF} name _PU + 'c_dd_dot_d';
+procedure _dd_dot_dd(const A, B: TDoubleDoubleArrays; out Res: DoubleDouble); external {$IFDEF USE_LIB}_LIB_MP{$ENDIF} name _PU + 'c_dd_dot_dd';
+procedure _qd_sum_d(const A: PDouble; const N: Integer; out Res: QuadDouble); external {$IFDEF USE_LIB}_LIB_MP{$ENDIF} name _PU + 'c_qd_sum_d';
+procedure _qd_dot_qd(const A, B: TQuadDoubleArrays; out Res: QuadDouble); external {$IFDEF USE_LIB}_LIB_MP{$ENDIF} name _PU + 'c_qd_dot_qd';
+procedure _qd_repro_init(out R: TExactSum); external {$IFDEF USE_LIB}_LIB_MP{$ENDIF} name _PU + 'c_qd_repro_init';
+procedure _qd_repro_sum_d(var R: TExactSum; const A: PDouble; const N: Integer); external {$IFDEF USE_LIB}_LIB_MP{$ENDIF} name _PU + 'c_qd_repro_sum_d';
+procedure _qd_repro_dot_d(var R: TExactSum; const A, B: PDouble; const N: Integer); external {$IFDEF USE_LIB}_LIB_MP{$ENDIF} name _PU + 'c_qd_repro_dot_d';
+procedure _qd_repro_sqr_d(var R: TExactSum; const A: PDouble; const N: Integer); external {$IFDEF USE_LIB}_LIB_MP{$ENDIF} name _PU + 'c_qd_repro_sqr_d';
+procedure _qd_repro_merge(var R: TExactSum; const B: TExactSum); external {$IFDEF USE_LIB}_LIB_MP{$ENDIF} name _PU + 'c_qd_repro_merge';
+procedure _dd_repro_result(const R: TExactSum; out Res: DoubleDouble); external {$IFDEF USE_LIB}_LIB_MP{$ENDIF} name _PU + 'c_dd_repro_result';
+procedure _qd_repro_result(const R: TExactSum; out Res: QuadDouble); external {$IFDEF USE_LIB}_LIB_MP{$ENDIF} name _PU + 'c_qd_repro_result';
+procedure _dd_to_soa(const A: PDoubleDouble; const Res: TDoubleDoubleArrays); external {$IFDEF USE_LIB}_LIB_MP{$ENDIF} name _PU + 'c_dd_to_soa';
+procedure _dd_to_aos(const A: TDoubleDoubleArrays; const Res: PDoubleDouble); external {$IFDEF USE_LIB}_LIB_MP{$ENDIF} name _PU + 'c_dd_to_aos';
+procedure _qd_to_soa(const A: PQuadDouble; const Res: TQuadDoubleArrays); external {$IFDEF USE_LIB}_LIB_MP{$ENDIF} name _PU + 'c_qd_to_soa';
+procedure _qd_to_aos(const A: TQuadDoubleArrays; const Res: PQuadDouble); external {$IFDEF USE_LIB}_LIB_MP{$ENDIF} name _PU + 'c_qd_to_aos';
+procedure _dd_gemm(var G: _TDDMatrixProduct; const Work: PDouble); external {$IFDEF USE_LIB}_LIB_MP{$ENDIF} name _PU + 'c_dd_gemm';
+procedure _qd_gemm(var G: _TQDMatrixProduct; const Work: PDouble); external {$IFDEF USE_LIB}_LIB_MP{$ENDIF} name _PU + 'c_qd_gemm';
+procedure _dd_gemv(var G: _TDDMatrixProduct); external {$IFDEF USE_LIB}_LIB_MP{$ENDIF} name _PU + 'c_dd_gemv';
+procedure _qd_gemv(var G: _TQDMatrixProduct); external {$IFDEF USE_LIB}_LIB_MP{$ENDIF} name _PU + 'c_qd_gemv';
+function _dd_gesv_step(var G: _TDDSolver): Integer; external {$IFDEF USE_LIB}_LIB_MP{$ENDIF} name _PU + 'c_dd_gesv_step';
+function _qd_gesv_step(var G: _TQDSolver): Integer; external {$IFDEF USE_LIB}_LIB_MP{$ENDIF} name _PU + 'c_qd_gesv_step';
+procedure _dd_gesv_pass(var G: _TDDSolver; const Work: PDouble); external {$IFDEF USE_LIB}_LIB_MP{$ENDIF} name _PU + 'c_dd_gesv_pass';
+procedure _qd_gesv_pass(var G: _TQDSolver; const Work: PDouble); external {$IFDEF USE_LIB}_LIB_MP{$ENDIF} name _PU + 'c_qd_gesv_pass';
+procedure _mp_render_tile(var Tile: _TMandelbrotTile; const Output, Cancel: PInteger); external {$IFDEF USE_LIB}_LIB_MP{$ENDIF} name _PU + 'c_mp_render_tile';
+procedure _mp_reference_orbit(var Tile: _TMandelbrotTile; const Orbit: PDouble); external {$IFDEF USE_LIB}_LIB_MP{$ENDIF} name _PU + 'c_mp_reference_orbit';
+function _dd_to_string(const A: DoubleDouble; const B: _TDecimalString): Integer; external {$IFDEF USE_LIB}_LIB_MP{$ENDIF} name _PU + 'c_dd_to_string';
+function _qd_to_string(const A: QuadDouble; const B: _TDecimalString): Integer; external {$IFDEF USE_LIB}_LIB_MP{$ENDIF} name _PU + 'c_qd_to_string';
+function _dd_parse(const S: PByte; const Len: Integer; out Res: DoubleDouble): Integer; external {$IFDEF USE_LIB}_LIB_MP{$ENDIF} name _PU + 'c_dd_parse';
+function _qd_parse(const S: PByte; const Len: Integer; out Res: QuadDouble): Integer; external {$IFDEF USE_LIB}_LIB_MP{$ENDIF} name _PU + 'c_qd_parse';
+procedure _qd_count_text(var Text: _TText); external {$IFDEF USE_LIB}_LIB_MP{$ENDIF} name _PU + 'c_qd_count_text';
+procedure _dd_parse_text(var Text: _TText); external {$IFDEF USE_LIB}_LIB_MP{$ENDIF} name _PU + 'c_dd_parse_text';
+procedure _qd_parse_text(var Text: _TText); external {$IFDEF USE_LIB}_LIB_MP{$ENDIF} name _PU + 'c_qd_parse_text';
+procedure _dd_measure_text(var Text: _TText); external {$IFDEF USE_LIB}_LIB_MP{$ENDIF} name _PU + 'c_dd_measure_text';
+procedure _qd_measure_text(var Text: _TText); external {$IFDEF USE_LIB}_LIB_MP{$ENDIF} name _PU + 'c_qd_measure_text';
+procedure _dd_format_text(var Text: _TText); external {$IFDEF USE_LIB}_LIB_MP{$ENDIF} name _PU + 'c_dd_format_text';
+procedure _qd_format_text(var Text: _TText); external {$IFDEF USE_LIB}_LIB_MP{$ENDIF} name _PU + 'c_qd_format_text';
+procedure _qd_file_init(out Header: _TFileHeader; const Components, Layout: Integer; const Count: Int64); external {$IFDEF USE_LIB}_LIB_MP{$ENDIF} name _PU + 'c_qd_file_init';
+function _qd_file_check(const Header: _TFileHeader; const Size: PInt64): Integer; external {$IFDEF USE_LIB}_LIB_MP{$ENDIF} name _PU + 'c_qd_file_check';
+function _qd_file_offset(const Header: _TFileHeader; const K: Integer): Int64; external {$IFDEF USE_LIB}_LIB_MP{$ENDIF} name _PU + 'c_qd_file_offset';
+{$ENDIF}
+
 var
   _USFormatSettings: TFormatSettings;
 {$ENDREGION 'Internal Declarations'}
@@ -1760,7 +2759,17 @@ var
 implementation
 
 uses
-  System.SysConst;
+  {$IFDEF MSWINDOWS}
+  Winapi.Windows,
+  {$ENDIF}
+  {$IFDEF POSIX}
+  Posix.Fcntl,
+  Posix.SysMman,
+  Posix.SysStat,
+  Posix.Unistd,
+  {$ENDIF}
+  System.SysConst,
+  System.Threading;
 
 const
   FuzzFactor = 1000;
@@ -1790,6 +2799,8 @@ end;
 
 {$IF Defined(WIN32)}
 { These are called from the C object files: }
+{ _qd_nan and _qd_inf are only used by object files built before NaN and
+  infinity became compile-time constants. }
 function _qd_nan: Double; cdecl;
 begin
   Result := NaN;
@@ -1837,6 +2848,8 @@ begin
 end;
 {$ELSE}
 { These are called from the C object files: }
+{ qd_nan and qd_inf are only used by libraries built before NaN and infinity
+  became compile-time constants. }
 function qd_nan: Double; cdecl;
 begin
   Result := NaN;
@@ -1876,7 +2889,7 @@ function qd_ceil(Value: Double): Double; cdecl;
 begin
   Result := System.Math.Ceil(Value);
 end;
-{$IF Defined(MACOS) or Defined(ANDROID)}
+{$IF Defined(MACOS) or Defined(ANDROID) or Defined(LINUX)}
 exports
   qd_nan,
   qd_inf,
@@ -1942,6 +2955,67 @@ end;
 
 { Common helpers }
 
+{$IF Defined(MP_REBUILT_BINARIES)}
+{ Converts the output of c_dd_to_string or c_qd_to_string to a String, using
+  the decimal separator in FormatSettings. Letters are converted to upper case
+  (for the exponent and for NAN and INF). }
+function DecimalToString(const S: PByte; const Len: Integer;
+  const FormatSettings: TFormatSettings): String;
+var
+  I: Integer;
+  C: Char;
+begin
+  SetLength(Result, Len);
+  for I := 0 to Len - 1 do
+  begin
+    C := Char(S[I]);
+    if (C = '.') then
+      C := FormatSettings.DecimalSeparator
+    else if (C >= 'a') and (C <= 'z') then
+      C := Char(Ord(C) - 32);
+    Result[Low(String) + I] := C;
+  end;
+end;
+
+{ Converts S to the input of c_dd_parse or c_qd_parse, using the decimal
+  separator in FormatSettings. Before the decimal separator, the other one of
+  '.' and ',' is ignored (as a thousands separator). Buffer must have room
+  for Length(S) + 1 bytes. Returns the number of bytes, not counting the
+  terminating 0. }
+function StringToDecimal(const S: String;
+  const FormatSettings: TFormatSettings; const Buffer: PByte): Integer;
+var
+  I: Integer;
+  C: Char;
+  Point: Boolean;
+begin
+  Result := 0;
+  Point := False;
+  for I := 0 to Length(S) - 1 do
+  begin
+    C := S[Low(String) + I];
+    if (C = FormatSettings.DecimalSeparator) then
+    begin
+      C := '.';
+      Point := True;
+    end
+    else if (C = '.') or (C = ',') then
+    begin
+      if (not Point) then
+        Continue;
+      { Ends the number, which makes the string invalid }
+      C := ',';
+    end
+    else if (C < ' ') then
+      C := ' '
+    else if (Ord(C) > 127) then
+      C := '?';
+    Buffer[Result] := Ord(C);
+    Inc(Result);
+  end;
+  Buffer[Result] := 0;
+end;
+{$ELSE}
 procedure RoundString(const S: TArray<Char>; Precision: Integer;
   var Offset: Integer);
 var
@@ -2002,6 +3076,7 @@ begin
 
   SB.Append(Char(Ord('0') + Exponent));
 end;
+{$ENDIF}
 
 function Add(const A, B: Double): DoubleDouble;
 begin
@@ -2214,6 +3289,32 @@ begin
   __qd_ldexp(A, Exp, Result);
 end;
 
+{$IF Defined(MP_REBUILT_BINARIES)}
+function PolyEval(const C: array of DoubleDouble; const X: DoubleDouble): DoubleDouble;
+begin
+  _dd_polyeval(@C, High(C), X, Result);
+end;
+
+function PolyEval(const C: array of QuadDouble; const X: QuadDouble): QuadDouble;
+begin
+  _qd_polyeval(@C, High(C), X, Result);
+end;
+
+function PolyRoot(const C: array of DoubleDouble; const X0: DoubleDouble;
+  const MaxIterations: Integer): DoubleDouble;
+begin
+  Result := X0;
+  _dd_polyroot(@C, High(C), Result, MaxIterations);
+end;
+
+function PolyRoot(const C: array of QuadDouble; const X0: QuadDouble;
+  const MaxIterations: Integer): QuadDouble;
+begin
+  Result := X0;
+  _qd_polyroot(@C, High(C), Result, MaxIterations);
+end;
+{$ENDIF}
+
 function Exp(const A: DoubleDouble): DoubleDouble;
 begin
   _dd_exp(A, Result);
@@ -3016,93 +4117,1558 @@ begin
     Result := Value;
 end;
 
-{ DoubleDouble }
+{$IF Defined(MP_REBUILT_BINARIES)}
+procedure AddN(const A, B, Result: TDoubleDoubleArrays);
+begin
+  _dd_add_n(A, B, Result);
+end;
 
-class operator DoubleDouble.Add(const A, B: DoubleDouble): DoubleDouble;
+procedure SubtractN(const A, B, Result: TDoubleDoubleArrays);
 begin
-  _dd_add(A, B, Result);
+  _dd_sub_n(A, B, Result);
 end;
 
-class operator DoubleDouble.Add(const A: Double; const B: DoubleDouble): DoubleDouble;
+procedure MultiplyN(const A, B, Result: TDoubleDoubleArrays);
 begin
-  _dd_add_d_dd(@A, B, Result);
+  _dd_mul_n(A, B, Result);
 end;
 
-class operator DoubleDouble.Add(const A: DoubleDouble; const B: Double): DoubleDouble;
+procedure DivideN(const A, B, Result: TDoubleDoubleArrays);
 begin
-  _dd_add_dd_d(A, @B, Result);
+  _dd_div_n(A, B, Result);
 end;
 
-procedure DoubleDouble.Clear;
+procedure SqrN(const A, Result: TDoubleDoubleArrays);
 begin
-  X[0] := 0;
-  X[1] := 0;
+  _dd_sqr_n(A, Result);
 end;
 
-class operator DoubleDouble.Divide(const A, B: DoubleDouble): DoubleDouble;
+procedure MultiplyAddN(const A, B, Result: TDoubleDoubleArrays);
 begin
-  _dd_div(A, B, Result);
+  _dd_fma_n(A, B, Result);
 end;
 
-class operator DoubleDouble.Divide(const A: Double; const B: DoubleDouble): DoubleDouble;
+procedure MultiplyAddN(const A: DoubleDouble;
+  const B, Result: TDoubleDoubleArrays);
 begin
-  _dd_div_d_dd(@A, B, Result);
+  _dd_axpy(A, B, Result);
 end;
 
-class operator DoubleDouble.Divide(const A: DoubleDouble; const B: Double): DoubleDouble;
+{ TDoubleDoubleArrays }
+
+procedure TDoubleDoubleArrays.Init(const Hi, Lo: PDouble;
+  const Count: Integer);
 begin
-  _dd_div_dd_d(A, @B, Result);
+  X[0] := Hi;
+  X[1] := Lo;
+  Self.Count := Count;
 end;
 
-class operator DoubleDouble.Equal(const A: DoubleDouble; const B: Double): Boolean;
+procedure TDoubleDoubleArrays.Load(const Source: PDoubleDouble);
 begin
-  Result := (A.X[0] = B) and (A.X[1] = 0);
+  _dd_to_soa(Source, Self);
 end;
 
-class operator DoubleDouble.Equal(const A: Double; const B: DoubleDouble): Boolean;
+procedure TDoubleDoubleArrays.Store(const Target: PDoubleDouble);
 begin
-  Result := (A = B.X[0]) and (B.X[1] = 0);
+  _dd_to_aos(Self, Target);
 end;
 
-function DoubleDouble.Equals(const A: DoubleDouble): Boolean;
+procedure AddN(const A, B, Result: TQuadDoubleArrays);
 begin
-  Result := (X[0] = A.X[0]) and (X[1] = A.X[1]);
+  _qd_add_n(A, B, Result);
 end;
 
-function DoubleDouble.Equals(const A: Double): Boolean;
+procedure SubtractN(const A, B, Result: TQuadDoubleArrays);
 begin
-  Result := (X[0] = A) and (X[1] = 0);
+  _qd_sub_n(A, B, Result);
 end;
 
-class operator DoubleDouble.Equal(const A, B: DoubleDouble): Boolean;
+procedure MultiplyN(const A, B, Result: TQuadDoubleArrays);
 begin
-  Result := (A.X[0] = B.X[0]) and (A.X[1] = B.X[1]);
+  _qd_mul_n(A, B, Result);
 end;
 
-class operator DoubleDouble.GreaterThan(const A: DoubleDouble;
-  const B: Double): Boolean;
+procedure SqrN(const A, Result: TQuadDoubleArrays);
 begin
-  Result := (A.X[0] > B) or ((A.X[0] = B) and (A.X[1] > 0));
+  _qd_sqr_n(A, Result);
 end;
 
-class operator DoubleDouble.GreaterThan(const A, B: DoubleDouble): Boolean;
+procedure MultiplyAddN(const A, B, Result: TQuadDoubleArrays);
 begin
-  Result := (A.X[0] > B.X[0]) or ((A.X[0] = B.X[0]) and (A.X[1] > B.X[1]));
+  _qd_fma_n(A, B, Result);
 end;
 
-function DoubleDouble.GetExp: UInt64;
+procedure MultiplyAddN(const A: QuadDouble;
+  const B, Result: TQuadDoubleArrays);
 begin
-  Result := X[0].Exp;
+  _qd_axpy(A, B, Result);
 end;
 
-function DoubleDouble.GetSign: Boolean;
+procedure ExpN(const A, Result: TDoubleDoubleArrays);
 begin
-  Result := X[0].Sign;
+  _dd_exp_n(A, Result);
 end;
 
-function DoubleDouble.GetSpecialType: TFloatSpecial;
+procedure ExpN(const A, Result: TQuadDoubleArrays);
 begin
-  if (IsZero) then
+  _qd_exp_n(A, Result);
+end;
+
+procedure LnN(const A, Result: TDoubleDoubleArrays);
+begin
+  _dd_log_n(A, Result);
+end;
+
+procedure LnN(const A, Result: TQuadDoubleArrays);
+begin
+  _qd_log_n(A, Result);
+end;
+
+procedure SinCosN(const A, SinA, CosA: TDoubleDoubleArrays);
+begin
+  _dd_sincos_n(A, SinA, CosA);
+end;
+
+procedure SinCosN(const A, SinA, CosA: TQuadDoubleArrays);
+begin
+  _qd_sincos_n(A, SinA, CosA);
+end;
+
+procedure ArcTan2N(const Y, X, Result: TDoubleDoubleArrays);
+begin
+  _dd_atan2_n(Y, X, Result);
+end;
+
+procedure ArcTan2N(const Y, X, Result: TQuadDoubleArrays);
+begin
+  _qd_atan2_n(Y, X, Result);
+end;
+
+procedure PolyEvalN(const C: array of DoubleDouble;
+  const X, Result: TDoubleDoubleArrays);
+begin
+  _dd_polyeval_n(@C, High(C), X, Result);
+end;
+
+procedure PolyEvalN(const C: array of TDoubleDoubleArrays;
+  const X: DoubleDouble; const Result: TDoubleDoubleArrays);
+begin
+  _dd_polyeval_set_n(@C, High(C), X, Result);
+end;
+
+procedure PolyEvalN(const C: array of QuadDouble;
+  const X, Result: TQuadDoubleArrays);
+begin
+  _qd_polyeval_n(@C, High(C), X, Result);
+end;
+
+procedure PolyEvalN(const C: array of TQuadDoubleArrays;
+  const X: QuadDouble; const Result: TQuadDoubleArrays);
+begin
+  _qd_polyeval_set_n(@C, High(C), X, Result);
+end;
+
+const
+  { Number of values in each part of SumN, DotN and ExactReduction }
+  REDUCE_PART_SIZE = 1 shl 16;
+
+{ Number of parts of a reduction of ACount values (at least one) }
+function ReducePartCount(const ACount: Integer): Integer; inline;
+begin
+  Result := System.Math.Max((ACount + REDUCE_PART_SIZE - 1) div REDUCE_PART_SIZE, 1);
+end;
+
+{ Calls AProc(Part, Start, Count) for each part of REDUCE_PART_SIZE values
+  (the last part may be smaller) of ACount values, on all CPU cores. Each
+  task claims the next part when it is done with the previous one, like
+  RenderMandelbrot. }
+procedure RunReduction(const ACount: Integer;
+  const AProc: TProc<Integer, Integer, Integer>);
+var
+  Tasks: TArray<ITask>;
+  Run: TProc;
+  Next, PartCount, I: Integer;
+begin
+  PartCount := ReducePartCount(ACount);
+  Next := 0;
+  Run :=
+    procedure
+    var
+      Part: Integer;
+    begin
+      Part := AtomicIncrement(Next) - 1;
+      while (Part < PartCount) do
+      begin
+        AProc(Part, Part * REDUCE_PART_SIZE,
+          System.Math.Min(ACount - Part * REDUCE_PART_SIZE, REDUCE_PART_SIZE));
+        Part := AtomicIncrement(Next) - 1;
+      end;
+    end;
+
+  SetLength(Tasks, System.Math.Min(CPUCount, PartCount) - 1);
+  for I := 0 to Length(Tasks) - 1 do
+    Tasks[I] := TTask.Run(
+      procedure
+      var
+        State: UInt32;
+      begin
+        State := MultiPrecisionInit;
+        try
+          Run();
+        finally
+          MultiPrecisionReset(State);
+        end;
+      end);
+
+  Run();
+  if (Tasks <> nil) then
+    TTask.WaitForAll(Tasks);
+end;
+
+procedure SumN(const A: array of Double; out Result: DoubleDouble);
+var
+  P: PByte;
+  Parts: TArray<DoubleDouble>;
+  I: Integer;
+begin
+  P := @A;
+  SetLength(Parts, ReducePartCount(Length(A)));
+  RunReduction(Length(A),
+    procedure(APart, AStart, ACount: Integer)
+    begin
+      _dd_sum_d(PDouble(P + AStart * SizeOf(Double)), ACount, Parts[APart]);
+    end);
+
+  Result := Parts[0];
+  for I := 1 to Length(Parts) - 1 do
+    Result := Result + Parts[I];
+end;
+
+procedure SumN(const A: array of Double; out Result: QuadDouble);
+var
+  P: PByte;
+  Parts: TArray<QuadDouble>;
+  I: Integer;
+begin
+  P := @A;
+  SetLength(Parts, ReducePartCount(Length(A)));
+  RunReduction(Length(A),
+    procedure(APart, AStart, ACount: Integer)
+    begin
+      _qd_sum_d(PDouble(P + AStart * SizeOf(Double)), ACount, Parts[APart]);
+    end);
+
+  Result := Parts[0];
+  for I := 1 to Length(Parts) - 1 do
+    Result := Result + Parts[I];
+end;
+
+procedure DotN(const A, B: array of Double; out Result: DoubleDouble);
+var
+  PA, PB: PByte;
+  Parts: TArray<DoubleDouble>;
+  I: Integer;
+begin
+  PA := @A;
+  PB := @B;
+  SetLength(Parts, ReducePartCount(Length(A)));
+  RunReduction(Length(A),
+    procedure(APart, AStart, ACount: Integer)
+    begin
+      _dd_dot_d(PDouble(PA + AStart * SizeOf(Double)),
+        PDouble(PB + AStart * SizeOf(Double)), ACount, Parts[APart]);
+    end);
+
+  Result := Parts[0];
+  for I := 1 to Length(Parts) - 1 do
+    Result := Result + Parts[I];
+end;
+
+procedure DotN(const A, B: TDoubleDoubleArrays; out Result: DoubleDouble);
+var
+  VA, VB: TDoubleDoubleArrays;
+  Parts: TArray<DoubleDouble>;
+  I: Integer;
+begin
+  VA := A;
+  VB := B;
+  SetLength(Parts, ReducePartCount(A.Count));
+  RunReduction(A.Count,
+    procedure(APart, AStart, ACount: Integer)
+    var
+      PartA, PartB: TDoubleDoubleArrays;
+      K: Integer;
+    begin
+      PartA.Count := ACount;
+      PartB.Count := ACount;
+      for K := 0 to 1 do
+      begin
+        PartA.X[K] := PDouble(PByte(VA.X[K]) + AStart * SizeOf(Double));
+        PartB.X[K] := PDouble(PByte(VB.X[K]) + AStart * SizeOf(Double));
+      end;
+      _dd_dot_dd(PartA, PartB, Parts[APart]);
+    end);
+
+  Result := Parts[0];
+  for I := 1 to Length(Parts) - 1 do
+    Result := Result + Parts[I];
+end;
+
+procedure DotN(const A, B: TQuadDoubleArrays; out Result: QuadDouble);
+var
+  VA, VB: TQuadDoubleArrays;
+  Parts: TArray<QuadDouble>;
+  I: Integer;
+begin
+  VA := A;
+  VB := B;
+  SetLength(Parts, ReducePartCount(A.Count));
+  RunReduction(A.Count,
+    procedure(APart, AStart, ACount: Integer)
+    var
+      PartA, PartB: TQuadDoubleArrays;
+      K: Integer;
+    begin
+      PartA.Count := ACount;
+      PartB.Count := ACount;
+      for K := 0 to 3 do
+      begin
+        PartA.X[K] := PDouble(PByte(VA.X[K]) + AStart * SizeOf(Double));
+        PartB.X[K] := PDouble(PByte(VB.X[K]) + AStart * SizeOf(Double));
+      end;
+      _qd_dot_qd(PartA, PartB, Parts[APart]);
+    end);
+
+  Result := Parts[0];
+  for I := 1 to Length(Parts) - 1 do
+    Result := Result + Parts[I];
+end;
+
+{ TExactSum }
+
+procedure TExactSum.Add(const A: array of Double);
+begin
+  _qd_repro_sum_d(Self, @A, Length(A));
+end;
+
+procedure TExactSum.AddProducts(const A, B: array of Double);
+begin
+  _qd_repro_dot_d(Self, @A, @B, Length(A));
+end;
+
+procedure TExactSum.AddSquares(const A: array of Double);
+begin
+  _qd_repro_sqr_d(Self, @A, Length(A));
+end;
+
+procedure TExactSum.Init;
+begin
+  _qd_repro_init(Self);
+end;
+
+procedure TExactSum.Merge(const Other: TExactSum);
+begin
+  _qd_repro_merge(Self, Other);
+end;
+
+function TExactSum.ToDoubleDouble: DoubleDouble;
+begin
+  _dd_repro_result(Self, Result);
+end;
+
+function TExactSum.ToQuadDouble: QuadDouble;
+begin
+  _qd_repro_result(Self, Result);
+end;
+
+type
+  { What ExactReduction adds to the accumulators }
+  _TExactReduction = (Sum, Products, Squares);
+
+{ Adds the first ALength values, products or squares of the arrays at A and
+  B to an accumulator for each part (see RunReduction), and merges the
+  parts into Sum. }
+procedure ExactReduction(const A, B: PByte; const ALength: Integer;
+  const AKind: _TExactReduction; out Sum: TExactSum);
+var
+  PA, PB: PByte;
+  Kind: _TExactReduction;
+  Parts: TArray<TExactSum>;
+  I: Integer;
+begin
+  PA := A;
+  PB := B;
+  Kind := AKind;
+  SetLength(Parts, ReducePartCount(ALength));
+  RunReduction(ALength,
+    procedure(APart, AStart, ACount: Integer)
+    var
+      X, Y: PDouble;
+    begin
+      X := PDouble(PA + AStart * SizeOf(Double));
+      Y := PDouble(PB + AStart * SizeOf(Double));
+      _qd_repro_init(Parts[APart]);
+      case Kind of
+        _TExactReduction.Sum:
+          _qd_repro_sum_d(Parts[APart], X, ACount);
+        _TExactReduction.Products:
+          _qd_repro_dot_d(Parts[APart], X, Y, ACount);
+        _TExactReduction.Squares:
+          _qd_repro_sqr_d(Parts[APart], X, ACount);
+      end;
+    end);
+
+  Sum := Parts[0];
+  for I := 1 to Length(Parts) - 1 do
+    Sum.Merge(Parts[I]);
+end;
+
+procedure ExactSumN(const A: array of Double; out Result: DoubleDouble);
+var
+  Sum: TExactSum;
+begin
+  ExactReduction(@A, nil, Length(A), _TExactReduction.Sum, Sum);
+  Result := Sum.ToDoubleDouble;
+end;
+
+procedure ExactSumN(const A: array of Double; out Result: QuadDouble);
+var
+  Sum: TExactSum;
+begin
+  ExactReduction(@A, nil, Length(A), _TExactReduction.Sum, Sum);
+  Result := Sum.ToQuadDouble;
+end;
+
+procedure ExactDotN(const A, B: array of Double; out Result: DoubleDouble);
+var
+  Sum: TExactSum;
+begin
+  ExactReduction(@A, @B, Length(A), _TExactReduction.Products, Sum);
+  Result := Sum.ToDoubleDouble;
+end;
+
+procedure ExactDotN(const A, B: array of Double; out Result: QuadDouble);
+var
+  Sum: TExactSum;
+begin
+  ExactReduction(@A, @B, Length(A), _TExactReduction.Products, Sum);
+  Result := Sum.ToQuadDouble;
+end;
+
+procedure ExactNormN(const A: array of Double; out Result: DoubleDouble);
+var
+  Sum: TExactSum;
+begin
+  ExactReduction(@A, nil, Length(A), _TExactReduction.Squares, Sum);
+  Result := Sqrt(Sum.ToDoubleDouble);
+end;
+
+procedure ExactNormN(const A: array of Double; out Result: QuadDouble);
+var
+  Sum: TExactSum;
+begin
+  ExactReduction(@A, nil, Length(A), _TExactReduction.Squares, Sum);
+  Result := Sqrt(Sum.ToQuadDouble);
+end;
+
+{ TDoubleDoubleMatrix }
+
+procedure TDoubleDoubleMatrix.Init(const Arrays: TDoubleDoubleArrays;
+  const Rows, Cols: Integer);
+begin
+  X := Arrays.X;
+  Self.Rows := Rows;
+  Self.Cols := Cols;
+  RowStride := Cols;
+  ColStride := 1;
+end;
+
+function TDoubleDoubleMatrix.Transpose: TDoubleDoubleMatrix;
+begin
+  Result.X := X;
+  Result.Rows := Cols;
+  Result.Cols := Rows;
+  Result.RowStride := ColStride;
+  Result.ColStride := RowStride;
+end;
+
+{ TQuadDoubleMatrix }
+
+procedure TQuadDoubleMatrix.Init(const Arrays: TQuadDoubleArrays;
+  const Rows, Cols: Integer);
+begin
+  X := Arrays.X;
+  Self.Rows := Rows;
+  Self.Cols := Cols;
+  RowStride := Cols;
+  ColStride := 1;
+end;
+
+function TQuadDoubleMatrix.Transpose: TQuadDoubleMatrix;
+begin
+  Result.X := X;
+  Result.Rows := Cols;
+  Result.Cols := Rows;
+  Result.RowStride := ColStride;
+  Result.ColStride := RowStride;
+end;
+
+const
+  { Number of Doubles of the work buffer of _dd_gemm and _qd_gemm
+    (QD_GEMM_WORK in C/c_blas.h) }
+  GEMM_WORK = 40960;
+
+  { Size of the tiles of the matrix products (QD_DD_GEMM_TILE,
+    QD_QD_GEMM_TILE and QD_GEMV_TILE in C/c_blas.h) }
+  DD_GEMM_TILE = 64;
+  QD_GEMM_TILE = 32;
+  GEMV_TILE = 64;
+
+{ Number of tiles of a matrix product with an output of ARows x ACols
+  elements }
+function MatrixTileCount(const ARows, ACols, ATileRows,
+  ATileCols: Integer): Integer; inline;
+begin
+  Result := ((ARows + ATileRows - 1) div ATileRows)
+    * ((ACols + ATileCols - 1) div ATileCols);
+end;
+
+{ Calls AProc on all CPU cores (but not more often than there are tiles),
+  like RenderMandelbrot. Each call computes the tiles of a matrix product
+  that have not been claimed by another call yet, using its own work buffer
+  of AWorkSize Doubles. }
+procedure RunMatrixProduct(const ATileCount, AWorkSize: Integer;
+  const AProc: TProc<PDouble>);
+var
+  Tasks: TArray<ITask>;
+  Run: TProc;
+  I: Integer;
+begin
+  Run :=
+    procedure
+    var
+      Work: TArray<Double>;
+    begin
+      SetLength(Work, AWorkSize);
+      AProc(Pointer(Work));
+    end;
+
+  SetLength(Tasks,
+    System.Math.Min(CPUCount, System.Math.Max(ATileCount, 1)) - 1);
+  for I := 0 to Length(Tasks) - 1 do
+    Tasks[I] := TTask.Run(
+      procedure
+      var
+        State: UInt32;
+      begin
+        State := MultiPrecisionInit;
+        try
+          Run();
+        finally
+          MultiPrecisionReset(State);
+        end;
+      end);
+
+  Run();
+  if (Tasks <> nil) then
+    TTask.WaitForAll(Tasks);
+end;
+
+procedure MultiplyMatrixN(const Alpha: DoubleDouble; const A,
+  B: TDoubleDoubleMatrix; const Beta: DoubleDouble;
+  const C: TDoubleDoubleMatrix);
+var
+  Product: _TDDMatrixProduct;
+begin
+  Assert((A.Cols = B.Rows) and (A.Rows = C.Rows) and (B.Cols = C.Cols));
+  Product.A := A;
+  Product.B := B;
+  Product.C := C;
+  Product.Alpha := Alpha;
+  Product.Beta := Beta;
+  Product.NextTile := 0;
+  RunMatrixProduct(MatrixTileCount(C.Rows, C.Cols, DD_GEMM_TILE,
+    DD_GEMM_TILE), GEMM_WORK,
+    procedure(AWork: PDouble)
+    begin
+      _dd_gemm(Product, AWork);
+    end);
+end;
+
+procedure MultiplyMatrixN(const Alpha: QuadDouble; const A,
+  B: TQuadDoubleMatrix; const Beta: QuadDouble;
+  const C: TQuadDoubleMatrix);
+var
+  Product: _TQDMatrixProduct;
+begin
+  Assert((A.Cols = B.Rows) and (A.Rows = C.Rows) and (B.Cols = C.Cols));
+  Product.A := A;
+  Product.B := B;
+  Product.C := C;
+  Product.Alpha := Alpha;
+  Product.Beta := Beta;
+  Product.NextTile := 0;
+  RunMatrixProduct(MatrixTileCount(C.Rows, C.Cols, QD_GEMM_TILE,
+    QD_GEMM_TILE), GEMM_WORK,
+    procedure(AWork: PDouble)
+    begin
+      _qd_gemm(Product, AWork);
+    end);
+end;
+
+procedure MultiplyMatrixVectorN(const Alpha: DoubleDouble;
+  const A: TDoubleDoubleMatrix; const X: TDoubleDoubleArrays;
+  const Beta: DoubleDouble; const Y: TDoubleDoubleArrays);
+var
+  Product: _TDDMatrixProduct;
+begin
+  Assert((X.Count >= A.Cols) and (Y.Count >= A.Rows));
+  Product.A := A;
+  Product.B.X := X.X;
+  Product.B.Rows := A.Cols;
+  Product.B.Cols := 1;
+  Product.B.RowStride := 1;
+  Product.B.ColStride := 1;
+  Product.C.X := Y.X;
+  Product.C.Rows := A.Rows;
+  Product.C.Cols := 1;
+  Product.C.RowStride := 1;
+  Product.C.ColStride := 1;
+  Product.Alpha := Alpha;
+  Product.Beta := Beta;
+  Product.NextTile := 0;
+  RunMatrixProduct(MatrixTileCount(A.Rows, 1, GEMV_TILE, 1), 0,
+    procedure(AWork: PDouble)
+    begin
+      _dd_gemv(Product);
+    end);
+end;
+
+procedure MultiplyMatrixVectorN(const Alpha: QuadDouble;
+  const A: TQuadDoubleMatrix; const X: TQuadDoubleArrays;
+  const Beta: QuadDouble; const Y: TQuadDoubleArrays);
+var
+  Product: _TQDMatrixProduct;
+begin
+  Assert((X.Count >= A.Cols) and (Y.Count >= A.Rows));
+  Product.A := A;
+  Product.B.X := X.X;
+  Product.B.Rows := A.Cols;
+  Product.B.Cols := 1;
+  Product.B.RowStride := 1;
+  Product.B.ColStride := 1;
+  Product.C.X := Y.X;
+  Product.C.Rows := A.Rows;
+  Product.C.Cols := 1;
+  Product.C.RowStride := 1;
+  Product.C.ColStride := 1;
+  Product.Alpha := Alpha;
+  Product.Beta := Beta;
+  Product.NextTile := 0;
+  RunMatrixProduct(MatrixTileCount(A.Rows, 1, GEMV_TILE, 1), 0,
+    procedure(AWork: PDouble)
+    begin
+      _qd_gemv(Product);
+    end);
+end;
+
+const
+  { Maximum number of refinement steps of SolveMatrixN }
+  SOLVE_MAX_ITERATIONS = 30;
+
+  { Status of a solver when the refinement stalled, and the solver needs a
+    buffer for the DoubleDouble or QuadDouble factors (qd_gesv_stalled in
+    C/c_solve.h) }
+  SOLVE_STALLED = 3;
+
+function SolveMatrixN(const A, B, X: TDoubleDoubleMatrix): TMatrixSolveResult;
+var
+  Solver: _TDDSolver;
+  Work, Factors: TArray<Double>;
+  Pivots: TArray<Integer>;
+begin
+  Assert((A.Rows = A.Cols) and (B.Rows = A.Rows) and (X.Rows = A.Rows)
+    and (X.Cols = B.Cols));
+  FillChar(Solver, SizeOf(Solver), 0);
+  Solver.A := A;
+  Solver.B := B;
+  Solver.X := X;
+  SetLength(Work, A.Rows * A.Rows + 3 * A.Rows * B.Cols);
+  SetLength(Pivots, A.Rows);
+  Solver.Work := Pointer(Work);
+  Solver.Pivots := Pointer(Pivots);
+  Solver.MaxIterations := SOLVE_MAX_ITERATIONS;
+  while True do
+  begin
+    while (_dd_gesv_step(Solver) <> 0) do
+      RunMatrixProduct(Solver.Tiles, GEMM_WORK,
+        procedure(AWork: PDouble)
+        begin
+          _dd_gesv_pass(Solver, AWork);
+        end);
+
+    if (Solver.Status <> SOLVE_STALLED) then
+      Break;
+
+    { Only allocate the DoubleDouble factors when they are needed }
+    SetLength(Factors, 2 * A.Rows * A.Rows);
+    Solver.Factors := Pointer(Factors);
+  end;
+  Result := TMatrixSolveResult(Solver.Status);
+end;
+
+function SolveMatrixN(const A, B, X: TQuadDoubleMatrix): TMatrixSolveResult;
+var
+  Solver: _TQDSolver;
+  Work, Factors: TArray<Double>;
+  Pivots: TArray<Integer>;
+begin
+  Assert((A.Rows = A.Cols) and (B.Rows = A.Rows) and (X.Rows = A.Rows)
+    and (X.Cols = B.Cols));
+  FillChar(Solver, SizeOf(Solver), 0);
+  Solver.A := A;
+  Solver.B := B;
+  Solver.X := X;
+  SetLength(Work, A.Rows * A.Rows + 5 * A.Rows * B.Cols);
+  SetLength(Pivots, A.Rows);
+  Solver.Work := Pointer(Work);
+  Solver.Pivots := Pointer(Pivots);
+  Solver.MaxIterations := SOLVE_MAX_ITERATIONS;
+  while True do
+  begin
+    while (_qd_gesv_step(Solver) <> 0) do
+      RunMatrixProduct(Solver.Tiles, GEMM_WORK,
+        procedure(AWork: PDouble)
+        begin
+          _qd_gesv_pass(Solver, AWork);
+        end);
+
+    if (Solver.Status <> SOLVE_STALLED) then
+      Break;
+
+    SetLength(Factors, 4 * A.Rows * A.Rows);
+    Solver.Factors := Pointer(Factors);
+  end;
+  Result := TMatrixSolveResult(Solver.Status);
+end;
+
+procedure RenderMandelbrot(const APrecision: TMandelbrotPrecision;
+  const ACenterRe, ACenterIm: QuadDouble; const AStep: Double;
+  const AWidth, AHeight, AMaxIterations: Integer; const AOutput: PInteger;
+  const ACancel: PInteger);
+var
+  Tile: _TMandelbrotTile;
+  Tasks: TArray<ITask>;
+  Orbit: TArray<Double>;
+  Output, Cancel: PInteger;
+  I: Integer;
+begin
+  Tile.CenterRe := ACenterRe;
+  Tile.CenterIm := ACenterIm;
+  Tile.Step := AStep;
+  Tile.Precision := Ord(APrecision);
+  Tile.Width := AWidth;
+  Tile.Height := AHeight;
+  Tile.MaxIterations := AMaxIterations;
+  Tile.NextRow := 0;
+  Tile.Orbit := nil;
+  Tile.OrbitLen := 0;
+  Output := AOutput;
+  Cancel := ACancel;
+
+  if (APrecision = TMandelbrotPrecision.Perturbation) then
+  begin
+    SetLength(Orbit, 2 * (AMaxIterations + 2));
+    _mp_reference_orbit(Tile, @Orbit[0]);
+  end;
+
+  { CPUCount - 1 tasks and the current thread render rows of the same tile.
+    Each of them claims the next row by incrementing the atomic counter
+    Tile.NextRow when it is done with the previous one, so faster threads
+    render more rows. }
+  SetLength(Tasks, CPUCount - 1);
+  for I := 0 to Length(Tasks) - 1 do
+    Tasks[I] := TTask.Run(
+      procedure
+      var
+        State: UInt32;
+      begin
+        State := MultiPrecisionInit;
+        try
+          _mp_render_tile(Tile, Output, Cancel);
+        finally
+          MultiPrecisionReset(State);
+        end;
+      end);
+
+  _mp_render_tile(Tile, Output, Cancel);
+  if (Tasks <> nil) then
+    TTask.WaitForAll(Tasks);
+end;
+
+{ Runs a pass of the text functions on all CPU cores, like RenderMandelbrot }
+procedure RunTextPass(var AText: _TText; const APass: _TTextPass);
+var
+  Tasks: TArray<ITask>;
+  Pass: _TTextPass;
+  Text: ^_TText;
+  I: Integer;
+begin
+  AText.NextChunk := 0;
+  AText.DoneChunks := 0;
+  Pass := APass;
+  Text := @AText;
+
+  SetLength(Tasks, CPUCount - 1);
+  for I := 0 to Length(Tasks) - 1 do
+    Tasks[I] := TTask.Run(
+      procedure
+      var
+        State: UInt32;
+      begin
+        State := MultiPrecisionInit;
+        try
+          Pass(Text^);
+        finally
+          MultiPrecisionReset(State);
+        end;
+      end);
+
+  Pass(AText);
+  if (Tasks <> nil) then
+    TTask.WaitForAll(Tasks);
+end;
+
+{ Counts the rows and columns of a table in text form }
+procedure CountText(out AText: _TText; const AData: Pointer;
+  const ASize: NativeInt; const ASeparator: AnsiChar);
+begin
+  FillChar(AText, SizeOf(AText), 0);
+  AText.Text := AData;
+  AText.Size := ASize;
+  AText.Separator := Ord(ASeparator);
+  if (ASize > 0) then
+    RunTextPass(AText, _qd_count_text);
+end;
+
+{ Converts a table to text. APlanes contains the component arrays of all
+  columns (2 or 4 per column). }
+function FormatText(const APlanes: TArray<PDouble>;
+  const AColumns, ARows: Integer; const AFormat: TMPFloatFormat;
+  const APrecision: Integer; const ASeparator: AnsiChar;
+  const AMeasure, AFormatPass: _TTextPass): TBytes;
+var
+  Text: _TText;
+begin
+  Result := nil;
+  if (AColumns = 0) or (ARows = 0) then
+    Exit;
+
+  FillChar(Text, SizeOf(Text), 0);
+  Text.X := @APlanes[0];
+  Text.Columns := AColumns;
+  Text.Rows := ARows;
+  Text.Separator := Ord(ASeparator);
+  Text.Format := Ord(AFormat);
+  Text.Precision := APrecision;
+  RunTextPass(Text, AMeasure);
+
+  SetLength(Result, Text.Size);
+  Text.Text := @Result[0];
+  RunTextPass(Text, AFormatPass);
+end;
+
+function ReadText(const AText: Pointer; const ASize: NativeInt;
+  out AColumns: TArray<TDoubleDoubleVector>;
+  const ASeparator: AnsiChar): Integer;
+var
+  Text: _TText;
+  Planes: TArray<PDouble>;
+  I: Integer;
+begin
+  CountText(Text, AText, ASize, ASeparator);
+  SetLength(AColumns, Text.Columns);
+  SetLength(Planes, Text.Columns * 2);
+  try
+    for I := 0 to Text.Columns - 1 do
+    begin
+      AColumns[I] := TDoubleDoubleVector.Create(Text.Rows);
+      Planes[I * 2] := AColumns[I].Arrays.X[0];
+      Planes[I * 2 + 1] := AColumns[I].Arrays.X[1];
+    end;
+  except
+    for I := 0 to Length(AColumns) - 1 do
+      AColumns[I].Free;
+    AColumns := nil;
+    raise;
+  end;
+
+  if (Text.Columns > 0) then
+  begin
+    Text.X := @Planes[0];
+    RunTextPass(Text, _dd_parse_text);
+  end;
+  Result := Text.Errors;
+end;
+
+function ReadText(const AText: Pointer; const ASize: NativeInt;
+  out AColumns: TArray<TQuadDoubleVector>;
+  const ASeparator: AnsiChar): Integer;
+var
+  Text: _TText;
+  Planes: TArray<PDouble>;
+  I, J: Integer;
+begin
+  CountText(Text, AText, ASize, ASeparator);
+  SetLength(AColumns, Text.Columns);
+  SetLength(Planes, Text.Columns * 4);
+  try
+    for I := 0 to Text.Columns - 1 do
+    begin
+      AColumns[I] := TQuadDoubleVector.Create(Text.Rows);
+      for J := 0 to 3 do
+        Planes[I * 4 + J] := AColumns[I].Arrays.X[J];
+    end;
+  except
+    for I := 0 to Length(AColumns) - 1 do
+      AColumns[I].Free;
+    AColumns := nil;
+    raise;
+  end;
+
+  if (Text.Columns > 0) then
+  begin
+    Text.X := @Planes[0];
+    RunTextPass(Text, _qd_parse_text);
+  end;
+  Result := Text.Errors;
+end;
+
+function WriteText(const AColumns: array of TDoubleDoubleArrays;
+  const AFormat: TMPFloatFormat; const APrecision: Integer;
+  const ASeparator: AnsiChar): TBytes;
+var
+  Planes: TArray<PDouble>;
+  I: Integer;
+begin
+  if (Length(AColumns) = 0) then
+    Exit(nil);
+
+  SetLength(Planes, Length(AColumns) * 2);
+  for I := 0 to Length(AColumns) - 1 do
+  begin
+    Assert(AColumns[I].Count = AColumns[0].Count);
+    Planes[I * 2] := AColumns[I].X[0];
+    Planes[I * 2 + 1] := AColumns[I].X[1];
+  end;
+  Result := FormatText(Planes, Length(AColumns), AColumns[0].Count, AFormat,
+    APrecision, ASeparator, _dd_measure_text, _dd_format_text);
+end;
+
+function WriteText(const AColumns: array of TQuadDoubleArrays;
+  const AFormat: TMPFloatFormat; const APrecision: Integer;
+  const ASeparator: AnsiChar): TBytes;
+var
+  Planes: TArray<PDouble>;
+  I, J: Integer;
+begin
+  if (Length(AColumns) = 0) then
+    Exit(nil);
+
+  SetLength(Planes, Length(AColumns) * 4);
+  for I := 0 to Length(AColumns) - 1 do
+  begin
+    Assert(AColumns[I].Count = AColumns[0].Count);
+    for J := 0 to 3 do
+      Planes[I * 4 + J] := AColumns[I].X[J];
+  end;
+  Result := FormatText(Planes, Length(AColumns), AColumns[0].Count, AFormat,
+    APrecision, ASeparator, _qd_measure_text, _qd_format_text);
+end;
+
+{ TQuadDoubleArrays }
+
+procedure TQuadDoubleArrays.Init(const X0, X1, X2, X3: PDouble;
+  const Count: Integer);
+begin
+  X[0] := X0;
+  X[1] := X1;
+  X[2] := X2;
+  X[3] := X3;
+  Self.Count := Count;
+end;
+
+procedure TQuadDoubleArrays.Load(const Source: PQuadDouble);
+begin
+  _qd_to_soa(Source, Self);
+end;
+
+procedure TQuadDoubleArrays.Store(const Target: PQuadDouble);
+begin
+  _qd_to_aos(Self, Target);
+end;
+
+{ Vector memory }
+
+{$POINTERMATH ON}
+
+const
+  VECTOR_ALIGNMENT = 64;
+
+{ Allocates memory for APlanes planes of ACount Doubles each. Returns the
+  first plane (aligned to VECTOR_ALIGNMENT bytes) and sets AStride to the
+  distance between planes in Doubles. AMemory must be passed to
+  FreeVectorMemory later. }
+function AllocVectorMemory(const ACount, APlanes: Integer;
+  const ALargePages: Boolean; out AMemory: Pointer; out AStride: Integer;
+  out AIsLarge: Boolean): PDouble;
+var
+  Size: NativeUInt;
+  {$IFDEF MSWINDOWS}
+  PageSize: NativeUInt;
+  {$ENDIF}
+begin
+  AStride := (ACount + (VECTOR_ALIGNMENT div SizeOf(Double)) - 1)
+    and not ((VECTOR_ALIGNMENT div SizeOf(Double)) - 1);
+  Size := NativeUInt(AStride) * NativeUInt(APlanes) * SizeOf(Double);
+  AIsLarge := False;
+
+  {$IFDEF MSWINDOWS}
+  if (ALargePages) then
+  begin
+    PageSize := GetLargePageMinimum;
+    if (PageSize <> 0) then
+    begin
+      AMemory := VirtualAlloc(nil, (Size + PageSize - 1) and not (PageSize - 1),
+        MEM_RESERVE or MEM_COMMIT or MEM_LARGE_PAGES, PAGE_READWRITE);
+      if (AMemory <> nil) then
+      begin
+        AIsLarge := True;
+        Exit(AMemory);
+      end;
+    end;
+  end;
+  {$ENDIF}
+
+  GetMem(AMemory, Size + VECTOR_ALIGNMENT - 1);
+  Result := Pointer((UIntPtr(AMemory) + VECTOR_ALIGNMENT - 1)
+    and not UIntPtr(VECTOR_ALIGNMENT - 1));
+end;
+
+procedure FreeVectorMemory(const AMemory: Pointer; const AIsLarge: Boolean);
+begin
+  {$IFDEF MSWINDOWS}
+  if (AIsLarge) then
+  begin
+    VirtualFree(AMemory, 0, MEM_RELEASE);
+    Exit;
+  end;
+  {$ENDIF}
+  FreeMem(AMemory);
+end;
+
+{ Vector files }
+
+const
+  { qd_file_layout and qd_file_status in C/c_file.h }
+  FILE_LAYOUT_SOA = 0;
+  FILE_OK = 0;
+  FILE_VERSION = 2;
+  FILE_BYTE_ORDER = 3;
+
+resourcestring
+  SVectorFileInvalid = 'Invalid or truncated vector file';
+  SVectorFileVersion = 'Vector file was written by a newer version';
+  SVectorFileByteOrder = 'Vector file was written on a CPU with a different byte order';
+  SVectorFileType = 'Vector file contains values of a different type';
+
+{ Checks the header of a vector file of ASize bytes with AComponents
+  components }
+procedure CheckFileHeader(const AHeader: _TFileHeader; const ASize: Int64;
+  const AComponents: Integer);
+begin
+  case _qd_file_check(AHeader, @ASize) of
+    FILE_OK:
+      ;
+    FILE_VERSION:
+      raise EReadError.CreateRes(@SVectorFileVersion);
+    FILE_BYTE_ORDER:
+      raise EReadError.CreateRes(@SVectorFileByteOrder);
+  else
+    raise EReadError.CreateRes(@SVectorFileInvalid);
+  end;
+  if (AHeader.Components <> AComponents) then
+    raise EReadError.CreateRes(@SVectorFileType);
+  if (AHeader.Count > MaxInt) then
+    raise EReadError.CreateRes(@SVectorFileInvalid);
+end;
+
+procedure SaveVector(const AStream: TStream; const AX: array of PDouble;
+  const ACount: Integer);
+var
+  Header: _TFileHeader;
+  Padding: array [0..VECTOR_ALIGNMENT - 1] of Byte;
+  Size: NativeInt;
+  I: Integer;
+begin
+  _qd_file_init(Header, Length(AX), FILE_LAYOUT_SOA, ACount);
+  FillChar(Padding, SizeOf(Padding), 0);
+  Size := NativeInt(ACount) * SizeOf(Double);
+  AStream.WriteBuffer(Header, SizeOf(Header));
+  for I := 0 to Length(AX) - 1 do
+  begin
+    AStream.WriteBuffer(AX[I]^, Size);
+    AStream.WriteBuffer(Padding, NativeInt(Header.Stride) - Size);
+  end;
+end;
+
+{ Reads and checks the header of a vector file from a stream, and skips to
+  the values }
+function ReadFileHeader(const AStream: TStream;
+  const AComponents: Integer): _TFileHeader;
+begin
+  if (AStream.Read(Result, SizeOf(Result)) <> SizeOf(Result)) then
+    raise EReadError.CreateRes(@SVectorFileInvalid);
+  CheckFileHeader(Result, AStream.Size - AStream.Position + SizeOf(Result),
+    AComponents);
+  AStream.Seek(Result.HeaderSize - SizeOf(Result), soCurrent);
+end;
+
+{ Reads the values after the header into the planes AX }
+procedure ReadFileValues(const AStream: TStream; const AHeader: _TFileHeader;
+  const AX: array of PDouble);
+var
+  Buffer: array [0..1023] of Double;
+  Size: NativeInt;
+  Done, N, I, J: Integer;
+begin
+  Size := NativeInt(AHeader.Count) * SizeOf(Double);
+  if (AHeader.Layout = FILE_LAYOUT_SOA) then
+  begin
+    for I := 0 to Length(AX) - 1 do
+    begin
+      AStream.ReadBuffer(AX[I]^, Size);
+      if (I < Length(AX) - 1) then
+        AStream.Seek(AHeader.Stride - Size, soCurrent);
+    end;
+    Exit;
+  end;
+
+  { Array of structures: de-interleave through a buffer }
+  Done := 0;
+  while (Done < AHeader.Count) do
+  begin
+    N := Min(Length(Buffer) div Length(AX), Integer(AHeader.Count) - Done);
+    AStream.ReadBuffer(Buffer, N * Length(AX) * SizeOf(Double));
+    for J := 0 to N - 1 do
+      for I := 0 to Length(AX) - 1 do
+        AX[I][Done + J] := Buffer[J * Length(AX) + I];
+    Inc(Done, N);
+  end;
+end;
+
+{ Maps a whole file into memory (copy-on-write) }
+function MapFile(const AFilename: String; out ASize: NativeInt): Pointer;
+{$IFDEF MSWINDOWS}
+var
+  Handle, Mapping: THandle;
+  Size: Int64;
+begin
+  Handle := CreateFile(PChar(AFilename), GENERIC_READ, FILE_SHARE_READ, nil,
+    OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0);
+  if (Handle = INVALID_HANDLE_VALUE) then
+    RaiseLastOSError;
+  try
+    if (not GetFileSizeEx(Handle, Size)) then
+      RaiseLastOSError;
+    if (Size < SizeOf(_TFileHeader)) or (NativeInt(Size) <> Size) then
+      raise EReadError.CreateRes(@SVectorFileInvalid);
+
+    Mapping := CreateFileMapping(Handle, nil, PAGE_WRITECOPY, 0, 0, nil);
+    if (Mapping = 0) then
+      RaiseLastOSError;
+    try
+      Result := MapViewOfFile(Mapping, FILE_MAP_COPY, 0, 0, 0);
+      if (Result = nil) then
+        RaiseLastOSError;
+    finally
+      CloseHandle(Mapping);
+    end;
+  finally
+    CloseHandle(Handle);
+  end;
+  ASize := Size;
+end;
+{$ELSE}
+var
+  Handle: Integer;
+  Stat: _stat;
+  M: TMarshaller;
+begin
+  Handle := open(M.AsUtf8(AFilename).ToPointer, O_RDONLY);
+  if (Handle = -1) then
+    RaiseLastOSError;
+  try
+    if (fstat(Handle, Stat) <> 0) then
+      RaiseLastOSError;
+    if (Stat.st_size < SizeOf(_TFileHeader)) or (NativeInt(Stat.st_size) <> Stat.st_size) then
+      raise EReadError.CreateRes(@SVectorFileInvalid);
+
+    Result := mmap(nil, Stat.st_size, PROT_READ or PROT_WRITE, MAP_PRIVATE,
+      Handle, 0);
+    if (Result = MAP_FAILED) then
+      RaiseLastOSError;
+  finally
+    __close(Handle);
+  end;
+  ASize := Stat.st_size;
+end;
+{$ENDIF}
+
+procedure UnmapFile(const AView: Pointer; const ASize: NativeInt);
+begin
+  {$IFDEF MSWINDOWS}
+  UnmapViewOfFile(AView);
+  {$ELSE}
+  munmap(AView, ASize);
+  {$ENDIF}
+end;
+
+{ Maps a vector file with AComponents planes into memory. Returns the view
+  and sets the planes in AX. Returns nil if the file uses the
+  array-of-structures layout, which must be read with ReadFileValues. }
+function MapVectorFile(const AFilename: String; const AComponents: Integer;
+  var AX: array of PDouble; out ACount: Integer;
+  out AMappedSize: NativeInt): Pointer;
+var
+  View: PByte;
+  Header: ^_TFileHeader;
+  Size: NativeInt;
+  I: Integer;
+begin
+  ACount := 0;
+  AMappedSize := 0;
+  View := MapFile(AFilename, Size);
+  Header := Pointer(View);
+  try
+    CheckFileHeader(Header^, Size, AComponents);
+  except
+    UnmapFile(View, Size);
+    raise;
+  end;
+
+  if (Header.Layout <> FILE_LAYOUT_SOA) then
+  begin
+    UnmapFile(View, Size);
+    Exit(nil);
+  end;
+
+  for I := 0 to AComponents - 1 do
+    AX[I] := Pointer(View + NativeInt(_qd_file_offset(Header^, I)));
+  ACount := Header.Count;
+  AMappedSize := Size;
+  Result := View;
+end;
+
+{ TDoubleDoubleVector }
+
+constructor TDoubleDoubleVector.Create(const ACount: Integer;
+  const ALargePages: Boolean);
+var
+  Stride: Integer;
+begin
+  inherited Create;
+  FArrays.X[0] := AllocVectorMemory(ACount, 2, ALargePages, FMemory, Stride,
+    FLargePages);
+  FArrays.X[1] := FArrays.X[0] + Stride;
+  FArrays.Count := ACount;
+end;
+
+constructor TDoubleDoubleVector.CreateFromFile(const AFilename: String);
+var
+  Stream: TFileStream;
+begin
+  inherited Create;
+  FMemory := MapVectorFile(AFilename, 2, FArrays.X, FArrays.Count,
+    FMappedSize);
+  if (FMemory = nil) then
+  begin
+    Stream := TFileStream.Create(AFilename, fmOpenRead or fmShareDenyWrite);
+    try
+      CreateFromStream(Stream);
+    finally
+      Stream.Free;
+    end;
+  end;
+end;
+
+constructor TDoubleDoubleVector.CreateFromStream(const AStream: TStream;
+  const ALargePages: Boolean);
+var
+  Header: _TFileHeader;
+begin
+  Header := ReadFileHeader(AStream, 2);
+  Create(Header.Count, ALargePages);
+  ReadFileValues(AStream, Header, FArrays.X);
+end;
+
+destructor TDoubleDoubleVector.Destroy;
+begin
+  if (FMappedSize <> 0) then
+    UnmapFile(FMemory, FMappedSize)
+  else
+    FreeVectorMemory(FMemory, FLargePages);
+  inherited;
+end;
+
+function TDoubleDoubleVector.GetItem(const AIndex: Integer): DoubleDouble;
+begin
+  Assert(Cardinal(AIndex) < Cardinal(FArrays.Count));
+  Result.X[0] := FArrays.X[0][AIndex];
+  Result.X[1] := FArrays.X[1][AIndex];
+end;
+
+procedure TDoubleDoubleVector.Load(const ASource: PDoubleDouble);
+begin
+  _dd_to_soa(ASource, FArrays);
+end;
+
+procedure TDoubleDoubleVector.SaveToFile(const AFilename: String);
+var
+  Stream: TFileStream;
+begin
+  Stream := TFileStream.Create(AFilename, fmCreate);
+  try
+    SaveToStream(Stream);
+  finally
+    Stream.Free;
+  end;
+end;
+
+procedure TDoubleDoubleVector.SaveToStream(const AStream: TStream);
+begin
+  SaveVector(AStream, FArrays.X, FArrays.Count);
+end;
+
+procedure TDoubleDoubleVector.SetItem(const AIndex: Integer;
+  const AValue: DoubleDouble);
+begin
+  Assert(Cardinal(AIndex) < Cardinal(FArrays.Count));
+  FArrays.X[0][AIndex] := AValue.X[0];
+  FArrays.X[1][AIndex] := AValue.X[1];
+end;
+
+procedure TDoubleDoubleVector.Store(const ATarget: PDoubleDouble);
+begin
+  _dd_to_aos(FArrays, ATarget);
+end;
+
+{ TQuadDoubleVector }
+
+constructor TQuadDoubleVector.Create(const ACount: Integer;
+  const ALargePages: Boolean);
+var
+  Stride, I: Integer;
+begin
+  inherited Create;
+  FArrays.X[0] := AllocVectorMemory(ACount, 4, ALargePages, FMemory, Stride,
+    FLargePages);
+  for I := 1 to 3 do
+    FArrays.X[I] := FArrays.X[I - 1] + Stride;
+  FArrays.Count := ACount;
+end;
+
+constructor TQuadDoubleVector.CreateFromFile(const AFilename: String);
+var
+  Stream: TFileStream;
+begin
+  inherited Create;
+  FMemory := MapVectorFile(AFilename, 4, FArrays.X, FArrays.Count,
+    FMappedSize);
+  if (FMemory = nil) then
+  begin
+    Stream := TFileStream.Create(AFilename, fmOpenRead or fmShareDenyWrite);
+    try
+      CreateFromStream(Stream);
+    finally
+      Stream.Free;
+    end;
+  end;
+end;
+
+constructor TQuadDoubleVector.CreateFromStream(const AStream: TStream;
+  const ALargePages: Boolean);
+var
+  Header: _TFileHeader;
+begin
+  Header := ReadFileHeader(AStream, 4);
+  Create(Header.Count, ALargePages);
+  ReadFileValues(AStream, Header, FArrays.X);
+end;
+
+destructor TQuadDoubleVector.Destroy;
+begin
+  if (FMappedSize <> 0) then
+    UnmapFile(FMemory, FMappedSize)
+  else
+    FreeVectorMemory(FMemory, FLargePages);
+  inherited;
+end;
+
+function TQuadDoubleVector.GetItem(const AIndex: Integer): QuadDouble;
+var
+  I: Integer;
+begin
+  Assert(Cardinal(AIndex) < Cardinal(FArrays.Count));
+  for I := 0 to 3 do
+    Result.X[I] := FArrays.X[I][AIndex];
+end;
+
+procedure TQuadDoubleVector.Load(const ASource: PQuadDouble);
+begin
+  _qd_to_soa(ASource, FArrays);
+end;
+
+procedure TQuadDoubleVector.SaveToFile(const AFilename: String);
+var
+  Stream: TFileStream;
+begin
+  Stream := TFileStream.Create(AFilename, fmCreate);
+  try
+    SaveToStream(Stream);
+  finally
+    Stream.Free;
+  end;
+end;
+
+procedure TQuadDoubleVector.SaveToStream(const AStream: TStream);
+begin
+  SaveVector(AStream, FArrays.X, FArrays.Count);
+end;
+
+procedure TQuadDoubleVector.SetItem(const AIndex: Integer;
+  const AValue: QuadDouble);
+var
+  I: Integer;
+begin
+  Assert(Cardinal(AIndex) < Cardinal(FArrays.Count));
+  for I := 0 to 3 do
+    FArrays.X[I][AIndex] := AValue.X[I];
+end;
+
+procedure TQuadDoubleVector.Store(const ATarget: PQuadDouble);
+begin
+  _qd_to_aos(FArrays, ATarget);
+end;
+
+{$POINTERMATH OFF}
+{$ENDIF}
+
+{ DoubleDouble }
+
+{$IF Defined(MP_REBUILT_BINARIES)}
+class function DoubleDouble.AccurateAdd(const A, B: DoubleDouble): DoubleDouble;
+begin
+  _dd_add_accurate(A, B, Result);
+end;
+
+class function DoubleDouble.AccurateDivide(const A, B: DoubleDouble): DoubleDouble;
+begin
+  _dd_div_accurate(A, B, Result);
+end;
+
+class function DoubleDouble.AccurateSubtract(const A, B: DoubleDouble): DoubleDouble;
+begin
+  _dd_sub_accurate(A, B, Result);
+end;
+{$ENDIF}
+
+class operator DoubleDouble.Add(const A, B: DoubleDouble): DoubleDouble;
+begin
+  _dd_add(A, B, Result);
+end;
+
+class operator DoubleDouble.Add(const A: Double; const B: DoubleDouble): DoubleDouble;
+begin
+  _dd_add_d_dd(@A, B, Result);
+end;
+
+class operator DoubleDouble.Add(const A: DoubleDouble; const B: Double): DoubleDouble;
+begin
+  _dd_add_dd_d(A, @B, Result);
+end;
+
+procedure DoubleDouble.Clear;
+begin
+  X[0] := 0;
+  X[1] := 0;
+end;
+
+class operator DoubleDouble.Divide(const A, B: DoubleDouble): DoubleDouble;
+begin
+  _dd_div(A, B, Result);
+end;
+
+class operator DoubleDouble.Divide(const A: Double; const B: DoubleDouble): DoubleDouble;
+begin
+  _dd_div_d_dd(@A, B, Result);
+end;
+
+class operator DoubleDouble.Divide(const A: DoubleDouble; const B: Double): DoubleDouble;
+begin
+  _dd_div_dd_d(A, @B, Result);
+end;
+
+class operator DoubleDouble.Equal(const A: DoubleDouble; const B: Double): Boolean;
+begin
+  Result := (A.X[0] = B) and (A.X[1] = 0);
+end;
+
+class operator DoubleDouble.Equal(const A: Double; const B: DoubleDouble): Boolean;
+begin
+  Result := (A = B.X[0]) and (B.X[1] = 0);
+end;
+
+function DoubleDouble.Equals(const A: DoubleDouble): Boolean;
+begin
+  Result := (X[0] = A.X[0]) and (X[1] = A.X[1]);
+end;
+
+function DoubleDouble.Equals(const A: Double): Boolean;
+begin
+  Result := (X[0] = A) and (X[1] = 0);
+end;
+
+class operator DoubleDouble.Equal(const A, B: DoubleDouble): Boolean;
+begin
+  Result := (A.X[0] = B.X[0]) and (A.X[1] = B.X[1]);
+end;
+
+class operator DoubleDouble.GreaterThan(const A: DoubleDouble;
+  const B: Double): Boolean;
+begin
+  Result := (A.X[0] > B) or ((A.X[0] = B) and (A.X[1] > 0));
+end;
+
+class operator DoubleDouble.GreaterThan(const A, B: DoubleDouble): Boolean;
+begin
+  Result := (A.X[0] > B.X[0]) or ((A.X[0] = B.X[0]) and (A.X[1] > B.X[1]));
+end;
+
+function DoubleDouble.GetExp: UInt64;
+begin
+  Result := X[0].Exp;
+end;
+
+function DoubleDouble.GetSign: Boolean;
+begin
+  Result := X[0].Sign;
+end;
+
+function DoubleDouble.GetSpecialType: TFloatSpecial;
+begin
+  if (IsZero) then
   begin
     if (PUInt64(@Self)^ = $8000000000000000) then
       Result := fsNZero
@@ -3184,6 +5750,29 @@ begin
   X[1] := Lo;
 end;
 
+{$IF Defined(MP_REBUILT_BINARIES)}
+procedure DoubleDouble.Init(const S: String;
+  const FormatSettings: TFormatSettings);
+var
+  Buffer: array [0..127] of Byte;
+  LongBuffer: TBytes;
+  P: PByte;
+  Len: Integer;
+begin
+  if (Length(S) < Length(Buffer)) then
+    P := @Buffer
+  else
+  begin
+    SetLength(LongBuffer, Length(S) + 1);
+    P := Pointer(LongBuffer);
+  end;
+  Len := _dd_parse(P, StringToDecimal(S, FormatSettings, P), Self);
+
+  { Only whitespace may follow the number }
+  if (Len = 0) or (P[Len] > Ord(' ')) then
+    Self := NaN;
+end;
+{$ELSE}
 procedure DoubleDouble.Init(const S: String;
   const FormatSettings: TFormatSettings);
 var
@@ -3295,6 +5884,7 @@ begin
   else
     Self := R;
 end;
+{$ENDIF}
 
 procedure DoubleDouble.Init(const S: String);
 begin
@@ -3399,58 +5989,148 @@ begin
   Result := (A.X[0] <> B.X[0]) or (A.X[1] <> B.X[1]);
 end;
 
-class operator DoubleDouble.NotEqual(const A: DoubleDouble; const B: Double): Boolean;
+class operator DoubleDouble.NotEqual(const A: DoubleDouble; const B: Double): Boolean;
+begin
+  Result := (A.X[0] <> B) or (A.X[1] <> 0);
+end;
+
+class operator DoubleDouble.NotEqual(const A: Double; const B: DoubleDouble): Boolean;
+begin
+  Result := (A <> B.X[0]) or (B.X[1] <> 0);
+end;
+
+class function DoubleDouble.Parse(const S: String): DoubleDouble;
+begin
+  Result.Init(S, FormatSettings);
+end;
+
+class function DoubleDouble.Parse(const S: String;
+  const FormatSettings: TFormatSettings): DoubleDouble;
+begin
+  Result.Init(S, FormatSettings);
+end;
+
+class operator DoubleDouble.Subtract(const A, B: DoubleDouble): DoubleDouble;
+begin
+  _dd_sub(A, B, Result);
+end;
+
+class operator DoubleDouble.Subtract(const A: Double; const B: DoubleDouble): DoubleDouble;
+begin
+  _dd_sub_d_dd(@A, B, Result);
+end;
+
+procedure DoubleDouble.SetExp(const Value: UInt64);
+begin
+  X[0].Exp := Value;
+end;
+
+procedure DoubleDouble.SetSign(const Value: Boolean);
+begin
+  X[0].Sign := Value;
+  X[1].Sign := Value;
+end;
+
+class function DoubleDouble.Size: Integer;
+begin
+  Result := SizeOf(DoubleDouble);
+end;
+
+{$IF Defined(MP_REBUILT_BINARIES)}
+class function DoubleDouble.SloppyAdd(const A, B: DoubleDouble): DoubleDouble;
+begin
+  _dd_add_sloppy(A, B, Result);
+end;
+
+class function DoubleDouble.SloppyDivide(const A, B: DoubleDouble): DoubleDouble;
+begin
+  _dd_div_sloppy(A, B, Result);
+end;
+
+class function DoubleDouble.SloppySubtract(const A, B: DoubleDouble): DoubleDouble;
 begin
-  Result := (A.X[0] <> B) or (A.X[1] <> 0);
+  _dd_sub_sloppy(A, B, Result);
 end;
+{$ENDIF}
 
-class operator DoubleDouble.NotEqual(const A: Double; const B: DoubleDouble): Boolean;
+class operator DoubleDouble.Subtract(const A: DoubleDouble; const B: Double): DoubleDouble;
 begin
-  Result := (A <> B.X[0]) or (B.X[1] <> 0);
+  _dd_sub_dd_d(A, @B, Result);
 end;
 
-class function DoubleDouble.Parse(const S: String): DoubleDouble;
+function DoubleDouble.ToDouble: Double;
 begin
-  Result.Init(S, FormatSettings);
+  Result := X[0];
 end;
 
-class function DoubleDouble.Parse(const S: String;
-  const FormatSettings: TFormatSettings): DoubleDouble;
+function DoubleDouble.ToExtended: Extended;
 begin
-  Result.Init(S, FormatSettings);
+  Result := X[1] + X[0];
 end;
 
-class operator DoubleDouble.Subtract(const A, B: DoubleDouble): DoubleDouble;
+function DoubleDouble.ToInteger: Integer;
 begin
-  _dd_sub(A, B, Result);
+  Result := System.Trunc(X[0]);
 end;
 
-class operator DoubleDouble.Subtract(const A: Double; const B: DoubleDouble): DoubleDouble;
+class function DoubleDouble.ToString(const Value: DoubleDouble;
+  const FormatSettings: TFormatSettings; const Format: TMPFloatFormat;
+  const Precision: Integer): String;
 begin
-  _dd_sub_d_dd(@A, B, Result);
+  Result := Value.ToString(FormatSettings, Format, Precision);
 end;
 
-procedure DoubleDouble.SetExp(const Value: UInt64);
+class function DoubleDouble.TryParse(const S: String;
+  out Value: DoubleDouble): Boolean;
 begin
-  X[0].Exp := Value;
+  Value.Init(S, FormatSettings);
+  Result := (not Value.IsNan);
 end;
 
-procedure DoubleDouble.SetSign(const Value: Boolean);
+class function DoubleDouble.TryParse(const S: String; out Value: DoubleDouble;
+  const FormatSettings: TFormatSettings): Boolean;
 begin
-  X[0].Sign := Value;
-  X[1].Sign := Value;
+  Value.Init(S, FormatSettings);
+  Result := (not Value.IsNan);
 end;
 
-class function DoubleDouble.Size: Integer;
+class function DoubleDouble.ToString(const Value: DoubleDouble;
+  const Format: TMPFloatFormat; const Precision: Integer): String;
 begin
-  Result := SizeOf(DoubleDouble);
+  Result := Value.ToString(FormatSettings, Format, Precision);
 end;
 
-class operator DoubleDouble.Subtract(const A: DoubleDouble; const B: Double): DoubleDouble;
+function DoubleDouble.ToString(const Format: TMPFloatFormat;
+  const Precision: Integer): String;
 begin
-  _dd_sub_dd_d(A, @B, Result);
+  Result := ToString(FormatSettings, Format, Precision);
 end;
 
+{$IF Defined(MP_REBUILT_BINARIES)}
+function DoubleDouble.ToString(const FormatSettings: TFormatSettings;
+  const Format: TMPFloatFormat; const Precision: Integer): String;
+var
+  Buffer: array [0..127] of Byte;
+  LongBuffer: TBytes;
+  S: _TDecimalString;
+  Len: Integer;
+begin
+  S.Buffer := @Buffer;
+  S.Size := Length(Buffer);
+  S.Format := Ord(Format);
+  S.Precision := Precision;
+  Len := _dd_to_string(Self, S);
+  if (Len >= S.Size) then
+  begin
+    { Fixed format of a large value, or a large precision }
+    SetLength(LongBuffer, Len + 1);
+    S.Buffer := Pointer(LongBuffer);
+    S.Size := Len + 1;
+    _dd_to_string(Self, S);
+  end;
+  Result := DecimalToString(S.Buffer, Len, FormatSettings);
+end;
+{$ELSE}
 procedure DoubleDouble.ToDigits(const S: TArray<Char>; var Exponent: Integer;
   const Precision: Integer);
 var
@@ -3555,54 +6235,6 @@ begin
   Exponent := E;
 end;
 
-function DoubleDouble.ToDouble: Double;
-begin
-  Result := X[0];
-end;
-
-function DoubleDouble.ToExtended: Extended;
-begin
-  Result := X[1] + X[0];
-end;
-
-function DoubleDouble.ToInteger: Integer;
-begin
-  Result := System.Trunc(X[0]);
-end;
-
-class function DoubleDouble.ToString(const Value: DoubleDouble;
-  const FormatSettings: TFormatSettings; const Format: TMPFloatFormat;
-  const Precision: Integer): String;
-begin
-  Result := Value.ToString(FormatSettings, Format, Precision);
-end;
-
-class function DoubleDouble.TryParse(const S: String;
-  out Value: DoubleDouble): Boolean;
-begin
-  Value.Init(S, FormatSettings);
-  Result := (not Value.IsNan);
-end;
-
-class function DoubleDouble.TryParse(const S: String; out Value: DoubleDouble;
-  const FormatSettings: TFormatSettings): Boolean;
-begin
-  Value.Init(S, FormatSettings);
-  Result := (not Value.IsNan);
-end;
-
-class function DoubleDouble.ToString(const Value: DoubleDouble;
-  const Format: TMPFloatFormat; const Precision: Integer): String;
-begin
-  Result := Value.ToString(FormatSettings, Format, Precision);
-end;
-
-function DoubleDouble.ToString(const Format: TMPFloatFormat;
-  const Precision: Integer): String;
-begin
-  Result := ToString(FormatSettings, Format, Precision);
-end;
-
 function DoubleDouble.ToString(const FormatSettings: TFormatSettings;
   const Format: TMPFloatFormat; const Precision: Integer): String;
 var
@@ -3759,9 +6391,32 @@ begin
     SB.Free;
   end;
 end;
+{$ENDIF}
 
 { QuadDouble }
 
+{$IF Defined(MP_REBUILT_BINARIES)}
+class function QuadDouble.AccurateAdd(const A, B: QuadDouble): QuadDouble;
+begin
+  _qd_add_accurate(A, B, Result);
+end;
+
+class function QuadDouble.AccurateDivide(const A, B: QuadDouble): QuadDouble;
+begin
+  _qd_div_accurate(A, B, Result);
+end;
+
+class function QuadDouble.AccurateMultiply(const A, B: QuadDouble): QuadDouble;
+begin
+  _qd_mul_accurate(A, B, Result);
+end;
+
+class function QuadDouble.AccurateSubtract(const A, B: QuadDouble): QuadDouble;
+begin
+  _qd_sub_accurate(A, B, Result);
+end;
+{$ENDIF}
+
 class operator QuadDouble.Add(const A: QuadDouble; const B: Double): QuadDouble;
 begin
   _qd_add_qd_d(A, @B, Result);
@@ -4020,6 +6675,29 @@ begin
   X[3] := X3;
 end;
 
+{$IF Defined(MP_REBUILT_BINARIES)}
+procedure QuadDouble.Init(const S: String;
+  const FormatSettings: TFormatSettings);
+var
+  Buffer: array [0..127] of Byte;
+  LongBuffer: TBytes;
+  P: PByte;
+  Len: Integer;
+begin
+  if (Length(S) < Length(Buffer)) then
+    P := @Buffer
+  else
+  begin
+    SetLength(LongBuffer, Length(S) + 1);
+    P := Pointer(LongBuffer);
+  end;
+  Len := _qd_parse(P, StringToDecimal(S, FormatSettings, P), Self);
+
+  { Only whitespace may follow the number }
+  if (Len = 0) or (P[Len] > Ord(' ')) then
+    Self := NaN;
+end;
+{$ELSE}
 procedure QuadDouble.Init(const S: String;
   const FormatSettings: TFormatSettings);
 var
@@ -4131,6 +6809,7 @@ begin
   else
     Self := R;
 end;
+{$ENDIF}
 
 procedure QuadDouble.Init(const S: String);
 begin
@@ -4336,6 +7015,28 @@ begin
   Result := SizeOf(QuadDouble);
 end;
 
+{$IF Defined(MP_REBUILT_BINARIES)}
+class function QuadDouble.SloppyAdd(const A, B: QuadDouble): QuadDouble;
+begin
+  _qd_add_sloppy(A, B, Result);
+end;
+
+class function QuadDouble.SloppyDivide(const A, B: QuadDouble): QuadDouble;
+begin
+  _qd_div_sloppy(A, B, Result);
+end;
+
+class function QuadDouble.SloppyMultiply(const A, B: QuadDouble): QuadDouble;
+begin
+  _qd_mul_sloppy(A, B, Result);
+end;
+
+class function QuadDouble.SloppySubtract(const A, B: QuadDouble): QuadDouble;
+begin
+  _qd_sub_sloppy(A, B, Result);
+end;
+{$ENDIF}
+
 class operator QuadDouble.Subtract(const A: QuadDouble;
   const B: DoubleDouble): QuadDouble;
 begin
@@ -4357,6 +7058,84 @@ begin
   _qd_sub_qd_d(A, @B, Result);
 end;
 
+function QuadDouble.ToDouble: Double;
+begin
+  Result := X[0];
+end;
+
+function QuadDouble.ToDoubleDouble: DoubleDouble;
+begin
+  Result.Init(X[0], X[1]);
+end;
+
+function QuadDouble.ToExtended: Extended;
+begin
+  Result := X[1] + X[0];
+end;
+
+function QuadDouble.ToInteger: Integer;
+begin
+  Result := System.Trunc(X[0]);
+end;
+
+class function QuadDouble.ToString(const Value: QuadDouble;
+  const FormatSettings: TFormatSettings; const Format: TMPFloatFormat;
+  const Precision: Integer): String;
+begin
+  Result := Value.ToString(FormatSettings, Format, Precision);
+end;
+
+class function QuadDouble.TryParse(const S: String;
+  out Value: QuadDouble): Boolean;
+begin
+  Value.Init(S, FormatSettings);
+  Result := (not Value.IsNan);
+end;
+
+class function QuadDouble.TryParse(const S: String; out Value: QuadDouble;
+  const FormatSettings: TFormatSettings): Boolean;
+begin
+  Value.Init(S, FormatSettings);
+  Result := (not Value.IsNan);
+end;
+
+class function QuadDouble.ToString(const Value: QuadDouble;
+  const Format: TMPFloatFormat; const Precision: Integer): String;
+begin
+  Result := Value.ToString(FormatSettings, Format, Precision);
+end;
+
+function QuadDouble.ToString(const Format: TMPFloatFormat;
+  const Precision: Integer): String;
+begin
+  Result := ToString(FormatSettings, Format, Precision);
+end;
+
+{$IF Defined(MP_REBUILT_BINARIES)}
+function QuadDouble.ToString(const FormatSettings: TFormatSettings;
+  const Format: TMPFloatFormat; const Precision: Integer): String;
+var
+  Buffer: array [0..127] of Byte;
+  LongBuffer: TBytes;
+  S: _TDecimalString;
+  Len: Integer;
+begin
+  S.Buffer := @Buffer;
+  S.Size := Length(Buffer);
+  S.Format := Ord(Format);
+  S.Precision := Precision;
+  Len := _qd_to_string(Self, S);
+  if (Len >= S.Size) then
+  begin
+    { Fixed format of a large value, or a large precision }
+    SetLength(LongBuffer, Len + 1);
+    S.Buffer := Pointer(LongBuffer);
+    S.Size := Len + 1;
+    _qd_to_string(Self, S);
+  end;
+  Result := DecimalToString(S.Buffer, Len, FormatSettings);
+end;
+{$ELSE}
 procedure QuadDouble.ToDigits(const S: TArray<Char>; var Exponent: Integer;
   const Precision: Integer);
 var
@@ -4461,59 +7240,6 @@ begin
   Exponent := E;
 end;
 
-function QuadDouble.ToDouble: Double;
-begin
-  Result := X[0];
-end;
-
-function QuadDouble.ToDoubleDouble: DoubleDouble;
-begin
-  Result.Init(X[0], X[1]);
-end;
-
-function QuadDouble.ToExtended: Extended;
-begin
-  Result := X[1] + X[0];
-end;
-
-function QuadDouble.ToInteger: Integer;
-begin
-  Result := System.Trunc(X[0]);
-end;
-
-class function QuadDouble.ToString(const Value: QuadDouble;
-  const FormatSettings: TFormatSettings; const Format: TMPFloatFormat;
-  const Precision: Integer): String;
-begin
-  Result := Value.ToString(FormatSettings, Format, Precision);
-end;
-
-class function QuadDouble.TryParse(const S: String;
-  out Value: QuadDouble): Boolean;
-begin
-  Value.Init(S, FormatSettings);
-  Result := (not Value.IsNan);
-end;
-
-class function QuadDouble.TryParse(const S: String; out Value: QuadDouble;
-  const FormatSettings: TFormatSettings): Boolean;
-begin
-  Value.Init(S, FormatSettings);
-  Result := (not Value.IsNan);
-end;
-
-class function QuadDouble.ToString(const Value: QuadDouble;
-  const Format: TMPFloatFormat; const Precision: Integer): String;
-begin
-  Result := Value.ToString(FormatSettings, Format, Precision);
-end;
-
-function QuadDouble.ToString(const Format: TMPFloatFormat;
-  const Precision: Integer): String;
-begin
-  Result := ToString(FormatSettings, Format, Precision);
-end;
-
 function QuadDouble.ToString(const FormatSettings: TFormatSettings;
   const Format: TMPFloatFormat; const Precision: Integer): String;
 var
@@ -4670,6 +7396,7 @@ begin
     SB.Free;
   end;
 end;
+{$ENDIF}
 
 initialization
   Initialize;
@@ -280,6 +280,7 @@ begin
     1: Precision := TPrecision.Double;
     2: Precision := TPrecision.DoubleDouble;
     3: Precision := TPrecision.QuadDouble;
+    4: Precision := TPrecision.Perturbation;
   else
     Assert(False);
     Precision := TPrecision.Single;
@@ -5,10 +5,11 @@ unit MandelbrotGenerator;
 interface
 
 uses
-  System.Classes;
+  System.Classes,
+  Neslib.MultiPrecision;
 
 type
-  TPrecision = (Single, Double, DoubleDouble, QuadDouble);
+  TPrecision = (Single, Double, DoubleDouble, QuadDouble, Perturbation);
 
 type
   TSurface = record
@@ -28,13 +29,19 @@ type
     FMaxIterations: Integer;
     FMagnification: Double;
     FPrecision: TPrecision;
+    FCancel: Integer;
   private
     procedure GenerateSingle;
+    {$IF MultiPrecisionRebuiltBinaries}
+    procedure GenerateNative(const APrecision: TMandelbrotPrecision);
+    {$ELSE}
     procedure GenerateDouble;
     procedure GenerateDoubleDouble;
     procedure GenerateQuadDouble;
+    {$ENDIF}
   protected
     procedure Execute; override;
+    procedure TerminatedSet; override;
   public
     constructor Create(const AMaxIterations: Integer;
       const AMagnification: Double; const APrecision: TPrecision);
@@ -45,8 +52,7 @@ type
 implementation
 
 uses
-  System.SysUtils,
-  Neslib.MultiPrecision;
+  System.SysUtils;
 
 const
   CENTER_RE = '-0.00677652295833245729642263781984627256356509565412970431582937';
@@ -73,12 +79,39 @@ procedure TMandelbrotGenerator.Execute;
 begin
   case FPrecision of
     TPrecision.Single      : GenerateSingle;
+    {$IF MultiPrecisionRebuiltBinaries}
+    TPrecision.Double      : GenerateNative(TMandelbrotPrecision.Double);
+    TPrecision.DoubleDouble: GenerateNative(TMandelbrotPrecision.DoubleDouble);
+    TPrecision.QuadDouble  : GenerateNative(TMandelbrotPrecision.QuadDouble);
+    TPrecision.Perturbation: GenerateNative(TMandelbrotPrecision.Perturbation);
+    {$ELSE}
     TPrecision.Double      : GenerateDouble;
     TPrecision.DoubleDouble: GenerateDoubleDouble;
-    TPrecision.QuadDouble  : GenerateQuadDouble;
+    { Perturbation needs RenderMandelbrot, so use QuadDouble precision instead }
+    TPrecision.QuadDouble,
+    TPrecision.Perturbation: GenerateQuadDouble;
+    {$ENDIF}
   end;
 end;
 
+{$IF MultiPrecisionRebuiltBinaries}
+procedure TMandelbrotGenerator.GenerateNative(
+  const APrecision: TMandelbrotPrecision);
+var
+  CenterRe, CenterIm: QuadDouble;
+  Step: Double;
+begin
+  { The iterations for Double, DoubleDouble and QuadDouble precision are
+    performed in native code, using all CPU cores. }
+  MultiPrecisionInit;
+  CenterRe := CENTER_RE;
+  CenterIm := CENTER_IM;
+  Step := (2.5 / FMagnification) / FSurface.Width;
+
+  RenderMandelbrot(APrecision, CenterRe, CenterIm, Step, FSurface.Width,
+    FSurface.Height, FMaxIterations, @FSurface.Data[0], @FCancel);
+end;
+{$ELSE}
 procedure TMandelbrotGenerator.GenerateDouble;
 var
   CenterRe, CenterIm, Radius, XStart, YStart, X, Y, Step: Double;
@@ -245,6 +278,7 @@ begin
     end;
   end;
 end;
+{$ENDIF}
 
 procedure TMandelbrotGenerator.GenerateSingle;
 var
@@ -301,6 +335,12 @@ begin
   end;
 end;
 
+procedure TMandelbrotGenerator.TerminatedSet;
+begin
+  inherited;
+  FCancel := 1;
+end;
+
 initialization
   USFormatSettings := TFormatSettings.Create('en-US');
   USFormatSettings.DecimalSeparator := '.';
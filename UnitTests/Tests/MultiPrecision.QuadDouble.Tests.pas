@@ -49,6 +49,9 @@ type
     procedure TestRem;
     procedure TestDivRem;
     procedure TestFMod;
+    {$IF MultiPrecisionRebuiltBinaries}
+    procedure TestSloppyAccurate;
+    {$ENDIF}
 
     procedure TestNeg;
     procedure TestInv;
@@ -88,6 +91,20 @@ type
     procedure TestArcCosh;
     procedure TestArcTanh;
 
+    {$IF MultiPrecisionRebuiltBinaries}
+    procedure TestBatch;
+    procedure TestBatchTranscendental;
+    procedure TestPoly;
+    procedure TestSum;
+    procedure TestExactSum;
+    procedure TestMatrix;
+    procedure TestSolve;
+    procedure TestVector;
+    procedure TestText;
+    procedure TestFile;
+    procedure TestRenderMandelbrot;
+    {$ENDIF}
+
     procedure TestIssue3;
     procedure TestIssue4;
     procedure TestIssue5;
@@ -97,9 +114,15 @@ type
 implementation
 
 uses
+  {$IF MultiPrecisionRebuiltBinaries}
+  System.Classes,
+  System.IOUtils,
+  {$ENDIF}
   System.Math,
   System.SysUtils;
 
+{$POINTERMATH ON}
+
 { TTestQuadDouble }
 
 procedure TTestQuadDouble.CheckEquals(const AExpected: String;
@@ -179,6 +202,10 @@ var
   A: QuadDouble;
 begin
   A := '1.1'; CheckEquals('NAN', ArcCos(A));
+  {$IF MultiPrecisionRebuiltBinaries}
+  A := '1.0'; CheckEquals('0.00000000000000000000000000000000000000000000000000000000000000', ArcCos(A));
+  A := '-1.0'; CheckEquals('3.14159265358979323846264338327950288419716939937510582097494459', ArcCos(A));
+  {$ELSE}
   {$IFDEF MP_ACCURATE}
   A := '1.0'; CheckEquals('0.00000000000000000000000000000000435788199605262343947870810047', ArcCos(A));
   A := '-1.0'; CheckEquals('3.14159265358979323846264338327949852631517334675166634226684412', ArcCos(A));
@@ -186,6 +213,7 @@ begin
   A := '1.0'; CheckEquals('0.00000000000000000000000000000000000000000000000000000000000000', ArcCos(A));
   A := '-1.0'; CheckEquals('3.14159265358979323846264338327950288419716939937510582097494459', ArcCos(A));
   {$ENDIF}
+  {$ENDIF}
   A := '0.5'; CheckEquals('1.04719755119659774615421446109316762806572313312503527365831486', ArcCos(A));
 end;
 
@@ -202,6 +230,10 @@ var
   A: QuadDouble;
 begin
   A := '1.1'; CheckEquals('NAN', ArcSin(A));
+  {$IF MultiPrecisionRebuiltBinaries}
+  A := '1.0'; CheckEquals('1.57079632679489661923132169163975144209858469968755291048747230', ArcSin(A));
+  A := '-1.0'; CheckEquals('-1.57079632679489661923132169163975144209858469968755291048747230', ArcSin(A));
+  {$ELSE}
   {$IFDEF MP_ACCURATE}
   A := '1.0'; CheckEquals('1.57079632679489661923132169163974708421658864706411343177937183', ArcSin(A));
   A := '-1.0'; CheckEquals('-1.57079632679489661923132169163974708421658864706411343177937183', ArcSin(A));
@@ -209,6 +241,7 @@ begin
   A := '1.0'; CheckEquals('1.57079632679489661923132169163975144209858469968755291048747230', ArcSin(A));
   A := '-1.0'; CheckEquals('-1.57079632679489661923132169163975144209858469968755291048747230', ArcSin(A));
   {$ENDIF}
+  {$ENDIF}
   A := '0.5'; CheckEquals('0.52359877559829887307710723054658381403286156656251763682915743', ArcSin(A));
 end;
 
@@ -245,6 +278,13 @@ begin
   P := '0.4';
   N := '-0.1';
   CheckEquals('-0.24497866312686415417208248121127581091414409838118406712737591', ArcTan2(N, P));
+
+  {$IF MultiPrecisionRebuiltBinaries}
+  { Arguments near the end of the range }
+  P := QuadDouble(1e300) * 3;
+  N := QuadDouble(-1e300);
+  CheckEquals('-0.32175055439664219340140461435866131902075529555765619143280306', ArcTan2(N, P));
+  {$ENDIF}
 end;
 
 procedure TTestQuadDouble.TestArcTanh;
@@ -255,6 +295,827 @@ begin
   A := '0.5'; CheckEquals('0.54930614433405484569762261846126285232374527891137472586734717', ArcTanh(A));
 end;
 
+{$IF MultiPrecisionRebuiltBinaries}
+procedure TTestQuadDouble.TestBatch;
+const
+  { Not a multiple of the SIMD width, so the remaining values are tested too }
+  COUNT = 11;
+var
+  A, B, Expected: array [0..COUNT - 1] of QuadDouble;
+  AX, BX, CX: array [0..3, 0..COUNT - 1] of Double;
+  VA, VB, VC: TQuadDoubleArrays;
+  I, J, Op: Integer;
+begin
+  for I := 0 to COUNT - 1 do
+  begin
+    A[I] := QuadDouble.Pi * (I + 0.5);
+    B[I] := QuadDouble.E / (I - 3.5);
+    for J := 0 to 3 do
+    begin
+      AX[J, I] := A[I].X[J];
+      BX[J, I] := B[I].X[J];
+    end;
+  end;
+  VA.Init(@AX[0], @AX[1], @AX[2], @AX[3], COUNT);
+  VB.Init(@BX[0], @BX[1], @BX[2], @BX[3], COUNT);
+  VC.Init(@CX[0], @CX[1], @CX[2], @CX[3], COUNT);
+
+  for Op := 0 to 5 do
+  begin
+    for I := 0 to COUNT - 1 do
+    begin
+      CX[0, I] := I;
+      for J := 1 to 3 do
+        CX[J, I] := 0;
+    end;
+
+    case Op of
+      0: AddN(VA, VB, VC);
+      1: SubtractN(VA, VB, VC);
+      2: MultiplyN(VA, VB, VC);
+      3: SqrN(VA, VC);
+      4: MultiplyAddN(VA, VB, VC);
+      5: MultiplyAddN(B[3], VA, VC);
+    end;
+
+    for I := 0 to COUNT - 1 do
+    begin
+      case Op of
+        0: Expected[I] := A[I] + B[I];
+        1: Expected[I] := A[I] - B[I];
+        2: Expected[I] := A[I] * B[I];
+        3: Expected[I] := Sqr(A[I]);
+        4: Expected[I] := I + A[I] * B[I];
+        5: Expected[I] := I + B[3] * A[I];
+      end;
+      for J := 0 to 3 do
+        CheckTrue(CX[J, I] = Expected[I].X[J]);
+    end;
+  end;
+end;
+
+procedure TTestQuadDouble.TestBatchTranscendental;
+const
+  COUNT = 11;
+var
+  A: array [0..COUNT - 1] of QuadDouble;
+  E: QuadDouble;
+  AX, BX, CX: array [0..3, 0..COUNT - 1] of Double;
+  VA, VB, VC: TQuadDoubleArrays;
+  I, J: Integer;
+
+  procedure CheckClose(const AExpected: QuadDouble; const AActual: array of Double);
+  var
+    Actual: QuadDouble;
+    K: Integer;
+  begin
+    for K := 0 to 3 do
+      Actual.X[K] := AActual[K];
+    CheckTrue(Abs(Actual - AExpected) <= Abs(AExpected) * 1e-60);
+  end;
+
+begin
+  for I := 0 to COUNT - 1 do
+  begin
+    A[I] := QuadDouble.E * (I - 4.5) / 2;
+    for J := 0 to 3 do
+      AX[J, I] := A[I].X[J];
+  end;
+  VA.Init(@AX[0], @AX[1], @AX[2], @AX[3], COUNT);
+  VB.Init(@BX[0], @BX[1], @BX[2], @BX[3], COUNT);
+  VC.Init(@CX[0], @CX[1], @CX[2], @CX[3], COUNT);
+
+  { ExpN gives the same results as Exp }
+  ExpN(VA, VB);
+  for I := 0 to COUNT - 1 do
+  begin
+    E := Exp(A[I]);
+    for J := 0 to 3 do
+      CheckTrue(BX[J, I] = E.X[J]);
+  end;
+
+  SinCosN(VA, VB, VC);
+  for I := 0 to COUNT - 1 do
+  begin
+    CheckClose(Sin(A[I]), [BX[0, I], BX[1, I], BX[2, I], BX[3, I]]);
+    CheckClose(Cos(A[I]), [CX[0, I], CX[1, I], CX[2, I], CX[3, I]]);
+  end;
+
+  { ArcTan2N gives the same results as ArcTan2 }
+  ArcTan2N(VA, VB, VC);
+  for I := 0 to COUNT - 1 do
+  begin
+    for J := 0 to 3 do
+      E.X[J] := BX[J, I];
+    E := ArcTan2(A[I], E);
+    for J := 0 to 3 do
+      CheckTrue(CX[J, I] = E.X[J]);
+  end;
+
+  { LnN gives the same results as Ln, and Ln of Exp(A) gives back A }
+  ExpN(VA, VA);
+  LnN(VA, VB);
+  for I := 0 to COUNT - 1 do
+  begin
+    for J := 0 to 3 do
+      E.X[J] := AX[J, I];
+    E := Ln(E);
+    for J := 0 to 3 do
+      CheckTrue(BX[J, I] = E.X[J]);
+    CheckClose(A[I], [BX[0, I], BX[1, I], BX[2, I], BX[3, I]]);
+  end;
+end;
+
+procedure TTestQuadDouble.TestPoly;
+const
+  COUNT = 13;
+  DEGREE = 40;
+var
+  C, D: array [0..DEGREE] of QuadDouble;
+  CS: array [0..DEGREE, 0..3, 0..COUNT - 1] of Double;
+  CA: array [0..DEGREE] of TQuadDoubleArrays;
+  XS, Y: array [0..3, 0..COUNT - 1] of Double;
+  VX, VY: TQuadDoubleArrays;
+  One, X, R: QuadDouble;
+  I, J, K, L: Integer;
+begin
+  One := QuadDouble.One;
+  CheckTrue(PolyEval([One, One * 2, One * 3], One * 2) = 17);
+
+  { The Taylor polynomial of Exp }
+  C[0] := One;
+  for K := 1 to DEGREE do
+    C[K] := C[K - 1] / K;
+  X := One / 8;
+  CheckTrue(Abs(PolyEval(C, X) - Exp(X)) < 1e-60);
+
+  { Sqrt(2) is a root of X^2 - 2 }
+  X := PolyRoot([-2 * One, QuadDouble.Zero, One], One);
+  CheckTrue(Abs(X - Sqrt(2 * One)) < 1e-60);
+
+  { The batch versions give the same results for every degree }
+  VX.Init(@XS[0], @XS[1], @XS[2], @XS[3], COUNT);
+  VY.Init(@Y[0], @Y[1], @Y[2], @Y[3], COUNT);
+  for I := 0 to COUNT - 1 do
+  begin
+    X := (I - 6) / (One * 7);
+    for J := 0 to 3 do
+      XS[J, I] := X.X[J];
+  end;
+  for K := 0 to DEGREE do
+  begin
+    CA[K].Init(@CS[K, 0], @CS[K, 1], @CS[K, 2], @CS[K, 3], COUNT);
+    for I := 0 to COUNT - 1 do
+    begin
+      R := C[K] * (I + 1);
+      for J := 0 to 3 do
+        CS[K, J, I] := R.X[J];
+    end;
+  end;
+
+  for K := 0 to DEGREE do
+  begin
+    PolyEvalN(Slice(C, K + 1), VX, VY);
+    for I := 0 to COUNT - 1 do
+    begin
+      for J := 0 to 3 do
+        X.X[J] := XS[J, I];
+      R := PolyEval(Slice(C, K + 1), X);
+      CheckTrue((Y[0, I] = R.X[0]) and
+        (Y[1, I] = R.X[1]) and
+        (Y[2, I] = R.X[2]) and
+        (Y[3, I] = R.X[3]));
+    end;
+
+    X := One / 3;
+    PolyEvalN(Slice(CA, K + 1), X, VY);
+    for J := 0 to COUNT - 1 do
+    begin
+      for I := 0 to K do
+        for L := 0 to 3 do
+          D[I].X[L] := CS[I, L, J];
+      R := PolyEval(Slice(D, K + 1), X);
+      CheckTrue((Y[0, J] = R.X[0]) and
+        (Y[1, J] = R.X[1]) and
+        (Y[2, J] = R.X[2]) and
+        (Y[3, J] = R.X[3]));
+    end;
+  end;
+end;
+
+procedure TTestQuadDouble.TestSum;
+const
+  COUNT = 200000;
+var
+  A: TArray<Double>;
+  AX, BX: array [0..3] of TArray<Double>;
+  VA, VB: TQuadDoubleArrays;
+  Expected, Actual, X, Y: QuadDouble;
+  I, J: Integer;
+begin
+  SumN([1e300, 1, -1e300, 1e-300], Actual);
+  CheckTrue(Actual = QuadDouble.One + 1e-300);
+
+  { Large arrays are split into parts }
+  SetLength(A, COUNT);
+  RandSeed := 1;
+  for I := 0 to COUNT - 1 do
+    A[I] := (Random - 0.5) * 1e30;
+
+  Expected := QuadDouble.Zero;
+  for I := 0 to COUNT - 1 do
+    Expected := Expected + A[I];
+  SumN(A, Actual);
+  CheckTrue(Abs(Actual - Expected) <= Abs(Expected) * 1e-55);
+
+  for J := 0 to 3 do
+  begin
+    SetLength(AX[J], COUNT);
+    SetLength(BX[J], COUNT);
+  end;
+  Expected := QuadDouble.Zero;
+  for I := 0 to COUNT - 1 do
+  begin
+    X := QuadDouble.Pi * A[I];
+    Y := QuadDouble.E * (Random - 0.5);
+    for J := 0 to 3 do
+    begin
+      AX[J, I] := X.X[J];
+      BX[J, I] := Y.X[J];
+    end;
+    Expected := Expected + X * Y;
+  end;
+  VA.Init(@AX[0, 0], @AX[1, 0], @AX[2, 0], @AX[3, 0], COUNT);
+  VB.Init(@BX[0, 0], @BX[1, 0], @BX[2, 0], @BX[3, 0], COUNT);
+  DotN(VA, VB, Actual);
+  CheckTrue(Abs(Actual - Expected) <= Abs(Expected) * 1e-55);
+end;
+
+procedure TTestQuadDouble.TestExactSum;
+const
+  COUNT = 200000;
+var
+  A, B, R: TArray<Double>;
+  Sum, Part: TExactSum;
+  Expected, Actual, X, Y: QuadDouble;
+  I: Integer;
+begin
+  ExactSumN([1e308, 1, -1e308], Actual);
+  CheckTrue(Actual = 1);
+  ExactSumN([1e300, 1, -1e300, 1e-300], Actual);
+  CheckTrue((Actual.X[0] = 1) and (Actual.X[1] = 1e-300) and (Actual.X[2] = 0));
+  ExactNormN([3, 4], Actual);
+  CheckTrue(Actual = 5);
+  ExactSumN(A, Actual);
+  CheckTrue(Actual = 0);
+
+  { Large arrays are split into parts }
+  SetLength(A, COUNT);
+  SetLength(B, COUNT);
+  SetLength(R, COUNT);
+  RandSeed := 1;
+  for I := 0 to COUNT - 1 do
+  begin
+    A[I] := System.Math.Ldexp(Random - 0.5, Random(120) - 60);
+    B[I] := Random - 0.5;
+  end;
+  for I := 0 to COUNT - 1 do
+    R[I] := A[COUNT - 1 - I];
+
+  Expected := QuadDouble.Zero;
+  for I := 0 to COUNT - 1 do
+    Expected := Expected + A[I];
+  ExactSumN(A, X);
+  CheckTrue(Abs(X - Expected) <= Abs(Expected) * 1e-55);
+
+  { The result does not depend on the order of the values... }
+  ExactSumN(R, Y);
+  CheckTrue((X.X[0] = Y.X[0]) and (X.X[1] = Y.X[1]) and
+    (X.X[2] = Y.X[2]) and (X.X[3] = Y.X[3]));
+
+  { ...or on how they are split }
+  Sum.Init;
+  Sum.Add(Copy(A, 1000, COUNT - 1000));
+  Part.Init;
+  Part.Add(Copy(A, 0, 1000));
+  Sum.Merge(Part);
+  Y := Sum.ToQuadDouble;
+  CheckTrue((X.X[0] = Y.X[0]) and (X.X[1] = Y.X[1]) and
+    (X.X[2] = Y.X[2]) and (X.X[3] = Y.X[3]));
+
+  Expected := QuadDouble.Zero;
+  for I := 0 to COUNT - 1 do
+    Expected := Expected + A[I] * QuadDouble.One * B[I];
+  ExactDotN(A, B, Actual);
+  CheckTrue(Abs(Actual - Expected) <= Abs(Expected) * 1e-55);
+
+  Sum.Init;
+  Sum.AddProducts(A, B);
+  X := Sum.ToQuadDouble;
+  CheckTrue((X.X[0] = Actual.X[0]) and (X.X[1] = Actual.X[1]) and
+    (X.X[2] = Actual.X[2]) and (X.X[3] = Actual.X[3]));
+
+  Expected := QuadDouble.Zero;
+  for I := 0 to COUNT - 1 do
+    Expected := Expected + Sqr(A[I] * QuadDouble.One);
+  ExactNormN(A, Actual);
+  CheckTrue(Abs(Actual - Sqrt(Expected)) <= Sqrt(Expected) * 1e-55);
+end;
+
+procedure TTestQuadDouble.TestRenderMandelbrot;
+const
+  { Not a multiple of the SIMD widths, so rows end with a partial vector }
+  WIDTH     = 13;
+  HEIGHT    = 9;
+  MAX_ITER  = 50;
+var
+  Expected, Actual: array [0..WIDTH * HEIGHT - 1] of Integer;
+  Precision: TMandelbrotPrecision;
+  Row, Col, Iter, Cancel: Integer;
+  X, Y, ZRe, ZIm, ZReSq, ZImSq: Double;
+  CenterRe, CenterIm: QuadDouble;
+begin
+  { All coordinates are multiples of 1/4, so all precisions should give the
+    same results as a plain Double loop. }
+  for Row := 0 to HEIGHT - 1 do
+    for Col := 0 to WIDTH - 1 do
+    begin
+      X := -2.125 + (Col * 0.25);
+      Y := -1.125 + (Row * 0.25);
+      ZRe := X;
+      ZIm := Y;
+      Iter := 0;
+      while (Iter < MAX_ITER) do
+      begin
+        ZReSq := ZRe * ZRe;
+        ZImSq := ZIm * ZIm;
+        if ((ZReSq + ZImSq) > 4) then
+          Break;
+        ZIm := Y + (2 * ZRe * ZIm);
+        ZRe := X + (ZReSq - ZImSq);
+        Inc(Iter);
+      end;
+      if (Iter = MAX_ITER) then
+        Iter := -1;
+      Expected[(Row * WIDTH) + Col] := Iter;
+    end;
+
+  CenterRe.Init(-0.5);
+  CenterIm.Init(0);
+
+  for Precision := Low(TMandelbrotPrecision) to High(TMandelbrotPrecision) do
+  begin
+    FillChar(Actual, SizeOf(Actual), 0);
+    RenderMandelbrot(Precision, CenterRe, CenterIm, 0.25, WIDTH, HEIGHT,
+      MAX_ITER, @Actual[0]);
+    for Row := 0 to WIDTH * HEIGHT - 1 do
+      CheckTrue(Actual[Row] = Expected[Row]);
+  end;
+
+  { Nothing should be rendered if cancelled beforehand }
+  Cancel := 1;
+  FillChar(Actual, SizeOf(Actual), $FF);
+  RenderMandelbrot(TMandelbrotPrecision.QuadDouble, CenterRe, CenterIm, 0.25,
+    WIDTH, HEIGHT, MAX_ITER, @Actual[0], @Cancel);
+  for Row := 0 to WIDTH * HEIGHT - 1 do
+    CheckTrue(Actual[Row] = -1);
+
+  { Deep zoom near the Misiurewicz point i. Perturbation should give the same
+    results as QuadDouble, while Double has run out of precision. }
+  CenterRe.Init(1E-60);
+  CenterIm.Init(1);
+  RenderMandelbrot(TMandelbrotPrecision.QuadDouble, CenterRe, CenterIm, 1E-40,
+    WIDTH, HEIGHT, 1000, @Expected[0]);
+  RenderMandelbrot(TMandelbrotPrecision.Perturbation, CenterRe, CenterIm,
+    1E-40, WIDTH, HEIGHT, 1000, @Actual[0]);
+  for Row := 0 to WIDTH * HEIGHT - 1 do
+  begin
+    CheckTrue(Expected[Row] > 0);
+    CheckTrue(Actual[Row] = Expected[Row]);
+  end;
+end;
+
+procedure TTestQuadDouble.TestMatrix;
+const
+  { More than one tile, and not multiples of the tile sizes or SIMD widths }
+  M = 70;
+  K = 37;
+  N = 67;
+var
+  AX, BX, CX, C0: array [0..3] of TArray<Double>;
+  VA, VB, VC, VX, VY: TQuadDoubleArrays;
+  A, B, C: TQuadDoubleMatrix;
+  Alpha, Beta, Expected, Term, Bound: QuadDouble;
+  I, J, L: Integer;
+
+  function Get(const AArrays: TQuadDoubleArrays; const AIndex: Integer): QuadDouble;
+  begin
+    Result.Init(AArrays.X[0][AIndex], AArrays.X[1][AIndex],
+      AArrays.X[2][AIndex], AArrays.X[3][AIndex]);
+  end;
+
+  procedure Check(const AActual: TQuadDoubleArrays; const AIndex: Integer);
+  begin
+    CheckTrue(Abs(Get(AActual, AIndex) - Expected) <= Bound * 1e-60);
+  end;
+
+begin
+  RandSeed := 1;
+  for J := 0 to 3 do
+  begin
+    SetLength(AX[J], M * K);
+    SetLength(BX[J], N * K);
+    SetLength(CX[J], M * N);
+  end;
+  for I := 0 to M * K - 1 do
+  begin
+    Term := QuadDouble.Pi * (Random - 0.5);
+    for J := 0 to 3 do
+      AX[J, I] := Term.X[J];
+  end;
+  for I := 0 to N * K - 1 do
+  begin
+    Term := QuadDouble.E * (Random - 0.5);
+    for J := 0 to 3 do
+      BX[J, I] := Term.X[J];
+  end;
+  for I := 0 to M * N - 1 do
+  begin
+    CX[0, I] := I;
+    for J := 1 to 3 do
+      CX[J, I] := 0;
+  end;
+  for J := 0 to 3 do
+    C0[J] := Copy(CX[J]);
+  VA.Init(@AX[0, 0], @AX[1, 0], @AX[2, 0], @AX[3, 0], M * K);
+  VB.Init(@BX[0, 0], @BX[1, 0], @BX[2, 0], @BX[3, 0], N * K);
+  VC.Init(@CX[0, 0], @CX[1, 0], @CX[2, 0], @CX[3, 0], M * N);
+
+  { C := Alpha * A * B + Beta * C, with B stored column by column }
+  A.Init(VA, M, K);
+  B.Init(VB, N, K);
+  B := B.Transpose;
+  C.Init(VC, M, N);
+  Alpha := QuadDouble.E;
+  Beta.Init(0.5);
+  MultiplyMatrixN(Alpha, A, B, Beta, C);
+  for I := 0 to M - 1 do
+    for J := 0 to N - 1 do
+    begin
+      Expected := QuadDouble.Zero;
+      Bound := QuadDouble.Zero;
+      for L := 0 to K - 1 do
+      begin
+        Term := Get(VA, I * K + L) * Get(VB, J * K + L);
+        Expected := Expected + Term;
+        Bound := Bound + Abs(Term);
+      end;
+      Expected := Alpha * Expected + Beta * C0[0, I * N + J];
+      Bound := Alpha * Bound + Beta * C0[0, I * N + J];
+      Check(VC, I * N + J);
+    end;
+
+  { Y := Alpha * A * X, with the rows of A stored contiguously. Y is not
+    read since Beta is zero. }
+  VX.Init(@BX[0, 0], @BX[1, 0], @BX[2, 0], @BX[3, 0], K);
+  VY.Init(@CX[0, 0], @CX[1, 0], @CX[2, 0], @CX[3, 0], M);
+  for I := 0 to M - 1 do
+    CX[0, I] := NaN;
+  MultiplyMatrixVectorN(Alpha, A, VX, QuadDouble.Zero, VY);
+  for I := 0 to M - 1 do
+  begin
+    Expected := QuadDouble.Zero;
+    Bound := QuadDouble.Zero;
+    for L := 0 to K - 1 do
+    begin
+      Term := Get(VA, I * K + L) * Get(VX, L);
+      Expected := Expected + Term;
+      Bound := Bound + Abs(Term);
+    end;
+    Expected := Alpha * Expected;
+    Bound := Alpha * Bound;
+    Check(VY, I);
+  end;
+
+  { Y := A * X + Y, with the columns of A stored contiguously }
+  VX.Init(@AX[0, 0], @AX[1, 0], @AX[2, 0], @AX[3, 0], N);
+  VY.Init(@CX[0, 0], @CX[1, 0], @CX[2, 0], @CX[3, 0], K);
+  for I := 0 to K - 1 do
+  begin
+    CX[0, I] := I;
+    for J := 1 to 3 do
+      CX[J, I] := 0;
+  end;
+  MultiplyMatrixVectorN(QuadDouble.One, B, VX, QuadDouble.One, VY);
+  for I := 0 to K - 1 do
+  begin
+    Expected.Init(I);
+    Bound.Init(I);
+    for L := 0 to N - 1 do
+    begin
+      Term := Get(VB, L * K + I) * Get(VX, L);
+      Expected := Expected + Term;
+      Bound := Bound + Abs(Term);
+    end;
+    Check(VY, I);
+  end;
+end;
+
+procedure TTestQuadDouble.TestSolve;
+const
+  { More than one panel and tile, and not a multiple of the panel size }
+  N = 70;
+  NRHS = 2;
+
+  { Size of the ill-conditioned matrix }
+  H = 20;
+var
+  AX, BX, XX: array [0..3] of TArray<Double>;
+  VA, VB, VX: TQuadDoubleArrays;
+  A, B, X: TQuadDoubleMatrix;
+  Term: QuadDouble;
+  I, J, L: Integer;
+
+  function Get(const AMatrix: TQuadDoubleMatrix; const I, J: Integer): QuadDouble;
+  var
+    Index: Integer;
+  begin
+    Index := I * AMatrix.RowStride + J * AMatrix.ColStride;
+    Result.Init(AMatrix.X[0][Index], AMatrix.X[1][Index],
+      AMatrix.X[2][Index], AMatrix.X[3][Index]);
+  end;
+
+  { Checks that the residual B - A * X is small compared to the terms }
+  procedure CheckResidual;
+  var
+    I, J, L: Integer;
+    Residual, Bound, Term: QuadDouble;
+  begin
+    for I := 0 to A.Rows - 1 do
+      for J := 0 to B.Cols - 1 do
+      begin
+        Residual := Get(B, I, J);
+        Bound := Abs(Residual);
+        for L := 0 to A.Cols - 1 do
+        begin
+          Term := Get(A, I, L) * Get(X, L, J);
+          Residual := Residual - Term;
+          Bound := Bound + Abs(Term);
+        end;
+        CheckTrue(Abs(Residual) <= Bound * 1e-60);
+      end;
+  end;
+
+begin
+  RandSeed := 1;
+  for J := 0 to 3 do
+  begin
+    SetLength(AX[J], N * N);
+    SetLength(BX[J], N * NRHS);
+    SetLength(XX[J], N * NRHS);
+  end;
+  for I := 0 to N * N - 1 do
+  begin
+    Term := QuadDouble.Pi * (Random - 0.5);
+    for J := 0 to 3 do
+      AX[J, I] := Term.X[J];
+  end;
+  for I := 0 to N * NRHS - 1 do
+  begin
+    Term := QuadDouble.E * (Random - 0.5);
+    for J := 0 to 3 do
+      BX[J, I] := Term.X[J];
+  end;
+  VA.Init(@AX[0, 0], @AX[1, 0], @AX[2, 0], @AX[3, 0], N * N);
+  VB.Init(@BX[0, 0], @BX[1, 0], @BX[2, 0], @BX[3, 0], N * NRHS);
+  VX.Init(@XX[0, 0], @XX[1, 0], @XX[2, 0], @XX[3, 0], N * NRHS);
+
+  { A random matrix is well-conditioned, so the solution is refined. B and
+    X are stored column by column. }
+  A.Init(VA, N, N);
+  B.Init(VB, NRHS, N);
+  B := B.Transpose;
+  X.Init(VX, NRHS, N);
+  X := X.Transpose;
+  CheckTrue(SolveMatrixN(A, B, X) = TMatrixSolveResult.Refined);
+  CheckResidual;
+
+  { The Hilbert matrix is too ill-conditioned for Double precision }
+  for I := 0 to H - 1 do
+    for J := 0 to H - 1 do
+    begin
+      Term := QuadDouble.One / (I + J + 1);
+      for L := 0 to 3 do
+        AX[L, I * H + J] := Term.X[L];
+    end;
+  A.Init(VA, H, H);
+  B.Init(VB, H, 1);
+  X.Init(VX, H, 1);
+  CheckTrue(SolveMatrixN(A, B, X) = TMatrixSolveResult.Factored);
+  CheckResidual;
+
+  { A matrix with equal rows is singular }
+  for I := 0 to H * H - 1 do
+  begin
+    AX[0, I] := 1;
+    for J := 1 to 3 do
+      AX[J, I] := 0;
+  end;
+  CheckTrue(SolveMatrixN(A, B, X) = TMatrixSolveResult.Singular);
+end;
+
+procedure TTestQuadDouble.TestVector;
+const
+  COUNT = 19;
+var
+  A, B: array [0..COUNT - 1] of QuadDouble;
+  V: TQuadDoubleVector;
+  I, J: Integer;
+begin
+  for I := 0 to COUNT - 1 do
+    A[I] := QuadDouble.Pi * (I + 0.5);
+
+  V := TQuadDoubleVector.Create(COUNT);
+  try
+    CheckTrue(V.Count = COUNT);
+    for J := 0 to 3 do
+      CheckTrue((UIntPtr(V.Arrays.X[J]) and 63) = 0);
+
+    V.Load(@A[0]);
+    for I := 0 to COUNT - 1 do
+      for J := 0 to 3 do
+        CheckTrue(V.Arrays.X[J][I] = A[I].X[J]);
+
+    AddN(V.Arrays, V.Arrays, V.Arrays);
+    V[3] := QuadDouble.E;
+    V.Store(@B[0]);
+    for I := 0 to COUNT - 1 do
+    begin
+      if (I = 3) then
+        CheckTrue(B[I] = QuadDouble.E)
+      else
+        CheckTrue(B[I] = A[I] + A[I]);
+      CheckTrue(V[I] = B[I]);
+    end;
+  finally
+    V.Free;
+  end;
+end;
+
+procedure TTestQuadDouble.TestText;
+const
+  COUNT = 1000;
+var
+  V: array [0..1] of TQuadDoubleVector;
+  Columns: TArray<TQuadDoubleVector>;
+  Bytes: TBytes;
+  I, J: Integer;
+begin
+  { Values converted to text (in the Shortest format) and back are the same }
+  V[0] := TQuadDoubleVector.Create(COUNT);
+  V[1] := TQuadDoubleVector.Create(COUNT);
+  try
+    for I := 0 to COUNT - 1 do
+    begin
+      V[0][I] := QuadDouble.Pi / (I + 1);
+      V[1][I] := -QuadDouble.E * (I * 1e10);
+    end;
+    Bytes := WriteText([V[0].Arrays, V[1].Arrays]);
+    CheckTrue(ReadText(@Bytes[0], Length(Bytes), Columns) = 0);
+    try
+      CheckTrue(Length(Columns) = 2);
+      for J := 0 to 1 do
+      begin
+        CheckTrue(Columns[J].Count = COUNT);
+        for I := 0 to COUNT - 1 do
+        begin
+          CheckTrue(Columns[J][I].X[0] = V[J][I].X[0]);
+          CheckTrue(Columns[J][I].X[1] = V[J][I].X[1]);
+          CheckTrue(Columns[J][I].X[2] = V[J][I].X[2]);
+          CheckTrue(Columns[J][I].X[3] = V[J][I].X[3]);
+        end;
+      end;
+    finally
+      for J := 0 to Length(Columns) - 1 do
+        Columns[J].Free;
+    end;
+  finally
+    V[0].Free;
+    V[1].Free;
+  end;
+
+  { Empty lines are skipped. Invalid and missing fields are NaN. }
+  Bytes := TEncoding.ASCII.GetBytes('1.5,-2'#13#10#13#10' 0.5 ,x'#10'3,'#10);
+  CheckTrue(ReadText(@Bytes[0], Length(Bytes), Columns) = 2);
+  try
+    CheckTrue(Length(Columns) = 2);
+    CheckTrue(Columns[0].Count = 3);
+    CheckEquals('1.50000000000000000000000000000000000000000000000000000000000000', Columns[0][0]);
+    CheckEquals('-2.00000000000000000000000000000000000000000000000000000000000000', Columns[1][0]);
+    CheckEquals('0.50000000000000000000000000000000000000000000000000000000000000', Columns[0][1]);
+    CheckTrue(Columns[1][1].IsNan);
+    CheckEquals('3.00000000000000000000000000000000000000000000000000000000000000', Columns[0][2]);
+    CheckTrue(Columns[1][2].IsNan);
+
+    Bytes := WriteText([Columns[0].Arrays, Columns[1].Arrays],
+      TMPFloatFormat.Fixed, 2, ';');
+    CheckEquals('1.50;-2.00'#10'0.50;nan'#10'3.00;nan'#10,
+      TEncoding.ASCII.GetString(Bytes));
+  finally
+    for J := 0 to Length(Columns) - 1 do
+      Columns[J].Free;
+  end;
+end;
+
+procedure TTestQuadDouble.TestFile;
+const
+  COUNT = 1001;
+var
+  V, W: TQuadDoubleVector;
+  Stream: TMemoryStream;
+  Filename: String;
+  I: Integer;
+begin
+  V := TQuadDoubleVector.Create(COUNT);
+  try
+    for I := 0 to COUNT - 1 do
+      V[I] := QuadDouble.Pi / (I + 1);
+
+    Stream := TMemoryStream.Create;
+    try
+      { A 64-byte header, and 4 planes padded to a multiple of 64 bytes }
+      V.SaveToStream(Stream);
+      CheckTrue(Stream.Size = 32320);
+
+      Stream.Position := 0;
+      W := TQuadDoubleVector.CreateFromStream(Stream);
+      try
+        CheckTrue(W.Count = COUNT);
+        for I := 0 to COUNT - 1 do
+        begin
+          CheckTrue(W[I].X[0] = V[I].X[0]);
+          CheckTrue(W[I].X[1] = V[I].X[1]);
+          CheckTrue(W[I].X[2] = V[I].X[2]);
+          CheckTrue(W[I].X[3] = V[I].X[3]);
+        end;
+      finally
+        W.Free;
+      end;
+
+      { The file contains QuadDouble values }
+      Stream.Position := 0;
+      ShouldRaise(EReadError,
+        procedure
+        begin
+          TDoubleDoubleVector.CreateFromStream(Stream).Free;
+        end);
+
+      { Truncated file }
+      Stream.Size := Stream.Size - 64;
+      Stream.Position := 0;
+      ShouldRaise(EReadError,
+        procedure
+        begin
+          TQuadDoubleVector.CreateFromStream(Stream).Free;
+        end);
+    finally
+      Stream.Free;
+    end;
+
+    { A mapped file can be changed without changing the file }
+    Filename := TPath.GetTempFileName;
+    try
+      V.SaveToFile(Filename);
+      W := TQuadDoubleVector.CreateFromFile(Filename);
+      try
+        CheckTrue(W.Count = COUNT);
+        for I := 0 to COUNT - 1 do
+        begin
+          CheckTrue(W[I].X[0] = V[I].X[0]);
+          CheckTrue(W[I].X[1] = V[I].X[1]);
+          CheckTrue(W[I].X[2] = V[I].X[2]);
+          CheckTrue(W[I].X[3] = V[I].X[3]);
+        end;
+        W[0] := QuadDouble.Zero;
+      finally
+        W.Free;
+      end;
+
+      W := TQuadDoubleVector.CreateFromFile(Filename);
+      try
+        CheckTrue(W[0].X[0] = V[0].X[0]);
+      finally
+        W.Free;
+      end;
+    finally
+      TFile.Delete(Filename);
+    end;
+  finally
+    V.Free;
+  end;
+end;
+{$ENDIF}
+
 procedure TTestQuadDouble.TestCeil;
 var
   A: QuadDouble;
@@ -269,12 +1130,16 @@ begin
   CheckEquals('-3.00000000000000000000000000000000000000000000000000000000000000', Ceil(A));
 
   A := '-3.0';
+  {$IF MultiPrecisionRebuiltBinaries}
+  CheckEquals('-3.00000000000000000000000000000000000000000000000000000000000000', Trunc(A));
+  {$ELSE}
   {$IFDEF MP_ACCURATE}
   { -3.0 cannot be accurately represented. It is actually represented as slightly larger than -3 }
   CheckEquals('-2.00000000000000000000000000000000000000000000000000000000000000', Trunc(A));
   {$ELSE}
   CheckEquals('-3.00000000000000000000000000000000000000000000000000000000000000', Trunc(A));
   {$ENDIF}
+  {$ENDIF}
 
   A := '0.0';
   CheckEquals('0.00000000000000000000000000000000000000000000000000000000000000', Ceil(A));
@@ -471,6 +1336,11 @@ var
 begin
   A := Exp(QuadDouble.Pi);
   CheckEquals('23.14069263277926900572908636794854738026610624260021199344504641', A);
+
+  {$IF MultiPrecisionRebuiltBinaries}
+  A := Exp(-QuadDouble.Pi);
+  CheckEquals('0.04321391826377224977441773717172801127572810981063308298071969', A);
+  {$ENDIF}
 end;
 
 procedure TTestQuadDouble.TestFloor;
@@ -493,12 +1363,16 @@ begin
   CheckEquals('0.00000000000000000000000000000000000000000000000000000000000000', Floor(A));
 
   A := '2.0';
+  {$IF MultiPrecisionRebuiltBinaries}
+  CheckEquals('2.00000000000000000000000000000000000000000000000000000000000000', Floor(A));
+  {$ELSE}
   {$IFDEF MP_ACCURATE}
   { 2.0 cannot be accurately represented. It is actually represented as slightly smaller than 2 }
   CheckEquals('1.00000000000000000000000000000000000000000000000000000000000000', Floor(A));
   {$ELSE}
   CheckEquals('2.00000000000000000000000000000000000000000000000000000000000000', Floor(A));
   {$ENDIF}
+  {$ENDIF}
 
   A := '2.1';
   CheckEquals('2.00000000000000000000000000000000000000000000000000000000000000', Floor(A));
@@ -582,7 +1456,12 @@ end;
 
 procedure TTestQuadDouble.TestInit;
 var
+  {$IF MultiPrecisionRebuiltBinaries}
+  A, B: QuadDouble;
+  FS: TFormatSettings;
+  {$ELSE}
   A: QuadDouble;
+  {$ENDIF}
 begin
   A.Init;
   CheckEquals(0, A.X[0], 0);
@@ -618,6 +1497,25 @@ begin
   CheckEquals(QuadDouble.E.X[2], A.X[2], 0);
   CheckEquals(QuadDouble.E.X[3], A.X[3], 0);
   CheckEquals('2.71828182845904523536028747135266249775724709369995957496696763', A);
+
+  {$IF MultiPrecisionRebuiltBinaries}
+  { The shortest string converts back to the same value }
+  B := QuadDouble.Pi / 1e3;
+  A.Init('0.0031415926535897932384626433832795028841971693993751058209749445923', USFormatSettings);
+  CheckEquals(B.X[0], A.X[0], 0);
+  CheckEquals(B.X[1], A.X[1], 0);
+  CheckEquals(B.X[2], A.X[2], 0);
+  CheckEquals(B.X[3], A.X[3], 0);
+  FS := TFormatSettings.Create('nl-NL');
+  A.Init('1.234.567,5', FS);
+  CheckEquals('1234567.50000000000000000000000000000000000000000000000000000000', A);
+
+  A.Init('-INF', USFormatSettings);
+  CheckEquals('-INF', A);
+
+  A.Init('1.5x', USFormatSettings);
+  CheckEquals('NAN', A);
+  {$ENDIF}
 end;
 
 procedure TTestQuadDouble.TestInv;
@@ -777,6 +1675,11 @@ var
 begin
   A := Ln(QuadDouble.Pi);
   CheckEquals('1.14472988584940017414342735135305871164729481291531157151362307', A);
+
+  {$IF MultiPrecisionRebuiltBinaries}
+  A := Ln(QuadDouble.One * 1025 / 1024);
+  CheckEquals('0.00097608597305545889596082490801718667261183433378453623775860', A);
+  {$ENDIF}
 end;
 
 procedure TTestQuadDouble.TestLog10;
@@ -928,12 +1831,16 @@ begin
   CheckEquals('2.00000000000000000000000000000000000000000000000000000000000000', Round(A));
 
   A := '2.5';
+  {$IF MultiPrecisionRebuiltBinaries}
+  CheckEquals('3.00000000000000000000000000000000000000000000000000000000000000', Round(A));
+  {$ELSE}
   {$IFDEF MP_ACCURATE}
   { 2.5 cannot be accurately represented. It is actually represented as smaller larger than 2.5 }
   CheckEquals('2.00000000000000000000000000000000000000000000000000000000000000', Round(A));
   {$ELSE}
   CheckEquals('3.00000000000000000000000000000000000000000000000000000000000000', Round(A));
   {$ENDIF}
+  {$ENDIF}
 
   A := '2.9';
   CheckEquals('3.00000000000000000000000000000000000000000000000000000000000000', Round(A));
@@ -982,6 +1889,15 @@ begin
 
   A := '4.713'; A := Sin(A);
   CheckEquals('-0.99999981332752066089223456502852650209847284677993360766809990', A);
+
+  {$IF MultiPrecisionRebuiltBinaries}
+  { Large arguments }
+  A := '1e22'; A := Sin(A);
+  CheckEquals('-0.85220084976718880177270589375302936826176215041004365625650933', A);
+
+  A := Sin(QuadDouble(1e300));
+  CheckEquals('-0.81788191211590859704588528275542621201142830389038404646373959', A);
+  {$ENDIF}
 end;
 
 procedure TTestQuadDouble.TestSinCos;
@@ -1070,6 +1986,58 @@ begin
   CheckEquals('0.01000016666750000198412973986141173801764156013522752414026264', A);
 end;
 
+{$IF MultiPrecisionRebuiltBinaries}
+procedure TTestQuadDouble.TestSloppyAccurate;
+const
+  { 2^-60 and 2^-55 }
+  P60 = 1 / 1152921504606846976;
+  P55 = 1 / 36028797018963968;
+var
+  A, B, C: QuadDouble;
+
+  function Bits(const AValue: Double): UInt64;
+  begin
+    Result := PUInt64(@AValue)^;
+  end;
+
+begin
+  A := QuadDouble.SloppyAdd(QuadDouble.Pi, QuadDouble.E);
+  CheckEquals('5.85987448204883847382293085463216538195441649307506539594191222', A);
+  A := QuadDouble.AccurateAdd(QuadDouble.Pi, QuadDouble.E);
+  CheckEquals('5.85987448204883847382293085463216538195441649307506539594191222', A);
+
+  A := QuadDouble.SloppySubtract(QuadDouble.Pi, QuadDouble.E);
+  CheckEquals('0.42331082513074800310235591192684038643992230567514624600797696', A);
+  A := QuadDouble.AccurateSubtract(QuadDouble.Pi, QuadDouble.E);
+  CheckEquals('0.42331082513074800310235591192684038643992230567514624600797696', A);
+
+  A := QuadDouble.SloppyMultiply(QuadDouble.Pi, QuadDouble.E);
+  CheckEquals('8.53973422267356706546355086954657449503488853576511496187960113', A);
+  A := QuadDouble.AccurateMultiply(QuadDouble.Pi, QuadDouble.E);
+  CheckEquals('8.53973422267356706546355086954657449503488853576511496187960113', A);
+
+  A := QuadDouble.SloppyDivide(QuadDouble.Pi, QuadDouble.E);
+  CheckEquals('1.15572734979092171791009318331269629912085102316441582049970654', A);
+  A := QuadDouble.AccurateDivide(QuadDouble.Pi, QuadDouble.E);
+  CheckEquals('1.15572734979092171791009318331269629912085102316441582049970654', A);
+
+  { The sloppy and accurate divisions give different results here. These
+    must not depend on MP_ACCURATE, so check every bit. }
+  A.Init(1, -9 * P60, -9 * P60 * P55, 0);
+  B.Init(3, 5 * P60, 10 * P60 * P55, 0);
+  C := QuadDouble.SloppyDivide(A, B);
+  CheckTrue(Bits(C.X[0]) = $3FD5555555555555);
+  CheckTrue(Bits(C.X[1]) = $3C71C71C71C71C72);
+  CheckTrue(Bits(C.X[2]) = $B9102F684BDA12F7);
+  CheckTrue(Bits(C.X[3]) = $35BEF561F9ADD3C0);
+  C := QuadDouble.AccurateDivide(A, B);
+  CheckTrue(Bits(C.X[0]) = $3FD5555555555555);
+  CheckTrue(Bits(C.X[1]) = $3C71C71C71C71C72);
+  CheckTrue(Bits(C.X[2]) = $B9102F684BDA12F7);
+  CheckTrue(Bits(C.X[3]) = $35BEF561F9ADD3C1);
+end;
+{$ENDIF}
+
 procedure TTestQuadDouble.TestSqr;
 var
   A: QuadDouble;
@@ -1176,28 +2144,42 @@ begin
   CheckEquals('0.0000000000000000000000000000000000000000', A.ToString(USFormatSettings, TMPFloatFormat.Fixed, 40));
   CheckEquals('0,0000000000000000000000000000000000000000E+00', A.ToString(FS, TMPFloatFormat.Scientific, 40));
   CheckEquals('0,0000000000000000000000000000000000000000', A.ToString(FS, TMPFloatFormat.Fixed, 40));
+  {$IF MultiPrecisionRebuiltBinaries}
+  CheckEquals('0', A.ToString(USFormatSettings, TMPFloatFormat.Shortest));
+  {$ENDIF}
 
   A := QuadDouble.Pi / 1e3;
   CheckEquals('3.14159265358979323846264338327950288419716939937510582097494459E-03', A.ToString(USFormatSettings));
   CheckEquals('0.00314159265358979323846264338327950288419716939937510582097494', A.ToString(USFormatSettings, TMPFloatFormat.Fixed));
   CheckEquals('3.1415926535897932384626433832795028841972E-03', A.ToString(USFormatSettings, TMPFloatFormat.Scientific, 40));
   CheckEquals('0.0031415926535897932384626433832795028842', A.ToString(USFormatSettings, TMPFloatFormat.Fixed, 40));
+  {$IF MultiPrecisionRebuiltBinaries}
+  CheckEquals('0.0031415926535897932384626433832795028841971693993751058209749445923', A.ToString(USFormatSettings, TMPFloatFormat.Shortest));
+  {$ENDIF}
 
   A := QuadDouble.E * 1e8;
   CheckEquals('2.71828182845904523536028747135266249775724709369995957496696763E+08', A.ToString(USFormatSettings));
-  {$IF Defined(MP_ACCURATE)}
+  {$IF MultiPrecisionRebuiltBinaries}
+  CheckEquals('271828182.84590452353602874713526624977572470936999595749669676277041041', A.ToString(USFormatSettings, TMPFloatFormat.Fixed));
+  {$ELSEIF Defined(MP_ACCURATE)}
   CheckEquals('271828182.84590452353602874713526624977572470936999595749669676276992280', A.ToString(USFormatSettings, TMPFloatFormat.Fixed));
   {$ELSE}
   CheckEquals('271828182.84590452353602874713526624977572470936999595749669676277296138', A.ToString(USFormatSettings, TMPFloatFormat.Fixed));
   {$ENDIF}
   CheckEquals('2.7182818284590452353602874713526624977572E+08', A.ToString(USFormatSettings, TMPFloatFormat.Scientific, 40));
   CheckEquals('271828182.8459045235360287471352662497757247093700', A.ToString(USFormatSettings, TMPFloatFormat.Fixed, 40));
+  {$IF MultiPrecisionRebuiltBinaries}
+  CheckEquals('271828182.8459045235360287471352662497757247093699959574966967627704', A.ToString(USFormatSettings, TMPFloatFormat.Shortest));
+  {$ENDIF}
 
   A := QuadDouble.NaN;
   CheckEquals('NAN', A.ToString);
   CheckEquals('NAN', A.ToString(TMPFloatFormat.Fixed));
   CheckEquals('NAN', A.ToString(TMPFloatFormat.Scientific, 40));
   CheckEquals('NAN', A.ToString(TMPFloatFormat.Fixed, 40));
+  {$IF MultiPrecisionRebuiltBinaries}
+  CheckEquals('NAN', A.ToString(TMPFloatFormat.Shortest));
+  {$ENDIF}
 
   A := QuadDouble.PositiveInfinity;
   CheckEquals('INF', A.ToString);
@@ -1210,6 +2192,9 @@ begin
   CheckEquals('-INF', A.ToString(TMPFloatFormat.Fixed));
   CheckEquals('-INF', A.ToString(TMPFloatFormat.Scientific, 40));
   CheckEquals('-INF', A.ToString(TMPFloatFormat.Fixed, 40));
+  {$IF MultiPrecisionRebuiltBinaries}
+  CheckEquals('-INF', A.ToString(TMPFloatFormat.Shortest));
+  {$ENDIF}
 end;
 
 procedure TTestQuadDouble.TestTrunc;
@@ -1226,22 +2211,30 @@ begin
   CheckEquals('-3.00000000000000000000000000000000000000000000000000000000000000', Trunc(A));
 
   A := '-3.0';
+  {$IF MultiPrecisionRebuiltBinaries}
+  CheckEquals('-3.00000000000000000000000000000000000000000000000000000000000000', Trunc(A));
+  {$ELSE}
   {$IFDEF MP_ACCURATE}
   { -3.0 cannot be accurately represented. It is actually represented as slightly larger than -3 }
   CheckEquals('-2.00000000000000000000000000000000000000000000000000000000000000', Trunc(A));
   {$ELSE}
   CheckEquals('-3.00000000000000000000000000000000000000000000000000000000000000', Trunc(A));
   {$ENDIF}
+  {$ENDIF}
 
   A := '0.0';
   CheckEquals('0.00000000000000000000000000000000000000000000000000000000000000', Trunc(A));
 
   A := '2.0';
+  {$IF MultiPrecisionRebuiltBinaries}
+  CheckEquals('2.00000000000000000000000000000000000000000000000000000000000000', Trunc(A));
+  {$ELSE}
   {$IFDEF MP_ACCURATE}
   CheckEquals('1.00000000000000000000000000000000000000000000000000000000000000', Trunc(A));
   {$ELSE}
   CheckEquals('2.00000000000000000000000000000000000000000000000000000000000000', Trunc(A));
   {$ENDIF}
+  {$ENDIF}
 
   A := '2.1';
   CheckEquals('2.00000000000000000000000000000000000000000000000000000000000000', Trunc(A));